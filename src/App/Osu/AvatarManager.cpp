@@ -107,7 +107,7 @@ void AvatarManager::load_avatar_image(AvatarEntry& entry) {
         return;
     }
 
-    resourceManager->requestNextLoadAsync();
+    resourceManager->requestNextLoadAsync(LoadPriority::LOW);
     // the path *is* the resource name
     entry.image = resourceManager->loadImageAbs(entry.file_path, entry.file_path);
 }
@@ -5,38 +5,51 @@
 #include "DatabaseBeatmap.h"
 #include "Engine.h"
 #include "ResourceManager.h"
+#include "VisualProfiler.h"
 
-BackgroundImageHandler::BackgroundImageHandler() { this->bFrozen = false; }
+BackgroundImageHandler::BackgroundImageHandler() {
+    this->iCacheBytes = 0;
+    this->iNumHits = 0;
+    this->iNumMisses = 0;
+    this->bFrozen = false;
+}
 
 BackgroundImageHandler::~BackgroundImageHandler() {
     for(auto &i : this->cache) {
         resourceManager->destroyResource(i.backgroundImagePathLoader);
         resourceManager->destroyResource(i.image);
     }
+    for(auto &i : this->index) {
+        i.clear();
+    }
     this->cache.clear();
 }
 
 void BackgroundImageHandler::update(bool allowEviction) {
-    for(size_t i = 0; i < this->cache.size(); i++) {
-        ENTRY &entry = this->cache[i];
+    for(auto it = this->cache.begin(); it != this->cache.end();) {
+        ENTRY &entry = *it;
 
         // NOTE: avoid load/unload jitter if framerate is below eviction delay
         const bool wasUsedLastFrame = entry.wasUsedLastFrame;
         entry.wasUsedLastFrame = false;
 
+        // account for finished loads
+        if(entry.sizeInBytes == 0 && entry.image != nullptr && entry.image->isReady()) {
+            entry.sizeInBytes =
+                static_cast<u64>(entry.image->getWidth()) * entry.image->getHeight() * Image::NUM_CHANNELS;
+            if(!entry.isThumbnail) entry.sizeInBytes += entry.sizeInBytes / 3;  // mipmaps
+
+            this->iCacheBytes += entry.sizeInBytes;
+        }
+
         // check and handle evictions
         if(!wasUsedLastFrame &&
            (engine->getTime() >= entry.evictionTime && engine->getFrameCount() >= entry.evictionTimeFrameCount)) {
             if(allowEviction) {
-                if(!this->bFrozen && !engine->isMinimized()) {
-                    if(entry.backgroundImagePathLoader != nullptr) entry.backgroundImagePathLoader->interruptLoad();
-                    if(entry.image != nullptr) entry.image->interruptLoad();
-
-                    resourceManager->destroyResource(entry.backgroundImagePathLoader);
-                    resourceManager->destroyResource(entry.image);
-
-                    this->cache.erase(this->cache.begin() + i);
-                    i--;
+                // loaded images stay cached until they get pushed out by the budget (see evictLeastRecentlyUsed()),
+                // but scheduled/in-progress loads of entries which are no longer visible are cancelled
+                if(entry.sizeInBytes == 0 && !this->bFrozen && !engine->isMinimized()) {
+                    it = this->evictEntry(it);
                     continue;
                 }
             } else {
@@ -77,20 +90,59 @@ void BackgroundImageHandler::update(bool allowEviction) {
                 }
             }
         }
+
+        ++it;
     }
 
+    if(allowEviction && !this->bFrozen && !engine->isMinimized()) this->evictLeastRecentlyUsed();
+
     // reset flags
     this->bFrozen = false;
 
-    // DEBUG:
-    // debugLog("m_cache.size() = {:d}\n", (int)this->cache.size());
+    if(vprof != nullptr && vprof->isEnabled()) {
+        vprof->addInfoBladeAppTextLine(UString::fmt("BG Cache: {:d} entries, {:.1f} / {:d} MB", this->cache.size(),
+                                                    static_cast<double>(this->iCacheBytes) / (1024.0 * 1024.0),
+                                                    cv::background_image_cache_budget_mb.getInt()));
+        vprof->addInfoBladeAppTextLine(
+            UString::fmt("BG Cache Hits: {:d}, Misses: {:d}", this->iNumHits, this->iNumMisses));
+    }
+}
+
+void BackgroundImageHandler::evictLeastRecentlyUsed() {
+    const u64 maxCacheBytes = static_cast<u64>(std::max(0, cv::background_image_cache_budget_mb.getInt())) * 1024 * 1024;
+    const size_t maxCacheEntries = std::max(0, cv::background_image_cache_size.getInt());
+
+    while(!this->cache.empty() && (this->iCacheBytes > maxCacheBytes || this->cache.size() > maxCacheEntries)) {
+        auto it = std::prev(this->cache.end());
+
+        // never evict anything that is still being drawn (requested this frame or the last one), everything in front
+        // of it is even more recent
+        if(engine->getFrameCount() - it->lastUsedFrameCount <= 1 || it->evictionTime > engine->getTime()) break;
+
+        this->evictEntry(it);
+    }
+}
+
+BackgroundImageHandler::EntryList::iterator BackgroundImageHandler::evictEntry(EntryList::iterator it) {
+    ENTRY &entry = *it;
+
+    if(entry.backgroundImagePathLoader != nullptr) entry.backgroundImagePathLoader->interruptLoad();
+    if(entry.image != nullptr) entry.image->interruptLoad();
+
+    resourceManager->destroyResource(entry.backgroundImagePathLoader);
+    resourceManager->destroyResource(entry.image);
+
+    this->iCacheBytes -= entry.sizeInBytes;
+    this->getIndex(entry.isThumbnail).erase(entry.osuFilePath);
+
+    return this->cache.erase(it);
 }
 
 void BackgroundImageHandler::handleLoadPathForEntry(ENTRY &entry) {
     entry.backgroundImagePathLoader = new DatabaseBeatmapBackgroundImagePathLoader(entry.osuFilePath);
 
     // start path load
-    resourceManager->requestNextLoadAsync();
+    resourceManager->requestNextLoadAsync(entry.isThumbnail ? LoadPriority::LOW : LoadPriority::NORMAL);
     resourceManager->loadResource(entry.backgroundImagePathLoader);
 }
 
@@ -98,15 +150,35 @@ void BackgroundImageHandler::handleLoadImageForEntry(ENTRY &entry) {
     std::string fullBackgroundImageFilePath = entry.folder;
     fullBackgroundImageFilePath.append(entry.backgroundImageFileName);
 
-    // start image load
-    resourceManager->requestNextLoadAsync();
-    resourceManager->requestNextLoadUnmanaged();
-    entry.image = resourceManager->loadImageAbsUnnamed(fullBackgroundImageFilePath, true);
+    // start image load (thumbnails are loaded in bulk while scrolling, don't let them hold up anything else)
+    resourceManager->requestNextLoadAsync(entry.isThumbnail ? LoadPriority::LOW : LoadPriority::NORMAL);
+    if(entry.isThumbnail) {
+        // no mipmaps needed, thumbnails are already (roughly) drawn at their native size
+        entry.image = g->createImage(fullBackgroundImageFilePath, false, false);
+        entry.image->setThumbnailHeight(cv::background_image_thumbnail_height.getInt());
+
+        // unmanaged like the full backgrounds, evicting them while scrolling shouldn't scan the whole resource list
+        resourceManager->requestNextLoadUnmanaged();
+        resourceManager->loadResource(entry.image);
+    } else {
+        resourceManager->requestNextLoadUnmanaged();
+        entry.image = resourceManager->loadImageAbsUnnamed(fullBackgroundImageFilePath, true);
+    }
+}
+
+Image *BackgroundImageHandler::getLoadBackgroundImage(const DatabaseBeatmap *beatmap, bool thumbnail) {
+    return this->requestEntry(beatmap, thumbnail, false);
+}
+
+void BackgroundImageHandler::prefetchBackgroundImage(const DatabaseBeatmap *beatmap, bool thumbnail) {
+    this->requestEntry(beatmap, thumbnail, true);
 }
 
-Image *BackgroundImageHandler::getLoadBackgroundImage(const DatabaseBeatmap *beatmap) {
+Image *BackgroundImageHandler::requestEntry(const DatabaseBeatmap *beatmap, bool thumbnail, bool prefetch) {
     if(beatmap == nullptr || !cv::load_beatmap_background_images.getBool() || !beatmap->draw_background) return nullptr;
 
+    thumbnail &= cv::background_image_thumbnail_height.getInt() > 0;
+
     // NOTE: no references to beatmap are kept anywhere (database can safely be deleted/reloaded without having to
     // notify the BackgroundImageHandler)
 
@@ -115,63 +187,67 @@ Image *BackgroundImageHandler::getLoadBackgroundImage(const DatabaseBeatmap *bea
     const unsigned long newEvictionTimeFrameCount =
         engine->getFrameCount() + (unsigned long)std::max(0, cv::background_image_eviction_delay_frames.getInt());
 
+    EntryIndex &entryIndex = this->getIndex(thumbnail);
+
     // 1) if the path or image is already loaded, return image ref immediately (which may still be NULL) and keep track
     // of when it was last requested
-    for(auto &i : this->cache) {
-        ENTRY &entry = i;
-
-        if(entry.osuFilePath == beatmap->getFilePath()) {
-            entry.wasUsedLastFrame = true;
-            entry.evictionTime = newEvictionTime;
-            entry.evictionTimeFrameCount = newEvictionTimeFrameCount;
+    this->lookupPath.assign(beatmap->getFolder());
+    this->lookupPath.append(beatmap->getFileName());
+    if(const auto indexIt = entryIndex.find(this->lookupPath); indexIt != entryIndex.end()) {
+        const auto it = indexIt->second;
+        ENTRY &entry = *it;
+
+        // move to the front of the LRU list (iterators stay valid)
+        this->cache.splice(this->cache.begin(), this->cache, it);
+
+        entry.wasUsedLastFrame = true;
+        entry.lastUsedFrameCount = engine->getFrameCount();
+        entry.evictionTime = newEvictionTime;
+        entry.evictionTimeFrameCount = newEvictionTimeFrameCount;
+
+        // HACKHACK: to improve future loading speed, if we have already loaded the backgroundImageFileName, force
+        // update the database backgroundImageFileName. this is similar to how it worked before the rework, but 100%
+        // safe(r) since we are not async
+        if(entry.image != nullptr && entry.backgroundImageFileName.length() > 1 &&
+           beatmap->getBackgroundImageFileName().length() < 2) {
+            const_cast<DatabaseBeatmap *>(beatmap)->sBackgroundImageFileName = entry.backgroundImageFileName;
+        }
 
-            // HACKHACK: to improve future loading speed, if we have already loaded the backgroundImageFileName, force
-            // update the database backgroundImageFileName and fullBackgroundImageFilePath this is similar to how it
-            // worked before the rework, but 100% safe(r) since we are not async
-            if(i.image != nullptr && i.backgroundImageFileName.length() > 1 &&
-               beatmap->getBackgroundImageFileName().length() < 2) {
-                const_cast<DatabaseBeatmap *>(beatmap)->sBackgroundImageFileName = i.backgroundImageFileName;
-                const_cast<DatabaseBeatmap *>(beatmap)->sFullBackgroundImageFilePath = beatmap->getFolder();
-                const_cast<DatabaseBeatmap *>(beatmap)->sFullBackgroundImageFilePath.append(i.backgroundImageFileName);
-            }
+        if(!prefetch) this->iNumHits++;
 
-            return entry.image;
-        }
+        return entry.image;
     }
 
+    if(!prefetch) this->iNumMisses++;
+
     // 2) not found in cache, so create a new entry which will get handled in the next update
     {
-        // try evicting stale not-yet-loaded-nor-started-loading entries on overflow
-        const int maxCacheEntries = cv::background_image_cache_size.getInt();
-        {
-            if(this->cache.size() >= maxCacheEntries) {
-                for(size_t i = 0; i < this->cache.size(); i++) {
-                    if(this->cache[i].isLoadScheduled && !this->cache[i].wasUsedLastFrame) {
-                        this->cache.erase(this->cache.begin() + i);
-                        i--;
-                        continue;
-                    }
-                }
-            }
-        }
+        // make room on overflow (only evicts entries which are not currently visible)
+        const size_t maxCacheEntries = std::max(0, cv::background_image_cache_size.getInt());
+        if(this->cache.size() >= maxCacheEntries) this->evictLeastRecentlyUsed();
+        if(this->cache.size() >= maxCacheEntries) return nullptr;
 
         // create entry
         ENTRY entry;
         {
             entry.isLoadScheduled = true;
             entry.wasUsedLastFrame = true;
+            entry.lastUsedFrameCount = engine->getFrameCount();
+            entry.isThumbnail = thumbnail;
             entry.loadingTime = newLoadingTime;
             entry.evictionTime = newEvictionTime;
             entry.evictionTimeFrameCount = newEvictionTimeFrameCount;
+            entry.sizeInBytes = 0;
 
-            entry.osuFilePath = beatmap->getFilePath();
+            entry.osuFilePath = this->lookupPath;
             entry.folder = beatmap->getFolder();
             entry.backgroundImageFileName = beatmap->getBackgroundImageFileName();
 
             entry.backgroundImagePathLoader = nullptr;
             entry.image = nullptr;
         }
-        if(this->cache.size() < maxCacheEntries) this->cache.push_back(entry);
+        this->cache.push_front(std::move(entry));
+        entryIndex.emplace(this->cache.front().osuFilePath, this->cache.begin());
     }
 
     return nullptr;
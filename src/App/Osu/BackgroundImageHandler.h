@@ -4,6 +4,10 @@
 
 #include "cbase.h"
 
+#include <list>
+#include <string_view>
+#include <unordered_map>
+
 class Image;
 
 class DatabaseBeatmap;
@@ -18,7 +22,11 @@ class BackgroundImageHandler {
 
     void scheduleFreezeCache() { this->bFrozen = true; }
 
-    Image *getLoadBackgroundImage(const DatabaseBeatmap *beatmap);
+    // thumbnail: downscaled (and disk-cached) version for song browser buttons, the full image is only for backdrops
+    Image *getLoadBackgroundImage(const DatabaseBeatmap *beatmap, bool thumbnail = false);
+
+    // hint that the image will likely be requested soon (e.g. buttons just outside the visible carousel area)
+    void prefetchBackgroundImage(const DatabaseBeatmap *beatmap, bool thumbnail = false);
 
    private:
     struct ENTRY {
@@ -30,18 +38,46 @@ class BackgroundImageHandler {
         Image *image;
 
         unsigned long evictionTimeFrameCount;
+        unsigned long lastUsedFrameCount;  // wasUsedLastFrame is already reset by the time update() evicts
 
         float loadingTime;
         float evictionTime;
 
+        // decoded size of the image (RAM/VRAM), only known once it finished loading
+        u64 sizeInBytes;
+
         bool isLoadScheduled;
         bool wasUsedLastFrame;
+        bool isThumbnail;
     };
 
+    // most recently used entries are at the front
+    using EntryList = std::list<ENTRY>;
+
+    // keys point into the (node-stable) osuFilePath of the entry they index
+    using EntryIndex = std::unordered_map<std::string_view, EntryList::iterator>;
+
+    Image *requestEntry(const DatabaseBeatmap *beatmap, bool thumbnail, bool prefetch);
+
     void handleLoadPathForEntry(ENTRY &entry);
     void handleLoadImageForEntry(ENTRY &entry);
 
-    std::vector<ENTRY> cache;
+    EntryList::iterator evictEntry(EntryList::iterator it);
+    void evictLeastRecentlyUsed();
+
+    [[nodiscard]] inline EntryIndex &getIndex(bool thumbnail) { return this->index[thumbnail ? 1 : 0]; }
+
+    EntryList cache;
+    std::array<EntryIndex, 2> index;
+
+    // stats, for the debug overlay
+    u64 iCacheBytes;
+    u64 iNumHits;
+    u64 iNumMisses;
+
+    // scratch buffer for building the .osu path of a beatmap to look it up in the index
+    std::string lookupPath;
+
     bool bFrozen;
 };
 
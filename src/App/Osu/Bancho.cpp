@@ -722,7 +722,7 @@ void BanchoState::handle_packet(Packet *packet) {
                 auto name = proto::read_stdstring(packet);
                 auto cvar = cvars->getConVarByName(name, false);
                 if(cvar) {
-                    cvar->hasServerValue.store(false, std::memory_order_release);
+                    cvar->clearServerValue();
                 } else {
                     debugLog("Server wanted to reset cvar '{}', but it doesn't exist!", name);
                 }
@@ -45,6 +45,7 @@ std::mutex incoming_mutex;
 std::vector<Packet> incoming_queue;
 time_t last_packet_tms = {0};
 std::atomic<double> seconds_between_pings{1.0};
+std::atomic<u32> pending_bancho_requests{0};
 
 std::mutex auth_mutex;
 std::string auth_header = "";
@@ -114,10 +115,12 @@ void send_bancho_packet_async(Packet outgoing) {
     auto query_url = UString::format("%sc.%s/", scheme, BanchoState::endpoint.c_str());
 
     last_packet_tms = time(nullptr);
+    pending_bancho_requests++;
 
     networkHandler->httpRequestAsync(
         query_url,
         [](NetworkHandler::Response response) {
+            pending_bancho_requests--;
             if(!response.success) {
                 Engine::logRaw("[httpRequestAsync] Failed to send packet, HTTP error {}\n", response.responseCode);
                 std::scoped_lock<std::mutex> lock{auth_mutex};
@@ -383,13 +386,16 @@ void send_api_request(const APIRequest &request) {
 }
 
 void send_packet(Packet &packet) {
-    if(BanchoState::get_uid() <= 0) {
-        // Don't queue any packets until we're logged in
-        free(packet.memory);
-        packet.memory = nullptr;
-        packet.size = 0;
-        return;
-    }
+    send_packet_copy(packet);
+
+    free(packet.memory);
+    packet.memory = nullptr;
+    packet.size = 0;
+}
+
+void send_packet_copy(const Packet &packet) {
+    // Don't queue any packets until we're logged in
+    if(BanchoState::get_uid() <= 0) return;
 
     // debugLog("Sending packet of type {:}: ", packet.id);
     // for (int i = 0; i < packet.pos; i++) {
@@ -406,13 +412,11 @@ void send_packet(Packet &packet) {
     // Some packets have an empty payload
     if(packet.memory != nullptr) {
         proto::write_bytes(&outgoing, packet.memory, packet.pos);
-        free(packet.memory);
     }
-
-    packet.memory = nullptr;
-    packet.size = 0;
 }
 
+u32 get_pending_requests() { return pending_bancho_requests.load(); }
+
 void cleanup_networking() {
     // no thread to kill, just cleanup any remaining state
     try_logging_in = false;
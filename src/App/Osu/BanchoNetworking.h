@@ -31,6 +31,12 @@ void send_api_request(const APIRequest& request);
 // Send a packet to Bancho. Do not free it after calling this.
 void send_packet(Packet& packet);
 
+// Same as send_packet(), but leaves the packet alone, so that its buffer can be reused.
+void send_packet_copy(const Packet& packet);
+
+// Number of requests to Bancho which haven't gotten a response yet.
+u32 get_pending_requests();
+
 // Poll for new packets. Should be called regularly from main thread.
 void receive_api_responses();
 void receive_bancho_packets();
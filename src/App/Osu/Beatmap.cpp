@@ -19,9 +19,11 @@
 #include "Database.h"
 #include "DatabaseBeatmap.h"
 #include "DifficultyCalculator.h"
+#include "DrainRate.h"
 #include "Engine.h"
 #include "GameRules.h"
 #include "HUD.h"
+#include "HitObjectStacking.h"
 #include "HitObjects.h"
 #include "Keyboard.h"
 #include "LegacyReplay.h"
@@ -431,7 +433,7 @@ bool Beatmap::play() {
     this->is_watching = false;
 
     if(this->start()) {
-        this->last_spectator_broadcast = engine->getTime();
+        this->spectator_stream.reset(engine->getTime());
         RichPresence::onPlayStart();
         if(!BanchoState::spectators.empty()) {
             Packet packet;
@@ -644,7 +646,7 @@ bool Beatmap::start() {
         this->default_sample_set = result.defaultSampleSet;
 
         // load beatmap skin
-        osu->getSkin()->loadBeatmapOverride(this->selectedDifficulty2->getFolder());
+        osu->getSkin()->loadBeatmapOverride(std::string{this->selectedDifficulty2->getFolder()});
     }
 
     // the drawing order is different from the playing/input order.
@@ -1019,10 +1021,13 @@ void Beatmap::seekMS(u32 ms) {
     }
 
     if(this->is_watching) {
-        // When seeking backwards, restart simulation from beginning
+        // When seeking backwards, continue the simulation from the last checkpoint before the new position
         if(ms < this->iCurMusicPos) {
-            SAFE_DELETE(sim);
-            this->sim = new SimulatedBeatmap(this->selectedDifficulty2, osu->getScore()->mods);
+            if(this->sim != nullptr) {
+                this->sim->rewind_to((i32)ms);
+            } else {
+                this->sim = new SimulatedBeatmap(this->selectedDifficulty2, osu->getScore()->mods);
+            }
             this->sim->spectated_replay = this->spectated_replay;
             osu->getScore()->reset();
         }
@@ -1230,14 +1235,14 @@ bool Beatmap::isClickHeld() const { return this->isKey1Down() || this->isKey2Dow
 
 std::string Beatmap::getTitle() const {
     if(this->selectedDifficulty2 != nullptr)
-        return this->selectedDifficulty2->getTitle();
+        return std::string{this->selectedDifficulty2->getTitle()};
     else
         return "NULL";
 }
 
 std::string Beatmap::getArtist() const {
     if(this->selectedDifficulty2 != nullptr)
-        return this->selectedDifficulty2->getArtist();
+        return std::string{this->selectedDifficulty2->getArtist()};
     else
         return "NULL";
 }
@@ -3097,20 +3102,9 @@ void Beatmap::update2() {
 void Beatmap::broadcast_spectator_frames() {
     if(BanchoState::spectators.empty()) return;
 
-    Packet packet;
-    packet.id = OUT_SPECTATE_FRAMES;
-    proto::write<i32>(&packet, 0);
-    proto::write<u16>(&packet, this->frame_batch.size());
-    for(auto batch : this->frame_batch) {
-        proto::write<LiveReplayFrame>(&packet, batch);
-    }
-    proto::write<u8>(&packet, LiveReplayBundle::Action::NONE);
-    proto::write<ScoreFrame>(&packet, ScoreFrame::get());
-    proto::write<u16>(&packet, this->spectator_sequence++);
-    BANCHO::Net::send_packet(packet);
-
-    this->frame_batch.clear();
-    this->last_spectator_broadcast = engine->getTime();
+    const Packet &packet =
+        this->spectator_stream.flush(engine->getTime(), ScoreFrame::get(), this->spectator_sequence++);
+    BANCHO::Net::send_packet_copy(packet);
 }
 
 void Beatmap::write_frame() {
@@ -3144,7 +3138,7 @@ void Beatmap::write_frame() {
         .key_flags = this->current_keys,
     });
 
-    this->frame_batch.push_back(LiveReplayFrame{
+    this->spectator_stream.add_frame(LiveReplayFrame{
         .key_flags = this->current_keys,
         .padding = 0,
         .mouse_x = pos.x,
@@ -3156,7 +3150,8 @@ void Beatmap::write_frame() {
     this->last_event_ms = this->iCurMusicPosWithOffsets;
     this->last_keys = this->current_keys;
 
-    if(!BanchoState::spectators.empty() && last_event_time > this->last_spectator_broadcast + 1.0) {
+    if(!BanchoState::spectators.empty() &&
+       this->spectator_stream.should_flush(this->last_event_time, BANCHO::Net::get_pending_requests())) {
         this->broadcast_spectator_frames();
     }
 }
@@ -3833,12 +3828,6 @@ void Beatmap::calculateStacks() {
 
     debugLog("Beatmap: Calculating stacks ...\n");
 
-    // reset
-    for(auto &hitobject : this->hitobjects) {
-        hitobject->setStack(0);
-    }
-
-    const f32 STACK_LENIENCE = 3.0f;
     const f32 STACK_OFFSET = 0.05f;
 
     const f32 approachTime =
@@ -3846,113 +3835,11 @@ void Beatmap::calculateStacks() {
                                       GameRules::getMaxApproachTime());
     const f32 stackLeniency = this->selectedDifficulty2->getStackLeniency();
 
-    if(this->getSelectedDifficulty2()->getVersion() > 5) {
-        // peppy's algorithm
-        // https://gist.github.com/peppy/1167470
-
-        for(int i = this->hitobjects.size() - 1; i >= 0; i--) {
-            int n = i;
-
-            HitObject *objectI = this->hitobjects[i];
-
-            bool isSpinner = dynamic_cast<Spinner *>(objectI) != nullptr;
-
-            if(objectI->getStack() != 0 || isSpinner) continue;
-
-            bool isHitCircle = dynamic_cast<Circle *>(objectI) != nullptr;
-            bool isSlider = dynamic_cast<Slider *>(objectI) != nullptr;
-
-            if(isHitCircle) {
-                while(--n >= 0) {
-                    HitObject *objectN = this->hitobjects[n];
-
-                    bool isSpinnerN = dynamic_cast<Spinner *>(objectN);
-
-                    if(isSpinnerN) continue;
-
-                    if(objectI->click_time - (approachTime * stackLeniency) > (objectN->click_time + objectN->duration))
-                        break;
-
-                    vec2 objectNEndPosition = objectN->getOriginalRawPosAt(objectN->click_time + objectN->duration);
-                    if(objectN->duration != 0 &&
-                       vec::length(objectNEndPosition - objectI->getOriginalRawPosAt(objectI->click_time)) <
-                           STACK_LENIENCE) {
-                        int offset = objectI->getStack() - objectN->getStack() + 1;
-                        for(int j = n + 1; j <= i; j++) {
-                            if(vec::length((objectNEndPosition - this->hitobjects[j]->getOriginalRawPosAt(
-                                                                     this->hitobjects[j]->click_time))) <
-                               STACK_LENIENCE)
-                                this->hitobjects[j]->setStack(this->hitobjects[j]->getStack() - offset);
-                        }
-
-                        break;
-                    }
-
-                    if(vec::length((objectN->getOriginalRawPosAt(objectN->click_time) -
-                                    objectI->getOriginalRawPosAt(objectI->click_time))) < STACK_LENIENCE) {
-                        objectN->setStack(objectI->getStack() + 1);
-                        objectI = objectN;
-                    }
-                }
-            } else if(isSlider) {
-                while(--n >= 0) {
-                    HitObject *objectN = this->hitobjects[n];
-
-                    bool isSpinner = dynamic_cast<Spinner *>(objectN) != nullptr;
-
-                    if(isSpinner) continue;
-
-                    if(objectI->click_time - (approachTime * stackLeniency) > objectN->click_time) break;
-
-                    if(vec::length(((objectN->duration != 0
-                                         ? objectN->getOriginalRawPosAt(objectN->click_time + objectN->duration)
-                                         : objectN->getOriginalRawPosAt(objectN->click_time)) -
-                                    objectI->getOriginalRawPosAt(objectI->click_time))) < STACK_LENIENCE) {
-                        objectN->setStack(objectI->getStack() + 1);
-                        objectI = objectN;
-                    }
-                }
-            }
-        }
-    } else  // getSelectedDifficulty()->version < 6
-    {
-        // old stacking algorithm for old beatmaps
-        // https://github.com/ppy/osu/blob/master/osu.Game.Rulesets.Osu/Beatmaps/BeatmapProcessor.cs
-
-        for(int i = 0; i < this->hitobjects.size(); i++) {
-            HitObject *currHitObject = this->hitobjects[i];
-            auto *sliderPointer = dynamic_cast<Slider *>(currHitObject);
-
-            const bool isSlider = (sliderPointer != nullptr);
-
-            if(currHitObject->getStack() != 0 && !isSlider) continue;
-
-            long startTime = currHitObject->click_time + currHitObject->duration;
-            int sliderStack = 0;
-
-            for(int j = i + 1; j < this->hitobjects.size(); j++) {
-                HitObject *objectJ = this->hitobjects[j];
-
-                if(objectJ->click_time - (approachTime * stackLeniency) > startTime) break;
-
-                // "The start position of the hitobject, or the position at the end of the path if the hitobject is a
-                // slider"
-                vec2 position2 =
-                    isSlider ? sliderPointer->getOriginalRawPosAt(sliderPointer->click_time + sliderPointer->duration)
-                             : currHitObject->getOriginalRawPosAt(currHitObject->click_time);
-
-                if(vec::length((objectJ->getOriginalRawPosAt(objectJ->click_time) -
-                                currHitObject->getOriginalRawPosAt(currHitObject->click_time))) < 3) {
-                    currHitObject->setStack(currHitObject->getStack() + 1);
-                    startTime = objectJ->click_time + objectJ->duration;
-                } else if(vec::length((objectJ->getOriginalRawPosAt(objectJ->click_time) - position2)) < 3) {
-                    // "Case for sliders - bump notes down and right, rather than up and left."
-                    sliderStack++;
-                    objectJ->setStack(objectJ->getStack() - sliderStack);
-                    startTime = objectJ->click_time + objectJ->duration;
-                }
-            }
-        }
+    std::vector<i32> stacks;
+    HitObjectStacking::calculateStacks(HitObjectStacking::fromHitObjects(this->hitobjects), approachTime,
+                                       stackLeniency, this->getSelectedDifficulty2()->getVersion(), stacks);
+    for(size_t i = 0; i < this->hitobjects.size(); i++) {
+        this->hitobjects[i]->setStack(stacks[i]);
     }
 
     // update hitobject positions
@@ -3971,211 +3858,18 @@ void Beatmap::computeDrainRate() {
 
     debugLog("Beatmap: Calculating drain ...\n");
 
-    {
-        // see https://github.com/ppy/osu-iPhone/blob/master/Classes/OsuPlayer.m
-        // see calcHPDropRate() @ https://github.com/ppy/osu-iPhone/blob/master/Classes/OsuFiletype.m#L661
-
-        // NOTE: all drain changes between 2014 and today have been fixed here (the link points to an old version of the
-        // algorithm!) these changes include: passive spinner nerf (drain * 0.25 while spinner is active), and clamping
-        // the object length drain to 0 + an extra check for that (see maxLongObjectDrop) see
-        // https://osu.ppy.sh/home/changelog/stable40/20190513.2
-
-        struct TestPlayer {
-            TestPlayer(f64 hpBarMaximum) {
-                this->hpBarMaximum = hpBarMaximum;
-
-                this->hpMultiplierNormal = 1.0;
-                this->hpMultiplierComboEnd = 1.0;
-
-                this->resetHealth();
-            }
-
-            void resetHealth() {
-                this->health = this->hpBarMaximum;
-                this->healthUncapped = this->hpBarMaximum;
-            }
-
-            void increaseHealth(f64 amount) {
-                this->healthUncapped += amount;
-                this->health += amount;
-
-                if(this->health > this->hpBarMaximum) this->health = this->hpBarMaximum;
-
-                if(this->health < 0.0) this->health = 0.0;
-
-                if(this->healthUncapped < 0.0) this->healthUncapped = 0.0;
-            }
-
-            void decreaseHealth(f64 amount) {
-                this->health -= amount;
-
-                if(this->health < 0.0) this->health = 0.0;
-
-                if(this->health > this->hpBarMaximum) this->health = this->hpBarMaximum;
-
-                this->healthUncapped -= amount;
-
-                if(this->healthUncapped < 0.0) this->healthUncapped = 0.0;
-            }
-
-            f64 hpBarMaximum;
-
-            f64 health;
-            f64 healthUncapped;
-
-            f64 hpMultiplierNormal;
-            f64 hpMultiplierComboEnd;
-        };
-        TestPlayer testPlayer(200.0);
-
-        const f64 HP = this->getHP();
-        const int version = this->selectedDifficulty2->getVersion();
-
-        f64 testDrop = 0.05;
-
-        const f64 lowestHpEver = GameRules::mapDifficultyRange(HP, 195.0, 160.0, 60.0);
-        const f64 lowestHpComboEnd = GameRules::mapDifficultyRange(HP, 198.0, 170.0, 80.0);
-        const f64 lowestHpEnd = GameRules::mapDifficultyRange(HP, 198.0, 180.0, 80.0);
-        const f64 HpRecoveryAvailable = GameRules::mapDifficultyRange(HP, 8.0, 4.0, 0.0);
-
-        bool fail = false;
-
-        do {
-            testPlayer.resetHealth();
-
-            f64 lowestHp = testPlayer.health;
-            int lastTime = (int)(this->hitobjects[0]->click_time - (long)this->getApproachTime());
-            fail = false;
-
-            const int breakCount = this->breaks.size();
-            int breakNumber = 0;
-
-            int comboTooLowCount = 0;
-
-            for(int i = 0; i < this->hitobjects.size(); i++) {
-                const HitObject *h = this->hitobjects[i];
-                const auto *sliderPointer = dynamic_cast<const Slider *>(h);
-                const auto *spinnerPointer = dynamic_cast<const Spinner *>(h);
-
-                const int localLastTime = lastTime;
-
-                int breakTime = 0;
-                if(breakCount > 0 && breakNumber < breakCount) {
-                    const DatabaseBeatmap::BREAK &e = this->breaks[breakNumber];
-                    if(e.startTime >= localLastTime && e.endTime <= h->click_time) {
-                        // consider break start equal to object end time for version 8+ since drain stops during this
-                        // time
-                        breakTime = (version < 8) ? (e.endTime - e.startTime) : (e.endTime - localLastTime);
-                        breakNumber++;
-                    }
-                }
-
-                testPlayer.decreaseHealth(testDrop * (h->click_time - lastTime - breakTime));
-
-                lastTime = (int)(h->click_time + h->duration);
-
-                if(testPlayer.health < lowestHp) lowestHp = testPlayer.health;
-
-                if(testPlayer.health > lowestHpEver) {
-                    const f64 longObjectDrop = testDrop * (f64)h->duration;
-                    const f64 maxLongObjectDrop = std::max(0.0, longObjectDrop - testPlayer.health);
-
-                    testPlayer.decreaseHealth(longObjectDrop);
-
-                    // nested hitobjects
-                    if(sliderPointer != nullptr) {
-                        // startcircle
-                        testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                            LiveScore::HIT::HIT_SLIDER30, HP, testPlayer.hpMultiplierNormal,
-                            testPlayer.hpMultiplierComboEnd, 1.0));  // slider30
-
-                        // ticks + repeats + repeat ticks
-                        const std::vector<Slider::SLIDERCLICK> &clicks = sliderPointer->getClicks();
-                        for(const auto &click : clicks) {
-                            switch(click.type) {
-                                case 0:  // repeat
-                                    testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                                        LiveScore::HIT::HIT_SLIDER30, HP, testPlayer.hpMultiplierNormal,
-                                        testPlayer.hpMultiplierComboEnd, 1.0));  // slider30
-                                    break;
-                                case 1:  // tick
-                                    testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                                        LiveScore::HIT::HIT_SLIDER10, HP, testPlayer.hpMultiplierNormal,
-                                        testPlayer.hpMultiplierComboEnd, 1.0));  // slider10
-                                    break;
-                            }
-                        }
-
-                        // endcircle
-                        testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                            LiveScore::HIT::HIT_SLIDER30, HP, testPlayer.hpMultiplierNormal,
-                            testPlayer.hpMultiplierComboEnd, 1.0));  // slider30
-                    } else if(spinnerPointer != nullptr) {
-                        const int rotationsNeeded =
-                            (int)((f32)spinnerPointer->duration / 1000.0f * GameRules::getSpinnerSpinsPerSecond(this));
-                        for(int r = 0; r < rotationsNeeded; r++) {
-                            testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                                LiveScore::HIT::HIT_SPINNERSPIN, HP, testPlayer.hpMultiplierNormal,
-                                testPlayer.hpMultiplierComboEnd, 1.0));  // spinnerspin
-                        }
-                    }
-
-                    if(!(maxLongObjectDrop > 0.0) || (testPlayer.health - maxLongObjectDrop) > lowestHpEver) {
-                        // regular hit (for every hitobject)
-                        testPlayer.increaseHealth(
-                            LiveScore::getHealthIncrease(LiveScore::HIT::HIT_300, HP, testPlayer.hpMultiplierNormal,
-                                                         testPlayer.hpMultiplierComboEnd, 1.0));  // 300
-
-                        // end of combo (new combo starts at next hitobject)
-                        if((i == this->hitobjects.size() - 1) || this->hitobjects[i]->is_end_of_combo) {
-                            testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                                LiveScore::HIT::HIT_300G, HP, testPlayer.hpMultiplierNormal,
-                                testPlayer.hpMultiplierComboEnd, 1.0));  // geki
-
-                            if(testPlayer.health < lowestHpComboEnd) {
-                                if(++comboTooLowCount > 2) {
-                                    testPlayer.hpMultiplierComboEnd *= 1.07;
-                                    testPlayer.hpMultiplierNormal *= 1.03;
-                                    fail = true;
-                                    break;
-                                }
-                            }
-                        }
-
-                        continue;
-                    }
-
-                    fail = true;
-                    testDrop *= 0.96;
-                    break;
-                }
-
-                fail = true;
-                testDrop *= 0.96;
-                break;
-            }
-
-            if(!fail && testPlayer.health < lowestHpEnd) {
-                fail = true;
-                testDrop *= 0.94;
-                testPlayer.hpMultiplierComboEnd *= 1.01;
-                testPlayer.hpMultiplierNormal *= 1.01;
-            }
-
-            const f64 recovery = (testPlayer.healthUncapped - testPlayer.hpBarMaximum) / (f64)this->hitobjects.size();
-            if(!fail && recovery < HpRecoveryAvailable) {
-                fail = true;
-                testDrop *= 0.96;
-                testPlayer.hpMultiplierComboEnd *= 1.02;
-                testPlayer.hpMultiplierNormal *= 1.01;
-            }
-        } while(fail);
-
-        this->fDrainRate =
-            (testDrop / testPlayer.hpBarMaximum) * 1000.0;  // from [0, 200] to [0, 1], and from ms to seconds
-        this->fHpMultiplierComboEnd = testPlayer.hpMultiplierComboEnd;
-        this->fHpMultiplierNormal = testPlayer.hpMultiplierNormal;
-    }
+    const DrainRate::Result result = DrainRate::get(
+        this->selectedDifficulty2->getMD5Hash(),
+        DrainRate::Input{.hitobjects = this->hitobjects,
+                         .breaks = this->breaks,
+                         .HP = this->getHP(),
+                         .approachTime = this->getApproachTime(),
+                         .spinsPerSecond = GameRules::getSpinnerSpinsPerSecond(this),
+                         .version = this->selectedDifficulty2->getVersion()});
+
+    this->fDrainRate = result.drainRate;
+    this->fHpMultiplierNormal = result.hpMultiplierNormal;
+    this->fHpMultiplierComboEnd = result.hpMultiplierComboEnd;
 }
 
 f32 Beatmap::getApproachTime_full() const {
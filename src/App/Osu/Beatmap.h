@@ -7,6 +7,7 @@
 #include "HUD.h"
 #include "LegacyReplay.h"
 #include "PlaybackInterpolator.h"
+#include "SpectatorStreamer.h"
 #include "score.h"
 #include "uwu.h"
 
@@ -164,8 +165,7 @@ class Beatmap : public BeatmapInterface {
 
     // getting spectated (live)
     void broadcast_spectator_frames();
-    std::vector<LiveReplayFrame> frame_batch;
-    f64 last_spectator_broadcast = 0;
+    SpectatorStreamer spectator_stream;
     u16 spectator_sequence = 0;
 
     // spectating (live)
@@ -3,6 +3,7 @@
 
 #include "AnimationHandler.h"
 #include "Bancho.h"
+#include "BenchCheck.h"
 #include "BanchoNetworking.h"
 #include "BanchoUsers.h"
 #include "Beatmap.h"
@@ -35,7 +36,10 @@
 #include "UserCard2.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cwctype>
+#include <random>
 #include <regex>
 #include <utility>
 
@@ -43,6 +47,121 @@ namespace proto = BANCHO::Proto;
 
 static McFont *chat_font = nullptr;
 
+namespace {  // static namespace
+bool is_link_space(wchar_t ch) { return std::iswspace(ch) != 0; }
+bool is_line_break(wchar_t ch) { return ch == L'\n' || ch == L'\r'; }
+
+struct LinkMatch {
+    size_t len{0};  // 0 = no match
+    UString url;
+    UString label;
+};
+
+// [[Chat Console]]
+LinkMatch match_wiki_link(std::wstring_view text, size_t pos) {
+    if(text.substr(pos, 2) != L"[[") return {};
+
+    // shortest non-empty label which is followed by "]]"
+    for(size_t end = pos + 2; end < text.length() && !is_line_break(text[end]); end++) {
+        if(end > pos + 2 && text.substr(end, 2) == L"]]") {
+            const std::wstring_view page = text.substr(pos + 2, end - pos - 2);
+            LinkMatch match{.len = end + 2 - pos, .url = "https://osu.ppy.sh/wiki/", .label = "wiki:"};
+            match.url.append(UString(page.data(), (int)page.length()));
+            match.label.append(UString(page.data(), (int)page.length()));
+            return match;
+        }
+    }
+
+    return {};
+}
+
+// [https://example.com label]
+LinkMatch match_labeled_link(std::wstring_view text, size_t pos) {
+    if(text[pos] != L'[') return {};
+
+    // the url is everything up to the first whitespace, which has to be a space
+    size_t url_end = pos + 1;
+    while(url_end < text.length() && !is_link_space(text[url_end])) url_end++;
+    if(url_end == pos + 1 || url_end >= text.length() || text[url_end] != L' ') return {};
+
+    // the protocol is everything up to the last "://" which still has something after it
+    const std::wstring_view url = text.substr(pos + 1, url_end - pos - 1);
+    const size_t separator = url.substr(0, url.length() - 1).rfind(L"://");
+    if(separator == std::wstring_view::npos || separator == 0) return {};
+
+    // shortest non-empty label which is followed by "]"
+    size_t label_end = url_end + 1;
+    for(; label_end < text.length() && !is_line_break(text[label_end]); label_end++) {
+        if(label_end > url_end + 1 && text[label_end] == L']') break;
+    }
+    if(label_end >= text.length() || text[label_end] != L']' || label_end == url_end + 1) return {};
+
+    LinkMatch match{.len = label_end + 1 - pos};
+    match.url = UString(url.data(), (int)url.length());
+    match.label = UString(text.data() + url_end + 1, (int)(label_end - url_end - 1));
+
+    // normalize invite links to osump://
+    const std::wstring_view protocol = url.substr(0, separator);
+    if(protocol == L"osu") {
+        // osu:// -> osump://
+        match.url.insert(2, "mp");
+    } else if(protocol == L"http://osump") {
+        // http://osump:// -> osump://
+        match.url.erase(0, 7);
+    }
+
+    return match;
+}
+
+// https://example.com
+LinkMatch match_raw_link(std::wstring_view text, size_t pos) {
+    size_t end;
+    if(text.substr(pos, 7) == L"http://") {
+        end = pos + 7;
+    } else if(text.substr(pos, 8) == L"https://") {
+        end = pos + 8;
+    } else {
+        return {};
+    }
+
+    const size_t url_start = end;
+    while(end < text.length() && !is_link_space(text[end])) end++;
+    if(end == url_start) return {};
+
+    const UString url(text.data() + pos, (int)(end - pos));
+    return {.len = end - pos, .url = url, .label = url};
+}
+}  // namespace
+
+std::vector<ChatFragment> tokenize_chat_message(const UString &text) {
+    const std::wstring_view str = text.unicodeView();
+    std::vector<ChatFragment> fragments;
+
+    // leftmost match wins, and at the same position wiki links before labeled links before raw links
+    size_t text_start = 0;
+    for(size_t i = 0; i < str.length(); i++) {
+        if(str[i] != L'[' && str[i] != L'h') continue;
+
+        LinkMatch match = match_wiki_link(str, i);
+        if(match.len == 0) match = match_labeled_link(str, i);
+        if(match.len == 0) match = match_raw_link(str, i);
+        if(match.len == 0) continue;
+
+        if(i > text_start) {
+            fragments.push_back({.text = text.substr(text_start, i - text_start), .url = {}});
+        }
+        fragments.push_back({.text = std::move(match.label), .url = std::move(match.url)});
+
+        text_start = i + match.len;
+        i = text_start - 1;
+    }
+    if(text_start < str.length()) {
+        fragments.push_back({.text = text.substr(text_start), .url = {}});
+    }
+
+    return fragments;
+}
+
 ChatChannel::ChatChannel(Chat *chat, UString name_arg) {
     this->chat = chat;
     this->name = std::move(name_arg);
@@ -78,10 +197,7 @@ void ChatChannel::onChannelButtonClick(CBaseUIButton * /*btn*/) {
 }
 
 void ChatChannel::add_message(ChatMessage msg) {
-    const float line_height = 20;
-    const Color system_color = 0xffffff00;
-
-    float x = 10;
+    ChatMessageLayout layout;
 
     bool is_action = msg.text.startsWith("\001ACTION");
     if(is_action) {
@@ -92,187 +208,176 @@ void ChatChannel::add_message(ChatMessage msg) {
     }
 
     struct tm *tm = localtime(&msg.tms);
-    auto timestamp_str = UString::format("%02d:%02d ", tm->tm_hour, tm->tm_min);
-    if(is_action) timestamp_str.append("*");
-    float time_width = chat_font->getStringWidth(timestamp_str);
-    auto *timestamp = new CBaseUILabel(x, this->y_total, time_width, line_height, "", timestamp_str);
-    timestamp->setDrawFrame(false);
-    timestamp->setDrawBackground(false);
-    this->ui->getContainer()->addBaseUIElement(timestamp);
-    x += time_width;
-
-    bool is_system_message = msg.author_name.length() == 0;
-    if(!is_system_message) {
-        float name_width = chat_font->getStringWidth(msg.author_name);
-        auto user_box = new UIUserLabel(msg.author_id, msg.author_name);
-        user_box->setTextColor(0xff2596be);
-        user_box->setPos(x, this->y_total);
-        user_box->setSize(name_width, line_height);
-        this->ui->getContainer()->addBaseUIElement(user_box);
-        x += name_width;
+    layout.timestamp = UString::fmt("{:02d}:{:02d} ", tm->tm_hour, tm->tm_min);
+    if(is_action) layout.timestamp.append("*");
 
-        if(!is_action) {
-            msg.text.insert(0, ": ");
-        }
+    layout.is_system_message = msg.author_name.length() == 0;
+    if(!layout.is_system_message && !is_action) {
+        msg.text.insert(0, ": ");
     }
 
-    // regex101 format: (\[\[(.+?)\]\])|(\[((\S+):\/\/\S+) (.+?)\])|(https?:\/\/\S+)
-    // This matches:
-    // - Raw URLs      https://example.com
-    // - Labeled URLs  [https://regex101.com useful website]
-    // - Lobby invites [osump://0/ join my lobby plz]
-    // - Wiki links    [[Chat Console]]
-    //
-    // Group 1) [[FAQ]]
-    // Group 2) FAQ
-    // Group 3) [https://regex101.com label]
-    // Group 4) https://regex101.com
-    // Group 5) https
-    // Group 6) label
-    // Group 7) https://example.com
-    //
-    // Groups 1, 2 only exist for wiki links
-    // Groups 3, 4, 5, 6 only exist for labeled links
-    // Group 7 only exists for raw links
-    std::wregex url_regex(L"(\\[\\[(.+?)\\]\\])|(\\[((\\S+)://\\S+) (.+?)\\])|(https?://\\S+)");
-
-    std::wstring msg_text = msg.text.wc_str();
-    std::wsmatch match;
-    std::vector<CBaseUILabel *> temp_text_fragments;
-    std::wstring::const_iterator search_start = msg_text.cbegin();
-    sSz text_idx = 0;
-    while(std::regex_search(search_start, msg_text.cend(), match, url_regex)) {
-        sSz match_pos;
-        sSz match_len;
-        UString link_url;
-        UString link_label;
-        if(match[7].matched) {
-            // Raw link
-            match_pos = match.position(7);
-            match_len = match.length(7);
-            link_url = match.str(7).c_str();
-            link_label = match.str(7).c_str();
-        } else if(match[3].matched) {
-            // Labeled link
-            match_pos = match.position(3);
-            match_len = match.length(3);
-            link_url = match.str(4).c_str();
-            link_label = match.str(6).c_str();
-
-            // Normalize invite links to osump://
-            UString link_protocol = match.str(5).c_str();
-            if(link_protocol == "osu") {
-                // osu:// -> osump://
-                link_url.insert(2, "mp");
-            } else if(link_protocol == "http://osump") {
-                // http://osump:// -> osump://
-                link_url.erase(0, 7);
-            }
-        } else {
-            // Wiki link
-            match_pos = match.position(1);
-            match_len = match.length(1);
-            link_url = "https://osu.ppy.sh/wiki/";
-            link_url.append(match.str(2).c_str());
-            link_label = "wiki:";
-            link_label.append(match.str(2).c_str());
-        }
+    layout.fragments = tokenize_chat_message(msg.text);
+    layout.msg = std::move(msg);
 
-        sSz search_idx = search_start - msg_text.cbegin();
-        auto url_start = search_idx + match_pos;
-        auto preceding_text = msg.text.substr(text_idx, url_start - text_idx);
-        if(preceding_text.length() > 0) {
-            temp_text_fragments.push_back(new CBaseUILabel(0, 0, 0, 0, "", preceding_text));
-        }
+    if(this->messages.full()) this->evict_oldest_message();
+    ChatMessageLayout &added = this->messages.push_back(std::move(layout));
 
-        auto link = new ChatLink(0, 0, 0, 0, link_url, link_label);
-        temp_text_fragments.push_back(link);
+    // not laid out yet, updateLayout() will take care of it
+    if(this->ui->getSize().x <= 0.f) return;
 
-        text_idx = url_start + match_len;
-        search_start = msg_text.cbegin() + text_idx;
-    }
-    if(search_start != msg_text.cend()) {
-        auto text = msg.text.substr(text_idx);
-        temp_text_fragments.push_back(new CBaseUILabel(0, 0, 0, 0, "", text));
-    }
-    if(is_action) {
-        // Only appending now to prevent this character from being included in a link
-        msg.text.append(L"*");
-        msg_text.append(L"*");
+    this->layout_message(added, this->ui->getSize().x);
+    this->add_elements(added);
+    this->ui->setScrollSizeToContent();
+}
+
+void ChatChannel::clear() {
+    this->messages.clear();
+    this->ui->freeElements();
+    this->y_total = 7;
+    this->ui->setScrollSizeToContent();
+}
+
+void ChatChannel::layout_message(ChatMessageLayout &layout, float width) {
+    const float line_height = 20;
+
+    layout.pieces.clear();
+    layout.layout_width = width;
+
+    float x = 10;
+    float y = 0;
+
+    const float time_width = chat_font->getStringWidth(layout.timestamp);
+    layout.pieces.push_back({.type = ChatMessageLayout::PIECE::TIMESTAMP,
+                             .pos = vec2{x, y},
+                             .width = time_width,
+                             .text = layout.timestamp,
+                             .url = {}});
+    x += time_width;
+
+    if(!layout.is_system_message) {
+        const float name_width = chat_font->getStringWidth(layout.msg.author_name);
+        layout.pieces.push_back({.type = ChatMessageLayout::PIECE::AUTHOR,
+                                 .pos = vec2{x, y},
+                                 .width = name_width,
+                                 .text = layout.msg.author_name,
+                                 .url = {}});
+        x += name_width;
     }
 
     // We're offsetting the first fragment to account for the username + timestamp
-    // Since first fragment will always be text, we don't care about the size being wrong
     float line_width = x;
 
-    // We got a bunch of text fragments, now position them, and if we start a new line,
-    // possibly divide them into more text fragments.
-    for(auto fragment : temp_text_fragments) {
-        UString text_str("");
-        auto fragment_text = fragment->getText();
-
-        for(int i = 0; i < fragment_text.length(); i++) {
-            float char_width = chat_font->getGlyphMetrics(fragment_text[i]).advance_x;
-            if(line_width + char_width + 20 >= this->ui->getSize().x) {
-                auto *link_fragment = dynamic_cast<ChatLink *>(fragment);
-                if(link_fragment == nullptr) {
-                    auto *text = new CBaseUILabel(x, this->y_total, line_width - x, line_height, "", text_str);
-                    text->setDrawFrame(false);
-                    text->setDrawBackground(false);
-                    if(is_system_message) {
-                        text->setTextColor(system_color);
-                    }
-                    this->ui->getContainer()->addBaseUIElement(text);
-                } else {
-                    auto *link =
-                        new ChatLink(x, this->y_total, line_width - x, line_height, fragment->getName(), text_str);
-                    this->ui->getContainer()->addBaseUIElement(link);
+    // Position the fragments, and if we start a new line, divide them into more pieces.
+    for(const ChatFragment &fragment : layout.fragments) {
+        const auto type = fragment.url.length() > 0 ? ChatMessageLayout::PIECE::LINK : ChatMessageLayout::PIECE::TEXT;
+
+        int piece_start = 0;
+        for(int i = 0; i < fragment.text.length(); i++) {
+            float char_width = chat_font->getGlyphMetrics(fragment.text[i]).advance_x;
+            if(line_width + char_width + 20 >= width) {
+                if(i > piece_start) {
+                    layout.pieces.push_back({.type = type,
+                                             .pos = vec2{x, y},
+                                             .width = line_width - x,
+                                             .text = fragment.text.substr(piece_start, i - piece_start),
+                                             .url = fragment.url});
                 }
 
                 x = 10;
-                this->y_total += line_height;
+                y += line_height;
                 line_width = x;
-                text_str = "";
+                piece_start = i;
             }
 
-            text_str.append(fragment_text[i]);
             line_width += char_width;
         }
 
-        auto *link_fragment = dynamic_cast<ChatLink *>(fragment);
-        if(link_fragment == nullptr) {
-            auto *text = new CBaseUILabel(x, this->y_total, line_width - x, line_height, "", text_str);
-            text->setDrawFrame(false);
-            text->setDrawBackground(false);
-            if(is_system_message) {
-                text->setTextColor(system_color);
-            }
-            this->ui->getContainer()->addBaseUIElement(text);
-        } else {
-            auto *link = new ChatLink(x, this->y_total, line_width - x, line_height, fragment->getName(), text_str);
-            this->ui->getContainer()->addBaseUIElement(link);
-        }
+        layout.pieces.push_back({.type = type,
+                                 .pos = vec2{x, y},
+                                 .width = line_width - x,
+                                 .text = fragment.text.substr(piece_start),
+                                 .url = fragment.url});
 
         x = line_width;
     }
 
-    for(auto &fragment : temp_text_fragments) {
-        SAFE_DELETE(fragment);
+    layout.height = y + line_height;
+}
+
+void ChatChannel::add_elements(ChatMessageLayout &layout) {
+    const float line_height = 20;
+    const Color system_color = 0xffffff00;
+
+    layout.elements.clear();
+    for(const auto &piece : layout.pieces) {
+        const vec2 pos{piece.pos.x, this->y_total + piece.pos.y};
+
+        CBaseUILabel *element = nullptr;
+        switch(piece.type) {
+            case ChatMessageLayout::PIECE::TIMESTAMP:
+            case ChatMessageLayout::PIECE::TEXT:
+                element = new CBaseUILabel(pos.x, pos.y, piece.width, line_height, "", piece.text);
+                element->setDrawFrame(false);
+                element->setDrawBackground(false);
+                if(piece.type == ChatMessageLayout::PIECE::TEXT && layout.is_system_message) {
+                    element->setTextColor(system_color);
+                }
+                break;
+            case ChatMessageLayout::PIECE::AUTHOR:
+                element = new UIUserLabel(layout.msg.author_id, piece.text);
+                element->setTextColor(0xff2596be);
+                element->setPos(pos);
+                element->setSize(piece.width, line_height);
+                break;
+            case ChatMessageLayout::PIECE::LINK:
+                element = new ChatLink(pos.x, pos.y, piece.width, line_height, piece.url, piece.text);
+                break;
+        }
+
+        this->ui->getContainer()->addBaseUIElement(element);
+        layout.elements.push_back(element);
     }
 
-    this->y_total += line_height;
-    this->ui->setScrollSizeToContent();
+    this->y_total += layout.height;
+}
+
+void ChatChannel::evict_oldest_message() {
+    ChatMessageLayout &oldest = this->messages.front();
+
+    // its elements are the first ones in the container, since messages are only ever appended
+    for(CBaseUIElement *element : oldest.elements) {
+        this->ui->getContainer()->deleteBaseUIElement(element);
+    }
+
+    // move everything else up to take its place
+    for(CBaseUIElement *element : this->ui->getContainer()->getElements()) {
+        element->setRelPosY(element->getRelPos().y - oldest.height);
+    }
+    this->ui->getContainer()->update_pos();
+    this->y_total -= oldest.height;
+
+    this->messages.pop_front();
 }
 
 void ChatChannel::updateLayout(vec2 pos, vec2 size) {
-    this->ui->freeElements();
     this->ui->setPos(pos);
     this->ui->setSize(size);
+
+    // same width as before, so the existing elements are still laid out correctly
+    bool width_changed = this->messages.empty();
+    for(const auto &layout : this->messages) {
+        width_changed |= layout.layout_width != size.x;
+    }
+    if(!width_changed) return;
+
+    this->ui->freeElements();
     this->y_total = 7;
 
-    for(const auto &msg : this->messages) {
-        this->add_message(msg);
+    for(auto &layout : this->messages) {
+        if(layout.layout_width != size.x) this->layout_message(layout, size.x);
+        this->add_elements(layout);
     }
+    this->ui->setScrollSizeToContent();
 }
 
 Chat::Chat() : OsuScreen() {
@@ -440,7 +545,7 @@ void Chat::mouse_update(bool *propagate_clicks) {
 
 void Chat::handle_command(const UString &msg) {
     if(msg == "/clear") {
-        this->selected_channel->messages.clear();
+        this->selected_channel->clear();
         this->updateLayout(osu->getScreenSize());
         return;
     }
@@ -462,8 +567,8 @@ void Chat::handle_command(const UString &msg) {
             return;
         }
 
-        UString song_name = UString::format("%s - %s [%s]", diff->getArtist().c_str(), diff->getTitle().c_str(),
-                                            diff->getDifficultyName().c_str());
+        UString song_name =
+            UString::fmt("{:s} - {:s} [{:s}]", diff->getArtist(), diff->getTitle(), diff->getDifficultyName());
         UString song_link = UString::format("[https://osu.%s/beatmaps/%d %s]", BanchoState::endpoint.c_str(), diff->getID(),
                                             song_name.toUtf8());
 
@@ -926,7 +1031,6 @@ void Chat::addMessage(UString channel_name, const ChatMessage &msg, bool mark_un
     this->addChannel(channel_name);
     for(auto chan : this->channels) {
         if(chan->name != channel_name) continue;
-        chan->messages.push_back(msg);
         chan->add_message(msg);
 
         if(mark_unread) {
@@ -937,8 +1041,7 @@ void Chat::addMessage(UString channel_name, const ChatMessage &msg, bool mark_un
                 // Update ticker
                 auto screen = osu->getScreenSize();
                 this->ticker_tms = engine->getTime();
-                this->ticker->messages.clear();
-                this->ticker->messages.push_back(msg);
+                this->ticker->clear();
                 this->ticker->add_message(msg);
                 this->updateTickerLayout(screen);
             } else {
@@ -946,10 +1049,6 @@ void Chat::addMessage(UString channel_name, const ChatMessage &msg, bool mark_un
             }
         }
 
-        if(chan->messages.size() > 100) {
-            chan->messages.erase(chan->messages.begin());
-        }
-
         break;
     }
 
@@ -1311,3 +1410,141 @@ void Chat::askWhatChannelToJoin(CBaseUIButton * /*btn*/) {
     // XXX: Could display nicer UI with full channel list (chat_channels in Bancho.cpp)
     osu->prompt->prompt("Type in the channel you want to join (e.g. '#osu'):", SA::MakeDelegate<&Chat::join>(this));
 }
+
+void ChatChannel::bench() {
+    static constexpr int NUM_MESSAGES = 100'000;
+    static constexpr int NUM_RANDOM_MESSAGES = 300'000;
+
+    if(osu == nullptr || osu->chat == nullptr) return;
+
+    BenchCheck check("chat_bench");
+
+    // the regex parser add_message() used before tokenize_chat_message(), as the reference.
+    // regex101 format: (\[\[(.+?)\]\])|(\[((\S+):\/\/\S+) (.+?)\])|(https?:\/\/\S+)
+    // groups 1, 2 only exist for wiki links, 3, 4, 5, 6 only for labeled links, 7 only for raw links
+    const std::wregex urlRegex(L"(\\[\\[(.+?)\\]\\])|(\\[((\\S+)://\\S+) (.+?)\\])|(https?://\\S+)");
+    const auto regexTokenize = [&urlRegex](const UString &text) {
+        std::vector<ChatFragment> fragments;
+
+        const std::wstring str(text.unicodeView());
+        std::wsmatch match;
+        auto searchStart = str.cbegin();
+        while(std::regex_search(searchStart, str.cend(), match, urlRegex)) {
+            int group;
+            ChatFragment link;
+            if(match[7].matched) {
+                group = 7;
+                link.url = match.str(7).c_str();
+                link.text = match.str(7).c_str();
+            } else if(match[3].matched) {
+                group = 3;
+                link.url = match.str(4).c_str();
+                link.text = match.str(6).c_str();
+
+                const UString protocol = match.str(5).c_str();
+                if(protocol == "osu") {
+                    link.url.insert(2, "mp");
+                } else if(protocol == "http://osump") {
+                    link.url.erase(0, 7);
+                }
+            } else {
+                group = 1;
+                link.url = "https://osu.ppy.sh/wiki/";
+                link.url.append(match.str(2).c_str());
+                link.text = "wiki:";
+                link.text.append(match.str(2).c_str());
+            }
+
+            const auto linkStart = match[group].first;
+            if(linkStart != searchStart) {
+                fragments.push_back({.text = UString(std::wstring(searchStart, linkStart).c_str()), .url = {}});
+            }
+            fragments.push_back(std::move(link));
+            searchStart = match[group].second;
+        }
+        if(searchStart != str.cend()) {
+            fragments.push_back({.text = UString(std::wstring(searchStart, str.cend()).c_str()), .url = {}});
+        }
+
+        return fragments;
+    };
+
+    // fragments as comparable/printable strings
+    const auto describe = [](const std::vector<ChatFragment> &fragments) {
+        std::vector<std::string> descriptions;
+        for(const ChatFragment &fragment : fragments) {
+            descriptions.push_back(fmt::format("{:?} -> {:?}", fragment.text.utf8View(), fragment.url.utf8View()));
+        }
+        return descriptions;
+    };
+
+    // random messages made out of bits of links, so that all the almost-links and overlapping links get hit
+    const std::array<const wchar_t *, 20> pieces{
+        L"[", L"[[", L"]", L"]]", L" ", L"  ", L"\t", L"\n", L"a", L"wiki", L"h", L"\u00e9",
+        L"http://", L"https://", L"osu://", L"osump://", L"http://osump://", L"://", L"/", L":",
+    };
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<size_t> randomPiece(0, pieces.size() - 1);
+    std::uniform_int_distribution<int> randomLength(0, 16);
+
+    u64 startTime = Timing::getTicksNS();
+    for(int i = 0; i < NUM_RANDOM_MESSAGES; i++) {
+        std::wstring str;
+        for(int len = randomLength(rng); len > 0; len--) str.append(pieces[randomPiece(rng)]);
+
+        const UString text(str.c_str());
+        check.expectEqualElements(describe(tokenize_chat_message(text)), describe(regexTokenize(text)),
+                                  fmt::format("fragments of {:?}", text.utf8View()));
+    }
+    const double compareMS = static_cast<double>(Timing::getTicksNS() - startTime) / 1000000.0;
+
+    const std::array<UString, 6> texts{
+        "hey does anyone know how to get the new skin working? the cursor trail looks really weird for me",
+        "check this out https://osu.ppy.sh/beatmapsets/39804#osu/129891 it's so good",
+        "[osump://1234/ join my lobby plz] [https://osu.ppy.sh/b/129891 FREEDOM DiVE] no fc yet",
+        "read [[Chat Console]] and [[FAQ]] before asking please",
+        "gl on the map! that last stream is actually insane lmao",
+        "\001ACTION is listening to [https://osu.ppy.sh/b/75 Kenji Ninuma - DISCO PRINCE]\001",
+    };
+
+    startTime = Timing::getTicksNS();
+    size_t numFragments = 0;
+    for(int i = 0; i < NUM_MESSAGES; i++) {
+        numFragments += tokenize_chat_message(texts[i % texts.size()]).size();
+    }
+    const double tokenizeNS = static_cast<double>(Timing::getTicksNS() - startTime) / NUM_MESSAGES;
+
+    startTime = Timing::getTicksNS();
+    size_t numRegexFragments = 0;
+    for(int i = 0; i < NUM_MESSAGES; i++) {
+        numRegexFragments += regexTokenize(texts[i % texts.size()]).size();
+    }
+    const double regexNS = static_cast<double>(Timing::getTicksNS() - startTime) / NUM_MESSAGES;
+    check.expectEqual(numFragments, numRegexFragments, "fragments of the sample messages");
+
+    ChatChannel channel(nullptr, "#bench");
+    channel.updateLayout(vec2{0.f, 0.f}, vec2{800.f, 600.f});
+
+    startTime = Timing::getTicksNS();
+    for(int i = 0; i < NUM_MESSAGES; i++) {
+        channel.add_message(ChatMessage{.tms = static_cast<time_t>(i),
+                                        .author_id = i % 50 == 0 ? 0 : 1000 + i % 20,
+                                        .author_name = i % 50 == 0 ? UString{} : UString("someone"),
+                                        .text = texts[i % texts.size()]});
+    }
+    const double addNS = static_cast<double>(Timing::getTicksNS() - startTime) / NUM_MESSAGES;
+
+    startTime = Timing::getTicksNS();
+    channel.updateLayout(vec2{0.f, 0.f}, vec2{600.f, 600.f});
+    const double relayoutNS = static_cast<double>(Timing::getTicksNS() - startTime);
+
+    Engine::logRaw("chat_bench: {:d} random messages compared against the regex parser in {:.0f} ms\n",
+                   NUM_RANDOM_MESSAGES, compareMS);
+    Engine::logRaw("chat_bench: {:d} messages\n", NUM_MESSAGES);
+    Engine::logRaw("    tokenize:    {:.0f} ns per message (regex: {:.0f} ns)\n", tokenizeNS, regexNS);
+    Engine::logRaw("    add_message: {:.0f} ns per message\n", addNS);
+    Engine::logRaw("    relayout:    {:.0f} us for the whole channel\n", relayoutNS / 1000.0);
+    Engine::logRaw("chat_bench: done, kept {:d}/{:d} messages in {:d} ui elements\n", channel.messages.size(),
+                   channel.messages.capacity(), channel.ui->getContainer()->getElements().size());
+    check.finish();
+}
@@ -4,8 +4,10 @@
 #include "CBaseUIScrollView.h"
 #include "CBaseUITextbox.h"
 #include "OsuScreen.h"
+#include "templates.h"
 
 class CBaseUIButton;
+class CBaseUIElement;
 class McFont;
 class Chat;
 class UIButton;
@@ -17,7 +19,47 @@ struct ChatMessage {
     UString text;
 };
 
+// a run of message text, either plain text or a link (if url isn't empty)
+struct ChatFragment {
+    UString text;
+    UString url;
+};
+
+// splits message text into plain text and links, in a single pass. recognizes
+// - raw links        https://example.com
+// - labeled links    [https://example.com useful website]
+// - lobby invites    [osump://0/ join my lobby plz]
+// - wiki links       [[Chat Console]]
+std::vector<ChatFragment> tokenize_chat_message(const UString &text);
+
+// a message as it's displayed: tokenized once when it's received, and only wrapped again when the channel width changes
+struct ChatMessageLayout {
+    enum class PIECE : u8 { TIMESTAMP, AUTHOR, TEXT, LINK };
+
+    struct Piece {
+        PIECE type;
+        vec2 pos;  // relative to the top of the message
+        float width;
+        UString text;
+        UString url;
+    };
+
+    ChatMessage msg;
+    UString timestamp;
+    std::vector<ChatFragment> fragments;  // with the ": " after the author name already prepended
+    bool is_system_message;
+
+    std::vector<Piece> pieces;
+    float layout_width{-1.f};
+    float height{0.f};
+
+    // the ui elements created from the pieces, so that they can be removed again when the message is evicted
+    std::vector<CBaseUIElement *> elements;
+};
+
 struct ChatChannel {
+    static constexpr const size_t MAX_MESSAGES{100};
+
     ChatChannel(Chat *chat, UString name_arg);
     ~ChatChannel();
 
@@ -25,13 +67,22 @@ struct ChatChannel {
     CBaseUIScrollView *ui;
     UIButton *btn;
     UString name;
-    std::vector<ChatMessage> messages;
+    ring<ChatMessageLayout> messages{MAX_MESSAGES};  // the oldest message is dropped once it's full
     float y_total{.0f};
     bool read = true;
 
     void add_message(ChatMessage msg);
+    void clear();
     void updateLayout(vec2 pos, vec2 size);
     void onChannelButtonClick(CBaseUIButton *btn);
+
+    // chat_bench: tokenizing, adding and relayouting messages in an offscreen channel
+    static void bench();
+
+   private:
+    void layout_message(ChatMessageLayout &layout, float width);
+    void add_elements(ChatMessageLayout &layout);
+    void evict_oldest_message();
 };
 
 class Chat : public OsuScreen {
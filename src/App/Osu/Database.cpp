@@ -9,6 +9,7 @@
 #include "ConVar.h"
 #include "Database.h"
 #include "DatabaseBeatmap.h"
+#include "DrainRate.h"
 #include "Engine.h"
 #include "File.h"
 #include "LegacyReplay.h"
@@ -20,6 +21,7 @@
 #include "SongBrowser/MapCalcThread.h"
 #include "SongBrowser/ScoreConverterThread.h"
 #include "SongBrowser/SongBrowser.h"
+#include "Thread.h"
 #include "Timing.h"
 #include "score.h"
 
@@ -88,6 +90,89 @@ bool sortScoreByPP(FinishedScore const &a, FinishedScore const &b) {
     return false;  // equivalent
 }
 
+constexpr const char *SCORES_JOURNAL_PATH = "neosu_scores.db.journal";
+constexpr const char *SCORES_JOURNAL_COMPACTING_PATH = "neosu_scores.db.journal.old";
+
+// rewrites neosu_scores.db from scratch
+bool saveScoresSnapshot(const std::unordered_map<MD5Hash, std::vector<FinishedScore>> &scores) {
+    const double startTime = Timing::getTimeReal();
+
+    u32 nb_beatmaps = 0;
+    u32 nb_scores = 0;
+    for(const auto &[_, scorevec] : scores) {
+        u32 beatmap_scores = scorevec.size();
+        if(beatmap_scores > 0) {
+            nb_beatmaps++;
+            nb_scores += beatmap_scores;
+        }
+    }
+
+    {
+        ByteBufferedFile::Writer db("neosu_scores.db");
+        db.write_bytes((u8 *)"NEOSC", 5);
+        db.write<u32>(NEOSU_SCORE_DB_VERSION);
+        db.write<u32>(nb_beatmaps);
+        db.write<u32>(nb_scores);
+
+        for(const auto &[hash, scorevec] : scores) {
+            if(scorevec.empty()) continue;
+
+            db.write_hash(hash);
+            db.write<u32>(scorevec.size());
+
+            for(const auto &score : scorevec) {
+                assert(!score.is_online_score);
+
+                db.write_mods(score.mods);
+                db.write<u64>(score.score);
+                db.write<u64>(score.spinner_bonus);
+                db.write<u64>(score.unixTimestamp);
+                db.write<i32>(score.player_id);
+                db.write_string(score.playerName);
+                db.write<u8>((u8)score.grade);
+
+                db.write_string(score.client);
+                db.write_string(score.server);
+                db.write<i64>(score.bancho_score_id);
+                db.write<u64>(score.peppy_replay_tms);
+
+                db.write<u16>(score.num300s);
+                db.write<u16>(score.num100s);
+                db.write<u16>(score.num50s);
+                db.write<u16>(score.numGekis);
+                db.write<u16>(score.numKatus);
+                db.write<u16>(score.numMisses);
+                db.write<u16>(score.comboMax);
+
+                db.write<u32>(score.ppv2_version);
+                db.write<f32>(score.ppv2_score);
+                db.write<f32>(score.ppv2_total_stars);
+                db.write<f32>(score.ppv2_aim_stars);
+                db.write<f32>(score.ppv2_speed_stars);
+
+                db.write<u16>(score.numSliderBreaks);
+                db.write<f32>(score.unstableRate);
+                db.write<f32>(score.hitErrorAvgMin);
+                db.write<f32>(score.hitErrorAvgMax);
+                db.write<u32>(score.maxPossibleCombo);
+                db.write<u32>(score.numHitObjects);
+                db.write<u32>(score.numCircles);
+            }
+        }
+
+        if(!db.good()) {
+            debugLog("Failed to save scores: {:s}\n", db.error());
+            return false;
+        }
+    }
+
+    debugLog("Saved {:d} scores in {:f} seconds.\n", nb_scores, (Timing::getTimeReal() - startTime));
+    return true;
+}
+
+// osu!.db is split up between loader threads in chunks of at least this many beatmaps
+constexpr const size_t MIN_ENTRIES_PER_LOAD_THREAD{1024};
+
 }  // namespace
 
 // run after at least one engine frame (due to resourceManager->update() in Engine::onUpdate())
@@ -102,6 +187,8 @@ void Database::AsyncDBLoader::init() {
         sct_calc(db->scores);
     }
 
+    db->maybeCompactScores();
+
     // signal that we are done
     db->fLoadingProgress = 1.0f;
     this->bReady = true;
@@ -120,6 +207,7 @@ void Database::AsyncDBLoader::initAsync() {
     db->findDatabases();
     if(db->bInterruptLoad.load()) goto done;
     db->loadScores(db->database_files["neosu_scores.db"]);
+    db->loadScoreJournal();
     if(db->bInterruptLoad.load()) goto done;
     db->loadOldMcNeosuScores(db->database_files["scores.db"]);
     if(db->bInterruptLoad.load()) goto done;
@@ -207,6 +295,8 @@ Database::Database() {
     this->iVersion = 0;
     this->iFolderCount = 0;
 
+    this->score_journal = std::make_unique<ScoreJournal>(SCORES_JOURNAL_PATH);
+
     this->prevPlayerStats.pp = 0.0f;
     this->prevPlayerStats.accuracy = 0.0f;
     this->prevPlayerStats.numScoresWithPP = 0;
@@ -224,10 +314,11 @@ Database::Database() {
 
 Database::~Database() {
     this->destroyLoader();
+    sct_abort();  // (can start a compaction)
+    if(this->score_compaction_thread.joinable()) this->score_compaction_thread.join();
 
     SAFE_DELETE(this->importTimer);
 
-    sct_abort();
     lct_set_map(nullptr);
     VolNormalization::abort();
     this->loudness_to_calc.clear();
@@ -328,6 +419,7 @@ void Database::save() {
     save_collections();
     this->saveMaps();
     this->saveScores();
+    DrainRate::save();
 }
 
 BeatmapSet *Database::addBeatmapSet(const std::string &beatmapFolderPath, i32 set_id_override) {
@@ -360,12 +452,15 @@ BeatmapSet *Database::addBeatmapSet(const std::string &beatmapFolderPath, i32 se
 }
 
 int Database::addScore(const FinishedScore &score) {
-    this->addScoreRaw(score);
+    const bool added = this->addScoreRaw(score);
     this->sortScores(score.beatmap_hash);
 
     this->bDidScoresChangeForStats = true;
 
-    if(cv::scores_save_immediately.getBool()) this->saveScores();
+    if(added && cv::scores_save_immediately.getBool()) {
+        this->score_journal->add(score);
+        this->maybeCompactScores();
+    }
 
     // @PPV3: use new replay format
 
@@ -445,16 +540,23 @@ bool Database::addScoreRaw(const FinishedScore &score) {
 }
 
 void Database::deleteScore(MD5Hash beatmapMD5Hash, u64 scoreUnixTimestamp) {
-    std::scoped_lock lock(this->scores_mtx);
-    for(int i = 0; i < this->scores[beatmapMD5Hash].size(); i++) {
-        if(this->scores[beatmapMD5Hash][i].unixTimestamp == scoreUnixTimestamp) {
-            this->scores[beatmapMD5Hash].erase(this->scores[beatmapMD5Hash].begin() + i);
-            this->bDidScoresChangeForStats = true;
-            break;
+    {
+        std::scoped_lock lock(this->scores_mtx);
+        for(int i = 0; i < this->scores[beatmapMD5Hash].size(); i++) {
+            if(this->scores[beatmapMD5Hash][i].unixTimestamp == scoreUnixTimestamp) {
+                this->scores[beatmapMD5Hash].erase(this->scores[beatmapMD5Hash].begin() + i);
+                this->bDidScoresChangeForStats = true;
+                this->score_journal->remove(beatmapMD5Hash, scoreUnixTimestamp);
+                break;
+            }
         }
     }
+
+    this->maybeCompactScores();
 }
 
+void Database::onScoresPPChanged(std::span<const FinishedScore> scores) { this->score_journal->update_pp(scores); }
+
 void Database::sortScoresInPlace(std::vector<FinishedScore> &scores) {
     if(scores.size() < 2) return;
 
@@ -802,7 +904,8 @@ void Database::loadMaps() {
     // We don't want to reload it, ever. Would cause too much jank.
     static bool first_load = true;
     {
-        ByteBufferedFile::Reader neosu_maps(neosu_maps_path);
+        ByteBufferedFile::MappedFile neosu_maps_file(neosu_maps_path);
+        ByteBufferedFile::MemoryReader neosu_maps(neosu_maps_file);
         if(first_load && neosu_maps.total_size > 0) {
             first_load = false;
 
@@ -843,17 +946,12 @@ void Database::loadMaps() {
 
                     std::string osu_filename = neosu_maps.read_string();
 
-                    std::string map_path = mapset_path;
-                    map_path.append(osu_filename);
-
-                    auto diff =
-                        new BeatmapDifficulty(map_path, mapset_path, DatabaseBeatmap::BeatmapType::NEOSU_DIFFICULTY);
+                    auto diff = new BeatmapDifficulty(mapset_path, osu_filename,
+                                                      DatabaseBeatmap::BeatmapType::NEOSU_DIFFICULTY);
                     diff->iID = neosu_maps.read<i32>();
                     diff->iSetID = set_id;
                     diff->sTitle = neosu_maps.read_string();
                     diff->sAudioFileName = neosu_maps.read_string();
-                    diff->sFullSoundFilePath = mapset_path;
-                    diff->sFullSoundFilePath.append(diff->sAudioFileName);
                     diff->iLengthMS = neosu_maps.read<i32>();
                     diff->fStackLeniency = neosu_maps.read<f32>();
                     diff->sArtist = neosu_maps.read_string();
@@ -957,7 +1055,8 @@ void Database::loadMaps() {
     }
 
     if(!this->bNeedRawLoad) {
-        ByteBufferedFile::Reader db(peppy_db_path);
+        ByteBufferedFile::MappedFile db_file(peppy_db_path);
+        ByteBufferedFile::MemoryReader db(db_file);
         bool should_read_peppy_database = db.total_size > 0;
         if(should_read_peppy_database) {
             // read header
@@ -982,299 +1081,89 @@ void Database::loadMaps() {
         }
 
         if(should_read_peppy_database) {
-            zarray<BPMTuple> bpm_calculation_buffer;
-            zarray<Database::TIMINGPOINT> timing_points_buffer;
+            Timer phase_timer;
+            phase_timer.start();
 
+            // 1) find where each entry starts (entries are variable-length, but skipping over one is cheap)
+            std::vector<size_t> entry_offsets;
+            entry_offsets.reserve(this->iNumBeatmapsToLoad);
             for(int i = 0; i < this->iNumBeatmapsToLoad; i++) {
                 if(this->bInterruptLoad.load()) break;  // cancellation point
 
-                if(cv::debug_db.getBool())
-                    debugLog("Database: Reading beatmap {:d}/{:d} ...\n", (i + 1), this->iNumBeatmapsToLoad);
-
-                // update progress (another thread checks if progress >= 1.f to know when we're done)
-                u32 progress_bytes = this->bytes_processed + db.total_pos;
-                f64 progress_float = (f64)progress_bytes / (f64)this->total_bytes;
-                this->fLoadingProgress = std::clamp(progress_float, 0.01, 0.99);
-
-                // NOTE: This is documented wrongly in many places.
-                //       This int was added in 20160408 and removed in 20191106
-                //       https://osu.ppy.sh/home/changelog/stable40/20160408.3
-                //       https://osu.ppy.sh/home/changelog/cuttingedge/20191106
-                if(this->iVersion >= 20160408 && this->iVersion < 20191106) {
-                    // size in bytes of the beatmap entry
-                    db.skip<u32>();
-                }
-
-                std::string artistName = db.read_string();
-                SString::trim(&artistName);
-                std::string artistNameUnicode = db.read_string();
-                std::string songTitle = db.read_string();
-                SString::trim(&songTitle);
-                std::string songTitleUnicode = db.read_string();
-                std::string creatorName = db.read_string();
-                SString::trim(&creatorName);
-                std::string difficultyName = db.read_string();
-                SString::trim(&difficultyName);
-                std::string audioFileName = db.read_string();
-
-                auto md5hash = db.read_hash();
-                auto overrides = this->peppy_overrides.find(md5hash);
-                bool overrides_found = overrides != this->peppy_overrides.end();
-
-                std::string osuFileName = db.read_string();
-                /*unsigned char rankedStatus = */ db.skip<u8>();
-                auto numCircles = db.read<u16>();
-                auto numSliders = db.read<u16>();
-                auto numSpinners = db.read<u16>();
-                long long lastModificationTime = db.read<u64>();
-
-                f32 AR, CS, HP, OD;
-                if(this->iVersion < 20140609) {
-                    AR = db.read<u8>();
-                    CS = db.read<u8>();
-                    HP = db.read<u8>();
-                    OD = db.read<u8>();
-                } else {
-                    AR = db.read<f32>();
-                    CS = db.read<f32>();
-                    HP = db.read<f32>();
-                    OD = db.read<f32>();
-                }
-
-                auto sliderMultiplier = db.read<f64>();
-
-                f32 nomod_star_rating = 0.0f;
-                if(this->iVersion >= 20140609) {
-                    auto numOsuStandardStarRatings = db.read<u32>();
-                    for(int s = 0; s < numOsuStandardStarRatings; s++) {
-                        db.skip<u8>();  // 0x08
-                        auto mods = db.read<u32>();
-                        db.skip<u8>();  // 0x0c
-
-                        f32 sr = 0.f;
-
-                        // https://osu.ppy.sh/home/changelog/stable40/20250108.3
-                        if(this->iVersion >= 20250108) {
-                            sr = db.read<f32>();
-                        } else {
-                            sr = db.read<f64>();
-                        }
-
-                        if(mods == 0) nomod_star_rating = sr;
-                    }
-
-                    auto numTaikoStarRatings = db.read<u32>();
-                    for(int s = 0; s < numTaikoStarRatings; s++) {
-                        db.skip<u8>();  // 0x08
-                        db.skip<u32>();
-                        db.skip<u8>();  // 0x0c
-
-                        // https://osu.ppy.sh/home/changelog/stable40/20250108.3
-                        if(this->iVersion >= 20250108) {
-                            db.skip<f32>();
-                        } else {
-                            db.skip<f64>();
-                        }
-                    }
-
-                    auto numCtbStarRatings = db.read<u32>();
-                    for(int s = 0; s < numCtbStarRatings; s++) {
-                        db.skip<u8>();  // 0x08
-                        db.skip<u32>();
-                        db.skip<u8>();  // 0x0c
-
-                        // https://osu.ppy.sh/home/changelog/stable40/20250108.3
-                        if(this->iVersion >= 20250108) {
-                            db.skip<f32>();
-                        } else {
-                            db.skip<f64>();
-                        }
-                    }
-
-                    auto numManiaStarRatings = db.read<u32>();
-                    for(int s = 0; s < numManiaStarRatings; s++) {
-                        db.skip<u8>();  // 0x08
-                        db.skip<u32>();
-                        db.skip<u8>();  // 0x0c
-
-                        // https://osu.ppy.sh/home/changelog/stable40/20250108.3
-                        if(this->iVersion >= 20250108) {
-                            db.skip<f32>();
-                        } else {
-                            db.skip<f64>();
-                        }
-                    }
+                const size_t entry_offset = db.total_pos;
+                if(!skipPeppyMap(db, this->iVersion)) {
+                    debugLog("WARNING: osu!.db is truncated after {:d}/{:d} beatmaps!\n", i, this->iNumBeatmapsToLoad);
+                    break;
                 }
-
-                /*unsigned int drainTime = */ db.skip<u32>();  // seconds
-                int duration = db.read<u32>();                 // milliseconds
-                duration = duration >= 0 ? duration : 0;       // sanity clamp
-                int previewTime = db.read<u32>();
-
-                BPMInfo bpm;
-                auto nb_timing_points = db.read<u32>();
-                if(overrides_found) {
-                    db.skip_bytes(sizeof(Database::TIMINGPOINT) * nb_timing_points);
-                    bpm.min = overrides->second.min_bpm;
-                    bpm.max = overrides->second.max_bpm;
-                    bpm.most_common = overrides->second.avg_bpm;
-                } else if(nb_timing_points > 0) {
-                    timing_points_buffer.resize(nb_timing_points);
-                    if(db.read_bytes((u8 *)timing_points_buffer.data(),
-                                     sizeof(Database::TIMINGPOINT) * nb_timing_points) !=
-                       sizeof(Database::TIMINGPOINT) * nb_timing_points) {
-                        debugLog("WARNING: failed to read timing points from beatmap {:d} !\n", (i + 1));
+                entry_offsets.push_back(entry_offset);
+            }
+            const f64 skip_time = phase_timer.getLiveElapsedTime();
+
+            // 2) decode the entries, in parallel
+            std::vector<PeppyMapEntry> entries(entry_offsets.size());
+            {
+                size_t nb_threads = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 16);
+                if(cv::database_load_threads.getInt() > 0) nb_threads = cv::database_load_threads.getInt();
+                nb_threads = std::clamp<size_t>(entries.size() / MIN_ENTRIES_PER_LOAD_THREAD, 1, nb_threads);
+
+                std::atomic<size_t> nb_decoded{0};
+                const auto decode_range = [&](size_t start, size_t end) {
+                    ByteBufferedFile::MemoryReader reader(db_file);
+                    for(size_t i = start; i < end; i++) {
+                        if(this->bInterruptLoad.load()) break;  // cancellation point
+
+                        if(cv::debug_db.getBool())
+                            debugLog("Database: Reading beatmap {:d}/{:d} ...\n", (i + 1), entries.size());
+
+                        reader.seek(entry_offsets[i]);
+                        this->readPeppyMap(reader, songFolder, entries[i]);
+
+                        // update progress (another thread checks if progress >= 1.f to know when we're done)
+                        const f64 decoded_fraction = (f64)(++nb_decoded) / (f64)entries.size();
+                        const f64 progress_bytes = this->bytes_processed + decoded_fraction * db.total_size;
+                        this->fLoadingProgress = std::clamp(progress_bytes / (f64)this->total_bytes, 0.01, 0.99);
                     }
-                    bpm = getBPM(timing_points_buffer, bpm_calculation_buffer);
-                }
-
-                int beatmapID = db.read<i32>();  // fucking bullshit, this is NOT an unsigned integer as is described on
-                                                 // the wiki, it can and is -1 sometimes
-                int beatmapSetID = db.read<i32>();  // same here
-                /*unsigned int threadID = */ db.skip<u32>();
-
-                /*unsigned char osuStandardGrade = */ db.skip<u8>();
-                /*unsigned char taikoGrade = */ db.skip<u8>();
-                /*unsigned char ctbGrade = */ db.skip<u8>();
-                /*unsigned char maniaGrade = */ db.skip<u8>();
-
-                short localOffset = db.read<u16>();
-                auto stackLeniency = db.read<f32>();
-                auto mode = db.read<u8>();
-
-                auto songSource = db.read_string();
-                auto songTags = db.read_string();
-                SString::trim(&songSource);
-                SString::trim(&songTags);
-
-                short onlineOffset = db.read<u16>();
-                db.skip_string();  // song title font
-                /*bool unplayed = */ db.skip<u8>();
-                /*long long lastTimePlayed = */ db.skip<u64>();
-                /*bool isOsz2 = */ db.skip<u8>();
-
-                // somehow, some beatmaps may have spaces at the start/end of their
-                // path, breaking the Windows API (e.g. https://osu.ppy.sh/s/215347)
-                auto path = db.read_string();
-                SString::trim(&path);
-
-                /*long long lastOnlineCheck = */ db.skip<u64>();
-
-                /*bool ignoreBeatmapSounds = */ db.skip<u8>();
-                /*bool ignoreBeatmapSkin = */ db.skip<u8>();
-                /*bool disableStoryboard = */ db.skip<u8>();
-                /*bool disableVideo = */ db.skip<u8>();
-                /*bool visualOverride = */ db.skip<u8>();
-
-                if(this->iVersion < 20140609) {
-                    // https://github.com/ppy/osu/wiki/Legacy-database-file-structure defines it as "Unknown"
-                    db.skip<u16>();
+                };
+
+                // the last chunk is decoded on this thread
+                const size_t chunk_size = (entries.size() + nb_threads - 1) / nb_threads;
+                std::vector<std::thread> workers;
+                for(size_t t = 0; t + 1 < nb_threads; t++) {
+                    workers.emplace_back([&decode_range, t, chunk_size] {
+                        McThread::set_current_thread_name("db_loader");
+                        McThread::set_current_thread_prio(false);
+                        decode_range(t * chunk_size, (t + 1) * chunk_size);
+                    });
                 }
-
-                /*int lastEditTime = */ db.skip<u32>();
-                /*unsigned char maniaScrollSpeed = */ db.skip<u8>();
-
-                // HACKHACK: workaround for linux and macos: it can happen that nested beatmaps are stored in the
-                // database, and that osu! stores that filepath with a backslash (because windows)
-                if constexpr(!Env::cfg(OS::WINDOWS)) {
-                    for(int c = 0; c < path.length(); c++) {
-                        if(path[c] == '\\') {
-                            path[c] = '/';
-                        }
-                    }
+                decode_range(std::min((nb_threads - 1) * chunk_size, entries.size()), entries.size());
+                for(auto &worker : workers) {
+                    worker.join();
                 }
+            }
+            const f64 decode_time = phase_timer.getLiveElapsedTime() - skip_time;
 
-                // build beatmap & diffs from all the data
-                std::string beatmapPath = songFolder;
-                beatmapPath.append(path.c_str());
-                beatmapPath.append("/");
-                std::string fullFilePath = beatmapPath;
-                fullFilePath.append(osuFileName);
-
-                // skip invalid/corrupt entries
-                // the good way would be to check if the .osu file actually exists on disk, but that is slow af, ain't
-                // nobody got time for that so, since I've seen some concrete examples of what happens in such cases, we
-                // just exclude those
-                if(artistName.length() < 1 && songTitle.length() < 1 && creatorName.length() < 1 &&
-                   difficultyName.length() < 1 && md5hash.hash[0] == 0)
-                    continue;
-
-                // fill diff with data
-                if(mode != 0) continue;
-
-                auto *diff2 =
-                    new DatabaseBeatmap(fullFilePath, beatmapPath, DatabaseBeatmap::BeatmapType::PEPPY_DIFFICULTY);
-                {
-                    diff2->sTitle = songTitle;
-                    diff2->sTitleUnicode = songTitleUnicode;
-                    if(SString::whitespace_only(diff2->sTitleUnicode)) {
-                        diff2->bEmptyTitleUnicode = true;
-                    }
-                    diff2->sAudioFileName = audioFileName;
-                    diff2->iLengthMS = duration;
-
-                    diff2->fStackLeniency = stackLeniency;
-
-                    diff2->sArtist = artistName;
-                    diff2->sArtistUnicode = artistNameUnicode;
-                    if(SString::whitespace_only(diff2->sArtistUnicode)) {
-                        diff2->bEmptyArtistUnicode = true;
-                    }
-                    diff2->sCreator = creatorName;
-                    diff2->sDifficultyName = difficultyName;
-                    diff2->sSource = songSource;
-                    diff2->sTags = songTags;
-                    diff2->sMD5Hash = md5hash;
-                    diff2->iID = beatmapID;
-                    diff2->iSetID = beatmapSetID;
-
-                    diff2->fAR = AR;
-                    diff2->fCS = CS;
-                    diff2->fHP = HP;
-                    diff2->fOD = OD;
-                    diff2->fSliderMultiplier = sliderMultiplier;
-
-                    // diff2->sBackgroundImageFileName = "";
-
-                    diff2->iPreviewTime = previewTime;
-                    diff2->last_modification_time = lastModificationTime;
-
-                    diff2->sFullSoundFilePath = beatmapPath;
-                    diff2->sFullSoundFilePath.append(diff2->sAudioFileName);
-                    diff2->iNumObjects = numCircles + numSliders + numSpinners;
-                    diff2->iNumCircles = numCircles;
-                    diff2->iNumSliders = numSliders;
-                    diff2->iNumSpinners = numSpinners;
-                    diff2->iMinBPM = bpm.min;
-                    diff2->iMaxBPM = bpm.max;
-                    diff2->iMostCommonBPM = bpm.most_common;
+            if(this->bInterruptLoad.load()) {  // cancellation point
+                for(auto &entry : entries) {
+                    SAFE_DELETE(entry.diff);
                 }
+                entries.clear();
+            }
 
-                // special case: legacy fallback behavior for invalid beatmapSetID, try to parse the ID from the path
-                if(beatmapSetID < 1 && path.length() > 0) {
-                    auto upath = UString(path.c_str());
-                    const std::vector<UString> pathTokens =
-                        upath.split("\\");  // NOTE: this is hardcoded to backslash since osu is windows only
-                    if(pathTokens.size() > 0 && pathTokens[0].length() > 0) {
-                        const std::vector<UString> spaceTokens = pathTokens[0].split(" ");
-                        if(spaceTokens.size() > 0 && spaceTokens[0].length() > 0) {
-                            beatmapSetID = spaceTokens[0].toInt();
-                            if(beatmapSetID == 0) beatmapSetID = -1;
-                        }
-                    }
-                }
+            // 3) merge, in file order (so that duplicates/set grouping don't depend on thread timing)
+            for(auto &entry : entries) {
+                DatabaseBeatmap *diff2 = entry.diff;
+                if(diff2 == nullptr) continue;  // skipped entry
 
-                // (the diff is now fully built)
-                this->beatmap_difficulties[md5hash] = diff2;
+                const MD5Hash &md5hash = diff2->getMD5Hash();
 
                 // now, search if the current set (to which this diff would belong) already exists and add it there, or
                 // if it doesn't exist then create the set
-                const auto result = setIDToIndex.find(beatmapSetID);
+                const auto result = setIDToIndex.find(entry.set_id);
                 const bool beatmapSetExists = (result != setIDToIndex.end());
                 bool diff_already_added = false;
                 if(beatmapSetExists) {
                     for(const auto &existing_diff : *beatmapSets[result->second].diffs2) {
-                        if(existing_diff->getMD5Hash() == diff2->getMD5Hash()) {
+                        if(existing_diff->getMD5Hash() == md5hash) {
                             diff_already_added = true;
                             break;
                         }
@@ -1283,19 +1172,21 @@ void Database::loadMaps() {
                         beatmapSets[result->second].diffs2->push_back(diff2);
                     }
                 } else {
-                    setIDToIndex[beatmapSetID] = beatmapSets.size();
+                    setIDToIndex[entry.set_id] = beatmapSets.size();
 
                     Beatmap_Set s;
-                    s.setID = beatmapSetID;
+                    s.setID = entry.set_id;
                     s.diffs2 = new std::vector<DatabaseBeatmap *>();
                     s.diffs2->push_back(diff2);
                     beatmapSets.push_back(s);
                 }
 
                 if(!diff_already_added) {
+                    this->beatmap_difficulties[md5hash] = diff2;
+
                     bool loudness_found = false;
-                    if(overrides_found) {
-                        MapOverrides over = overrides->second;
+                    if(entry.overrides != nullptr) {
+                        const MapOverrides &over = *entry.overrides;
                         diff2->iLocalOffset = over.local_offset;
                         diff2->iOnlineOffset = over.online_offset;
                         diff2->fStarsNomod = over.star_rating;
@@ -1306,13 +1197,14 @@ void Database::loadMaps() {
                             loudness_found = true;
                         }
                     } else {
+                        f32 nomod_star_rating = entry.nomod_star_rating;
                         if(nomod_star_rating <= 0.f) {
                             nomod_star_rating *= -1.f;
                             this->maps_to_recalc.push_back(diff2);
                         }
 
-                        diff2->iLocalOffset = localOffset;
-                        diff2->iOnlineOffset = onlineOffset;
+                        diff2->iLocalOffset = entry.local_offset;
+                        diff2->iOnlineOffset = entry.online_offset;
                         diff2->fStarsNomod = nomod_star_rating;
                         diff2->draw_background = true;
                     }
@@ -1326,6 +1218,9 @@ void Database::loadMaps() {
 
                 nb_peppy_maps++;
             }
+            const f64 merge_time = phase_timer.getLiveElapsedTime() - skip_time - decode_time;
+            debugLog("Database: osu!.db skip pass took {:f}s, decoding took {:f}s, merging took {:f}s\n", skip_time,
+                     decode_time, merge_time);
 
             // build beatmap sets
             for(const auto &beatmapSet : beatmapSets) {
@@ -1365,7 +1260,7 @@ void Database::loadMaps() {
                     // set with invalid ID: treat all its diffs separately. we'll group the diffs by title+artist.
                     std::unordered_map<std::string, std::vector<DatabaseBeatmap *> *> titleArtistToBeatmap;
                     for(const auto &diff : (*beatmapSet.diffs2)) {
-                        std::string titleArtist = diff->getTitleLatin();
+                        std::string titleArtist{diff->getTitleLatin()};
                         titleArtist.append("|");
                         titleArtist.append(diff->getArtistLatin());
 
@@ -1395,9 +1290,328 @@ void Database::loadMaps() {
     debugLog("Found {:d} overrides; {:d} maps need star recalc, {:d} maps need loudness recalc\n", nb_overrides,
              this->maps_to_recalc.size(), this->loudness_to_calc.size());
 
+    const auto string_stats = DatabaseBeatmap::getStringPool().get_stats();
+    debugLog("Beatmap metadata: {:d} strings ({:d} unique) take up {:.2f} MB, would be {:.2f} MB without interning\n",
+             string_stats.num_interned, string_stats.num_strings, string_stats.bytes_allocated / (1024.0 * 1024.0),
+             string_stats.bytes_interned / (1024.0 * 1024.0));
+
     this->peppy_overrides_mtx.unlock();
 }
 
+bool Database::skipPeppyMap(ByteBufferedFile::MemoryReader &db, int version) {
+    if(version >= 20160408 && version < 20191106) {
+        db.skip<u32>();  // size in bytes of the beatmap entry
+    }
+
+    for(int s = 0; s < 7; s++) {
+        db.skip_string();  // artist, artist unicode, title, title unicode, creator, difficulty, audio file
+    }
+    db.skip_string();                            // md5 hash
+    db.skip_string();                            // .osu file name
+    db.skip_bytes(1 + 2 + 2 + 2 + 8);            // ranked status, circles, sliders, spinners, last modification time
+    db.skip_bytes(version < 20140609 ? 4 : 16);  // AR, CS, HP, OD
+    db.skip<f64>();                              // slider multiplier
+
+    if(version >= 20140609) {
+        const size_t star_rating_size = 1 + 4 + 1 + (version >= 20250108 ? sizeof(f32) : sizeof(f64));
+        for(int m = 0; m < 4; m++) {
+            const auto nb_star_ratings = db.read<u32>();
+            db.skip_bytes(star_rating_size * nb_star_ratings);
+        }
+    }
+
+    db.skip_bytes(4 + 4 + 4);  // drain time, duration, preview time
+    const auto nb_timing_points = db.read<u32>();
+    db.skip_bytes(sizeof(TIMINGPOINT) * nb_timing_points);
+    db.skip_bytes(4 + 4 + 4 + 4 + 2 + 4 + 1);  // IDs, thread ID, grades, local offset, stack leniency, mode
+    db.skip_string();                          // source
+    db.skip_string();                          // tags
+    db.skip<u16>();                            // online offset
+    db.skip_string();                          // title font
+    db.skip_bytes(1 + 8 + 1);                  // unplayed, last time played, is osz2
+    db.skip_string();                          // path
+    db.skip_bytes(8 + 5);                      // last online check, ignore sounds/skin, disable storyboard/video...
+    if(version < 20140609) {
+        db.skip<u16>();
+    }
+    db.skip_bytes(4 + 1);  // last edit time, mania scroll speed
+
+    return db.good();
+}
+
+void Database::readPeppyMap(ByteBufferedFile::MemoryReader &db, const std::string &songFolder,
+                            PeppyMapEntry &entry) const {
+    // NOTE: This is documented wrongly in many places.
+    //       This int was added in 20160408 and removed in 20191106
+    //       https://osu.ppy.sh/home/changelog/stable40/20160408.3
+    //       https://osu.ppy.sh/home/changelog/cuttingedge/20191106
+    if(this->iVersion >= 20160408 && this->iVersion < 20191106) {
+        // size in bytes of the beatmap entry
+        db.skip<u32>();
+    }
+
+    std::string artistName = db.read_string();
+    SString::trim(&artistName);
+    std::string artistNameUnicode = db.read_string();
+    std::string songTitle = db.read_string();
+    SString::trim(&songTitle);
+    std::string songTitleUnicode = db.read_string();
+    std::string creatorName = db.read_string();
+    SString::trim(&creatorName);
+    std::string difficultyName = db.read_string();
+    SString::trim(&difficultyName);
+    std::string audioFileName = db.read_string();
+
+    auto md5hash = db.read_hash();
+    auto overrides = this->peppy_overrides.find(md5hash);
+    bool overrides_found = overrides != this->peppy_overrides.end();
+    if(overrides_found) entry.overrides = &overrides->second;
+
+    std::string osuFileName = db.read_string();
+    /*unsigned char rankedStatus = */ db.skip<u8>();
+    auto numCircles = db.read<u16>();
+    auto numSliders = db.read<u16>();
+    auto numSpinners = db.read<u16>();
+    long long lastModificationTime = db.read<u64>();
+
+    f32 AR, CS, HP, OD;
+    if(this->iVersion < 20140609) {
+        AR = db.read<u8>();
+        CS = db.read<u8>();
+        HP = db.read<u8>();
+        OD = db.read<u8>();
+    } else {
+        AR = db.read<f32>();
+        CS = db.read<f32>();
+        HP = db.read<f32>();
+        OD = db.read<f32>();
+    }
+
+    auto sliderMultiplier = db.read<f64>();
+
+    f32 nomod_star_rating = 0.0f;
+    if(this->iVersion >= 20140609) {
+        auto numOsuStandardStarRatings = db.read<u32>();
+        for(int s = 0; s < numOsuStandardStarRatings; s++) {
+            db.skip<u8>();  // 0x08
+            auto mods = db.read<u32>();
+            db.skip<u8>();  // 0x0c
+
+            f32 sr = 0.f;
+
+            // https://osu.ppy.sh/home/changelog/stable40/20250108.3
+            if(this->iVersion >= 20250108) {
+                sr = db.read<f32>();
+            } else {
+                sr = db.read<f64>();
+            }
+
+            if(mods == 0) nomod_star_rating = sr;
+        }
+
+        auto numTaikoStarRatings = db.read<u32>();
+        for(int s = 0; s < numTaikoStarRatings; s++) {
+            db.skip<u8>();  // 0x08
+            db.skip<u32>();
+            db.skip<u8>();  // 0x0c
+
+            // https://osu.ppy.sh/home/changelog/stable40/20250108.3
+            if(this->iVersion >= 20250108) {
+                db.skip<f32>();
+            } else {
+                db.skip<f64>();
+            }
+        }
+
+        auto numCtbStarRatings = db.read<u32>();
+        for(int s = 0; s < numCtbStarRatings; s++) {
+            db.skip<u8>();  // 0x08
+            db.skip<u32>();
+            db.skip<u8>();  // 0x0c
+
+            // https://osu.ppy.sh/home/changelog/stable40/20250108.3
+            if(this->iVersion >= 20250108) {
+                db.skip<f32>();
+            } else {
+                db.skip<f64>();
+            }
+        }
+
+        auto numManiaStarRatings = db.read<u32>();
+        for(int s = 0; s < numManiaStarRatings; s++) {
+            db.skip<u8>();  // 0x08
+            db.skip<u32>();
+            db.skip<u8>();  // 0x0c
+
+            // https://osu.ppy.sh/home/changelog/stable40/20250108.3
+            if(this->iVersion >= 20250108) {
+                db.skip<f32>();
+            } else {
+                db.skip<f64>();
+            }
+        }
+    }
+
+    /*unsigned int drainTime = */ db.skip<u32>();  // seconds
+    int duration = db.read<u32>();                 // milliseconds
+    duration = duration >= 0 ? duration : 0;       // sanity clamp
+    int previewTime = db.read<u32>();
+
+    BPMInfo bpm;
+    auto nb_timing_points = db.read<u32>();
+    if(overrides_found) {
+        db.skip_bytes(sizeof(Database::TIMINGPOINT) * nb_timing_points);
+        bpm.min = overrides->second.min_bpm;
+        bpm.max = overrides->second.max_bpm;
+        bpm.most_common = overrides->second.avg_bpm;
+    } else if(nb_timing_points > 0) {
+        thread_local zarray<Database::TIMINGPOINT> timing_points_buffer;
+        thread_local zarray<BPMTuple> bpm_calculation_buffer;
+        timing_points_buffer.resize(nb_timing_points);
+        if(db.read_bytes((u8 *)timing_points_buffer.data(), sizeof(Database::TIMINGPOINT) * nb_timing_points) !=
+           sizeof(Database::TIMINGPOINT) * nb_timing_points) {
+            debugLog("WARNING: failed to read timing points from beatmap {:s} !\n", md5hash.hash.data());
+        }
+        bpm = getBPM(timing_points_buffer, bpm_calculation_buffer);
+    }
+
+    int beatmapID = db.read<i32>();  // fucking bullshit, this is NOT an unsigned integer as is described on
+                                     // the wiki, it can and is -1 sometimes
+    int beatmapSetID = db.read<i32>();  // same here
+    /*unsigned int threadID = */ db.skip<u32>();
+
+    /*unsigned char osuStandardGrade = */ db.skip<u8>();
+    /*unsigned char taikoGrade = */ db.skip<u8>();
+    /*unsigned char ctbGrade = */ db.skip<u8>();
+    /*unsigned char maniaGrade = */ db.skip<u8>();
+
+    short localOffset = db.read<u16>();
+    auto stackLeniency = db.read<f32>();
+    auto mode = db.read<u8>();
+
+    auto songSource = db.read_string();
+    auto songTags = db.read_string();
+    SString::trim(&songSource);
+    SString::trim(&songTags);
+
+    short onlineOffset = db.read<u16>();
+    db.skip_string();  // song title font
+    /*bool unplayed = */ db.skip<u8>();
+    /*long long lastTimePlayed = */ db.skip<u64>();
+    /*bool isOsz2 = */ db.skip<u8>();
+
+    // somehow, some beatmaps may have spaces at the start/end of their
+    // path, breaking the Windows API (e.g. https://osu.ppy.sh/s/215347)
+    auto path = db.read_string();
+    SString::trim(&path);
+
+    /*long long lastOnlineCheck = */ db.skip<u64>();
+
+    /*bool ignoreBeatmapSounds = */ db.skip<u8>();
+    /*bool ignoreBeatmapSkin = */ db.skip<u8>();
+    /*bool disableStoryboard = */ db.skip<u8>();
+    /*bool disableVideo = */ db.skip<u8>();
+    /*bool visualOverride = */ db.skip<u8>();
+
+    if(this->iVersion < 20140609) {
+        // https://github.com/ppy/osu/wiki/Legacy-database-file-structure defines it as "Unknown"
+        db.skip<u16>();
+    }
+
+    /*int lastEditTime = */ db.skip<u32>();
+    /*unsigned char maniaScrollSpeed = */ db.skip<u8>();
+
+    // HACKHACK: workaround for linux and macos: it can happen that nested beatmaps are stored in the database, and
+    // that osu! stores that filepath with a backslash (because windows)
+    if constexpr(!Env::cfg(OS::WINDOWS)) {
+        for(int c = 0; c < path.length(); c++) {
+            if(path[c] == '\\') {
+                path[c] = '/';
+            }
+        }
+    }
+
+    // build beatmap & diffs from all the data
+    std::string beatmapPath = songFolder;
+    beatmapPath.append(path.c_str());
+    beatmapPath.append("/");
+
+    // skip invalid/corrupt entries
+    // the good way would be to check if the .osu file actually exists on disk, but that is slow af, ain't nobody got
+    // time for that so, since I've seen some concrete examples of what happens in such cases, we just exclude those
+    if(artistName.length() < 1 && songTitle.length() < 1 && creatorName.length() < 1 && difficultyName.length() < 1 &&
+       md5hash.hash[0] == 0)
+        return;
+
+    // fill diff with data
+    if(mode != 0) return;
+
+    auto *diff2 = new DatabaseBeatmap(beatmapPath, osuFileName, DatabaseBeatmap::BeatmapType::PEPPY_DIFFICULTY);
+    {
+        diff2->sTitle = songTitle;
+        diff2->sTitleUnicode = songTitleUnicode;
+        if(SString::whitespace_only(diff2->sTitleUnicode)) {
+            diff2->bEmptyTitleUnicode = true;
+        }
+        diff2->sAudioFileName = audioFileName;
+        diff2->iLengthMS = duration;
+
+        diff2->fStackLeniency = stackLeniency;
+
+        diff2->sArtist = artistName;
+        diff2->sArtistUnicode = artistNameUnicode;
+        if(SString::whitespace_only(diff2->sArtistUnicode)) {
+            diff2->bEmptyArtistUnicode = true;
+        }
+        diff2->sCreator = creatorName;
+        diff2->sDifficultyName = difficultyName;
+        diff2->sSource = songSource;
+        diff2->sTags = songTags;
+        diff2->sMD5Hash = md5hash;
+        diff2->iID = beatmapID;
+        diff2->iSetID = beatmapSetID;
+
+        diff2->fAR = AR;
+        diff2->fCS = CS;
+        diff2->fHP = HP;
+        diff2->fOD = OD;
+        diff2->fSliderMultiplier = sliderMultiplier;
+
+        // diff2->sBackgroundImageFileName = "";
+
+        diff2->iPreviewTime = previewTime;
+        diff2->last_modification_time = lastModificationTime;
+
+        diff2->iNumObjects = numCircles + numSliders + numSpinners;
+        diff2->iNumCircles = numCircles;
+        diff2->iNumSliders = numSliders;
+        diff2->iNumSpinners = numSpinners;
+        diff2->iMinBPM = bpm.min;
+        diff2->iMaxBPM = bpm.max;
+        diff2->iMostCommonBPM = bpm.most_common;
+    }
+
+    entry.diff = diff2;
+    entry.nomod_star_rating = nomod_star_rating;
+    entry.local_offset = localOffset;
+    entry.online_offset = onlineOffset;
+
+    // special case: legacy fallback behavior for invalid beatmapSetID, try to parse the ID from the path
+    if(beatmapSetID < 1 && path.length() > 0) {
+        auto upath = UString(path.c_str());
+        const std::vector<UString> pathTokens =
+            upath.split("\\");  // NOTE: this is hardcoded to backslash since osu is windows only
+        if(pathTokens.size() > 0 && pathTokens[0].length() > 0) {
+            const std::vector<UString> spaceTokens = pathTokens[0].split(" ");
+            if(spaceTokens.size() > 0 && spaceTokens[0].length() > 0) {
+                beatmapSetID = spaceTokens[0].toInt();
+                if(beatmapSetID == 0) beatmapSetID = -1;
+            }
+        }
+    }
+    entry.set_id = beatmapSetID;
+}
+
 void Database::saveMaps() {
     debugLog("Osu: Saving maps ...\n");
     if(!this->neosu_maps_loaded) {
@@ -1427,7 +1641,7 @@ void Database::saveMaps() {
         maps.write<u16>(beatmap->getDifficulties().size());
 
         for(BeatmapDifficulty *diff : beatmap->getDifficulties()) {
-            maps.write_string(env->getFileNameFromFilePath(diff->sFilePath).c_str());
+            maps.write_string(diff->sFileName.c_str());
             maps.write<i32>(diff->iID);
             maps.write_string(diff->sTitle.c_str());
             maps.write_string(diff->sAudioFileName.c_str());
@@ -2079,72 +2293,105 @@ void Database::saveScores() {
         return;
     }
 
-    const double startTime = Timing::getTimeReal();
+    std::scoped_lock compaction_lock(this->score_compaction_mtx);
+    if(this->score_compaction_thread.joinable()) this->score_compaction_thread.join();
 
     std::scoped_lock lock(this->scores_mtx);
-    ByteBufferedFile::Writer db("neosu_scores.db");
-    db.write_bytes((u8 *)"NEOSC", 5);
-    db.write<u32>(NEOSU_SCORE_DB_VERSION);
+    if(saveScoresSnapshot(this->scores)) {
+        // everything is in neosu_scores.db now
+        this->score_journal->clear();
 
-    u32 nb_beatmaps = 0;
-    u32 nb_scores = 0;
-    for(const auto &[_, scorevec] : this->scores) {
-        u32 beatmap_scores = scorevec.size();
-        if(beatmap_scores > 0) {
-            nb_beatmaps++;
-            nb_scores += beatmap_scores;
+        std::error_code ec;
+        std::filesystem::remove(SCORES_JOURNAL_COMPACTING_PATH, ec);
+    }
+}
+
+void Database::loadScoreJournal() {
+    const auto apply = [this](const ScoreJournal::Record &record) { this->applyScoreJournalRecord(record); };
+
+    // a compaction was interrupted, neosu_scores.db might or might not contain these (replaying is idempotent)
+    std::error_code ec;
+    const bool was_compacting = std::filesystem::exists(SCORES_JOURNAL_COMPACTING_PATH, ec);
+    u32 nb_records = 0;
+    if(was_compacting) nb_records += ScoreJournal::replay(SCORES_JOURNAL_COMPACTING_PATH, apply);
+
+    nb_records += this->score_journal->load(apply);
+    if(nb_records > 0) debugLog("Replayed {:d} score journal records\n", nb_records);
+
+    if(was_compacting) {
+        // finish it now, before the next compaction would overwrite the rotated journal
+        std::scoped_lock lock(this->scores_mtx);
+        if(saveScoresSnapshot(this->scores)) {
+            this->score_journal->clear();
+            std::filesystem::remove(SCORES_JOURNAL_COMPACTING_PATH, ec);
         }
     }
-    db.write<u32>(nb_beatmaps);
-    db.write<u32>(nb_scores);
-
-    for(const auto &[hash, scorevec] : this->scores) {
-        if(scorevec.empty()) continue;
-
-        db.write_hash(hash);
-        db.write<u32>(scorevec.size());
-
-        for(const auto &score : scorevec) {
-            assert(!score.is_online_score);
-
-            db.write_mods(score.mods);
-            db.write<u64>(score.score);
-            db.write<u64>(score.spinner_bonus);
-            db.write<u64>(score.unixTimestamp);
-            db.write<i32>(score.player_id);
-            db.write_string(score.playerName);
-            db.write<u8>((u8)score.grade);
-
-            db.write_string(score.client);
-            db.write_string(score.server);
-            db.write<i64>(score.bancho_score_id);
-            db.write<u64>(score.peppy_replay_tms);
-
-            db.write<u16>(score.num300s);
-            db.write<u16>(score.num100s);
-            db.write<u16>(score.num50s);
-            db.write<u16>(score.numGekis);
-            db.write<u16>(score.numKatus);
-            db.write<u16>(score.numMisses);
-            db.write<u16>(score.comboMax);
-
-            db.write<u32>(score.ppv2_version);
-            db.write<f32>(score.ppv2_score);
-            db.write<f32>(score.ppv2_total_stars);
-            db.write<f32>(score.ppv2_aim_stars);
-            db.write<f32>(score.ppv2_speed_stars);
-
-            db.write<u16>(score.numSliderBreaks);
-            db.write<f32>(score.unstableRate);
-            db.write<f32>(score.hitErrorAvgMin);
-            db.write<f32>(score.hitErrorAvgMax);
-            db.write<u32>(score.maxPossibleCombo);
-            db.write<u32>(score.numHitObjects);
-            db.write<u32>(score.numCircles);
+}
+
+void Database::applyScoreJournalRecord(const ScoreJournal::Record &record) {
+    const auto &sc = record.score;
+    switch(record.type) {
+        case ScoreJournal::RecordType::ADD:
+            this->addScoreRaw(sc);
+            break;
+
+        case ScoreJournal::RecordType::REMOVE: {
+            std::scoped_lock lock(this->scores_mtx);
+            std::erase_if(this->scores[sc.beatmap_hash],
+                          [&](const FinishedScore &other) { return other.unixTimestamp == sc.unixTimestamp; });
+            break;
+        }
+
+        case ScoreJournal::RecordType::PP_UPDATE: {
+            std::scoped_lock lock(this->scores_mtx);
+            for(auto &other : this->scores[sc.beatmap_hash]) {
+                if(other.unixTimestamp != sc.unixTimestamp) continue;
+                other.ppv2_version = sc.ppv2_version;
+                other.ppv2_score = sc.ppv2_score;
+                other.ppv2_total_stars = sc.ppv2_total_stars;
+                other.ppv2_aim_stars = sc.ppv2_aim_stars;
+                other.ppv2_speed_stars = sc.ppv2_speed_stars;
+                break;
+            }
+            break;
         }
     }
+}
 
-    debugLog("Saved {:d} scores in {:f} seconds.\n", nb_scores, (Timing::getTimeReal() - startTime));
+// fold the journal back into neosu_scores.db once it gets long, on a separate thread
+void Database::maybeCompactScores() {
+    std::unique_lock compaction_lock(this->score_compaction_mtx, std::try_to_lock);
+    if(!compaction_lock.owns_lock()) return;  // someone else is already on it
+
+    if(!this->bScoresLoaded || this->bScoreCompactionRunning.load()) return;
+    if(this->score_journal->get_num_records() < cv::scores_journal_compact_threshold.getVal<u32>()) return;
+
+    // the previous compaction failed, the next saveScores() will take care of it
+    std::error_code ec;
+    if(std::filesystem::exists(SCORES_JOURNAL_COMPACTING_PATH, ec)) return;
+
+    if(this->score_compaction_thread.joinable()) this->score_compaction_thread.join();
+
+    // rotate the journal together with taking the copy, so that any later changes go into the new journal
+    std::unordered_map<MD5Hash, std::vector<FinishedScore>> scores_copy;
+    {
+        std::scoped_lock lock(this->scores_mtx);
+        if(!this->score_journal->rotate(SCORES_JOURNAL_COMPACTING_PATH)) return;
+        scores_copy = this->scores;
+    }
+
+    this->bScoreCompactionRunning = true;
+    this->score_compaction_thread = std::thread([this, scores = std::move(scores_copy)]() {
+        McThread::set_current_thread_name("score_compact");
+        McThread::set_current_thread_prio(false);  // reset priority
+
+        if(saveScoresSnapshot(scores)) {
+            std::error_code ec;
+            std::filesystem::remove(SCORES_JOURNAL_COMPACTING_PATH, ec);
+        }
+
+        this->bScoreCompactionRunning = false;
+    });
 }
 
 BeatmapSet *Database::loadRawBeatmap(const std::string &beatmapPath) {
@@ -2157,10 +2404,7 @@ BeatmapSet *Database::loadRawBeatmap(const std::string &beatmapPath) {
         std::string ext = env->getFileExtensionFromFilePath(beatmapFile);
         if(ext.compare("osu") != 0) continue;
 
-        std::string fullFilePath = beatmapPath;
-        fullFilePath.append(beatmapFile);
-
-        auto *diff2 = new BeatmapDifficulty(fullFilePath, beatmapPath, DatabaseBeatmap::BeatmapType::NEOSU_DIFFICULTY);
+        auto *diff2 = new BeatmapDifficulty(beatmapPath, beatmapFile, DatabaseBeatmap::BeatmapType::NEOSU_DIFFICULTY);
         if(diff2->loadMetadata()) {
             diffs2->push_back(diff2);
         } else {
@@ -7,11 +7,13 @@
 #include "ByteBufferedFile.h"
 #include "LegacyReplay.h"
 #include "Overrides.h"
+#include "ScoreJournal.h"
 #include "UString.h"
 #include "score.h"
 
 #include <mutex>
 #include <atomic>
+#include <thread>
 
 namespace Timing {
 class Timer;
@@ -75,6 +77,14 @@ class Database {
     void sortScoresInPlace(std::vector<FinishedScore> &scores);
     void sortScores(MD5Hash beatmapMD5Hash);
 
+    // for pp recalculated in the background: journals a whole batch of (already updated) scores with a single write,
+    // call without scores_mtx held
+    void onScoresPPChanged(std::span<const FinishedScore> scores);
+
+    // rewrites neosu_scores.db in the background if the journal got too long, call after a batch of changes
+    // (without scores_mtx held)
+    void maybeCompactScores();
+
     std::vector<UString> getPlayerNamesWithPPScores();
     std::vector<UString> getPlayerNamesWithScoresForUserSwitcher();
     PlayerPPScores getPlayerPPScores(const std::string &playerName);
@@ -154,10 +164,25 @@ class Database {
     void findDatabases();
     bool importDatabase(const std::string &db_path);
     void loadMaps();
+
+    // one osu!.db beatmap, decoded (possibly on a loader thread) before it gets merged into the database
+    struct PeppyMapEntry {
+        DatabaseBeatmap *diff{nullptr};  // nullptr if the entry was skipped (invalid, or not osu!standard)
+        const MapOverrides *overrides{nullptr};
+        f32 nomod_star_rating{0.f};
+        i32 set_id{0};  // with the legacy fallback applied, for grouping into sets
+        i16 local_offset{0};
+        i16 online_offset{0};
+    };
+    void readPeppyMap(ByteBufferedFile::MemoryReader &db, const std::string &songFolder, PeppyMapEntry &entry) const;
+    // same layout as readPeppyMap(), without decoding anything. returns false if the entry is truncated
+    static bool skipPeppyMap(ByteBufferedFile::MemoryReader &db, int version);
     void loadScores(const UString &dbPath);
     void loadOldMcNeosuScores(const UString &dbPath);
     void loadPeppyScores(const UString &dbPath);
     void saveScores();
+    void loadScoreJournal();
+    void applyScoreJournalRecord(const ScoreJournal::Record &record);
     bool addScoreRaw(const FinishedScore &score);
     // returns position of existing score in the scores[hash] array if found, -1 otherwise
     int isScoreAlreadyInDB(u64 unix_timestamp, const MD5Hash &map_hash);
@@ -184,6 +209,12 @@ class Database {
     // scores.db (legacy and custom)
     bool bScoresLoaded = false;
 
+    // changes since neosu_scores.db was last written, see ScoreJournal
+    std::unique_ptr<ScoreJournal> score_journal;
+    std::mutex score_compaction_mtx;  // maybeCompactScores() is also called from the score converter thread
+    std::thread score_compaction_thread;
+    std::atomic<bool> bScoreCompactionRunning{false};
+
     bool bNeedRawLoad{false};
 
     PlayerStats prevPlayerStats;
@@ -19,6 +19,7 @@
 #include "Engine.h"
 #include "File.h"
 #include "GameRules.h"
+#include "HitObjectStacking.h"
 #include "HitObjects.h"
 #include "NotificationOverlay.h"
 #include "Osu.h"
@@ -44,9 +45,19 @@ bool timingPointSortComparator(DatabaseBeatmap::TIMINGPOINT const &a, DatabaseBe
 }
 }  // namespace
 
-DatabaseBeatmap::DatabaseBeatmap(std::string filePath, std::string folder, BeatmapType type) {
-    this->sFilePath = std::move(filePath);
-    this->sFolder = std::move(folder);
+MetadataString &MetadataString::operator=(std::string_view str) {
+    this->view = DatabaseBeatmap::getStringPool().intern(str);
+    return *this;
+}
+
+StringPool &DatabaseBeatmap::getStringPool() {
+    static StringPool pool;
+    return pool;
+}
+
+DatabaseBeatmap::DatabaseBeatmap(std::string_view folder, std::string_view fileName, BeatmapType type) {
+    this->sFolder = folder;
+    this->sFileName = fileName;
     this->type = type;
 
     // raw metadata (note the special default values)
@@ -850,9 +861,7 @@ DatabaseBeatmap::LOAD_DIFFOBJ_RESULT DatabaseBeatmap::loadDifficultyHitObjects(P
     }
 
     // calculate stacks
-    // see Beatmap.cpp
     // NOTE: this must be done before the speed multiplier is applied!
-    // HACKHACK: code duplication ffs
     if(cv::stars_stacking.getBool() &&
        !calculateStarsInaccurately)  // NOTE: ignore stacking when calculating inaccurately
     {
@@ -860,115 +869,13 @@ DatabaseBeatmap::LOAD_DIFFOBJ_RESULT DatabaseBeatmap::loadDifficultyHitObjects(P
         const float finalCS = CS;
         const float rawHitCircleDiameter = GameRules::getRawHitCircleDiameter(finalCS);
 
-        const float STACK_LENIENCE = 3.0f;
-
         const float approachTime = GameRules::getApproachTimeForStacking(finalAR);
 
-        if(c.version > 5) {
-            // peppy's algorithm
-            // https://gist.github.com/peppy/1167470
-
-            for(int i = result.diffobjects.size() - 1; i >= 0; i--) {
-                int n = i;
-
-                OsuDifficultyHitObject *objectI = &result.diffobjects[i];
-
-                const bool isSpinner = (objectI->type == OsuDifficultyHitObject::TYPE::SPINNER);
-
-                if(objectI->stack != 0 || isSpinner) continue;
-
-                const bool isHitCircle = (objectI->type == OsuDifficultyHitObject::TYPE::CIRCLE);
-                const bool isSlider = (objectI->type == OsuDifficultyHitObject::TYPE::SLIDER);
-
-                if(isHitCircle) {
-                    while(--n >= 0) {
-                        OsuDifficultyHitObject *objectN = &result.diffobjects[n];
-
-                        const bool isSpinnerN = (objectN->type == OsuDifficultyHitObject::TYPE::SPINNER);
-
-                        if(isSpinnerN) continue;
-
-                        if(objectI->time - (approachTime * c.stackLeniency) > (objectN->endTime)) break;
-
-                        vec2 objectNEndPosition = objectN->getOriginalRawPosAt(objectN->time + objectN->getDuration());
-                        if(objectN->getDuration() != 0 &&
-                           vec::length(objectNEndPosition - objectI->getOriginalRawPosAt(objectI->time)) <
-                               STACK_LENIENCE) {
-                            int offset = objectI->stack - objectN->stack + 1;
-                            for(int j = n + 1; j <= i; j++) {
-                                if(vec::length(objectNEndPosition - result.diffobjects[j].getOriginalRawPosAt(
-                                                                        result.diffobjects[j].time)) < STACK_LENIENCE)
-                                    result.diffobjects[j].stack = (result.diffobjects[j].stack - offset);
-                            }
-
-                            break;
-                        }
-
-                        if(vec::length(objectN->getOriginalRawPosAt(objectN->time) -
-                                       objectI->getOriginalRawPosAt(objectI->time)) < STACK_LENIENCE) {
-                            objectN->stack = (objectI->stack + 1);
-                            objectI = objectN;
-                        }
-                    }
-                } else if(isSlider) {
-                    while(--n >= 0) {
-                        OsuDifficultyHitObject *objectN = &result.diffobjects[n];
-
-                        const bool isSpinner = (objectN->type == OsuDifficultyHitObject::TYPE::SPINNER);
-
-                        if(isSpinner) continue;
-
-                        if(objectI->time - (approachTime * c.stackLeniency) > objectN->time) break;
-
-                        if(vec::length((objectN->getDuration() != 0
-                                            ? objectN->getOriginalRawPosAt(objectN->time + objectN->getDuration())
-                                            : objectN->getOriginalRawPosAt(objectN->time)) -
-                                       objectI->getOriginalRawPosAt(objectI->time)) < STACK_LENIENCE) {
-                            objectN->stack = (objectI->stack + 1);
-                            objectI = objectN;
-                        }
-                    }
-                }
-            }
-        } else  // version < 6
-        {
-            // old stacking algorithm for old beatmaps
-            // https://github.com/ppy/osu/blob/master/osu.Game.Rulesets.Osu/Beatmaps/OsuBeatmapProcessor.cs
-
-            for(int i = 0; i < result.diffobjects.size(); i++) {
-                OsuDifficultyHitObject *currHitObject = &result.diffobjects[i];
-
-                const bool isSlider = (currHitObject->type == OsuDifficultyHitObject::TYPE::SLIDER);
-
-                if(currHitObject->stack != 0 && !isSlider) continue;
-
-                long startTime = currHitObject->time + currHitObject->getDuration();
-                int sliderStack = 0;
-
-                for(int j = i + 1; j < result.diffobjects.size(); j++) {
-                    OsuDifficultyHitObject *objectJ = &result.diffobjects[j];
-
-                    if(objectJ->time - (approachTime * c.stackLeniency) > startTime) break;
-
-                    // "The start position of the hitobject, or the position at the end of the path if the hitobject is
-                    // a slider"
-                    vec2 position2 =
-                        isSlider
-                            ? currHitObject->getOriginalRawPosAt(currHitObject->time + currHitObject->getDuration())
-                            : currHitObject->getOriginalRawPosAt(currHitObject->time);
-
-                    if(vec::length(objectJ->getOriginalRawPosAt(objectJ->time) -
-                                   currHitObject->getOriginalRawPosAt(currHitObject->time)) < 3) {
-                        currHitObject->stack++;
-                        startTime = objectJ->time + objectJ->getDuration();
-                    } else if(vec::length(objectJ->getOriginalRawPosAt(objectJ->time) - position2) < 3) {
-                        // "Case for sliders - bump notes down and right, rather than up and left."
-                        sliderStack++;
-                        objectJ->stack -= sliderStack;
-                        startTime = objectJ->time + objectJ->getDuration();
-                    }
-                }
-            }
+        std::vector<i32> stacks;
+        HitObjectStacking::calculateStacks(HitObjectStacking::fromDifficultyHitObjects(result.diffobjects),
+                                           approachTime, c.stackLeniency, c.version, stacks);
+        for(size_t i = 0; i < result.diffobjects.size(); i++) {
+            result.diffobjects[i].stack = stacks[i];
         }
 
         // update hitobject positions
@@ -1010,8 +917,22 @@ DatabaseBeatmap::LOAD_DIFFOBJ_RESULT DatabaseBeatmap::loadDifficultyHitObjects(P
 }
 
 // XXX: make it nonblocking, with callback
+std::string DatabaseBeatmap::getFilePath() const {
+    std::string path{this->sFolder.sv()};
+    path.append(this->sFileName.sv());
+    return path;
+}
+
+std::string DatabaseBeatmap::getFullBackgroundImageFilePath() const {
+    if(this->sBackgroundImageFileName.empty()) return {};
+
+    std::string path{this->sFolder.sv()};
+    path.append(this->sBackgroundImageFileName.sv());
+    return path;
+}
+
 std::string DatabaseBeatmap::getMapFile() {
-    File file(this->sFilePath);
+    File file(this->getFilePath());
     if(file.canRead()) {
         // Intentionally returning std::string because .osu files are always text
         return file.readString();
@@ -1027,14 +948,15 @@ bool DatabaseBeatmap::loadMetadata(bool compute_md5) {
     // reset
     this->timingpoints.clear();
 
-    if(cv::debug_osu.getBool()) debugLog("DatabaseBeatmap::loadMetadata() : {:s}\n", this->sFilePath.c_str());
+    const std::string filePath = this->getFilePath();
+    if(cv::debug_osu.getBool()) debugLog("DatabaseBeatmap::loadMetadata() : {:s}\n", filePath.c_str());
 
     std::vector<u8> fileBuffer;
     u8 *beatmapFile{nullptr};
     size_t beatmapFileSize{0};
 
     {
-        File file(this->sFilePath);
+        File file(filePath);
         if(file.canRead()) {
             beatmapFileSize = file.getFileSize();
             fileBuffer = file.takeFileBuffer();
@@ -1044,7 +966,7 @@ bool DatabaseBeatmap::loadMetadata(bool compute_md5) {
     }
 
     if(fileBuffer.empty()) {
-        debugLog("Osu Error: Couldn't read file {:s}\n", this->sFilePath.c_str());
+        debugLog("Osu Error: Couldn't read file {:s}\n", filePath.c_str());
         return false;
     }
 
@@ -1054,6 +976,10 @@ bool DatabaseBeatmap::loadMetadata(bool compute_md5) {
     }
 
     // load metadata
+    const auto parse_string = [](const char *line, const char *key, MetadataString *out) {
+        std::string value;
+        if(Parsing::parse(line, key, ':', &value)) *out = value;
+    };
     bool foundAR = false;
     int curBlock = -1;
     std::string curLine;
@@ -1098,7 +1024,7 @@ bool DatabaseBeatmap::loadMetadata(bool compute_md5) {
 
             // General
             case 0: {
-                Parsing::parse(curLineChar, "AudioFilename", ':', &this->sAudioFileName);
+                parse_string(curLineChar, "AudioFilename", &this->sAudioFileName);
                 Parsing::parse(curLineChar, "StackLeniency", ':', &this->fStackLeniency);
                 Parsing::parse(curLineChar, "PreviewTime", ':', &this->iPreviewTime);
                 Parsing::parse(curLineChar, "Mode", ':', &this->iGameMode);
@@ -1107,13 +1033,13 @@ bool DatabaseBeatmap::loadMetadata(bool compute_md5) {
 
             // Metadata
             case 1: {
-                Parsing::parse(curLineChar, "Title", ':', &this->sTitle);
-                Parsing::parse(curLineChar, "TitleUnicode", ':', &this->sTitleUnicode);
-                Parsing::parse(curLineChar, "ArtistUnicode", ':', &this->sArtistUnicode);
-                Parsing::parse(curLineChar, "Creator", ':', &this->sCreator);
-                Parsing::parse(curLineChar, "Version", ':', &this->sDifficultyName);
-                Parsing::parse(curLineChar, "Source", ':', &this->sSource);
-                Parsing::parse(curLineChar, "Tags", ':', &this->sTags);
+                parse_string(curLineChar, "Title", &this->sTitle);
+                parse_string(curLineChar, "TitleUnicode", &this->sTitleUnicode);
+                parse_string(curLineChar, "ArtistUnicode", &this->sArtistUnicode);
+                parse_string(curLineChar, "Creator", &this->sCreator);
+                parse_string(curLineChar, "Version", &this->sDifficultyName);
+                parse_string(curLineChar, "Source", &this->sSource);
+                parse_string(curLineChar, "Tags", &this->sTags);
                 Parsing::parse(curLineChar, "BeatmapID", ':', &this->iID);
                 Parsing::parse(curLineChar, "BeatmapSetID", ':', &this->iSetID);
                 break;
@@ -1137,8 +1063,6 @@ bool DatabaseBeatmap::loadMetadata(bool compute_md5) {
                 if(Parsing::parse(curLineChar, &type, ',', &startTime, ',', &str)) {
                     if(type == 0) {
                         this->sBackgroundImageFileName = str;
-                        this->sFullBackgroundImageFilePath = this->sFolder;
-                        this->sFullBackgroundImageFilePath.append(this->sBackgroundImageFileName);
                     }
                 }
 
@@ -1173,10 +1097,6 @@ bool DatabaseBeatmap::loadMetadata(bool compute_md5) {
         return false;  // nothing more to do here
     }
 
-    // build sound file path
-    this->sFullSoundFilePath = this->sFolder;
-    this->sFullSoundFilePath.append(this->sAudioFileName);
-
     // sort timingpoints and calculate BPM range
     if(this->timingpoints.size() > 0) {
         // sort timingpoints by time
@@ -1216,7 +1136,7 @@ DatabaseBeatmap::LOAD_GAMEPLAY_RESULT DatabaseBeatmap::loadGameplay(DatabaseBeat
     }
 
     // load primitives, put in temporary container
-    PRIMITIVE_CONTAINER c = loadPrimitiveObjects(databaseBeatmap->sFilePath);
+    PRIMITIVE_CONTAINER c = loadPrimitiveObjects(databaseBeatmap->getFilePath());
     if(c.errorCode != 0) {
         result.errorCode = c.errorCode;
         return result;
@@ -1515,11 +1435,18 @@ void DatabaseBeatmapBackgroundImagePathLoader::initAsync() {
 }
 
 std::string DatabaseBeatmap::getFullSoundFilePath() {
-    // this modifies this->sFullSoundFilePath inplace
-    if(File::existsCaseInsensitive(this->sFullSoundFilePath) == File::FILETYPE::FILE) {
-        return this->sFullSoundFilePath;
+    std::string path{this->sFolder.sv()};
+    path.append(this->sAudioFileName.sv());
+
+    // this modifies the path inplace, remember the corrected file name for next time
+    if(File::existsCaseInsensitive(path) == File::FILETYPE::FILE) {
+        if(path.starts_with(this->sFolder.sv()) && path.length() > this->sFolder.length()) {
+            const std::string_view fixedFileName = std::string_view{path}.substr(this->sFolder.length());
+            if(fixedFileName != this->sAudioFileName.sv()) this->sAudioFileName = fixedFileName;
+        }
+        return path;
     }
 
     // wasn't found but return what we have anyways
-    return this->sFullSoundFilePath;
+    return path;
 }
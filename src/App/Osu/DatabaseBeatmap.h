@@ -8,6 +8,7 @@
 #include "Osu.h"
 #include "Overrides.h"
 #include "Resource.h"
+#include "StringPool.h"
 #include "templates.h"
 
 class BeatmapInterface;
@@ -23,6 +24,25 @@ class BackgroundImageHandler;
 // 3) allow async calculations/loaders to work on the contained data (e.g. background image loader)
 // 4) be a container for difficulties (all top level DatabaseBeatmap objects are containers)
 
+// metadata string, interned in DatabaseBeatmap::getStringPool() (so e.g. the artist of a set is only stored once, no
+// matter how many difficulties it has). assigning to it interns the new value
+class MetadataString {
+   public:
+    MetadataString() = default;
+    explicit MetadataString(std::string_view str) { *this = str; }
+
+    MetadataString &operator=(std::string_view str);
+
+    [[nodiscard]] inline operator std::string_view() const { return this->view; }
+    [[nodiscard]] inline std::string_view sv() const { return this->view; }
+    [[nodiscard]] inline const char *c_str() const { return this->view.data(); }  // always NUL-terminated
+    [[nodiscard]] inline size_t length() const { return this->view.length(); }
+    [[nodiscard]] inline bool empty() const { return this->view.empty(); }
+
+   private:
+    std::string_view view{""};
+};
+
 class DatabaseBeatmap;
 typedef DatabaseBeatmap BeatmapDifficulty;
 typedef DatabaseBeatmap BeatmapSet;
@@ -149,7 +169,8 @@ class DatabaseBeatmap final {
         i32 errorCode{0};
     };
 
-    DatabaseBeatmap(std::string filePath, std::string folder, BeatmapType type);
+    // the .osu file is at folder + fileName
+    DatabaseBeatmap(std::string_view folder, std::string_view fileName, BeatmapType type);
     DatabaseBeatmap(std::vector<DatabaseBeatmap *> *difficulties, BeatmapType type);
     ~DatabaseBeatmap();
 
@@ -176,8 +197,9 @@ class DatabaseBeatmap final {
         this->update_overrides();
     }
 
-    [[nodiscard]] inline std::string getFolder() const { return this->sFolder; }
-    [[nodiscard]] inline std::string getFilePath() const { return this->sFilePath; }
+    [[nodiscard]] inline std::string_view getFolder() const { return this->sFolder; }
+    [[nodiscard]] inline std::string_view getFileName() const { return this->sFileName; }
+    [[nodiscard]] std::string getFilePath() const;
 
     template <typename T = DatabaseBeatmap>
     [[nodiscard]] inline const std::vector<T *> &getDifficulties() const
@@ -200,34 +222,32 @@ class DatabaseBeatmap final {
     [[nodiscard]] inline int getID() const { return this->iID; }
     [[nodiscard]] inline int getSetID() const { return this->iSetID; }
 
-    [[nodiscard]] inline const std::string &getTitle() const {
+    [[nodiscard]] inline std::string_view getTitle() const {
         if(!this->bEmptyTitleUnicode && cv::prefer_cjk.getBool()) {
             return this->sTitleUnicode;
         } else {
             return this->sTitle;
         }
     }
-    [[nodiscard]] inline const std::string &getTitleLatin() const { return this->sTitle; }
-    [[nodiscard]] inline const std::string &getTitleUnicode() const { return this->sTitleUnicode; }
+    [[nodiscard]] inline std::string_view getTitleLatin() const { return this->sTitle; }
+    [[nodiscard]] inline std::string_view getTitleUnicode() const { return this->sTitleUnicode; }
 
-    [[nodiscard]] inline const std::string &getArtist() const {
+    [[nodiscard]] inline std::string_view getArtist() const {
         if(!this->bEmptyArtistUnicode && cv::prefer_cjk.getBool()) {
             return this->sArtistUnicode;
         } else {
             return this->sArtist;
         }
     }
-    [[nodiscard]] inline const std::string &getArtistLatin() const { return this->sArtist; }
-    [[nodiscard]] inline const std::string &getArtistUnicode() const { return this->sArtistUnicode; }
-
-    [[nodiscard]] inline const std::string &getCreator() const { return this->sCreator; }
-    [[nodiscard]] inline const std::string &getDifficultyName() const { return this->sDifficultyName; }
-    [[nodiscard]] inline const std::string &getSource() const { return this->sSource; }
-    [[nodiscard]] inline const std::string &getTags() const { return this->sTags; }
-    [[nodiscard]] inline const std::string &getBackgroundImageFileName() const {
-        return this->sBackgroundImageFileName;
-    }
-    [[nodiscard]] inline const std::string &getAudioFileName() const { return this->sAudioFileName; }
+    [[nodiscard]] inline std::string_view getArtistLatin() const { return this->sArtist; }
+    [[nodiscard]] inline std::string_view getArtistUnicode() const { return this->sArtistUnicode; }
+
+    [[nodiscard]] inline std::string_view getCreator() const { return this->sCreator; }
+    [[nodiscard]] inline std::string_view getDifficultyName() const { return this->sDifficultyName; }
+    [[nodiscard]] inline std::string_view getSource() const { return this->sSource; }
+    [[nodiscard]] inline std::string_view getTags() const { return this->sTags; }
+    [[nodiscard]] inline std::string_view getBackgroundImageFileName() const { return this->sBackgroundImageFileName; }
+    [[nodiscard]] inline std::string_view getAudioFileName() const { return this->sAudioFileName; }
 
     [[nodiscard]] inline unsigned long getLengthMS() const { return this->iLengthMS; }
     [[nodiscard]] inline int getPreviewTime() const { return this->iPreviewTime; }
@@ -248,10 +268,7 @@ class DatabaseBeatmap final {
     std::string getMapFile();
     std::string getFullSoundFilePath();
 
-    // redundant data
-    [[nodiscard]] inline const std::string &getFullBackgroundImageFilePath() const {
-        return this->sFullBackgroundImageFilePath;
-    }
+    [[nodiscard]] std::string getFullBackgroundImageFilePath() const;
 
     // precomputed data
 
@@ -278,28 +295,27 @@ class DatabaseBeatmap final {
 
     zarray<DatabaseBeatmap::TIMINGPOINT> timingpoints;  // necessary for main menu anim
 
-    // redundant data (technically contained in metadata, but precomputed anyway)
+    // shared by all beatmaps, never shrinks (reloading the same beatmaps doesn't add anything to it)
+    static StringPool &getStringPool();
 
-    std::string sFolder;    // path to folder containing .osu file (e.g. "/path/to/beatmapfolder/")
-    std::string sFilePath;  // path to .osu file (e.g. "/path/to/beatmapfolder/beatmap.osu")
-    std::string sFullSoundFilePath;
-    std::string sFullBackgroundImageFilePath;
+    MetadataString sFolder;    // path to folder containing .osu file (e.g. "/path/to/beatmapfolder/")
+    MetadataString sFileName;  // .osu file name (e.g. "beatmap.osu")
 
     bool bEmptyArtistUnicode{false};
     bool bEmptyTitleUnicode{false};
 
     // raw metadata
 
-    std::string sTitle;
-    std::string sTitleUnicode;
-    std::string sArtist;
-    std::string sArtistUnicode;
-    std::string sCreator;
-    std::string sDifficultyName;  // difficulty name ("Version")
-    std::string sSource;          // only used by search
-    std::string sTags;            // only used by search
-    std::string sBackgroundImageFileName;
-    std::string sAudioFileName;
+    MetadataString sTitle;
+    MetadataString sTitleUnicode;
+    MetadataString sArtist;
+    MetadataString sArtistUnicode;
+    MetadataString sCreator;
+    MetadataString sDifficultyName;  // difficulty name ("Version")
+    MetadataString sSource;          // only used by search
+    MetadataString sTags;            // only used by search
+    MetadataString sBackgroundImageFileName;
+    MetadataString sAudioFileName;
 
     int iID;  // online ID, if uploaded
     unsigned long iLengthMS;
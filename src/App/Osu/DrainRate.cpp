@@ -0,0 +1,542 @@
+#include "DrainRate.h"
+
+#include "BenchCheck.h"
+#include "ByteBufferedFile.h"
+#include "ConVar.h"
+#include "Database.h"
+#include "Engine.h"
+#include "GameRules.h"
+#include "HitObjects.h"
+#include "SimulatedBeatmap.h"
+#include "Timing.h"
+#include "score.h"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <unordered_map>
+
+namespace DrainRate {
+
+namespace {  // static namespace
+
+constexpr const char *CACHE_PATH = "neosu_drain.db";
+
+// bump this whenever compute() changes, older caches are discarded
+constexpr const u32 CACHE_VERSION = 1;
+
+struct Key {
+    MD5Hash beatmapHash;
+    u64 fingerprint;
+
+    // bit patterns, so that the hash and the comparison agree (e.g. on -0.0)
+    u32 HP;
+    u32 approachTime;
+    u32 spinsPerSecond;
+    i32 version;
+
+    bool operator==(const Key &) const = default;
+};
+
+struct KeyHash {
+    size_t operator()(const Key &key) const {
+        u64 h = std::hash<MD5Hash>()(key.beatmapHash) ^ key.fingerprint;
+        h = (h ^ ((u64)key.HP << 32 | key.approachTime)) * 0x9E3779B97F4A7C15ULL;
+        h = (h ^ ((u64)key.spinsPerSecond << 32 | (u32)key.version)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+struct Entry {
+    Result result;
+    u64 lastUse;  // for trimming, 0 for everything loaded from disk
+};
+
+std::mutex mtx;
+std::unordered_map<Key, Entry, KeyHash> entries;
+Stats stats;
+u64 useCounter{0};
+bool loaded{false};
+bool dirty{false};
+
+u64 fingerprint(const Input &input) {
+    u64 h = 0xcbf29ce484222325ULL;
+    const auto mix = [&h](u64 v) { h = (h ^ v) * 0x100000001b3ULL; };
+
+    mix(input.hitobjects.size());
+    for(const HitObject *obj : input.hitobjects) {
+        mix(static_cast<u64>(obj->click_time));
+        mix(static_cast<u64>(obj->duration));
+
+        if(const auto *slider = dynamic_cast<const Slider *>(obj); slider != nullptr) {
+            const std::vector<Slider::SLIDERCLICK> &clicks = slider->getClicks();
+            mix(1 | (u64)obj->is_end_of_combo << 8 | (u64)clicks.size() << 16);
+            for(const auto &click : clicks) {
+                mix(static_cast<u64>(click.type));
+            }
+        } else {
+            const u64 type = dynamic_cast<const Spinner *>(obj) != nullptr ? 2 : 0;
+            mix(type | (u64)obj->is_end_of_combo << 8);
+        }
+    }
+
+    mix(input.breaks.size());
+    for(const auto &e : input.breaks) {
+        mix(static_cast<u64>(e.startTime));
+        mix(static_cast<u64>(e.endTime));
+    }
+
+    return h;
+}
+
+Key makeKey(const MD5Hash &beatmapHash, const Input &input) {
+    return Key{
+        .beatmapHash = beatmapHash,
+        .fingerprint = fingerprint(input),
+        .HP = std::bit_cast<u32>(input.HP),
+        .approachTime = std::bit_cast<u32>(input.approachTime),
+        .spinsPerSecond = std::bit_cast<u32>(input.spinsPerSecond),
+        .version = input.version,
+    };
+}
+
+// keeps the numEntries most recently used entries. mtx must be held
+void trim(size_t numEntries) {
+    if(entries.size() <= numEntries) return;
+
+    std::vector<u64> uses;
+    uses.reserve(entries.size());
+    for(const auto &[key, entry] : entries) {
+        uses.push_back(entry.lastUse);
+    }
+    std::ranges::nth_element(uses, uses.begin() + (uses.size() - numEntries));
+    const u64 cutoff = uses[uses.size() - numEntries];
+
+    // ties at the cutoff (e.g. everything loaded from disk) are dropped in hash order until we fit
+    size_t toRemove = entries.size() - numEntries;
+    for(auto it = entries.begin(); it != entries.end() && toRemove > 0;) {
+        if(it->second.lastUse <= cutoff) {
+            it = entries.erase(it);
+            toRemove--;
+        } else {
+            ++it;
+        }
+    }
+    dirty = true;
+}
+
+// mtx must be held
+void loadIfNeeded() {
+    if(loaded) return;
+    loaded = true;
+
+    ByteBufferedFile::MappedFile file(CACHE_PATH);
+    ByteBufferedFile::MemoryReader db(file);
+    if(db.total_size == 0) return;
+
+    const u32 version = db.read<u32>();
+    if(version != CACHE_VERSION) {
+        debugLog("DrainRate: ignoring {:s} (version {:d}, expected {:d})\n", CACHE_PATH, version, CACHE_VERSION);
+        dirty = true;
+        return;
+    }
+
+    const u32 numEntries = db.read<u32>();
+    entries.reserve(numEntries);
+    for(u32 i = 0; i < numEntries; i++) {
+        Key key;
+        key.beatmapHash = db.read_hash();
+        key.fingerprint = db.read<u64>();
+        key.HP = db.read<u32>();
+        key.approachTime = db.read<u32>();
+        key.spinsPerSecond = db.read<u32>();
+        key.version = db.read<i32>();
+
+        Entry entry{.result = {}, .lastUse = 0};
+        entry.result.drainRate = db.read<f64>();
+        entry.result.hpMultiplierNormal = db.read<f64>();
+        entry.result.hpMultiplierComboEnd = db.read<f64>();
+
+        if(!db.good()) {
+            debugLog("DrainRate: {:s} is truncated, kept {:d}/{:d} entries\n", CACHE_PATH, entries.size(),
+                     numEntries);
+            dirty = true;
+            break;
+        }
+        entries.emplace(key, entry);
+    }
+
+    debugLog("DrainRate: loaded {:d} cached results\n", entries.size());
+}
+
+}  // namespace
+
+Result compute(const Input &input) {
+    // see https://github.com/ppy/osu-iPhone/blob/master/Classes/OsuPlayer.m
+    // see calcHPDropRate() @ https://github.com/ppy/osu-iPhone/blob/master/Classes/OsuFiletype.m#L661
+
+    // NOTE: all drain changes between 2014 and today have been fixed here (the link points to an old version of the
+    // algorithm!) these changes include: passive spinner nerf (drain * 0.25 while spinner is active), and clamping
+    // the object length drain to 0 + an extra check for that (see maxLongObjectDrop) see
+    // https://osu.ppy.sh/home/changelog/stable40/20190513.2
+
+    const std::vector<HitObject *> &hitobjects = input.hitobjects;
+    if(hitobjects.size() < 1) return {};
+
+    struct TestPlayer {
+        TestPlayer(f64 hpBarMaximum) {
+            this->hpBarMaximum = hpBarMaximum;
+
+            this->hpMultiplierNormal = 1.0;
+            this->hpMultiplierComboEnd = 1.0;
+
+            this->resetHealth();
+        }
+
+        void resetHealth() {
+            this->health = this->hpBarMaximum;
+            this->healthUncapped = this->hpBarMaximum;
+        }
+
+        void increaseHealth(f64 amount) {
+            this->healthUncapped += amount;
+            this->health += amount;
+
+            if(this->health > this->hpBarMaximum) this->health = this->hpBarMaximum;
+
+            if(this->health < 0.0) this->health = 0.0;
+
+            if(this->healthUncapped < 0.0) this->healthUncapped = 0.0;
+        }
+
+        void decreaseHealth(f64 amount) {
+            this->health -= amount;
+
+            if(this->health < 0.0) this->health = 0.0;
+
+            if(this->health > this->hpBarMaximum) this->health = this->hpBarMaximum;
+
+            this->healthUncapped -= amount;
+
+            if(this->healthUncapped < 0.0) this->healthUncapped = 0.0;
+        }
+
+        f64 hpBarMaximum;
+
+        f64 health;
+        f64 healthUncapped;
+
+        f64 hpMultiplierNormal;
+        f64 hpMultiplierComboEnd;
+    };
+    TestPlayer testPlayer(200.0);
+
+    const f64 HP = input.HP;
+    const int version = input.version;
+
+    f64 testDrop = 0.05;
+
+    const f64 lowestHpEver = GameRules::mapDifficultyRange(HP, 195.0, 160.0, 60.0);
+    const f64 lowestHpComboEnd = GameRules::mapDifficultyRange(HP, 198.0, 170.0, 80.0);
+    const f64 lowestHpEnd = GameRules::mapDifficultyRange(HP, 198.0, 180.0, 80.0);
+    const f64 HpRecoveryAvailable = GameRules::mapDifficultyRange(HP, 8.0, 4.0, 0.0);
+
+    bool fail = false;
+
+    do {
+        testPlayer.resetHealth();
+
+        f64 lowestHp = testPlayer.health;
+        int lastTime = (int)(hitobjects[0]->click_time - (long)input.approachTime);
+        fail = false;
+
+        const int breakCount = input.breaks.size();
+        int breakNumber = 0;
+
+        int comboTooLowCount = 0;
+
+        for(int i = 0; i < hitobjects.size(); i++) {
+            const HitObject *h = hitobjects[i];
+            const auto *sliderPointer = dynamic_cast<const Slider *>(h);
+            const auto *spinnerPointer = dynamic_cast<const Spinner *>(h);
+
+            const int localLastTime = lastTime;
+
+            int breakTime = 0;
+            if(breakCount > 0 && breakNumber < breakCount) {
+                const DatabaseBeatmap::BREAK &e = input.breaks[breakNumber];
+                if(e.startTime >= localLastTime && e.endTime <= h->click_time) {
+                    // consider break start equal to object end time for version 8+ since drain stops during this
+                    // time
+                    breakTime = (version < 8) ? (e.endTime - e.startTime) : (e.endTime - localLastTime);
+                    breakNumber++;
+                }
+            }
+
+            testPlayer.decreaseHealth(testDrop * (h->click_time - lastTime - breakTime));
+
+            lastTime = (int)(h->click_time + h->duration);
+
+            if(testPlayer.health < lowestHp) lowestHp = testPlayer.health;
+
+            if(testPlayer.health > lowestHpEver) {
+                const f64 longObjectDrop = testDrop * (f64)h->duration;
+                const f64 maxLongObjectDrop = std::max(0.0, longObjectDrop - testPlayer.health);
+
+                testPlayer.decreaseHealth(longObjectDrop);
+
+                // nested hitobjects
+                if(sliderPointer != nullptr) {
+                    // startcircle
+                    testPlayer.increaseHealth(LiveScore::getHealthIncrease(
+                        LiveScore::HIT::HIT_SLIDER30, HP, testPlayer.hpMultiplierNormal,
+                        testPlayer.hpMultiplierComboEnd, 1.0));  // slider30
+
+                    // ticks + repeats + repeat ticks
+                    const std::vector<Slider::SLIDERCLICK> &clicks = sliderPointer->getClicks();
+                    for(const auto &click : clicks) {
+                        switch(click.type) {
+                            case 0:  // repeat
+                                testPlayer.increaseHealth(LiveScore::getHealthIncrease(
+                                    LiveScore::HIT::HIT_SLIDER30, HP, testPlayer.hpMultiplierNormal,
+                                    testPlayer.hpMultiplierComboEnd, 1.0));  // slider30
+                                break;
+                            case 1:  // tick
+                                testPlayer.increaseHealth(LiveScore::getHealthIncrease(
+                                    LiveScore::HIT::HIT_SLIDER10, HP, testPlayer.hpMultiplierNormal,
+                                    testPlayer.hpMultiplierComboEnd, 1.0));  // slider10
+                                break;
+                        }
+                    }
+
+                    // endcircle
+                    testPlayer.increaseHealth(LiveScore::getHealthIncrease(
+                        LiveScore::HIT::HIT_SLIDER30, HP, testPlayer.hpMultiplierNormal,
+                        testPlayer.hpMultiplierComboEnd, 1.0));  // slider30
+                } else if(spinnerPointer != nullptr) {
+                    const int rotationsNeeded =
+                        (int)((f32)spinnerPointer->duration / 1000.0f * input.spinsPerSecond);
+                    for(int r = 0; r < rotationsNeeded; r++) {
+                        testPlayer.increaseHealth(LiveScore::getHealthIncrease(
+                            LiveScore::HIT::HIT_SPINNERSPIN, HP, testPlayer.hpMultiplierNormal,
+                            testPlayer.hpMultiplierComboEnd, 1.0));  // spinnerspin
+                    }
+                }
+
+                if(!(maxLongObjectDrop > 0.0) || (testPlayer.health - maxLongObjectDrop) > lowestHpEver) {
+                    // regular hit (for every hitobject)
+                    testPlayer.increaseHealth(
+                        LiveScore::getHealthIncrease(LiveScore::HIT::HIT_300, HP, testPlayer.hpMultiplierNormal,
+                                                     testPlayer.hpMultiplierComboEnd, 1.0));  // 300
+
+                    // end of combo (new combo starts at next hitobject)
+                    if((i == hitobjects.size() - 1) || hitobjects[i]->is_end_of_combo) {
+                        testPlayer.increaseHealth(LiveScore::getHealthIncrease(
+                            LiveScore::HIT::HIT_300G, HP, testPlayer.hpMultiplierNormal,
+                            testPlayer.hpMultiplierComboEnd, 1.0));  // geki
+
+                        if(testPlayer.health < lowestHpComboEnd) {
+                            if(++comboTooLowCount > 2) {
+                                testPlayer.hpMultiplierComboEnd *= 1.07;
+                                testPlayer.hpMultiplierNormal *= 1.03;
+                                fail = true;
+                                break;
+                            }
+                        }
+                    }
+
+                    continue;
+                }
+
+                fail = true;
+                testDrop *= 0.96;
+                break;
+            }
+
+            fail = true;
+            testDrop *= 0.96;
+            break;
+        }
+
+        if(!fail && testPlayer.health < lowestHpEnd) {
+            fail = true;
+            testDrop *= 0.94;
+            testPlayer.hpMultiplierComboEnd *= 1.01;
+            testPlayer.hpMultiplierNormal *= 1.01;
+        }
+
+        const f64 recovery = (testPlayer.healthUncapped - testPlayer.hpBarMaximum) / (f64)hitobjects.size();
+        if(!fail && recovery < HpRecoveryAvailable) {
+            fail = true;
+            testDrop *= 0.96;
+            testPlayer.hpMultiplierComboEnd *= 1.02;
+            testPlayer.hpMultiplierNormal *= 1.01;
+        }
+    } while(fail);
+
+    return Result{
+        .drainRate = (testDrop / testPlayer.hpBarMaximum) * 1000.0,  // from [0, 200] to [0, 1], and from ms to seconds
+        .hpMultiplierNormal = testPlayer.hpMultiplierNormal,
+        .hpMultiplierComboEnd = testPlayer.hpMultiplierComboEnd,
+    };
+}
+
+Result get(const MD5Hash &beatmapHash, const Input &input) {
+    if(!cv::drain_cache.getBool() || beatmapHash.length() < 1 || input.hitobjects.empty()) return compute(input);
+
+    const Key key = makeKey(beatmapHash, input);
+    {
+        std::scoped_lock lock(mtx);
+        loadIfNeeded();
+
+        if(auto it = entries.find(key); it != entries.end()) {
+            it->second.lastUse = ++useCounter;
+            stats.hits++;
+            return it->second.result;
+        }
+        stats.misses++;
+    }
+
+    // not holding the lock here, SimulatedBeatmaps on other threads might want their own results meanwhile
+    const u64 startTime = Timing::getTicksNS();
+    const Result result = compute(input);
+    const u64 elapsed = Timing::getTicksNS() - startTime;
+
+    std::scoped_lock lock(mtx);
+    stats.computeNS += elapsed;
+    entries[key] = Entry{.result = result, .lastUse = ++useCounter};
+    dirty = true;
+
+    // trimming sorts, so give it some slack instead of trimming on every miss
+    const size_t maxEntries = static_cast<size_t>(std::max(cv::drain_cache_max_entries.getInt(), 1));
+    if(entries.size() > maxEntries + maxEntries / 4) trim(maxEntries);
+
+    return result;
+}
+
+void forget(const MD5Hash &beatmapHash) {
+    std::scoped_lock lock(mtx);
+    loadIfNeeded();
+    dirty |= std::erase_if(entries, [&](const auto &pair) { return pair.first.beatmapHash == beatmapHash; }) > 0;
+}
+
+void save() {
+    std::scoped_lock lock(mtx);
+    if(!dirty) return;
+
+    trim(static_cast<size_t>(std::max(cv::drain_cache_max_entries.getInt(), 1)));
+
+    ByteBufferedFile::Writer db(CACHE_PATH);
+    db.write<u32>(CACHE_VERSION);
+    db.write<u32>(entries.size());
+    for(const auto &[key, entry] : entries) {
+        db.write_hash(key.beatmapHash);
+        db.write<u64>(key.fingerprint);
+        db.write<u32>(key.HP);
+        db.write<u32>(key.approachTime);
+        db.write<u32>(key.spinsPerSecond);
+        db.write<i32>(key.version);
+        db.write<f64>(entry.result.drainRate);
+        db.write<f64>(entry.result.hpMultiplierNormal);
+        db.write<f64>(entry.result.hpMultiplierComboEnd);
+    }
+
+    if(!db.good()) {
+        debugLog("DrainRate: failed to write {:s}: {:s}\n", CACHE_PATH, db.error());
+        return;
+    }
+
+    dirty = false;
+    debugLog("DrainRate: saved {:d} cached results\n", entries.size());
+}
+
+Stats getStats() {
+    std::scoped_lock lock(mtx);
+    Stats ret = stats;
+    ret.entries = entries.size();
+    return ret;
+}
+
+void resetStats() {
+    std::scoped_lock lock(mtx);
+    stats = {};
+}
+
+void printStats(const UString &args) {
+    if(args == "reset") {
+        resetStats();
+        Engine::logRaw("drain_cache_stats: reset\n");
+        return;
+    }
+
+    const Stats stats = getStats();
+    const u64 lookups = stats.hits + stats.misses;
+    Engine::logRaw("drain_cache_stats: {:d} lookups, {:d} hits ({:.1f}%), {:d} misses (\"drain_cache_stats reset\" to "
+                   "clear)\n",
+                   lookups, stats.hits, lookups > 0 ? 100.0 * static_cast<f64>(stats.hits) / lookups : 0.0,
+                   stats.misses);
+    Engine::logRaw("    {:.3f} ms spent simulating on misses, {:d} cached results\n",
+                   static_cast<f64>(stats.computeNS) / 1000000.0, stats.entries);
+}
+
+void bench(const UString &args) {
+    // loads the same maps twice like gameplay/ScoreConverterThread would (through SimulatedBeatmap), with their
+    // cached drain results dropped before the first pass, and checks that the second (cached) pass gives the exact
+    // same results
+    const size_t maxMaps = args.length() > 0 ? std::max(args.toInt(), 1) : 500;
+
+    std::vector<DatabaseBeatmap *> diffs;
+    for(const auto *set : db->getDatabaseBeatmaps()) {
+        for(auto *diff : set->getDifficulties()) {
+            if(diffs.size() < maxMaps) diffs.push_back(diff);
+        }
+        if(diffs.size() >= maxMaps) break;
+    }
+
+    if(diffs.empty()) {
+        Engine::logRaw("Usage:  drain_cache_bench <number of maps> (default: 500, needs a loaded database)\n");
+        return;
+    }
+
+    const bool wasCacheEnabled = cv::drain_cache.getBool();
+    cv::drain_cache.setValue(true);
+    for(const auto *diff : diffs) {
+        forget(diff->getMD5Hash());
+    }
+
+    BenchCheck check("drain_cache_bench");
+    std::vector<Result> firstResults(diffs.size());
+    for(int pass = 0; pass < 2; pass++) {
+        const Stats before = getStats();
+
+        const u64 startTime = Timing::getTicksNS();
+        for(size_t i = 0; i < diffs.size(); i++) {
+            SimulatedBeatmap smap(diffs[i], Replay::Mods{});
+            const Result result{.drainRate = smap.getDrainRate(),
+                                .hpMultiplierNormal = smap.fHpMultiplierNormal,
+                                .hpMultiplierComboEnd = smap.fHpMultiplierComboEnd};
+            if(pass == 0) {
+                firstResults[i] = result;
+            } else {
+                const Result &expected = firstResults[i];
+                check.expect(result == expected,
+                             "{:s}: cached drain rate {:g}, hp multipliers {:g}/{:g}, computed {:g}, {:g}/{:g}",
+                             diffs[i]->getFilePath(), result.drainRate, result.hpMultiplierNormal,
+                             result.hpMultiplierComboEnd, expected.drainRate, expected.hpMultiplierNormal,
+                             expected.hpMultiplierComboEnd);
+            }
+        }
+        const f64 passMS = static_cast<f64>(Timing::getTicksNS() - startTime) / 1000000.0;
+
+        const Stats after = getStats();
+        Engine::logRaw("    pass {:d}: {:.3f} ms, {:d} hits, {:d} misses, {:.3f} ms simulating drain\n", pass + 1,
+                       passMS, after.hits - before.hits, after.misses - before.misses,
+                       static_cast<f64>(after.computeNS - before.computeNS) / 1000000.0);
+    }
+
+    cv::drain_cache.setValue(wasCacheEnabled);
+    Engine::logRaw("drain_cache_bench: {:d} maps\n", diffs.size());
+    check.finish();
+}
+
+}  // namespace DrainRate
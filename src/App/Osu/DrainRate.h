@@ -0,0 +1,64 @@
+#pragma once
+
+#include "DatabaseBeatmap.h"
+#include "MD5Hash.h"
+#include "types.h"
+
+#include <vector>
+
+class HitObject;
+class UString;
+
+// the osu!stable hp drain simulation, shared by Beatmap and SimulatedBeatmap.
+// the simulation replays the whole map until it finds a drain rate the map can be passed with, which can take a few
+// hundred passes on long maps, for every gameplay start, every mod change and every simulated replay. the results are
+// memoized by get(), keyed by the beatmap hash and the effective (modded, overridden) inputs, and kept in
+// neosu_drain.db next to neosu_maps.db
+namespace DrainRate {
+
+struct Result {
+    f64 drainRate{0.0};  // fraction of the hp bar per second
+    f64 hpMultiplierNormal{1.0};
+    f64 hpMultiplierComboEnd{1.0};
+
+    bool operator==(const Result &) const = default;
+};
+
+// everything compute() depends on, after mods and overrides have been applied
+struct Input {
+    const std::vector<HitObject *> &hitobjects;
+    const std::vector<DatabaseBeatmap::BREAK> &breaks;
+    f32 HP;
+    f32 approachTime;
+    f32 spinsPerSecond;  // GameRules::getSpinnerSpinsPerSecond()
+    i32 version;
+};
+
+Result compute(const Input &input);
+
+// compute() through the cache (unless drain_cache is off). the key also contains a fingerprint of the drain-relevant
+// parts of the hitobjects and breaks, so mods which change the objects themselves can't return stale results
+Result get(const MD5Hash &beatmapHash, const Input &input);
+
+// drops all cached results for a beatmap (e.g. after it was edited, or to get cold lookups in drain_cache_bench)
+void forget(const MD5Hash &beatmapHash);
+
+// writes neosu_drain.db if anything changed since it was loaded, called by Database::save()
+void save();
+
+struct Stats {
+    u64 hits{0};
+    u64 misses{0};
+    u64 computeNS{0};  // time spent in compute() on misses
+    size_t entries{0};
+};
+Stats getStats();
+void resetStats();
+
+// drain_cache_stats [reset]
+void printStats(const UString &args);
+
+// drain_cache_bench [number of maps]: a cold and a cached pass over the database, which have to give the same results
+void bench(const UString &args);
+
+}  // namespace DrainRate
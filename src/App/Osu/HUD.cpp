@@ -24,6 +24,7 @@
 #include "ScoreboardSlot.h"
 #include "Shader.h"
 #include "Skin.h"
+#include "SkinAtlas.h"
 #include "SkinImage.h"
 #include "SongBrowser/SongBrowser.h"
 #include "UIAvatar.h"
@@ -756,160 +757,63 @@ void HUD::drawBeatmapImportSpinner() {
 }
 
 void HUD::drawScoreNumber(unsigned long long number, float scale, bool drawLeadingZeroes) {
-    // get digits
-    static std::vector<int> digits;
-    digits.clear();
-    while(number >= 10) {
-        int curDigit = number % 10;
-        number /= 10;
+    Skin *skin = osu->getSkin();
 
-        digits.insert(digits.begin(), curDigit);
-    }
-    digits.insert(digits.begin(), number);
-    if(digits.size() == 1) {
-        if(drawLeadingZeroes) digits.insert(digits.begin(), 0);
-    }
+    // get digits (least significant first)
+    std::array<u8, 20> digits;
+    size_t numDigits = 0;
+    do {
+        digits[numDigits++] = static_cast<u8>(number % 10);
+        number /= 10;
+    } while(number > 0);
+    if(numDigits == 1 && drawLeadingZeroes) digits[numDigits++] = 0;
 
     // draw them
     // NOTE: just using the width here is incorrect, but it is the quickest solution instead of painstakingly
     // reverse-engineering how osu does it
-    float lastWidth = osu->getSkin()->getScore0()->getWidth();
-    for(int digit : digits) {
-        switch(digit) {
-            case 0:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore0());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 1:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore1());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 2:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore2());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 3:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore3());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 4:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore4());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 5:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore5());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 6:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore6());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 7:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore7());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 8:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore8());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 9:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getScore9());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-        }
-
-        g->translate(-osu->getSkin()->getScoreOverlap() * (osu->getSkin()->isScore02x() ? 2 : 1) * scale, 0);
+    SkinAtlas *atlas = skin->getAtlas();
+    Image *const digitImages[10]{skin->getScore0(), skin->getScore1(), skin->getScore2(), skin->getScore3(),
+                                 skin->getScore4(), skin->getScore5(), skin->getScore6(), skin->getScore7(),
+                                 skin->getScore8(), skin->getScore9()};
+    const float halfWidth = skin->getScore0()->getWidth() * 0.5f * scale;
+    const float overlap = skin->getScoreOverlap() * (skin->isScore02x() ? 2 : 1) * scale;
+    for(size_t i = numDigits; i-- > 0;) {
+        g->translate(halfWidth, 0);
+        atlas->drawImage(digitImages[digits[i]]);
+        g->translate(halfWidth - overlap, 0);
     }
 }
 
 void HUD::drawComboNumber(unsigned long long number, float scale, bool drawLeadingZeroes) {
-    // get digits
-    static std::vector<int> digits;
-    digits.clear();
-    while(number >= 10) {
-        int curDigit = number % 10;
-        number /= 10;
+    Skin *skin = osu->getSkin();
 
-        digits.insert(digits.begin(), curDigit);
-    }
-    digits.insert(digits.begin(), number);
-    if(digits.size() == 1) {
-        if(drawLeadingZeroes) digits.insert(digits.begin(), 0);
-    }
+    // get digits (least significant first)
+    std::array<u8, 20> digits;
+    size_t numDigits = 0;
+    do {
+        digits[numDigits++] = static_cast<u8>(number % 10);
+        number /= 10;
+    } while(number > 0);
+    if(numDigits == 1 && drawLeadingZeroes) digits[numDigits++] = 0;
 
     // draw them
     // NOTE: just using the width here is incorrect, but it is the quickest solution instead of painstakingly
     // reverse-engineering how osu does it
-    float lastWidth = osu->getSkin()->getCombo0()->getWidth();
-    for(int digit : digits) {
-        switch(digit) {
-            case 0:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo0());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 1:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo1());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 2:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo2());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 3:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo3());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 4:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo4());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 5:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo5());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 6:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo6());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 7:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo7());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 8:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo8());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-            case 9:
-                g->translate(lastWidth * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getCombo9());
-                g->translate(lastWidth * 0.5f * scale, 0);
-                break;
-        }
-
-        g->translate(-osu->getSkin()->getComboOverlap() * (osu->getSkin()->isCombo02x() ? 2 : 1) * scale, 0);
+    SkinAtlas *atlas = skin->getAtlas();
+    Image *const digitImages[10]{skin->getCombo0(), skin->getCombo1(), skin->getCombo2(), skin->getCombo3(),
+                                 skin->getCombo4(), skin->getCombo5(), skin->getCombo6(), skin->getCombo7(),
+                                 skin->getCombo8(), skin->getCombo9()};
+    const float halfWidth = skin->getCombo0()->getWidth() * 0.5f * scale;
+    const float overlap = skin->getComboOverlap() * (skin->isCombo02x() ? 2 : 1) * scale;
+    for(size_t i = numDigits; i-- > 0;) {
+        g->translate(halfWidth, 0);
+        atlas->drawImage(digitImages[digits[i]]);
+        g->translate(halfWidth - overlap, 0);
     }
 }
 
 void HUD::drawComboSimple(int combo, float scale) {
+    osu->getSkin()->getAtlas()->beginBatch();
     g->pushTransform();
     {
         this->drawComboNumber(combo, scale);
@@ -917,14 +821,16 @@ void HUD::drawComboSimple(int combo, float scale) {
         // draw 'x' at the end
         if(osu->getSkin()->getComboX() != osu->getSkin()->getMissingTexture()) {
             g->translate(osu->getSkin()->getComboX()->getWidth() * 0.5f * scale, 0);
-            g->drawImage(osu->getSkin()->getComboX());
+            osu->getSkin()->getAtlas()->drawImage(osu->getSkin()->getComboX());
         }
     }
     g->popTransform();
+    osu->getSkin()->getAtlas()->endBatch();
 }
 
 void HUD::drawCombo(int combo) {
     g->setColor(0xffffffff);
+    osu->getSkin()->getAtlas()->beginBatch();
 
     const int offset = 5;
 
@@ -944,7 +850,7 @@ void HUD::drawCombo(int combo) {
             // draw 'x' at the end
             if(osu->getSkin()->getComboX() != osu->getSkin()->getMissingTexture()) {
                 g->translate(osu->getSkin()->getComboX()->getWidth() * 0.5f * scale, 0);
-                g->drawImage(osu->getSkin()->getComboX());
+                osu->getSkin()->getAtlas()->drawImage(osu->getSkin()->getComboX());
             }
         }
         g->popTransform();
@@ -965,10 +871,11 @@ void HUD::drawCombo(int combo) {
         // draw 'x' at the end
         if(osu->getSkin()->getComboX() != osu->getSkin()->getMissingTexture()) {
             g->translate(osu->getSkin()->getComboX()->getWidth() * 0.5f * scale, 0);
-            g->drawImage(osu->getSkin()->getComboX());
+            osu->getSkin()->getAtlas()->drawImage(osu->getSkin()->getComboX());
         }
     }
     g->popTransform();
+    osu->getSkin()->getAtlas()->endBatch();
 }
 
 void HUD::drawScore(unsigned long long score) {
@@ -989,7 +896,9 @@ void HUD::drawScore(unsigned long long score) {
             osu->getScreenWidth() - osu->getSkin()->getScore0()->getWidth() * scale * numDigits +
                 osu->getSkin()->getScoreOverlap() * (osu->getSkin()->isScore02x() ? 2 : 1) * scale * (numDigits - 1),
             osu->getSkin()->getScore0()->getHeight() * scale / 2);
+        osu->getSkin()->getAtlas()->beginBatch();
         this->drawScoreNumber(score, scale, false);
+        osu->getSkin()->getAtlas()->endBatch();
     }
     g->popTransform();
 }
@@ -1799,89 +1708,110 @@ void HUD::drawStatistics(int misses, int sliderbreaks, int maxPossibleCombo, flo
             currentY += yDelta;
         };
 
+        // only format the text again if the value changed since the last frame
+        auto getText = [&](STATISTIC which, f64 value1, f64 value2, auto &&format) -> const UString & {
+            STATISTIC_TEXT &statistic = this->statisticTexts[static_cast<size_t>(which)];
+            if(statistic.text.isEmpty() || statistic.value1 != value1 || statistic.value2 != value2) {
+                statistic.value1 = value1;
+                statistic.value2 = value2;
+                statistic.text = format();
+            }
+            return statistic.text;
+        };
+
+        const int ppDecimalPlaces = std::clamp(cv::hud_statistics_pp_decimal_places.getInt(), 0, 2);
+        auto formatPP = [ppDecimalPlaces](std::string_view prefix, float value) {
+            if(ppDecimalPlaces < 1) return UString::fmt("{:s}{:d}pp", prefix, (int)std::round(value));
+            if(ppDecimalPlaces > 1) return UString::fmt("{:s}{:.2f}pp", prefix, value);
+            return UString::fmt("{:s}{:.1f}pp", prefix, value);
+        };
+
         if(cv::draw_statistics_pp.getBool())
-            addStatistic((cv::hud_statistics_pp_decimal_places.getInt() < 1
-                              ? UString::fmt("{:d}pp", (int)std::round(pp))
-                              : (cv::hud_statistics_pp_decimal_places.getInt() > 1 ? UString::fmt("{:.2f}pp", pp)
-                                                                                   : UString::fmt("{:.1f}pp", pp))),
+            addStatistic(getText(STATISTIC::PP, pp, ppDecimalPlaces, [&] { return formatPP("", pp); }),
                          cv::hud_statistics_pp_offset_x.getInt(), cv::hud_statistics_pp_offset_y.getInt());
 
         if(cv::draw_statistics_perfectpp.getBool())
-            addStatistic(
-                (cv::hud_statistics_pp_decimal_places.getInt() < 1
-                     ? UString::fmt("SS: {:d}pp", (int)std::round(ppfc))
-                     : (cv::hud_statistics_pp_decimal_places.getInt() > 1 ? UString::fmt("SS: {:.2f}pp", ppfc)
-                                                                          : UString::fmt("SS: {:.1f}pp", ppfc))),
-                cv::hud_statistics_perfectpp_offset_x.getInt(), cv::hud_statistics_perfectpp_offset_y.getInt());
+            addStatistic(getText(STATISTIC::PERFECTPP, ppfc, ppDecimalPlaces, [&] { return formatPP("SS: ", ppfc); }),
+                         cv::hud_statistics_perfectpp_offset_x.getInt(),
+                         cv::hud_statistics_perfectpp_offset_y.getInt());
 
         if(cv::draw_statistics_misses.getBool())
-            addStatistic(UString::fmt("Miss: {:d}", misses), cv::hud_statistics_misses_offset_x.getInt(),
-                         cv::hud_statistics_misses_offset_y.getInt());
+            addStatistic(getText(STATISTIC::MISSES, misses, 0, [&] { return UString::fmt("Miss: {:d}", misses); }),
+                         cv::hud_statistics_misses_offset_x.getInt(), cv::hud_statistics_misses_offset_y.getInt());
 
         if(cv::draw_statistics_sliderbreaks.getBool())
-            addStatistic(UString::fmt("SBrk: {:d}", sliderbreaks), cv::hud_statistics_sliderbreaks_offset_x.getInt(),
+            addStatistic(getText(STATISTIC::SLIDERBREAKS, sliderbreaks, 0,
+                                 [&] { return UString::fmt("SBrk: {:d}", sliderbreaks); }),
+                         cv::hud_statistics_sliderbreaks_offset_x.getInt(),
                          cv::hud_statistics_sliderbreaks_offset_y.getInt());
 
         if(cv::draw_statistics_maxpossiblecombo.getBool())
-            addStatistic(UString::fmt("FC: {:d}x", maxPossibleCombo),
+            addStatistic(getText(STATISTIC::MAXPOSSIBLECOMBO, maxPossibleCombo, 0,
+                                 [&] { return UString::fmt("FC: {:d}x", maxPossibleCombo); }),
                          cv::hud_statistics_maxpossiblecombo_offset_x.getInt(),
                          cv::hud_statistics_maxpossiblecombo_offset_y.getInt());
 
         if(cv::draw_statistics_livestars.getBool())
-            addStatistic(UString::fmt("{:.3g}***", liveStars), cv::hud_statistics_livestars_offset_x.getInt(),
+            addStatistic(getText(STATISTIC::LIVESTARS, liveStars, 0,
+                                 [&] { return UString::fmt("{:.3g}***", liveStars); }),
+                         cv::hud_statistics_livestars_offset_x.getInt(),
                          cv::hud_statistics_livestars_offset_y.getInt());
 
         if(cv::draw_statistics_totalstars.getBool())
-            addStatistic(UString::fmt("{:.3g}*", totalStars), cv::hud_statistics_totalstars_offset_x.getInt(),
+            addStatistic(getText(STATISTIC::TOTALSTARS, totalStars, 0,
+                                 [&] { return UString::fmt("{:.3g}*", totalStars); }),
+                         cv::hud_statistics_totalstars_offset_x.getInt(),
                          cv::hud_statistics_totalstars_offset_y.getInt());
 
         if(cv::draw_statistics_bpm.getBool())
-            addStatistic(UString::fmt("BPM: {:d}", bpm), cv::hud_statistics_bpm_offset_x.getInt(),
-                         cv::hud_statistics_bpm_offset_y.getInt());
+            addStatistic(getText(STATISTIC::BPM, bpm, 0, [&] { return UString::fmt("BPM: {:d}", bpm); }),
+                         cv::hud_statistics_bpm_offset_x.getInt(), cv::hud_statistics_bpm_offset_y.getInt());
 
         if(cv::draw_statistics_ar.getBool()) {
             ar = std::round(ar * 100.0f) / 100.0f;
-            addStatistic(UString::fmt("AR: {:g}", ar), cv::hud_statistics_ar_offset_x.getInt(),
-                         cv::hud_statistics_ar_offset_y.getInt());
+            addStatistic(getText(STATISTIC::AR, ar, 0, [&] { return UString::fmt("AR: {:g}", ar); }),
+                         cv::hud_statistics_ar_offset_x.getInt(), cv::hud_statistics_ar_offset_y.getInt());
         }
 
         if(cv::draw_statistics_cs.getBool()) {
             cs = std::round(cs * 100.0f) / 100.0f;
-            addStatistic(UString::fmt("CS: {:g}", cs), cv::hud_statistics_cs_offset_x.getInt(),
-                         cv::hud_statistics_cs_offset_y.getInt());
+            addStatistic(getText(STATISTIC::CS, cs, 0, [&] { return UString::fmt("CS: {:g}", cs); }),
+                         cv::hud_statistics_cs_offset_x.getInt(), cv::hud_statistics_cs_offset_y.getInt());
         }
 
         if(cv::draw_statistics_od.getBool()) {
             od = std::round(od * 100.0f) / 100.0f;
-            addStatistic(UString::fmt("OD: {:g}", od), cv::hud_statistics_od_offset_x.getInt(),
-                         cv::hud_statistics_od_offset_y.getInt());
+            addStatistic(getText(STATISTIC::OD, od, 0, [&] { return UString::fmt("OD: {:g}", od); }),
+                         cv::hud_statistics_od_offset_x.getInt(), cv::hud_statistics_od_offset_y.getInt());
         }
 
         if(cv::draw_statistics_hp.getBool()) {
             hp = std::round(hp * 100.0f) / 100.0f;
-            addStatistic(UString::fmt("HP: {:g}", hp), cv::hud_statistics_hp_offset_x.getInt(),
-                         cv::hud_statistics_hp_offset_y.getInt());
+            addStatistic(getText(STATISTIC::HP, hp, 0, [&] { return UString::fmt("HP: {:g}", hp); }),
+                         cv::hud_statistics_hp_offset_x.getInt(), cv::hud_statistics_hp_offset_y.getInt());
         }
 
         if(cv::draw_statistics_hitwindow300.getBool())
-            addStatistic(UString::fmt("300: +-{:d}ms", (int)hitWindow300),
-                         cv::hud_statistics_hitwindow300_offset_x.getInt(),
-                         cv::hud_statistics_hitwindow300_offset_y.getInt());
+            addStatistic(
+                getText(STATISTIC::HITWINDOW300, (int)hitWindow300, 0,
+                        [&] { return UString::fmt("300: +-{:d}ms", (int)hitWindow300); }),
+                cv::hud_statistics_hitwindow300_offset_x.getInt(), cv::hud_statistics_hitwindow300_offset_y.getInt());
 
         if(cv::draw_statistics_nps.getBool())
-            addStatistic(UString::fmt("NPS: {:d}", nps), cv::hud_statistics_nps_offset_x.getInt(),
-                         cv::hud_statistics_nps_offset_y.getInt());
+            addStatistic(getText(STATISTIC::NPS, nps, 0, [&] { return UString::fmt("NPS: {:d}", nps); }),
+                         cv::hud_statistics_nps_offset_x.getInt(), cv::hud_statistics_nps_offset_y.getInt());
 
         if(cv::draw_statistics_nd.getBool())
-            addStatistic(UString::fmt("ND: {:d}", nd), cv::hud_statistics_nd_offset_x.getInt(),
-                         cv::hud_statistics_nd_offset_y.getInt());
+            addStatistic(getText(STATISTIC::ND, nd, 0, [&] { return UString::fmt("ND: {:d}", nd); }),
+                         cv::hud_statistics_nd_offset_x.getInt(), cv::hud_statistics_nd_offset_y.getInt());
 
         if(cv::draw_statistics_ur.getBool())
-            addStatistic(UString::fmt("UR: {:d}", ur), cv::hud_statistics_ur_offset_x.getInt(),
-                         cv::hud_statistics_ur_offset_y.getInt());
+            addStatistic(getText(STATISTIC::UR, ur, 0, [&] { return UString::fmt("UR: {:d}", ur); }),
+                         cv::hud_statistics_ur_offset_x.getInt(), cv::hud_statistics_ur_offset_y.getInt());
 
         if(cv::draw_statistics_hitdelta.getBool())
-            addStatistic(UString::fmt("-{:d}ms +{:d}ms", std::abs(hitdeltaMin), hitdeltaMax),
+            addStatistic(getText(STATISTIC::HITDELTA, hitdeltaMin, hitdeltaMax,
+                                 [&] { return UString::fmt("-{:d}ms +{:d}ms", std::abs(hitdeltaMin), hitdeltaMax); }),
                          cv::hud_statistics_hitdelta_offset_x.getInt(), cv::hud_statistics_hitdelta_offset_y.getInt());
     }
     font->flushBatch();
@@ -3,6 +3,8 @@
 #include "OsuScreen.h"
 #include "MD5Hash.h"
 
+#include <array>
+
 class UIAvatar;
 class Beatmap;
 struct ScoreboardSlot;
@@ -122,6 +124,33 @@ class HUD : public OsuScreen {
         float endPercent;
     };
 
+    enum class STATISTIC : uint8_t {
+        PP,
+        PERFECTPP,
+        MISSES,
+        SLIDERBREAKS,
+        MAXPOSSIBLECOMBO,
+        LIVESTARS,
+        TOTALSTARS,
+        BPM,
+        AR,
+        CS,
+        OD,
+        HP,
+        HITWINDOW300,
+        NPS,
+        ND,
+        UR,
+        HITDELTA,
+        STATISTIC_COUNT
+    };
+
+    struct STATISTIC_TEXT {
+        f64 value1;
+        f64 value2;
+        UString text;
+    };
+
     void drawCursorTrailInt(Shader *trailShader, std::vector<CURSORTRAIL> &trail, vec2 pos,
                             float alphaMultiplier = 1.0f, bool emptyTrailFrame = false);
     void drawCursorTrailRaw(float alpha, vec2 pos);
@@ -167,6 +196,9 @@ class HUD : public OsuScreen {
     // hit error bar
     std::vector<HITERROR> hiterrors;
 
+    // statistics text cache, one per STATISTIC
+    std::array<STATISTIC_TEXT, static_cast<size_t>(STATISTIC::STATISTIC_COUNT)> statisticTexts{};
+
     // inputoverlay / key overlay
     float fInputoverlayK1AnimScale;
     float fInputoverlayK2AnimScale;
@@ -0,0 +1,582 @@
+#include "HitObjectStacking.h"
+
+#include "BenchCheck.h"
+#include "ConVar.h"
+#include "Database.h"
+#include "DatabaseBeatmap.h"
+#include "DifficultyCalculator.h"
+#include "Engine.h"
+#include "Environment.h"
+#include "GameRules.h"
+#include "HitObjects.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace HitObjectStacking {
+
+namespace {  // static namespace
+
+constexpr const f32 STACK_LENIENCE = 3.0f;
+
+inline bool isStacked(vec2 a, vec2 b) { return vec::length(a - b) < STACK_LENIENCE; }
+
+struct Window {
+    f32 approachTime;
+    f32 stackLeniency;
+
+    // true if something at earlierTime is too long ago to stack with something at laterTime.
+    // monotonic in both times, which is what lets the grid binary search for the end of the walk
+    [[nodiscard]] inline bool isOutside(i64 laterTime, i64 earlierTime) const {
+        return laterTime - (this->approachTime * this->stackLeniency) > earlierTime;
+    }
+};
+
+// positions bucketed into cells more than twice as large as STACK_LENIENCE, so everything which can stack with a
+// position is in one of the (at most) 2x2 cells its surroundings overlap. cells are hashed into a fixed number of
+// buckets, collisions only mean a few more objects to check. the indices of every bucket are sorted, so "the closest
+// index before/after n" is a binary search per bucket
+class Grid {
+   public:
+    void add(vec2 pos, i32 index) { this->entries.push_back({cellOf(pos), index}); }
+
+    // counting sort into buckets, entries were added in index order so every bucket stays sorted
+    void build() {
+        this->iBucketBits = 4;
+        while((size_t{1} << this->iBucketBits) < this->entries.size() * 2) this->iBucketBits++;
+
+        this->offsets.assign((size_t{1} << this->iBucketBits) + 1, 0);
+        for(const Entry &entry : this->entries) {
+            this->offsets[this->bucketOf(entry.cell) + 1]++;
+        }
+        for(size_t i = 1; i < this->offsets.size(); i++) {
+            this->offsets[i] += this->offsets[i - 1];
+        }
+
+        this->indices.resize(this->entries.size());
+        std::vector<u32> cursor(this->offsets.begin(), this->offsets.end() - 1);
+        for(const Entry &entry : this->entries) {
+            this->indices[cursor[this->bucketOf(entry.cell)]++] = entry.index;
+        }
+
+        this->entries.clear();
+        this->entries.shrink_to_fit();
+    }
+
+    // largest index < before near pos, -1 if there is none
+    [[nodiscard]] i32 findLast(vec2 pos, i32 before) const {
+        i32 result = -1;
+        this->forEachNeighbour(pos, [&](const i32 *begin, const i32 *end) {
+            const i32 *it = std::lower_bound(begin, end, before);
+            if(it != begin) result = std::max(result, *(it - 1));
+        });
+        return result;
+    }
+
+    // smallest index > after near pos, none if there is none
+    [[nodiscard]] i32 findFirst(vec2 pos, i32 after, i32 none) const {
+        i32 result = none;
+        this->forEachNeighbour(pos, [&](const i32 *begin, const i32 *end) {
+            const i32 *it = std::upper_bound(begin, end, after);
+            if(it != end) result = std::min(result, *it);
+        });
+        return result;
+    }
+
+    // every index in [first, last] near pos (once), unordered
+    template <typename Callback>
+    void forEachInRange(vec2 pos, i32 first, i32 last, Callback &&callback) const {
+        this->forEachNeighbour(pos, [&](const i32 *begin, const i32 *end) {
+            for(const i32 *it = std::lower_bound(begin, end, first); it != end && *it <= last; it++) {
+                callback(*it);
+            }
+        });
+    }
+
+   private:
+    static constexpr const f32 CELL_SIZE{8.0f};
+    static constexpr const f32 REACH{STACK_LENIENCE + 1.0f};  // a bit more, so that rounding can't matter
+    static constexpr const f32 MAX_CELL{1 << 24};
+
+    struct Entry {
+        u64 cell;
+        i32 index;
+    };
+
+    // clamping only merges cells far off the playfield
+    static inline i32 cellCoord(f32 v) {
+        return static_cast<i32>(std::clamp(std::floor(v / CELL_SIZE), -MAX_CELL, MAX_CELL));
+    }
+    static inline u64 cellKey(i32 x, i32 y) {
+        return (static_cast<u64>(static_cast<u32>(x)) << 32) | static_cast<u32>(y);
+    }
+    static inline u64 cellOf(vec2 pos) { return cellKey(cellCoord(pos.x), cellCoord(pos.y)); }
+
+    [[nodiscard]] inline u32 bucketOf(u64 cell) const {
+        return static_cast<u32>((cell * 0x9E3779B97F4A7C15ULL) >> (64 - this->iBucketBits));
+    }
+
+    // cells can hash into the same bucket, every bucket is only visited once
+    template <typename Callback>
+    void forEachNeighbour(vec2 pos, Callback &&callback) const {
+        const i32 minX = cellCoord(pos.x - REACH);
+        const i32 maxX = cellCoord(pos.x + REACH);
+        const i32 minY = cellCoord(pos.y - REACH);
+        const i32 maxY = cellCoord(pos.y + REACH);
+
+        u32 buckets[9];
+        int numBuckets = 0;
+        for(i32 x = minX; x <= maxX; x++) {
+            for(i32 y = minY; y <= maxY; y++) {
+                const u32 bucket = this->bucketOf(cellKey(x, y));
+                if(std::find(buckets, buckets + numBuckets, bucket) != buckets + numBuckets) continue;
+
+                buckets[numBuckets++] = bucket;
+                const i32 *bucketIndices = this->indices.data();
+                callback(bucketIndices + this->offsets[bucket], bucketIndices + this->offsets[bucket + 1]);
+            }
+        }
+    }
+
+    std::vector<Entry> entries;  // only until build()
+    std::vector<u32> offsets;    // into indices, one per bucket + 1
+    std::vector<i32> indices;
+    u32 iBucketBits{4};
+};
+
+}  // namespace
+
+std::vector<Object> fromHitObjects(const std::vector<HitObject *> &hitobjects) {
+    std::vector<Object> objects;
+    objects.reserve(hitobjects.size());
+    for(const HitObject *hitobject : hitobjects) {
+        objects.push_back(Object{
+            .time = hitobject->click_time,
+            .duration = hitobject->duration,
+            .startPos = hitobject->getOriginalRawPosAt(hitobject->click_time),
+            .endPos = hitobject->getOriginalRawPosAt(hitobject->click_time + hitobject->duration),
+            .type = hitobject->type == HitObjectType::CIRCLE   ? TYPE::CIRCLE
+                    : hitobject->type == HitObjectType::SLIDER ? TYPE::SLIDER
+                                                               : TYPE::SPINNER,
+        });
+    }
+    return objects;
+}
+
+std::vector<Object> fromDifficultyHitObjects(std::vector<OsuDifficultyHitObject> &diffobjects) {
+    std::vector<Object> objects;
+    objects.reserve(diffobjects.size());
+    for(OsuDifficultyHitObject &diffobject : diffobjects) {
+        objects.push_back(Object{
+            .time = diffobject.time,
+            .duration = diffobject.getDuration(),
+            .startPos = diffobject.getOriginalRawPosAt(diffobject.time),
+            .endPos = diffobject.getOriginalRawPosAt(diffobject.time + diffobject.getDuration()),
+            .type = diffobject.type == OsuDifficultyHitObject::TYPE::CIRCLE   ? TYPE::CIRCLE
+                    : diffobject.type == OsuDifficultyHitObject::TYPE::SLIDER ? TYPE::SLIDER
+                                                                              : TYPE::SPINNER,
+        });
+    }
+    return objects;
+}
+
+void calculateStacks(const std::vector<Object> &objects, f32 approachTime, f32 stackLeniency, i32 version,
+                     std::vector<i32> &stacks) {
+    if(cv::stacking_grid.getBool())
+        calculateStacksGrid(objects, approachTime, stackLeniency, version, stacks);
+    else
+        calculateStacksReference(objects, approachTime, stackLeniency, version, stacks);
+}
+
+void calculateStacksReference(const std::vector<Object> &objects, f32 approachTime, f32 stackLeniency, i32 version,
+                              std::vector<i32> &stacks) {
+    stacks.assign(objects.size(), 0);
+
+    const Window window{.approachTime = approachTime, .stackLeniency = stackLeniency};
+    const auto numObjects = static_cast<i32>(objects.size());
+
+    if(version > 5) {
+        // peppy's algorithm
+        // https://gist.github.com/peppy/1167470
+
+        for(i32 i = numObjects - 1; i >= 0; i--) {
+            i32 n = i;
+            i32 objectI = i;
+
+            if(stacks[i] != 0 || objects[i].type == TYPE::SPINNER) continue;
+
+            if(objects[i].type == TYPE::CIRCLE) {
+                while(--n >= 0) {
+                    const Object &objectN = objects[n];
+
+                    if(objectN.type == TYPE::SPINNER) continue;
+
+                    if(window.isOutside(objects[objectI].time, objectN.time + objectN.duration)) break;
+
+                    if(objectN.duration != 0 && isStacked(objectN.endPos, objects[objectI].startPos)) {
+                        const i32 offset = stacks[objectI] - stacks[n] + 1;
+                        for(i32 j = n + 1; j <= i; j++) {
+                            if(isStacked(objectN.endPos, objects[j].startPos)) stacks[j] -= offset;
+                        }
+
+                        break;
+                    }
+
+                    if(isStacked(objectN.startPos, objects[objectI].startPos)) {
+                        stacks[n] = stacks[objectI] + 1;
+                        objectI = n;
+                    }
+                }
+            } else if(objects[i].type == TYPE::SLIDER) {
+                while(--n >= 0) {
+                    const Object &objectN = objects[n];
+
+                    if(objectN.type == TYPE::SPINNER) continue;
+
+                    if(window.isOutside(objects[objectI].time, objectN.time)) break;
+
+                    if(isStacked(objectN.duration != 0 ? objectN.endPos : objectN.startPos,
+                                 objects[objectI].startPos)) {
+                        stacks[n] = stacks[objectI] + 1;
+                        objectI = n;
+                    }
+                }
+            }
+        }
+    } else  // version < 6
+    {
+        // old stacking algorithm for old beatmaps
+        // https://github.com/ppy/osu/blob/master/osu.Game.Rulesets.Osu/Beatmaps/OsuBeatmapProcessor.cs
+
+        for(i32 i = 0; i < numObjects; i++) {
+            const Object &current = objects[i];
+            const bool isSlider = (current.type == TYPE::SLIDER);
+
+            if(stacks[i] != 0 && !isSlider) continue;
+
+            i64 startTime = current.time + current.duration;
+            i32 sliderStack = 0;
+
+            // "The start position of the hitobject, or the position at the end of the path if the hitobject is a
+            // slider"
+            const vec2 position2 = isSlider ? current.endPos : current.startPos;
+
+            for(i32 j = i + 1; j < numObjects; j++) {
+                const Object &objectJ = objects[j];
+
+                if(window.isOutside(objectJ.time, startTime)) break;
+
+                if(isStacked(objectJ.startPos, current.startPos)) {
+                    stacks[i]++;
+                    startTime = objectJ.time + objectJ.duration;
+                } else if(isStacked(objectJ.startPos, position2)) {
+                    // "Case for sliders - bump notes down and right, rather than up and left."
+                    sliderStack++;
+                    stacks[j] -= sliderStack;
+                    startTime = objectJ.time + objectJ.duration;
+                }
+            }
+        }
+    }
+}
+
+// same loops as calculateStacksReference(). every walk starts out stepping through the window one object at a time,
+// and only if it gets crowded (dense streams, long windows) it jumps straight to the next object which can do
+// anything: one the grid says is close enough to stack, or the one which ends the walk. everything in between would
+// have been a no-op. the grids are only built once the first walk needs them
+void calculateStacksGrid(const std::vector<Object> &objects, f32 approachTime, f32 stackLeniency, i32 version,
+                         std::vector<i32> &stacks) {
+    // the jumps rely on start times being sorted and on nothing ending before it starts (spinners don't matter)
+    const bool usable = std::ranges::is_sorted(objects, {}, &Object::time) &&
+                        std::ranges::all_of(objects, [](const Object &object) {
+                            return (object.duration >= 0 || object.type == TYPE::SPINNER) &&
+                                   std::isfinite(object.startPos.x) && std::isfinite(object.startPos.y) &&
+                                   std::isfinite(object.endPos.x) && std::isfinite(object.endPos.y);
+                        });
+    if(!usable) {
+        calculateStacksReference(objects, approachTime, stackLeniency, version, stacks);
+        return;
+    }
+
+    // objects per walk before switching to the grid, about what one lookup costs
+    static constexpr const i32 LINEAR_WALK = 48;
+    static constexpr const i32 UNKNOWN = std::numeric_limits<i32>::min();
+
+    stacks.assign(objects.size(), 0);
+
+    const Window window{.approachTime = approachTime, .stackLeniency = stackLeniency};
+    const auto numObjects = static_cast<i32>(objects.size());
+
+    // the window usually only covers a few objects around the current one, so both of these gallop away from it
+    // before binary searching
+
+    // first index in [0, end] from which on everything before end starts inside the window before laterTime
+    const auto firstInside = [&](i64 laterTime, i32 end) -> i32 {
+        i32 hi = end;
+        for(i32 step = 1;; step *= 2) {
+            const i32 lo = hi - step;
+            if(lo < 0 || window.isOutside(laterTime, objects[lo].time)) {
+                const auto it = std::partition_point(
+                    objects.begin() + std::max(lo, 0), objects.begin() + hi,
+                    [&](const Object &object) { return window.isOutside(laterTime, object.time); });
+                return static_cast<i32>(it - objects.begin());
+            }
+            hi = lo;
+        }
+    };
+    // first index from "from" on which starts too late for something at earlierTime, numObjects if there is none
+    const auto firstOutside = [&](i64 earlierTime, i32 from) -> i32 {
+        i32 lo = from;
+        for(i32 step = 1;; step *= 2) {
+            const i32 hi = lo + step;
+            if(hi >= numObjects || window.isOutside(objects[hi].time, earlierTime)) {
+                const auto it = std::partition_point(
+                    objects.begin() + lo, objects.begin() + std::min(hi, numObjects),
+                    [&](const Object &object) { return !window.isOutside(object.time, earlierTime); });
+                return static_cast<i32>(it - objects.begin());
+            }
+            lo = hi;
+        }
+    };
+
+    // start positions of everything
+    std::unique_ptr<Grid> starts;
+    const auto getStarts = [&]() -> const Grid & {
+        if(!starts) {
+            starts = std::make_unique<Grid>();
+            for(i32 i = 0; i < numObjects; i++) {
+                starts->add(objects[i].startPos, i);
+            }
+            starts->build();
+        }
+        return *starts;
+    };
+
+    if(version > 5) {
+        // start positions of everything, and end positions of everything which has a duration
+        std::unique_ptr<Grid> points;
+        const auto getPoints = [&]() -> const Grid & {
+            if(!points) {
+                points = std::make_unique<Grid>();
+                for(i32 i = 0; i < numObjects; i++) {
+                    points->add(objects[i].startPos, i);
+                    if(objects[i].duration != 0) points->add(objects[i].endPos, i);
+                }
+                points->build();
+            }
+            return *points;
+        };
+
+        for(i32 i = numObjects - 1; i >= 0; i--) {
+            i32 n = i;
+            i32 objectI = i;
+
+            if(stacks[i] != 0 || objects[i].type == TYPE::SPINNER) continue;
+
+            const bool isHitCircle = (objects[i].type == TYPE::CIRCLE);
+            i32 breakIndex = UNKNOWN;
+
+            // of objectI
+            i64 timeI = objects[i].time;
+            vec2 posI = objects[i].startPos;
+            const auto setObjectI = [&](i32 index) {
+                stacks[index] = stacks[objectI] + 1;
+                objectI = index;
+                timeI = objects[index].time;
+                posI = objects[index].startPos;
+                breakIndex = UNKNOWN;
+            };
+
+            // the closest non-spinner before n which ends the walk. of the ones starting inside the window, only long
+            // objects overlapping its start can end the circle walk, so that's a short step back
+            const auto findBreak = [&]() -> i32 {
+                for(i32 m = firstInside(timeI, n) - 1; m >= 0; m--) {
+                    if(objects[m].type == TYPE::SPINNER) continue;
+                    if(!isHitCircle || window.isOutside(timeI, objects[m].time + objects[m].duration))
+                        return m;
+                }
+                return -1;
+            };
+
+            const auto jump = [&]() -> i32 {
+                if(breakIndex == UNKNOWN) breakIndex = findBreak();
+                return std::max(breakIndex, getPoints().findLast(posI, n));
+            };
+            // steps back one at a time like the reference loop at first, then jumps
+            const i32 walkEnd = i - LINEAR_WALK;
+            const auto nextIndex = [&]() -> i32 { return n > walkEnd ? n - 1 : jump(); };
+
+            if(isHitCircle) {
+                while((n = nextIndex()) >= 0) {
+                    const Object &objectN = objects[n];
+
+                    if(objectN.type == TYPE::SPINNER) continue;
+
+                    if(window.isOutside(timeI, objectN.time + objectN.duration)) break;
+
+                    if(objectN.duration != 0 && isStacked(objectN.endPos, posI)) {
+                        const i32 offset = stacks[objectI] - stacks[n] + 1;
+                        const auto unstack = [&](i32 j) {
+                            if(isStacked(objectN.endPos, objects[j].startPos)) stacks[j] -= offset;
+                        };
+                        if(i - n <= LINEAR_WALK) {
+                            for(i32 j = n + 1; j <= i; j++) {
+                                unstack(j);
+                            }
+                        } else {
+                            getStarts().forEachInRange(objectN.endPos, n + 1, i, unstack);
+                        }
+
+                        break;
+                    }
+
+                    if(isStacked(objectN.startPos, posI)) setObjectI(n);
+                }
+            } else if(objects[i].type == TYPE::SLIDER) {
+                while((n = nextIndex()) >= 0) {
+                    const Object &objectN = objects[n];
+
+                    if(objectN.type == TYPE::SPINNER) continue;
+
+                    if(window.isOutside(timeI, objectN.time)) break;
+
+                    if(isStacked(objectN.duration != 0 ? objectN.endPos : objectN.startPos, posI)) setObjectI(n);
+                }
+            }
+        }
+    } else {
+        for(i32 i = 0; i < numObjects; i++) {
+            const Object &current = objects[i];
+            const bool isSlider = (current.type == TYPE::SLIDER);
+
+            if(stacks[i] != 0 && !isSlider) continue;
+
+            i64 startTime = current.time + current.duration;
+            i32 sliderStack = 0;
+
+            const vec2 position2 = isSlider ? current.endPos : current.startPos;
+
+            i32 j = i;
+            i32 breakIndex = UNKNOWN;
+            const i32 walkEnd = i + LINEAR_WALK;
+            while(true) {
+                if(j < walkEnd) {
+                    if(++j >= numObjects || window.isOutside(objects[j].time, startTime)) break;
+                } else {
+                    if(breakIndex == UNKNOWN) breakIndex = firstOutside(startTime, j + 1);
+                    j = std::min(getStarts().findFirst(current.startPos, j, numObjects),
+                                 getStarts().findFirst(position2, j, numObjects));
+                    if(j >= breakIndex) break;
+                }
+
+                const Object &objectJ = objects[j];
+
+                if(isStacked(objectJ.startPos, current.startPos)) {
+                    stacks[i]++;
+                    startTime = objectJ.time + objectJ.duration;
+                    breakIndex = UNKNOWN;
+                } else if(isStacked(objectJ.startPos, position2)) {
+                    sliderStack++;
+                    stacks[j] -= sliderStack;
+                    startTime = objectJ.time + objectJ.duration;
+                    breakIndex = UNKNOWN;
+                }
+            }
+        }
+    }
+}
+
+void bench(const UString &args) {
+    // checks that HitObjectStacking::calculateStacksGrid() gives the exact same stack heights as the reference loops
+    // for every map in a folder (and its subfolders, so a songs folder works), and compares how long they take. every
+    // map is stacked at a few ARs, since the window length is what decides how long the walks get
+    const std::string folder =
+        Environment::normalizeDirectory(args.length() > 0 ? args.toUtf8() : Database::getOsuSongsFolder());
+
+    std::vector<std::string> osuFiles;
+    const auto addOsuFiles = [&](const std::string &dir) {
+        for(const auto &fileName : env->getFilesInFolder(dir)) {
+            if(env->getFileExtensionFromFilePath(fileName) == "osu") osuFiles.push_back(dir + fileName);
+        }
+    };
+    addOsuFiles(folder);
+    for(const auto &subfolder : env->getFoldersInFolder(folder)) {
+        addOsuFiles(folder + subfolder + "/");
+    }
+
+    if(osuFiles.empty()) {
+        Engine::logRaw("Usage:  stacking_bench <folder with .osu files> (default: the songs folder)\n");
+        return;
+    }
+
+    static constexpr f32 ARS[] = {5.f, 8.f, 9.3f, 10.f};
+
+    BenchCheck check("stacking_bench");
+
+    const std::atomic<bool> dead{false};
+    u64 referenceNS = 0;
+    u64 gridNS = 0;
+    u64 numObjects = 0;
+    u32 numMaps = 0;
+    f64 slowestMS = 0.0;
+    f64 slowestGridMS = 0.0;
+    std::string slowestMap;
+
+    std::vector<i32> referenceStacks;
+    std::vector<i32> gridStacks;
+    for(const auto &osuFile : osuFiles) {
+        DatabaseBeatmap::PRIMITIVE_CONTAINER c = DatabaseBeatmap::loadPrimitiveObjects(osuFile);
+        if(c.errorCode != 0) continue;
+
+        const i32 version = c.version;
+        const f32 stackLeniency = c.stackLeniency;
+        auto diffResult = DatabaseBeatmap::loadDifficultyHitObjects(c, 9.f, 4.f, 1.f, false, dead);
+        if(diffResult.errorCode != 0) continue;
+
+        const auto objects = fromDifficultyHitObjects(diffResult.diffobjects);
+        numObjects += objects.size();
+        numMaps++;
+
+        u64 mapReferenceNS = 0;
+        u64 mapGridNS = 0;
+        for(const f32 AR : ARS) {
+            const f32 approachTime = GameRules::getApproachTimeForStacking(AR);
+
+            u64 startTime = Timing::getTicksNS();
+            calculateStacksReference(objects, approachTime, stackLeniency, version, referenceStacks);
+            mapReferenceNS += Timing::getTicksNS() - startTime;
+
+            startTime = Timing::getTicksNS();
+            calculateStacksGrid(objects, approachTime, stackLeniency, version, gridStacks);
+            mapGridNS += Timing::getTicksNS() - startTime;
+
+            check.expectEqualElements(gridStacks, referenceStacks,
+                                      fmt::format("stack heights at AR {:g} in {:s}", AR, osuFile));
+        }
+        referenceNS += mapReferenceNS;
+        gridNS += mapGridNS;
+
+        const f64 mapReferenceMS = static_cast<f64>(mapReferenceNS) / 1000000.0;
+        if(mapReferenceMS > slowestMS) {
+            slowestMS = mapReferenceMS;
+            slowestGridMS = static_cast<f64>(mapGridNS) / 1000000.0;
+            slowestMap = osuFile;
+        }
+    }
+
+    const f64 referenceMS = static_cast<f64>(referenceNS) / 1000000.0;
+    const f64 gridMS = static_cast<f64>(gridNS) / 1000000.0;
+    Engine::logRaw("stacking_bench: {:d} maps, {:d} objects, {:d} ARs each\n", numMaps, numObjects, std::size(ARS));
+    Engine::logRaw("    reference: {:.3f} ms\n", referenceMS);
+    Engine::logRaw("    grid:      {:.3f} ms ({:.2f}x)\n", gridMS, referenceMS / std::max(gridMS, 1e-9));
+    if(!slowestMap.empty()) {
+        Engine::logRaw("    slowest map: {:s} (reference {:.3f} ms, grid {:.3f} ms)\n", slowestMap, slowestMS,
+                       slowestGridMS);
+    }
+    check.finish();
+}
+
+}  // namespace HitObjectStacking
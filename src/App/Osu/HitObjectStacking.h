@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Vectors.h"
+#include "types.h"
+
+#include <vector>
+
+class HitObject;
+class OsuDifficultyHitObject;
+class UString;
+
+// stack heights for Beatmap, SimulatedBeatmap and the star calculation (DatabaseBeatmap::loadDifficultyHitObjects()),
+// which used to have their own copies of the same loops.
+// both stacking algorithms walk from every object through all the other objects in the stack time window. on dense
+// streams (or with long windows) that can be hundreds of objects for every object, so once a walk gets long,
+// calculateStacksGrid() looks up the objects which are close enough to stack in a spatial hash of the start and end
+// positions and skips the rest. calculateStacksReference() is the plain version, the results are identical (see
+// stacking_bench)
+namespace HitObjectStacking {
+
+enum class TYPE : uint8_t { CIRCLE, SLIDER, SPINNER };
+
+struct Object {
+    i64 time;
+    i64 duration;
+    vec2 startPos;  // getOriginalRawPosAt(time)
+    vec2 endPos;    // getOriginalRawPosAt(time + duration)
+    TYPE type;
+};
+
+// takes the unstacked positions from getOriginalRawPosAt()
+std::vector<Object> fromHitObjects(const std::vector<HitObject *> &hitobjects);
+std::vector<Object> fromDifficultyHitObjects(std::vector<OsuDifficultyHitObject> &diffobjects);
+
+// objects have to be sorted by time (the grid falls back to the reference otherwise).
+// stacks is resized to objects.size(), the result is the stack height of every object.
+// calculateStacks() uses the grid unless stacking_grid is off
+void calculateStacks(const std::vector<Object> &objects, f32 approachTime, f32 stackLeniency, i32 version,
+                     std::vector<i32> &stacks);
+void calculateStacksGrid(const std::vector<Object> &objects, f32 approachTime, f32 stackLeniency, i32 version,
+                         std::vector<i32> &stacks);
+void calculateStacksReference(const std::vector<Object> &objects, f32 approachTime, f32 stackLeniency, i32 version,
+                              std::vector<i32> &stacks);
+
+// stacking_bench [folder]: the grid against the reference on every map in a folder (default: the songs folder)
+void bench(const UString &args);
+
+}  // namespace HitObjectStacking
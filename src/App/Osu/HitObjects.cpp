@@ -9,6 +9,7 @@
 #include "Camera.h"
 #include "ConVar.h"
 #include "Engine.h"
+#include "FrameArena.h"
 #include "GameRules.h"
 #include "HUD.h"
 #include "ModFPoSu.h"
@@ -19,7 +20,9 @@
 #include "RenderTarget.h"
 #include "ResourceManager.h"
 #include "Shader.h"
+#include "SimulationState.h"
 #include "Skin.h"
+#include "SkinAtlas.h"
 #include "SkinImage.h"
 #include "SliderCurves.h"
 #include "SliderRenderer.h"
@@ -498,6 +501,46 @@ void HitObject::onReset(long /*curPos*/) {
     this->hitresultanim2.time = -9999.0f;
 }
 
+void HitObject::saveState(SimulationState &state) const {
+    state.write<HITRESULTANIM>(this->hitresultanim1);
+    state.write<HITRESULTANIM>(this->hitresultanim2);
+    state.write<long>(this->iDelta);
+    state.write<long>(this->iApproachTime);
+    state.write<long>(this->iFadeInTime);
+    state.write<long>(this->iAutopilotDelta);
+    state.write<float>(this->fAlpha);
+    state.write<float>(this->fAlphaWithoutHidden);
+    state.write<float>(this->fAlphaForApproachCircle);
+    state.write<float>(this->fApproachScale);
+    state.write<float>(this->fHittableDimRGBColorMultiplierPercent);
+    state.write<bool>(this->bBlocked);
+    state.write<bool>(this->bOverrideHDApproachCircle);
+    state.write<bool>(this->bMisAim);
+    state.write<bool>(this->bUseFadeInTimeAsApproachTime);
+    state.write<bool>(this->bVisible);
+    state.write<bool>(this->bFinished);
+}
+
+void HitObject::loadState(SimulationState &state) {
+    this->hitresultanim1 = state.read<HITRESULTANIM>();
+    this->hitresultanim2 = state.read<HITRESULTANIM>();
+    this->iDelta = state.read<long>();
+    this->iApproachTime = state.read<long>();
+    this->iFadeInTime = state.read<long>();
+    this->iAutopilotDelta = state.read<long>();
+    this->fAlpha = state.read<float>();
+    this->fAlphaWithoutHidden = state.read<float>();
+    this->fAlphaForApproachCircle = state.read<float>();
+    this->fApproachScale = state.read<float>();
+    this->fHittableDimRGBColorMultiplierPercent = state.read<float>();
+    this->bBlocked = state.read<bool>();
+    this->bOverrideHDApproachCircle = state.read<bool>();
+    this->bMisAim = state.read<bool>();
+    this->bUseFadeInTimeAsApproachTime = state.read<bool>();
+    this->bVisible = state.read<bool>();
+    this->bFinished = state.read<bool>();
+}
+
 float HitObject::lerp3f(float a, float b, float c, float percent) {
     if(percent <= 0.5f)
         return std::lerp(a, b, percent * 2.0f);
@@ -545,9 +588,12 @@ void Circle::drawCircle(Skin *skin, vec2 pos, float hitcircleDiameter, float num
     /// drawApproachCircle(skin, pos, comboColor, hitcircleDiameter, approachScale, alpha, modHD,
     /// overrideHDApproachCircle); // they are now drawn separately in draw2()
 
+    // circle, overlay and number all come from the skin atlas (if packed), so draw them in one go
+    skin->getAtlas()->beginBatch();
+
     // circle
     const float circleImageScale = hitcircleDiameter / (128.0f * (skin->isHitCircle2x() ? 2.0f : 1.0f));
-    drawHitCircle(skin->getHitCircle(), pos, comboColor, circleImageScale, alpha);
+    drawHitCircle(skin, skin->getHitCircle(), pos, comboColor, circleImageScale, alpha);
 
     // overlay
     const float circleOverlayImageScale = hitcircleDiameter / skin->getHitCircleOverlay2()->getSizeBaseRaw().x;
@@ -560,18 +606,24 @@ void Circle::drawCircle(Skin *skin, vec2 pos, float hitcircleDiameter, float num
     // overlay
     if(skin->getHitCircleOverlayAboveNumber())
         drawHitCircleOverlay(skin->getHitCircleOverlay2(), pos, circleOverlayImageScale, alpha, colorRGBMultiplier);
+
+    skin->getAtlas()->endBatch();
 }
 
 void Circle::drawCircle(Skin *skin, vec2 pos, float hitcircleDiameter, Color color, float alpha) {
     // this function is only used by the target practice heatmap
 
+    skin->getAtlas()->beginBatch();
+
     // circle
     const float circleImageScale = hitcircleDiameter / (128.0f * (skin->isHitCircle2x() ? 2.0f : 1.0f));
-    drawHitCircle(skin->getHitCircle(), pos, color, circleImageScale, alpha);
+    drawHitCircle(skin, skin->getHitCircle(), pos, color, circleImageScale, alpha);
 
     // overlay
     const float circleOverlayImageScale = hitcircleDiameter / skin->getHitCircleOverlay2()->getSizeBaseRaw().x;
     drawHitCircleOverlay(skin->getHitCircleOverlay2(), pos, circleOverlayImageScale, alpha, 1.0f);
+
+    skin->getAtlas()->endBatch();
 }
 
 void Circle::drawSliderStartCircle(Beatmap *beatmap, vec2 rawPos, int number, int colorCounter, int colorOffset,
@@ -605,7 +657,7 @@ void Circle::drawSliderStartCircle(Skin *skin, vec2 pos, float hitcircleDiameter
 
     // circle
     const float circleImageScale = hitcircleDiameter / (128.0f * (skin->isSliderStartCircle2x() ? 2.0f : 1.0f));
-    drawHitCircle(skin->getSliderStartCircle(), pos, comboColor, circleImageScale, alpha);
+    drawHitCircle(skin, skin->getSliderStartCircle(), pos, comboColor, circleImageScale, alpha);
 
     // overlay
     const float circleOverlayImageScale = hitcircleDiameter / skin->getSliderStartCircleOverlay2()->getSizeBaseRaw().x;
@@ -657,7 +709,7 @@ void Circle::drawSliderEndCircle(Skin *skin, vec2 pos, float hitcircleDiameter,
 
     // circle
     const float circleImageScale = hitcircleDiameter / (128.0f * (skin->isSliderEndCircle2x() ? 2.0f : 1.0f));
-    drawHitCircle(skin->getSliderEndCircle(), pos, comboColor, circleImageScale, alpha);
+    drawHitCircle(skin, skin->getSliderEndCircle(), pos, comboColor, circleImageScale, alpha);
 
     // overlay
     if(skin->getSliderEndCircleOverlay() != skin->getMissingTexture()) {
@@ -707,7 +759,8 @@ void Circle::drawHitCircleOverlay(SkinImage *hitCircleOverlayImage, vec2 pos, fl
     hitCircleOverlayImage->drawRaw(pos, circleOverlayImageScale);
 }
 
-void Circle::drawHitCircle(Image *hitCircleImage, vec2 pos, Color comboColor, float circleImageScale, float alpha) {
+void Circle::drawHitCircle(Skin *skin, Image *hitCircleImage, vec2 pos, Color comboColor, float circleImageScale,
+                           float alpha) {
     g->setColor(comboColor);
 
     if(cv::circle_rainbow.getBool()) {
@@ -727,7 +780,7 @@ void Circle::drawHitCircle(Image *hitCircleImage, vec2 pos, Color comboColor, fl
     {
         g->scale(circleImageScale, circleImageScale);
         g->translate(pos.x, pos.y);
-        g->drawImage(hitCircleImage);
+        skin->getAtlas()->drawImage(hitCircleImage);
     }
     g->popTransform();
 }
@@ -767,7 +820,7 @@ void Circle::drawHitCircleNumber(Skin *skin, float numberScale, float overlapSca
     };
 
     // generate digits
-    std::vector<int> digits;
+    frame::vector<int> digits{frame::resource()};
     while(number >= 10) {
         digits.push_back(number % 10);
         number = number / 10;
@@ -797,6 +850,7 @@ void Circle::drawHitCircleNumber(Skin *skin, float numberScale, float overlapSca
     g->setAlpha(numberAlpha);
 
     // draw digits, start at correct offset
+    skin->getAtlas()->beginBatch();
     g->pushTransform();
     {
         g->scale(numberScale, numberScale);
@@ -819,34 +873,34 @@ void Circle::drawHitCircleNumber(Skin *skin, float numberScale, float overlapSca
         for(int i = digits.size() - 1; i >= 0; i--) {
             switch(digits[i]) {
                 case 0:
-                    g->drawImage(skin->getDefault0());
+                    skin->getAtlas()->drawImage(skin->getDefault0());
                     break;
                 case 1:
-                    g->drawImage(skin->getDefault1());
+                    skin->getAtlas()->drawImage(skin->getDefault1());
                     break;
                 case 2:
-                    g->drawImage(skin->getDefault2());
+                    skin->getAtlas()->drawImage(skin->getDefault2());
                     break;
                 case 3:
-                    g->drawImage(skin->getDefault3());
+                    skin->getAtlas()->drawImage(skin->getDefault3());
                     break;
                 case 4:
-                    g->drawImage(skin->getDefault4());
+                    skin->getAtlas()->drawImage(skin->getDefault4());
                     break;
                 case 5:
-                    g->drawImage(skin->getDefault5());
+                    skin->getAtlas()->drawImage(skin->getDefault5());
                     break;
                 case 6:
-                    g->drawImage(skin->getDefault6());
+                    skin->getAtlas()->drawImage(skin->getDefault6());
                     break;
                 case 7:
-                    g->drawImage(skin->getDefault7());
+                    skin->getAtlas()->drawImage(skin->getDefault7());
                     break;
                 case 8:
-                    g->drawImage(skin->getDefault8());
+                    skin->getAtlas()->drawImage(skin->getDefault8());
                     break;
                 case 9:
-                    g->drawImage(skin->getDefault9());
+                    skin->getAtlas()->drawImage(skin->getDefault9());
                     break;
             }
 
@@ -859,6 +913,7 @@ void Circle::drawHitCircleNumber(Skin *skin, float numberScale, float overlapSca
         }
     }
     g->popTransform();
+    skin->getAtlas()->endBatch();
 }
 
 Circle::Circle(int x, int y, long time, HitSamples samples, int comboNumber, bool isEndOfCombo, int colorCounter,
@@ -1078,6 +1133,22 @@ void Circle::onReset(long curPos) {
     }
 }
 
+void Circle::saveState(SimulationState &state) const {
+    HitObject::saveState(state);
+
+    state.write<bool>(this->bWaiting);
+    state.write<float>(this->fHitAnimation);
+    state.write<float>(this->fShakeAnimation);
+}
+
+void Circle::loadState(SimulationState &state) {
+    HitObject::loadState(state);
+
+    this->bWaiting = state.read<bool>();
+    this->fHitAnimation = state.read<float>();
+    this->fShakeAnimation = state.read<float>();
+}
+
 vec2 Circle::getAutoCursorPos(long /*curPos*/) const { return this->bi->osuCoords2Pixels(this->vRawPos); }
 
 Slider::Slider(char stype, int repeat, float pixelLength, std::vector<vec2> points, std::vector<float> ticks,
@@ -1357,13 +1428,11 @@ void Slider::draw() {
     bool instafade_slider_head = cv::instafade.getBool();
     if(!instafade_slider_body && this->fEndSliderBodyFadeAnimation > 0.0f &&
        this->fEndSliderBodyFadeAnimation != 1.0f && !(this->bm->getModsLegacy() & LegacyFlags::Hidden)) {
-        std::vector<vec2> emptyVector;
-        std::vector<vec2> alwaysPoints;
-        alwaysPoints.push_back(this->bm->osuCoords2Pixels(this->curve->pointAt(this->fSlidePercent)));
+        const vec2 alwaysPoints[]{this->bm->osuCoords2Pixels(this->curve->pointAt(this->fSlidePercent))};
         if(!cv::slider_shrink.getBool())
             this->drawBody(1.0f - this->fEndSliderBodyFadeAnimation, 0, 1);
         else if(cv::slider_body_lazer_fadeout_style.getBool())
-            SliderRenderer::draw(emptyVector, alwaysPoints, this->bm->fHitcircleDiameter, 0.0f, 0.0f,
+            SliderRenderer::draw(std::span<const vec2>{}, alwaysPoints, this->bm->fHitcircleDiameter, 0.0f, 0.0f,
                                  this->bm->getSkin()->getComboColorForCounter(this->iColorCounter, this->iColorOffset),
                                  1.0f, 1.0f - this->fEndSliderBodyFadeAnimation, this->click_time);
     }
@@ -1586,7 +1655,7 @@ void Slider::drawEndCircle(float /*alpha*/, float sliderSnake) {
 
 void Slider::drawBody(float alpha, float from, float to) {
     // smooth begin/end while snaking/shrinking
-    std::vector<vec2> alwaysPoints;
+    frame::vector<vec2> alwaysPoints{frame::resource()};
     if(cv::slider_body_smoothsnake.getBool()) {
         if(cv::slider_shrink.getBool() && this->fSliderSnakePercent > 0.999f) {
             alwaysPoints.push_back(this->bm->osuCoords2Pixels(this->curve->pointAt(this->fSlidePercent)));  // curpoint
@@ -1603,7 +1672,8 @@ void Slider::drawBody(float alpha, float from, float to) {
         this->bm->getSkin()->getComboColorForCounter(this->iColorCounter, this->iColorOffset);
 
     if(osu->shouldFallBackToLegacySliderRenderer()) {
-        std::vector<vec2> screenPoints = this->curve->getPoints();
+        const std::vector<vec2> &curvePoints = this->curve->getPoints();
+        frame::vector<vec2> screenPoints(curvePoints.begin(), curvePoints.end(), frame::resource());
         for(auto &screenPoint : screenPoints) {
             screenPoint = this->bm->osuCoords2Pixels(screenPoint);
         }
@@ -2437,6 +2507,81 @@ void Slider::onReset(long curPos) {
     }
 }
 
+void Slider::saveState(SimulationState &state) const {
+    HitObject::saveState(state);
+
+    // (the number of ticks/clicks never changes after loading)
+    state.writeBytes(this->ticks.data(), this->ticks.size() * sizeof(SLIDERTICK));
+    state.writeBytes(this->clicks.data(), this->clicks.size() * sizeof(SLIDERCLICK));
+
+    state.write<vec2>(this->vCurPoint);
+    state.write<vec2>(this->vCurPointRaw);
+    state.write<long>(this->iStrictTrackingModLastClickHeldTime);
+    state.write<float>(this->fSlidePercent);
+    state.write<float>(this->fActualSlidePercent);
+    state.write<float>(this->fSliderSnakePercent);
+    state.write<float>(this->fReverseArrowAlpha);
+    state.write<float>(this->fBodyAlpha);
+    state.write<float>(this->fStartHitAnimation);
+    state.write<float>(this->fEndHitAnimation);
+    state.write<float>(this->fEndSliderBodyFadeAnimation);
+    state.write<float>(this->fFollowCircleTickAnimationScale);
+    state.write<float>(this->fFollowCircleAnimationScale);
+    state.write<float>(this->fFollowCircleAnimationAlpha);
+    state.write<int>(this->iFatFingerKey);
+    state.write<int>(this->iReverseArrowPos);
+    state.write<int>(this->iCurRepeat);
+    state.write<int>(this->iCurRepeatCounterForHitSounds);
+    state.write<LiveScore::HIT>(this->startResult);
+    state.write<LiveScore::HIT>(this->endResult);
+    state.write<bool>(this->bStartFinished);
+    state.write<bool>(this->bEndFinished);
+    state.write<bool>(this->bCursorLeft);
+    state.write<bool>(this->bCursorInside);
+    state.write<bool>(this->bHeldTillEnd);
+    state.write<bool>(this->bHeldTillEndForLenienceHack);
+    state.write<bool>(this->bHeldTillEndForLenienceHackCheck);
+    state.write<bool>(this->bInReverse);
+    state.write<bool>(this->bHideNumberAfterFirstRepeatHit);
+}
+
+void Slider::loadState(SimulationState &state) {
+    HitObject::loadState(state);
+
+    state.readBytes(this->ticks.data(), this->ticks.size() * sizeof(SLIDERTICK));
+    state.readBytes(this->clicks.data(), this->clicks.size() * sizeof(SLIDERCLICK));
+
+    this->vCurPoint = state.read<vec2>();
+    this->vCurPointRaw = state.read<vec2>();
+    this->iStrictTrackingModLastClickHeldTime = state.read<long>();
+    this->fSlidePercent = state.read<float>();
+    this->fActualSlidePercent = state.read<float>();
+    this->fSliderSnakePercent = state.read<float>();
+    this->fReverseArrowAlpha = state.read<float>();
+    this->fBodyAlpha = state.read<float>();
+    this->fStartHitAnimation = state.read<float>();
+    this->fEndHitAnimation = state.read<float>();
+    this->fEndSliderBodyFadeAnimation = state.read<float>();
+    this->fFollowCircleTickAnimationScale = state.read<float>();
+    this->fFollowCircleAnimationScale = state.read<float>();
+    this->fFollowCircleAnimationAlpha = state.read<float>();
+    this->iFatFingerKey = state.read<int>();
+    this->iReverseArrowPos = state.read<int>();
+    this->iCurRepeat = state.read<int>();
+    this->iCurRepeatCounterForHitSounds = state.read<int>();
+    this->startResult = state.read<LiveScore::HIT>();
+    this->endResult = state.read<LiveScore::HIT>();
+    this->bStartFinished = state.read<bool>();
+    this->bEndFinished = state.read<bool>();
+    this->bCursorLeft = state.read<bool>();
+    this->bCursorInside = state.read<bool>();
+    this->bHeldTillEnd = state.read<bool>();
+    this->bHeldTillEndForLenienceHack = state.read<bool>();
+    this->bHeldTillEndForLenienceHackCheck = state.read<bool>();
+    this->bInReverse = state.read<bool>();
+    this->bHideNumberAfterFirstRepeatHit = state.read<bool>();
+}
+
 void Slider::rebuildVertexBuffer(bool useRawCoords) {
     // base mesh (background) (raw unscaled, size in raw osu coordinates centered at (0, 0, 0))
     // this mesh needs to be scaled and translated appropriately since we are not 1:1 with the playfield
@@ -2838,6 +2983,42 @@ void Spinner::onReset(long curPos) {
         this->bFinished = false;
 }
 
+void Spinner::saveState(SimulationState &state) const {
+    HitObject::saveState(state);
+
+    state.writeBytes(this->storedDeltaAngles, this->iMaxStoredDeltaAngles * sizeof(float));
+
+    state.write<float>(this->fPercent);
+    state.write<float>(this->fDrawRot);
+    state.write<float>(this->fRotations);
+    state.write<float>(this->fRotationsNeeded);
+    state.write<float>(this->fDeltaOverflow);
+    state.write<float>(this->fSumDeltaAngle);
+    state.write<int>(this->iDeltaAngleIndex);
+    state.write<float>(this->fDeltaAngleOverflow);
+    state.write<float>(this->fRPM);
+    state.write<float>(this->fLastMouseAngle);
+    state.write<float>(this->fRatio);
+}
+
+void Spinner::loadState(SimulationState &state) {
+    HitObject::loadState(state);
+
+    state.readBytes(this->storedDeltaAngles, this->iMaxStoredDeltaAngles * sizeof(float));
+
+    this->fPercent = state.read<float>();
+    this->fDrawRot = state.read<float>();
+    this->fRotations = state.read<float>();
+    this->fRotationsNeeded = state.read<float>();
+    this->fDeltaOverflow = state.read<float>();
+    this->fSumDeltaAngle = state.read<float>();
+    this->iDeltaAngleIndex = state.read<int>();
+    this->fDeltaAngleOverflow = state.read<float>();
+    this->fRPM = state.read<float>();
+    this->fLastMouseAngle = state.read<float>();
+    this->fRatio = state.read<float>();
+}
+
 void Spinner::onHit() {
     // calculate hit result
     LiveScore::HIT result = LiveScore::HIT::HIT_NULL;
@@ -5,6 +5,7 @@ class ConVar;
 
 class ModFPoSu;
 class Beatmap;
+class SimulationState;
 class SkinImage;
 class SliderCurve;
 class VertexArrayObject;
@@ -86,6 +87,10 @@ class HitObject {
     virtual void onClickEvent(std::vector<Click> & /*clicks*/) { ; }
     virtual void onReset(long curPos);
 
+    // everything which can change during gameplay, for SimulatedBeatmap checkpoints
+    virtual void saveState(SimulationState &state) const;
+    virtual void loadState(SimulationState &state);
+
    private:
    private:
     static float lerp3f(float a, float b, float c, float percent);
@@ -168,7 +173,8 @@ class Circle final : public HitObject {
                                    float alpha, bool modHD, bool overrideHDApproachCircle);
     static void drawHitCircleOverlay(SkinImage *hitCircleOverlayImage, vec2 pos, float circleOverlayImageScale,
                                      float alpha, float colorRGBMultiplier);
-    static void drawHitCircle(Image *hitCircleImage, vec2 pos, Color comboColor, float circleImageScale, float alpha);
+    static void drawHitCircle(Skin *skin, Image *hitCircleImage, vec2 pos, Color comboColor, float circleImageScale,
+                              float alpha);
     static void drawHitCircleNumber(Skin *skin, float numberScale, float overlapScale, vec2 pos, int number,
                                     float numberAlpha, float colorRGBMultiplier);
 
@@ -191,6 +197,9 @@ class Circle final : public HitObject {
     void onClickEvent(std::vector<Click> &clicks) override;
     void onReset(long curPos) override;
 
+    void saveState(SimulationState &state) const override;
+    void loadState(SimulationState &state) override;
+
    private:
     // necessary due to the static draw functions
     static int rainbowNumber;
@@ -243,6 +252,9 @@ class Slider final : public HitObject {
     void onClickEvent(std::vector<Click> &clicks) override;
     void onReset(long curPos) override;
 
+    void saveState(SimulationState &state) const override;
+    void loadState(SimulationState &state) override;
+
     void rebuildVertexBuffer(bool useRawCoords = false);
 
     [[nodiscard]] inline bool isStartCircleFinished() const { return this->bStartFinished; }
@@ -351,6 +363,9 @@ class Spinner final : public HitObject {
 
     void onReset(long curPos) override;
 
+    void saveState(SimulationState &state) const override;
+    void loadState(SimulationState &state) override;
+
    private:
     void onHit();
     void rotate(float rad);
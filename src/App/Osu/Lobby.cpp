@@ -265,8 +265,8 @@ void Lobby::on_create_room_clicked() {
 
     if(osu->getSelectedBeatmap() && osu->getSelectedBeatmap()->getSelectedDifficulty2()) {
         auto diff2 = osu->getSelectedBeatmap()->getSelectedDifficulty2();
-        BanchoState::room.map_name = UString::format("%s - %s [%s]", diff2->getArtist().c_str(),
-                                                     diff2->getTitle().c_str(), diff2->getDifficultyName().c_str());
+        BanchoState::room.map_name =
+            UString::fmt("{:s} - {:s} [{:s}]", diff2->getArtist(), diff2->getTitle(), diff2->getDifficultyName());
         BanchoState::room.map_md5 = diff2->getMD5Hash();
         BanchoState::room.map_id = diff2->getID();
     }
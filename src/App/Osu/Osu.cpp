@@ -791,6 +791,7 @@ void Osu::update() {
         VPROF_BUDGET_DBG("Bancho::recvpkt", VPROF_BUDGETGROUP_UPDATE);
         BANCHO::Net::receive_bancho_packets();
     }
+    cvars->updateMultiplayerState();
 
     // skin async loading
     if(this->bSkinLoadScheduled) {
@@ -1302,8 +1303,8 @@ void Osu::toggleSongBrowser() {
         // We didn't select a map; revert to previously selected one
         auto diff2 = this->songBrowser2->lastSelectedBeatmap;
         if(diff2 != nullptr) {
-            BanchoState::room.map_name = UString::format("%s - %s [%s]", diff2->getArtist().c_str(),
-                                                    diff2->getTitle().c_str(), diff2->getDifficultyName().c_str());
+            BanchoState::room.map_name =
+                UString::fmt("{:s} - {:s} [{:s}]", diff2->getArtist(), diff2->getTitle(), diff2->getDifficultyName());
             BanchoState::room.map_md5 = diff2->getMD5Hash();
             BanchoState::room.map_id = diff2->getID();
 
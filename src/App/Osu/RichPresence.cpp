@@ -47,11 +47,11 @@ void diff2str(DatabaseBeatmap* diff2, char* output, bool /*include_difficulty*/)
     }
 
     UString playingInfo;
-    playingInfo.append(diff2->getArtist().c_str());
+    playingInfo.append(UString{diff2->getArtist()});
     playingInfo.append(" - ");
-    playingInfo.append(diff2->getTitle().c_str());
+    playingInfo.append(UString{diff2->getTitle()});
 
-    auto diffStr = UString::format(" [%s]", diff2->getDifficultyName().c_str());
+    auto diffStr = UString::fmt(" [{:s}]", diff2->getDifficultyName());
     if(playingInfo.lengthUtf8() + diffStr.lengthUtf8() < 128) {
         playingInfo.append(diffStr);
     }
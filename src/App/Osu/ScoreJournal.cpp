@@ -0,0 +1,343 @@
+#include "ScoreJournal.h"
+
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+#include "BanchoProtocol.h"
+#include "Database.h"
+#include "Engine.h"
+#include "UString.h"
+#include "crypto.h"
+
+using namespace BANCHO::Proto;
+
+namespace {  // static namespace
+
+constexpr const u8 JOURNAL_MAGIC[5]{'N', 'E', 'O', 'S', 'J'};
+constexpr const size_t HEADER_SIZE{sizeof(JOURNAL_MAGIC) + sizeof(u32)};
+constexpr const size_t RECORD_HEADER_SIZE{sizeof(u8) + sizeof(u32) + sizeof(u32)};
+
+std::filesystem::path to_fs_path(const std::string &path) { return {UString(path).plat_str()}; }
+
+// same fields as in neosu_scores.db
+void write_score(Packet *packet, const FinishedScore &score) {
+    write_hash(packet, score.beatmap_hash);
+
+    write_mods(packet, score.mods);
+    write<u64>(packet, score.score);
+    write<u64>(packet, score.spinner_bonus);
+    write<u64>(packet, score.unixTimestamp);
+    write<i32>(packet, score.player_id);
+    write_string(packet, score.playerName.c_str());
+    write<u8>(packet, (u8)score.grade);
+
+    write_string(packet, score.client.c_str());
+    write_string(packet, score.server.c_str());
+    write<i64>(packet, score.bancho_score_id);
+    write<u64>(packet, score.peppy_replay_tms);
+
+    write<u16>(packet, score.num300s);
+    write<u16>(packet, score.num100s);
+    write<u16>(packet, score.num50s);
+    write<u16>(packet, score.numGekis);
+    write<u16>(packet, score.numKatus);
+    write<u16>(packet, score.numMisses);
+    write<u16>(packet, score.comboMax);
+
+    write<u32>(packet, score.ppv2_version);
+    write<f32>(packet, score.ppv2_score);
+    write<f32>(packet, score.ppv2_total_stars);
+    write<f32>(packet, score.ppv2_aim_stars);
+    write<f32>(packet, score.ppv2_speed_stars);
+
+    write<u16>(packet, score.numSliderBreaks);
+    write<f32>(packet, score.unstableRate);
+    write<f32>(packet, score.hitErrorAvgMin);
+    write<f32>(packet, score.hitErrorAvgMax);
+    write<u32>(packet, score.maxPossibleCombo);
+    write<u32>(packet, score.numHitObjects);
+    write<u32>(packet, score.numCircles);
+}
+
+void read_score(Packet *packet, FinishedScore &score) {
+    score.beatmap_hash = read_hash(packet);
+
+    score.mods = read_mods(packet);
+    score.score = read<u64>(packet);
+    score.spinner_bonus = read<u64>(packet);
+    score.unixTimestamp = read<u64>(packet);
+    score.player_id = read<i32>(packet);
+    score.playerName = read_stdstring(packet);
+    score.grade = (FinishedScore::Grade)read<u8>(packet);
+
+    score.client = read_stdstring(packet);
+    score.server = read_stdstring(packet);
+    score.bancho_score_id = read<i64>(packet);
+    score.peppy_replay_tms = read<u64>(packet);
+
+    score.num300s = read<u16>(packet);
+    score.num100s = read<u16>(packet);
+    score.num50s = read<u16>(packet);
+    score.numGekis = read<u16>(packet);
+    score.numKatus = read<u16>(packet);
+    score.numMisses = read<u16>(packet);
+    score.comboMax = read<u16>(packet);
+
+    score.ppv2_version = read<u32>(packet);
+    score.ppv2_score = read<f32>(packet);
+    score.ppv2_total_stars = read<f32>(packet);
+    score.ppv2_aim_stars = read<f32>(packet);
+    score.ppv2_speed_stars = read<f32>(packet);
+
+    score.numSliderBreaks = read<u16>(packet);
+    score.unstableRate = read<f32>(packet);
+    score.hitErrorAvgMin = read<f32>(packet);
+    score.hitErrorAvgMax = read<f32>(packet);
+    score.maxPossibleCombo = read<u32>(packet);
+    score.numHitObjects = read<u32>(packet);
+    score.numCircles = read<u32>(packet);
+}
+
+void write_pp(Packet *packet, const FinishedScore &score) {
+    write_hash(packet, score.beatmap_hash);
+    write<u64>(packet, score.unixTimestamp);
+    write<u32>(packet, score.ppv2_version);
+    write<f32>(packet, score.ppv2_score);
+    write<f32>(packet, score.ppv2_total_stars);
+    write<f32>(packet, score.ppv2_aim_stars);
+    write<f32>(packet, score.ppv2_speed_stars);
+}
+
+void read_pp(Packet *packet, FinishedScore &score) {
+    score.beatmap_hash = read_hash(packet);
+    score.unixTimestamp = read<u64>(packet);
+    score.ppv2_version = read<u32>(packet);
+    score.ppv2_score = read<f32>(packet);
+    score.ppv2_total_stars = read<f32>(packet);
+    score.ppv2_aim_stars = read<f32>(packet);
+    score.ppv2_speed_stars = read<f32>(packet);
+}
+
+}  // namespace
+
+ScoreJournal::ScoreJournal(std::string path) : path(std::move(path)) {}
+
+ScoreJournal::~ScoreJournal() {
+    std::scoped_lock lock(this->mtx);
+    if(this->file.is_open()) this->file.close();
+}
+
+bool ScoreJournal::add(const FinishedScore &score) {
+    Packet payload;
+    write_score(&payload, score);
+    const bool ok = this->append(RecordType::ADD, {&payload, 1});
+    free(payload.memory);
+    return ok;
+}
+
+bool ScoreJournal::remove(const MD5Hash &beatmap_hash, u64 unixTimestamp) {
+    Packet payload;
+    write_hash(&payload, beatmap_hash);
+    write<u64>(&payload, unixTimestamp);
+    const bool ok = this->append(RecordType::REMOVE, {&payload, 1});
+    free(payload.memory);
+    return ok;
+}
+
+bool ScoreJournal::update_pp(std::span<const FinishedScore> scores) {
+    std::vector<Packet> payloads(scores.size());
+    for(size_t i = 0; i < scores.size(); i++) {
+        write_pp(&payloads[i], scores[i]);
+    }
+    const bool ok = this->append(RecordType::PP_UPDATE, payloads);
+    for(Packet &payload : payloads) {
+        free(payload.memory);
+    }
+    return ok;
+}
+
+bool ScoreJournal::open_for_append() {
+    if(this->file.is_open()) return true;
+
+    const auto fs_path = to_fs_path(this->path);
+
+    std::error_code ec;
+    const auto existing_size = std::filesystem::file_size(fs_path, ec);
+    const bool is_new = ec || existing_size < HEADER_SIZE;
+
+    this->file.open(fs_path, std::ios::binary | (is_new ? std::ios::trunc : std::ios::app));
+    if(!this->file.is_open()) {
+        debugLog("Failed to open '{:s}' for writing\n", this->path);
+        return false;
+    }
+
+    if(is_new) {
+        const u32 version = NEOSU_SCORE_DB_VERSION;
+        this->file.write(reinterpret_cast<const char *>(JOURNAL_MAGIC), sizeof(JOURNAL_MAGIC));
+        this->file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    }
+
+    return this->file.good();
+}
+
+bool ScoreJournal::append(RecordType type, std::span<const Packet> payloads) {
+    if(payloads.empty()) return true;
+    for(const Packet &payload : payloads) {
+        if(payload.memory == nullptr) return false;
+    }
+
+    const u8 type_byte = static_cast<u8>(type);
+
+    std::scoped_lock lock(this->mtx);
+    if(!this->open_for_append()) return false;
+
+    for(const Packet &payload : payloads) {
+        const u32 size = payload.pos;
+        const u32 crc = crypto::hash::crc32(payload.memory, payload.pos);
+
+        this->file.write(reinterpret_cast<const char *>(&type_byte), sizeof(type_byte));
+        this->file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+        this->file.write(reinterpret_cast<const char *>(&crc), sizeof(crc));
+        this->file.write(reinterpret_cast<const char *>(payload.memory), payload.pos);
+    }
+    this->file.flush();
+
+    if(!this->file.good()) {
+        debugLog("Failed to write to '{:s}'\n", this->path);
+        this->file.close();
+        return false;
+    }
+
+    this->num_records += payloads.size();
+    return true;
+}
+
+u32 ScoreJournal::replay(const std::string &path, const std::function<void(const Record &)> &callback,
+                         size_t *valid_size) {
+    if(valid_size != nullptr) *valid_size = 0;
+
+    std::ifstream in(to_fs_path(path), std::ios::binary | std::ios::ate);
+    if(!in.is_open()) return 0;
+
+    const auto file_size = static_cast<size_t>(in.tellg());
+    if(file_size < HEADER_SIZE) return 0;
+
+    std::vector<u8> data(file_size);
+    in.seekg(0, std::ios::beg);
+    in.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(file_size));
+    if(static_cast<size_t>(in.gcount()) != file_size) return 0;
+
+    u32 version = 0;
+    memcpy(&version, data.data() + sizeof(JOURNAL_MAGIC), sizeof(version));
+    if(memcmp(data.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || version != NEOSU_SCORE_DB_VERSION) {
+        debugLog("Ignoring '{:s}' (invalid header or version {:d})\n", path, version);
+        return 0;
+    }
+
+    u32 nb_records = 0;
+    size_t pos = HEADER_SIZE;
+    while(pos + RECORD_HEADER_SIZE <= file_size) {
+        u8 type_byte = 0;
+        u32 size = 0;
+        u32 crc = 0;
+        memcpy(&type_byte, data.data() + pos, sizeof(type_byte));
+        memcpy(&size, data.data() + pos + sizeof(type_byte), sizeof(size));
+        memcpy(&crc, data.data() + pos + sizeof(type_byte) + sizeof(size), sizeof(crc));
+
+        u8 *payload_start = data.data() + pos + RECORD_HEADER_SIZE;
+        if(size > file_size - pos - RECORD_HEADER_SIZE || crypto::hash::crc32(payload_start, size) != crc) break;
+
+        Packet payload;
+        payload.memory = payload_start;
+        payload.size = size;
+
+        Record record{.type = static_cast<RecordType>(type_byte), .score = {}};
+        switch(record.type) {
+            case RecordType::ADD:
+                read_score(&payload, record.score);
+                break;
+            case RecordType::REMOVE:
+                record.score.beatmap_hash = read_hash(&payload);
+                record.score.unixTimestamp = read<u64>(&payload);
+                break;
+            case RecordType::PP_UPDATE:
+                read_pp(&payload, record.score);
+                break;
+            default:
+                payload.pos = payload.size + 1;  // unknown record type
+                break;
+        }
+
+        // checksum was fine, but the payload doesn't match the record type
+        if(payload.pos > payload.size) break;
+
+        callback(record);
+        nb_records++;
+        pos += RECORD_HEADER_SIZE + size;
+    }
+
+    if(pos < file_size) {
+        debugLog("'{:s}' is corrupted after {:d} records ({:d} bytes), ignoring the rest\n", path, nb_records,
+                 file_size - pos);
+    }
+
+    if(valid_size != nullptr) *valid_size = pos;
+    return nb_records;
+}
+
+u32 ScoreJournal::load(const std::function<void(const Record &)> &callback) {
+    std::scoped_lock lock(this->mtx);
+    if(this->file.is_open()) this->file.close();
+
+    size_t valid_size = 0;
+    this->num_records = ScoreJournal::replay(this->path, callback, &valid_size);
+
+    std::error_code ec;
+    const auto fs_path = to_fs_path(this->path);
+    const auto file_size = std::filesystem::file_size(fs_path, ec);
+    if(!ec && valid_size < file_size) {
+        if(valid_size < HEADER_SIZE)
+            std::filesystem::remove(fs_path, ec);
+        else
+            std::filesystem::resize_file(fs_path, valid_size, ec);
+    }
+
+    return this->num_records;
+}
+
+bool ScoreJournal::rotate(const std::string &to_path) {
+    std::scoped_lock lock(this->mtx);
+    if(this->file.is_open()) this->file.close();
+
+    std::error_code ec;
+    const auto fs_path = to_fs_path(this->path);
+    if(!std::filesystem::exists(fs_path, ec)) {
+        this->num_records = 0;
+        return true;
+    }
+
+    std::filesystem::remove(to_fs_path(to_path), ec);  // Windows
+    std::filesystem::rename(fs_path, to_fs_path(to_path), ec);
+    if(ec) {
+        debugLog("Failed to move '{:s}' to '{:s}': {:s}\n", this->path, to_path, ec.message());
+        return false;
+    }
+
+    this->num_records = 0;
+    return true;
+}
+
+void ScoreJournal::clear() {
+    std::scoped_lock lock(this->mtx);
+    if(this->file.is_open()) this->file.close();
+
+    std::error_code ec;
+    std::filesystem::remove(to_fs_path(this->path), ec);
+    this->num_records = 0;
+}
+
+u32 ScoreJournal::get_num_records() {
+    std::scoped_lock lock(this->mtx);
+    return this->num_records;
+}
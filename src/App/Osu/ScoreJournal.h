@@ -0,0 +1,71 @@
+#pragma once
+
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+
+#include "score.h"
+
+struct Packet;
+
+// append-only log of changes to neosu_scores.db, so that saving a score doesn't mean rewriting the whole database.
+// replayed on top of neosu_scores.db when loading, and folded back into it (compacted) by Database::saveScores()
+//
+// file layout: "NEOSJ", u32 NEOSU_SCORE_DB_VERSION, then records of
+//     u8 type, u32 payload size, u32 payload crc32, payload
+// a record which fails its checksum (e.g. crashed mid-write) ends the journal
+class ScoreJournal final {
+    NOCOPY_NOMOVE(ScoreJournal)
+   public:
+    enum class RecordType : u8 {
+        ADD = 1,
+        REMOVE = 2,
+        PP_UPDATE = 3,
+    };
+
+    struct Record {
+        RecordType type;
+
+        // ADD: the whole score
+        // REMOVE: only beatmap_hash and unixTimestamp
+        // PP_UPDATE: beatmap_hash, unixTimestamp and the ppv2_* fields
+        FinishedScore score;
+    };
+
+    ScoreJournal(std::string path);
+    ~ScoreJournal();
+
+    bool add(const FinishedScore &score);
+    bool remove(const MD5Hash &beatmap_hash, u64 unixTimestamp);
+    // all records are written in one go (for the score converter, which recalculates whole databases)
+    bool update_pp(std::span<const FinishedScore> scores);
+
+    // reads all records into `callback`, and cuts off anything after the last intact one (so that new records don't
+    // end up behind garbage). returns the number of records read
+    u32 load(const std::function<void(const Record &)> &callback);
+
+    // moves all records written so far to `to_path` (e.g. while they're being compacted), new records go into a fresh
+    // journal
+    bool rotate(const std::string &to_path);
+
+    // drops all records, once they're part of neosu_scores.db
+    void clear();
+
+    [[nodiscard]] inline const std::string &get_path() const { return this->path; }
+    [[nodiscard]] u32 get_num_records();
+
+    // for rotated journals, doesn't modify the file
+    static u32 replay(const std::string &path, const std::function<void(const Record &)> &callback,
+                      size_t *valid_size = nullptr);
+
+   private:
+    bool append(RecordType type, std::span<const Packet> payloads);
+    bool open_for_append();
+
+    std::mutex mtx;
+    std::string path;
+    std::ofstream file;
+    u32 num_records{0};
+};
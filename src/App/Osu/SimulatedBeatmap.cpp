@@ -1,12 +1,17 @@
 #include "SimulatedBeatmap.h"
 
 #include <algorithm>
+#include <limits>
+#include <random>
 
+#include "BenchCheck.h"
 #include "DatabaseBeatmap.h"
 #include "DifficultyCalculator.h"
+#include "DrainRate.h"
 #include "Engine.h"
 #include "Environment.h"
 #include "GameRules.h"
+#include "HitObjectStacking.h"
 #include "HitObjects.h"
 #include "KeyBindings.h"
 #include "Keyboard.h"
@@ -41,6 +46,15 @@ SimulatedBeatmap::SimulatedBeatmap(DatabaseBeatmap *diff2, Replay::Mods mods_) {
     this->fSliderFollowCircleDiameter = 0.0f;
 
     this->start();
+
+    for(const HitObject *hitobject : this->hitobjects) {
+        this->initial_object_offsets.push_back(this->initial_objects.size());
+        hitobject->saveState(this->initial_objects);
+    }
+    this->initial_objects.shrink();
+
+    this->saveCheckpoint();
+    this->checkpoints.back().music_pos = std::numeric_limits<i32>::min();
 }
 
 SimulatedBeatmap::~SimulatedBeatmap() {
@@ -103,9 +117,130 @@ void SimulatedBeatmap::simulate_to(i32 music_pos) {
         this->iCurMusicPos = current_frame.cur_music_pos;
 
         this->update(frame_time);
+
+        if(this->iCurMusicPos >= this->iNextCheckpointTime) this->saveCheckpoint();
     }
 }
 
+void SimulatedBeatmap::rewind_to(i32 music_pos) {
+    auto it = std::ranges::upper_bound(this->checkpoints, music_pos, {}, &Checkpoint::music_pos);
+    if(it != this->checkpoints.begin()) --it;  // (the first one is always at or before music_pos)
+
+    this->loadCheckpoint(*it);
+}
+
+void SimulatedBeatmap::saveCheckpoint() {
+    const i32 interval = cv::simulate_replays_checkpoint_interval.getInt();
+
+    // already have this one from before the last rewind
+    if(!this->checkpoints.empty() && this->checkpoints.back().music_pos >= this->iCurMusicPos) {
+        this->iNextCheckpointTime = interval > 0 ? this->iCurMusicPos + interval : std::numeric_limits<i32>::max();
+        return;
+    }
+
+    // same condition as the "past objects" check in update(), those are skipped from then on
+    const long pvs = this->getPVS();
+    i32 first_object = 0;
+    while(first_object < this->iTouchedObjectsEnd) {
+        const HitObject *hitobject = this->hitobjects[first_object];
+        if(!hitobject->isFinished() || this->iCurMusicPos - pvs <= hitobject->click_time + hitobject->duration) break;
+        first_object++;
+    }
+
+    Checkpoint &checkpoint = this->checkpoints.emplace_back(Checkpoint{.music_pos = this->iCurMusicPos,
+                                                                       .first_object = first_object,
+                                                                       .last_object = this->iTouchedObjectsEnd,
+                                                                       .live_score = this->live_score,
+                                                                       .state = {}});
+    SimulationState &state = checkpoint.state;
+
+    state.write<u8>(this->current_keys);
+    state.write<u8>(this->last_keys);
+    state.write<vec2>(this->interpolatedMousePos);
+    state.write<long>(this->current_frame_idx);
+    state.write<i32>(this->iCurMusicPos);
+    state.write<bool>(this->bFailed);
+    state.write<f64>(this->fHealth);
+    state.write<bool>(this->bInBreak);
+    state.write<i32>(this->iNextHitObjectTime);
+    state.write<i32>(this->iPreviousHitObjectTime);
+    state.write<i32>(this->iAllowAnyNextKeyForFullAlternateUntilHitObjectIndex);
+    state.write<size_t>(this->clicks.size());
+    state.writeBytes(this->clicks.data(), this->clicks.size() * sizeof(Click));
+    state.write<i32>(this->iNPS);
+    state.write<i32>(this->iND);
+    state.write<i32>(this->iCurrentHitObjectIndex);
+    state.write<i32>(this->iCurrentNumCircles);
+    state.write<i32>(this->iCurrentNumSliders);
+    state.write<i32>(this->iCurrentNumSpinners);
+    state.write<bool>(this->bIsSpinnerActive);
+    state.write<vec2>(this->vContinueCursorPoint);
+    state.write<float>(this->fPlayfieldRotation);
+    state.write<vec2>(this->vAutoCursorPos);
+    state.write<bool>(this->bPrevKeyWasKey1);
+    state.write<bool>(this->holding_slider);
+    state.write<u32>(this->iMaxPossibleCombo);
+    state.write<u32>(this->iScoreV2ComboPortionMaximum);
+
+    for(i32 i = first_object; i < this->iTouchedObjectsEnd; i++) {
+        this->hitobjects[i]->saveState(state);
+    }
+    state.shrink();
+
+    this->iNextCheckpointTime = interval > 0 ? this->iCurMusicPos + interval : std::numeric_limits<i32>::max();
+}
+
+void SimulatedBeatmap::loadCheckpoint(Checkpoint &checkpoint) {
+    SimulationState &state = checkpoint.state;
+    state.seek(0);
+
+    this->current_keys = state.read<u8>();
+    this->last_keys = state.read<u8>();
+    this->interpolatedMousePos = state.read<vec2>();
+    this->current_frame_idx = state.read<long>();
+    this->iCurMusicPos = state.read<i32>();
+    this->bFailed = state.read<bool>();
+    this->fHealth = state.read<f64>();
+    this->bInBreak = state.read<bool>();
+    this->iNextHitObjectTime = state.read<i32>();
+    this->iPreviousHitObjectTime = state.read<i32>();
+    this->iAllowAnyNextKeyForFullAlternateUntilHitObjectIndex = state.read<i32>();
+    this->clicks.resize(state.read<size_t>());
+    state.readBytes(this->clicks.data(), this->clicks.size() * sizeof(Click));
+    this->iNPS = state.read<i32>();
+    this->iND = state.read<i32>();
+    this->iCurrentHitObjectIndex = state.read<i32>();
+    this->iCurrentNumCircles = state.read<i32>();
+    this->iCurrentNumSliders = state.read<i32>();
+    this->iCurrentNumSpinners = state.read<i32>();
+    this->bIsSpinnerActive = state.read<bool>();
+    this->vContinueCursorPoint = state.read<vec2>();
+    this->fPlayfieldRotation = state.read<float>();
+    this->vAutoCursorPos = state.read<vec2>();
+    this->bPrevKeyWasKey1 = state.read<bool>();
+    this->holding_slider = state.read<bool>();
+    this->iMaxPossibleCombo = state.read<u32>();
+    this->iScoreV2ComboPortionMaximum = state.read<u32>();
+
+    for(i32 i = checkpoint.first_object; i < checkpoint.last_object; i++) {
+        this->hitobjects[i]->loadState(state);
+    }
+
+    // everything after that was still untouched back then
+    for(i32 i = checkpoint.last_object; i < this->iTouchedObjectsEnd; i++) {
+        this->initial_objects.seek(this->initial_object_offsets[i]);
+        this->hitobjects[i]->loadState(this->initial_objects);
+    }
+
+    this->live_score = checkpoint.live_score;
+    this->currentHitObject = nullptr;
+    this->iTouchedObjectsEnd = checkpoint.last_object;
+
+    const i32 interval = cv::simulate_replays_checkpoint_interval.getInt();
+    this->iNextCheckpointTime =
+        interval > 0 ? std::max(checkpoint.music_pos, this->iCurMusicPos) + interval : std::numeric_limits<i32>::max();
+}
+
 bool SimulatedBeatmap::start() {
     // reset everything, including deleting any previously loaded hitobjects from another diff which we might just have
     // played
@@ -511,6 +646,7 @@ void SimulatedBeatmap::update(f64 frame_time) {
 
             // main hitobject update
             this->hitobjects[i]->update(this->iCurMusicPos, frame_time);
+            this->iTouchedObjectsEnd = std::max(this->iTouchedObjectsEnd, i + 1);
 
             // spinner visibility detection
             // XXX: there might be a "better" way to do it?
@@ -896,12 +1032,6 @@ void SimulatedBeatmap::calculateStacks() {
 
     debugLog("Beatmap: Calculating stacks ...\n");
 
-    // reset
-    for(auto &hitobject : this->hitobjects) {
-        hitobject->setStack(0);
-    }
-
-    const f32 STACK_LENIENCE = 3.0f;
     const f32 STACK_OFFSET = 0.05f;
 
     const f32 approachTime =
@@ -909,112 +1039,11 @@ void SimulatedBeatmap::calculateStacks() {
                                       GameRules::getMaxApproachTime());
     const f32 stackLeniency = this->selectedDifficulty2->getStackLeniency();
 
-    if(this->selectedDifficulty2->getVersion() > 5) {
-        // peppy's algorithm
-        // https://gist.github.com/peppy/1167470
-
-        for(int i = this->hitobjects.size() - 1; i >= 0; i--) {
-            int n = i;
-
-            HitObject *objectI = this->hitobjects[i];
-
-            bool isSpinner = dynamic_cast<Spinner *>(objectI) != nullptr;
-
-            if(objectI->getStack() != 0 || isSpinner) continue;
-
-            bool isHitCircle = dynamic_cast<Circle *>(objectI) != nullptr;
-            bool isSlider = dynamic_cast<Slider *>(objectI) != nullptr;
-
-            if(isHitCircle) {
-                while(--n >= 0) {
-                    HitObject *objectN = this->hitobjects[n];
-
-                    bool isSpinnerN = dynamic_cast<Spinner *>(objectN);
-
-                    if(isSpinnerN) continue;
-
-                    if(objectI->click_time - (approachTime * stackLeniency) > (objectN->click_time + objectN->duration))
-                        break;
-
-                    vec2 objectNEndPosition = objectN->getOriginalRawPosAt(objectN->click_time + objectN->duration);
-                    if(objectN->duration != 0 &&
-                       vec::length(objectNEndPosition - objectI->getOriginalRawPosAt(objectI->click_time)) <
-                           STACK_LENIENCE) {
-                        int offset = objectI->getStack() - objectN->getStack() + 1;
-                        for(int j = n + 1; j <= i; j++) {
-                            if(vec::length(objectNEndPosition - this->hitobjects[j]->getOriginalRawPosAt(
-                                                                    this->hitobjects[j]->click_time)) < STACK_LENIENCE)
-                                this->hitobjects[j]->setStack(this->hitobjects[j]->getStack() - offset);
-                        }
-
-                        break;
-                    }
-
-                    if(vec::length(objectN->getOriginalRawPosAt(objectN->click_time) -
-                                   objectI->getOriginalRawPosAt(objectI->click_time)) < STACK_LENIENCE) {
-                        objectN->setStack(objectI->getStack() + 1);
-                        objectI = objectN;
-                    }
-                }
-            } else if(isSlider) {
-                while(--n >= 0) {
-                    HitObject *objectN = this->hitobjects[n];
-
-                    bool isSpinner = dynamic_cast<Spinner *>(objectN) != nullptr;
-
-                    if(isSpinner) continue;
-
-                    if(objectI->click_time - (approachTime * stackLeniency) > objectN->click_time) break;
-
-                    if(vec::length((objectN->duration != 0
-                                        ? objectN->getOriginalRawPosAt(objectN->click_time + objectN->duration)
-                                        : objectN->getOriginalRawPosAt(objectN->click_time)) -
-                                   objectI->getOriginalRawPosAt(objectI->click_time)) < STACK_LENIENCE) {
-                        objectN->setStack(objectI->getStack() + 1);
-                        objectI = objectN;
-                    }
-                }
-            }
-        }
-    } else  // getSelectedDifficulty()->version < 6
-    {
-        // old stacking algorithm for old beatmaps
-        // https://github.com/ppy/osu/blob/master/osu.Game.Rulesets.Osu/Beatmaps/BeatmapProcessor.cs
-
-        for(int i = 0; i < this->hitobjects.size(); i++) {
-            HitObject *currHitObject = this->hitobjects[i];
-            auto *sliderPointer = dynamic_cast<Slider *>(currHitObject);
-
-            const bool isSlider = (sliderPointer != nullptr);
-
-            if(currHitObject->getStack() != 0 && !isSlider) continue;
-
-            long startTime = currHitObject->click_time + currHitObject->duration;
-            int sliderStack = 0;
-
-            for(int j = i + 1; j < this->hitobjects.size(); j++) {
-                HitObject *objectJ = this->hitobjects[j];
-
-                if(objectJ->click_time - (approachTime * stackLeniency) > startTime) break;
-
-                // "The start position of the hitobject, or the position at the end of the path if the hitobject is a
-                // slider"
-                vec2 position2 =
-                    isSlider ? sliderPointer->getOriginalRawPosAt(sliderPointer->click_time + sliderPointer->duration)
-                             : currHitObject->getOriginalRawPosAt(currHitObject->click_time);
-
-                if(vec::length(objectJ->getOriginalRawPosAt(objectJ->click_time) -
-                               currHitObject->getOriginalRawPosAt(currHitObject->click_time)) < 3) {
-                    currHitObject->setStack(currHitObject->getStack() + 1);
-                    startTime = objectJ->click_time + objectJ->duration;
-                } else if(vec::length(objectJ->getOriginalRawPosAt(objectJ->click_time) - position2) < 3) {
-                    // "Case for sliders - bump notes down and right, rather than up and left."
-                    sliderStack++;
-                    objectJ->setStack(objectJ->getStack() - sliderStack);
-                    startTime = objectJ->click_time + objectJ->duration;
-                }
-            }
-        }
+    std::vector<i32> stacks;
+    HitObjectStacking::calculateStacks(HitObjectStacking::fromHitObjects(this->hitobjects), approachTime,
+                                       stackLeniency, this->selectedDifficulty2->getVersion(), stacks);
+    for(size_t i = 0; i < this->hitobjects.size(); i++) {
+        this->hitobjects[i]->setStack(stacks[i]);
     }
 
     // update hitobject positions
@@ -1029,215 +1058,22 @@ void SimulatedBeatmap::computeDrainRate() {
     this->fHpMultiplierNormal = 1.0;
     this->fHpMultiplierComboEnd = 1.0;
 
-    if(this->hitobjects.size() < 1) return;
+    if(this->hitobjects.size() < 1 || this->selectedDifficulty2 == nullptr) return;
 
     debugLog("Beatmap: Calculating drain ...\n");
 
-    {
-        // see https://github.com/ppy/osu-iPhone/blob/master/Classes/OsuPlayer.m
-        // see calcHPDropRate() @ https://github.com/ppy/osu-iPhone/blob/master/Classes/OsuFiletype.m#L661
-
-        // NOTE: all drain changes between 2014 and today have been fixed here (the link points to an old version of the
-        // algorithm!) these changes include: passive spinner nerf (drain * 0.25 while spinner is active), and clamping
-        // the object length drain to 0 + an extra check for that (see maxLongObjectDrop) see
-        // https://osu.ppy.sh/home/changelog/stable40/20190513.2
-
-        struct TestPlayer {
-            TestPlayer(f64 hpBarMaximum) {
-                this->hpBarMaximum = hpBarMaximum;
-
-                this->hpMultiplierNormal = 1.0;
-                this->hpMultiplierComboEnd = 1.0;
-
-                this->resetHealth();
-            }
-
-            void resetHealth() {
-                this->health = this->hpBarMaximum;
-                this->healthUncapped = this->hpBarMaximum;
-            }
-
-            void increaseHealth(f64 amount) {
-                this->healthUncapped += amount;
-                this->health += amount;
-
-                if(this->health > this->hpBarMaximum) this->health = this->hpBarMaximum;
-
-                if(this->health < 0.0) this->health = 0.0;
-
-                if(this->healthUncapped < 0.0) this->healthUncapped = 0.0;
-            }
-
-            void decreaseHealth(f64 amount) {
-                this->health -= amount;
-
-                if(this->health < 0.0) this->health = 0.0;
-
-                if(this->health > this->hpBarMaximum) this->health = this->hpBarMaximum;
-
-                this->healthUncapped -= amount;
-
-                if(this->healthUncapped < 0.0) this->healthUncapped = 0.0;
-            }
-
-            f64 hpBarMaximum;
-
-            f64 health;
-            f64 healthUncapped;
-
-            f64 hpMultiplierNormal;
-            f64 hpMultiplierComboEnd;
-        };
-        TestPlayer testPlayer(200.f);
-
-        const f64 HP = this->getHP();
-        const int version = this->selectedDifficulty2->getVersion();
-
-        f64 testDrop = 0.05;
-
-        const f64 lowestHpEver = GameRules::mapDifficultyRange(HP, 195.0, 160.0, 60.0);
-        const f64 lowestHpComboEnd = GameRules::mapDifficultyRange(HP, 198.0, 170.0, 80.0);
-        const f64 lowestHpEnd = GameRules::mapDifficultyRange(HP, 198.0, 180.0, 80.0);
-        const f64 HpRecoveryAvailable = GameRules::mapDifficultyRange(HP, 8.0, 4.0, 0.0);
-
-        bool fail = false;
-
-        do {
-            testPlayer.resetHealth();
-
-            f64 lowestHp = testPlayer.health;
-            int lastTime = (int)(this->hitobjects[0]->click_time - (long)this->getApproachTime());
-            fail = false;
-
-            const int breakCount = this->breaks.size();
-            int breakNumber = 0;
-
-            int comboTooLowCount = 0;
-
-            for(int i = 0; i < this->hitobjects.size(); i++) {
-                const HitObject *h = this->hitobjects[i];
-                const auto *sliderPointer = dynamic_cast<const Slider *>(h);
-                const auto *spinnerPointer = dynamic_cast<const Spinner *>(h);
-
-                const int localLastTime = lastTime;
-
-                int breakTime = 0;
-                if(breakCount > 0 && breakNumber < breakCount) {
-                    const DatabaseBeatmap::BREAK &e = this->breaks[breakNumber];
-                    if(e.startTime >= localLastTime && e.endTime <= h->click_time) {
-                        // consider break start equal to object end time for version 8+ since drain stops during this
-                        // time
-                        breakTime = (version < 8) ? (e.endTime - e.startTime) : (e.endTime - localLastTime);
-                        breakNumber++;
-                    }
-                }
-
-                testPlayer.decreaseHealth(testDrop * (h->click_time - lastTime - breakTime));
-
-                lastTime = (int)(h->click_time + h->duration);
-
-                if(testPlayer.health < lowestHp) lowestHp = testPlayer.health;
-
-                if(testPlayer.health > lowestHpEver) {
-                    const f64 longObjectDrop = testDrop * (f64)h->duration;
-                    const f64 maxLongObjectDrop = std::max(0.0, longObjectDrop - testPlayer.health);
-
-                    testPlayer.decreaseHealth(longObjectDrop);
-
-                    // nested hitobjects
-                    if(sliderPointer != nullptr) {
-                        // startcircle
-                        testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                            LiveScore::HIT::HIT_SLIDER30, HP, testPlayer.hpMultiplierNormal,
-                            testPlayer.hpMultiplierComboEnd, 1.0));  // slider30
-
-                        // ticks + repeats + repeat ticks
-                        const std::vector<Slider::SLIDERCLICK> &clicks = sliderPointer->getClicks();
-                        for(const auto &click : clicks) {
-                            switch(click.type) {
-                                case 0:  // repeat
-                                    testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                                        LiveScore::HIT::HIT_SLIDER30, HP, testPlayer.hpMultiplierNormal,
-                                        testPlayer.hpMultiplierComboEnd, 1.0));  // slider30
-                                    break;
-                                case 1:  // tick
-                                    testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                                        LiveScore::HIT::HIT_SLIDER10, HP, testPlayer.hpMultiplierNormal,
-                                        testPlayer.hpMultiplierComboEnd, 1.0));  // slider10
-                                    break;
-                            }
-                        }
-
-                        // endcircle
-                        testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                            LiveScore::HIT::HIT_SLIDER30, HP, testPlayer.hpMultiplierNormal,
-                            testPlayer.hpMultiplierComboEnd, 1.0));  // slider30
-                    } else if(spinnerPointer != nullptr) {
-                        const int rotationsNeeded =
-                            (int)((f32)spinnerPointer->duration / 1000.0f * GameRules::getSpinnerSpinsPerSecond(this));
-                        for(int r = 0; r < rotationsNeeded; r++) {
-                            testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                                LiveScore::HIT::HIT_SPINNERSPIN, HP, testPlayer.hpMultiplierNormal,
-                                testPlayer.hpMultiplierComboEnd, 1.0));  // spinnerspin
-                        }
-                    }
-
-                    if(!(maxLongObjectDrop > 0.0) || (testPlayer.health - maxLongObjectDrop) > lowestHpEver) {
-                        // regular hit (for every hitobject)
-                        testPlayer.increaseHealth(
-                            LiveScore::getHealthIncrease(LiveScore::HIT::HIT_300, HP, testPlayer.hpMultiplierNormal,
-                                                         testPlayer.hpMultiplierComboEnd, 1.0));  // 300
-
-                        // end of combo (new combo starts at next hitobject)
-                        if((i == this->hitobjects.size() - 1) || this->hitobjects[i]->is_end_of_combo) {
-                            testPlayer.increaseHealth(LiveScore::getHealthIncrease(
-                                LiveScore::HIT::HIT_300G, HP, testPlayer.hpMultiplierNormal,
-                                testPlayer.hpMultiplierComboEnd, 1.0));  // geki
-
-                            if(testPlayer.health < lowestHpComboEnd) {
-                                if(++comboTooLowCount > 2) {
-                                    testPlayer.hpMultiplierComboEnd *= 1.07;
-                                    testPlayer.hpMultiplierNormal *= 1.03;
-                                    fail = true;
-                                    break;
-                                }
-                            }
-                        }
-
-                        continue;
-                    }
-
-                    fail = true;
-                    testDrop *= 0.96;
-                    break;
-                }
-
-                fail = true;
-                testDrop *= 0.96;
-                break;
-            }
-
-            if(!fail && testPlayer.health < lowestHpEnd) {
-                fail = true;
-                testDrop *= 0.94;
-                testPlayer.hpMultiplierComboEnd *= 1.01;
-                testPlayer.hpMultiplierNormal *= 1.01;
-            }
-
-            const f64 recovery = (testPlayer.healthUncapped - testPlayer.hpBarMaximum) / (f64)this->hitobjects.size();
-            if(!fail && recovery < HpRecoveryAvailable) {
-                fail = true;
-                testDrop *= 0.96;
-                testPlayer.hpMultiplierComboEnd *= 1.02;
-                testPlayer.hpMultiplierNormal *= 1.01;
-            }
-        } while(fail);
-
-        this->fDrainRate =
-            (testDrop / testPlayer.hpBarMaximum) * 1000.0;  // from [0, 200] to [0, 1], and from ms to seconds
-        this->fHpMultiplierComboEnd = testPlayer.hpMultiplierComboEnd;
-        this->fHpMultiplierNormal = testPlayer.hpMultiplierNormal;
-    }
+    const DrainRate::Result result = DrainRate::get(
+        this->selectedDifficulty2->getMD5Hash(),
+        DrainRate::Input{.hitobjects = this->hitobjects,
+                         .breaks = this->breaks,
+                         .HP = this->getHP(),
+                         .approachTime = this->getApproachTime(),
+                         .spinsPerSecond = GameRules::getSpinnerSpinsPerSecond(this),
+                         .version = this->selectedDifficulty2->getVersion()});
+
+    this->fDrainRate = result.drainRate;
+    this->fHpMultiplierNormal = result.hpMultiplierNormal;
+    this->fHpMultiplierComboEnd = result.hpMultiplierComboEnd;
 }
 
 f32 SimulatedBeatmap::getApproachTime_full() const {
@@ -1252,4 +1088,72 @@ f32 SimulatedBeatmap::getRawApproachTime_full() const {
                ? this->getLength() * 2
                : GameRules::mapDifficultyRange(this->getRawAR(), GameRules::getMinApproachTime(),
                                                GameRules::getMidApproachTime(), GameRules::getMaxApproachTime());
-}
\ No newline at end of file
+}
+
+void SimulatedBeatmap::bench() {
+    static constexpr int NUM_SEEKS = 20;
+
+    auto beatmap = osu->getSelectedBeatmap();
+    if(beatmap == nullptr || !beatmap->is_watching || beatmap->getSelectedDifficulty2() == nullptr) {
+        Engine::logRaw("replay_seek_bench: not watching a replay\n");
+        return;
+    }
+
+    const auto mods = osu->getScore()->mods;
+    const auto makeSim = [&] {
+        auto sim = std::make_unique<SimulatedBeatmap>(beatmap->getSelectedDifficulty2(), mods);
+        sim->spectated_replay = beatmap->spectated_replay;
+        return sim;
+    };
+
+    const i32 length = static_cast<i32>(beatmap->getSelectedDifficulty2()->getLengthMS());
+    if(beatmap->spectated_replay.empty() || length <= 0) return;
+
+    // play through once to collect the checkpoints, like watching the replay up to the end would
+    auto seekingSim = makeSim();
+    seekingSim->simulate_to(length);
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<i32> dist(0, length);
+
+    BenchCheck check("replay_seek_bench");
+    u64 rewindNS = 0;
+    u64 restartNS = 0;
+    for(int i = 0; i < NUM_SEEKS; i++) {
+        const i32 target = dist(rng);
+
+        u64 startTime = Timing::getTicksNS();
+        seekingSim->rewind_to(target);
+        seekingSim->simulate_to(target);
+        rewindNS += Timing::getTicksNS() - startTime;
+
+        startTime = Timing::getTicksNS();
+        auto freshSim = makeSim();
+        freshSim->simulate_to(target);
+        restartNS += Timing::getTicksNS() - startTime;
+
+        // both have to end up in the exact same state
+        LiveScore &seeked = seekingSim->live_score;
+        LiveScore &fresh = freshSim->live_score;
+        const std::string at = fmt::format(" after seeking to {:d}ms", target);
+        check.expectEqual(seeked.getScore(), fresh.getScore(), "score" + at);
+        check.expectEqual(seeked.getCombo(), fresh.getCombo(), "combo" + at);
+        check.expectEqual(seeked.getComboMax(), fresh.getComboMax(), "max combo" + at);
+        check.expectEqual(seeked.getNum300s(), fresh.getNum300s(), "300s" + at);
+        check.expectEqual(seeked.getNum100s(), fresh.getNum100s(), "100s" + at);
+        check.expectEqual(seeked.getNum50s(), fresh.getNum50s(), "50s" + at);
+        check.expectEqual(seeked.getNumMisses(), fresh.getNumMisses(), "misses" + at);
+        check.expectEqual(seekingSim->fHealth, freshSim->fHealth, "health" + at);
+
+        // back to the end, for the next backwards seek
+        seekingSim->simulate_to(length);
+    }
+
+    Engine::logRaw("replay_seek_bench: {:d} backwards seeks over {:d}ms, {:d} checkpoints\n", NUM_SEEKS, length,
+                   seekingSim->getNumCheckpoints());
+    Engine::logRaw("    restart from beginning: {:.2f} ms per seek\n",
+                   static_cast<double>(restartNS) / NUM_SEEKS / 1'000'000.0);
+    Engine::logRaw("    rewind to checkpoint:   {:.2f} ms per seek\n",
+                   static_cast<double>(rewindNS) / NUM_SEEKS / 1'000'000.0);
+    check.finish();
+}
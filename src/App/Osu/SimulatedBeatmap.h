@@ -2,6 +2,7 @@
 
 #include "Beatmap.h"
 #include "Replay.h"
+#include "SimulationState.h"
 
 class SimulatedBeatmap : public BeatmapInterface {
    public:
@@ -13,6 +14,15 @@ class SimulatedBeatmap : public BeatmapInterface {
 
     void simulate_to(i32 music_pos);
 
+    // go back to the latest checkpoint at or before music_pos (or to the very beginning), so that seeking backwards
+    // doesn't have to simulate everything from the start again. simulate_to() continues from there
+    void rewind_to(i32 music_pos);
+    [[nodiscard]] inline size_t getNumCheckpoints() const { return this->checkpoints.size(); }
+
+    // replay_seek_bench: backwards seeks in the watched replay, rewinding to a checkpoint vs. restarting, and checks
+    // that both end up in the same state
+    static void bench();
+
     bool start();
     void update(f64 frame_time);
 
@@ -48,6 +58,7 @@ class SimulatedBeatmap : public BeatmapInterface {
     void resetScore();
 
     // live statistics
+    [[nodiscard]] inline f64 getDrainRate() const { return this->fDrainRate; }
     [[nodiscard]] inline int getNPS() const { return this->iNPS; }
     [[nodiscard]] inline int getND() const { return this->iND; }
 
@@ -120,6 +131,26 @@ class SimulatedBeatmap : public BeatmapInterface {
     i32 iCurrentNumSpinners;
 
    private:
+    // simulation state at some point in time. only the hitobjects which could have changed since the previous
+    // checkpoint are saved: the ones before first_object are finished and out of range, so they can't change anymore,
+    // and the ones from last_object on haven't been updated yet (they're restored from initial_objects)
+    struct Checkpoint {
+        i32 music_pos;
+        i32 first_object;
+        i32 last_object;
+        LiveScore live_score;
+        SimulationState state;
+    };
+
+    void saveCheckpoint();
+    void loadCheckpoint(Checkpoint &checkpoint);
+
+    std::vector<Checkpoint> checkpoints;  // sorted by music_pos, the first one is from right after start()
+    SimulationState initial_objects;      // state of every hitobject right after start()
+    std::vector<size_t> initial_object_offsets;
+    i32 iTouchedObjectsEnd = 0;  // hitobjects from here on have never been updated
+    i32 iNextCheckpointTime = 0;
+
     [[nodiscard]] Replay::Mods getMods_full() const override { return this->mods; }
     [[nodiscard]] u32 getModsLegacy_full() const override { return this->mods.to_legacy(); }
     [[nodiscard]] u32 getScoreV1DifficultyMultiplier_full() const override;
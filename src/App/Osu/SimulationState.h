@@ -0,0 +1,48 @@
+#pragma once
+
+#include "types.h"
+
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// flat byte buffer for saving and restoring simulation state (SimulatedBeatmap checkpoints).
+// values have to be read back in the same order and with the same types they were written in; it never leaves
+// memory, so there's no versioning or endianness handling
+class SimulationState {
+   public:
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write(const T &value) {
+        this->writeBytes(&value, sizeof(T));
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] T read() {
+        T value;
+        this->readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    void writeBytes(const void *bytes, size_t n) {
+        const size_t pos = this->data.size();
+        this->data.resize(pos + n);
+        if(n > 0) memcpy(this->data.data() + pos, bytes, n);
+    }
+
+    void readBytes(void *bytes, size_t n) {
+        assert(this->readPos + n <= this->data.size());
+        if(n > 0) memcpy(bytes, this->data.data() + this->readPos, n);
+        this->readPos += n;
+    }
+
+    [[nodiscard]] inline size_t size() const { return this->data.size(); }
+    inline void seek(size_t pos) { this->readPos = pos; }
+    inline void shrink() { this->data.shrink_to_fit(); }
+
+   private:
+    std::vector<u8> data;
+    size_t readPos{0};
+};
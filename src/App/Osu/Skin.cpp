@@ -16,8 +16,10 @@
 #include "Parsing.h"
 #include "ResourceManager.h"
 #include "SString.h"
+#include "SkinAtlas.h"
 #include "SkinImage.h"
 #include "SoundEngine.h"
+#include "Timing.h"
 #include "VolumeOverlay.h"
 
 // Readability
@@ -115,6 +117,8 @@ Skin::Skin(const UString &name, std::string filepath, bool isDefaultSkin) {
     this->bIsRandom = cv::skin_random.getBool();
     this->bIsRandomElements = cv::skin_random_elements.getBool();
 
+    this->atlas = std::make_unique<SkinAtlas>();
+
     // load all files
     this->load();
 }
@@ -143,6 +147,8 @@ void Skin::update() {
         osu->volumeOverlay->updateEffectVolume(this);
     }
 
+    if(this->bReady && this->bAtlasPending) this->buildAtlas();
+
     // shitty check to not animate while paused with hitobjects in background
     if(osu->isInPlayMode() && !osu->getSelectedBeatmap()->isPlaying() && !cv::skin_animation_force.getBool()) return;
 
@@ -174,7 +180,16 @@ bool Skin::isReady() {
 }
 
 void Skin::load() {
+    const u64 loadStartTime = Timing::getTicksNS();
     resourceManager->setSyncLoadMaxBatchSize(512);
+
+    // the skin folder might have changed since the last load, rebuild the listings as needed
+    this->fileIndex.clear();
+
+    // mipmapped elements can't be packed (and the atlas is built once everything finished loading)
+    this->atlas->clear();
+    this->bAtlasPending = cv::skin_atlas.getBool() && !cv::skin_mipmaps.getBool();
+
     // random skins
     {
         this->filepathsForRandomSkin.clear();
@@ -875,6 +890,8 @@ void Skin::load() {
     // print some debug info
     debugLog("Skin: Version {:f}\n", this->fVersion);
     debugLog("Skin: HitCircleOverlap = {:d}\n", this->iHitCircleOverlap);
+    debugLog("Skin: Resolved elements in {:.2f} ms ({} folders indexed)\n",
+             static_cast<f64>(Timing::getTicksNS() - loadStartTime) / 1e6, this->fileIndex.size());
 
     // delayed error notifications due to resource loading potentially blocking engine time
     if(!parseSkinIni1Status && parseSkinIni2Status && cv::skin.getString() != "default")
@@ -1169,6 +1186,72 @@ SkinImage *Skin::createSkinImage(const std::string &skinElementName, vec2 baseSi
     return skinImage;
 }
 
+bool Skin::skinFileExists(std::string &filePath) {
+    const size_t lastSlash = filePath.find_last_of("/\\");
+    const std::string folder = lastSlash != std::string::npos ? filePath.substr(0, lastSlash + 1) : "";
+
+    auto it = this->fileIndex.find(folder);
+    if(it == this->fileIndex.end()) {
+        std::unordered_map<std::string, std::string> files;
+        for(auto &fileName : env->getFilesInFolder(folder)) {
+            files.emplace(SString::lower(fileName), std::move(fileName));
+        }
+        it = this->fileIndex.emplace(folder, std::move(files)).first;
+    }
+
+    // couldn't list it (or it's empty), let the slow path deal with it (e.g. wrong casing in the folder name itself)
+    if(it->second.empty()) return env->fileExists(filePath);
+
+    const auto file = it->second.find(SString::lower(filePath.substr(folder.length())));
+    if(file == it->second.end()) return false;
+
+    filePath = folder + file->second;
+    return true;
+}
+
+bool Skin::isAtlasElement(const std::string &skinElementName) const {
+    if(!cv::skin_atlas.getBool() || cv::skin_mipmaps.getBool()) return false;
+
+    if(skinElementName == "hitcircle" || skinElementName == "hitcircleoverlay" || skinElementName == "approachcircle")
+        return true;
+
+    // number glyphs (and animation frames of the above)
+    const size_t dash = skinElementName.rfind('-');
+    if(dash == std::string::npos || dash == 0) return false;
+
+    const std::string_view prefix{skinElementName.data(), dash};
+    const std::string_view suffix{skinElementName.data() + dash + 1, skinElementName.length() - dash - 1};
+
+    const bool isGlyph = (suffix.length() == 1 && suffix[0] >= '0' && suffix[0] <= '9') || suffix == "x" ||
+                         suffix == "percent" || suffix == "dot";
+    if(!isGlyph) return false;
+
+    return prefix == "default" || prefix == "score" || prefix == "hitcircleoverlay" || prefix == this->sHitCirclePrefix ||
+           prefix == this->sScorePrefix || prefix == this->sComboPrefix;
+}
+
+void Skin::buildAtlas() {
+    std::vector<Image *> elements{this->hitCircle, this->approachCircle};
+    elements.insert(elements.end(), {this->default0, this->default1, this->default2, this->default3, this->default4,
+                                     this->default5, this->default6, this->default7, this->default8, this->default9});
+    elements.insert(elements.end(), {this->score0, this->score1, this->score2, this->score3, this->score4, this->score5,
+                                     this->score6, this->score7, this->score8, this->score9, this->scoreX,
+                                     this->scorePercent, this->scoreDot});
+    elements.insert(elements.end(), {this->combo0, this->combo1, this->combo2, this->combo3, this->combo4, this->combo5,
+                                     this->combo6, this->combo7, this->combo8, this->combo9, this->comboX});
+    for(int i = 0; i < this->hitCircleOverlay2->getNumImages(); i++) {
+        elements.push_back(this->hitCircleOverlay2->getImageForFrame(i));
+    }
+
+    // the default skin elements aren't part of isReady(), wait for them separately
+    for(Image *element : elements) {
+        if(resourceManager->isLoadingResource(element)) return;
+    }
+
+    this->bAtlasPending = false;
+    this->atlas->build(elements);
+}
+
 void Skin::checkLoadImage(Image **addressOfPointer, const std::string &skinElementName, const std::string &resourceName,
                           bool ignoreDefaultSkin, const std::string &fileExtension, bool forceLoadMipmaps) {
     if(*addressOfPointer != MISSING_TEXTURE) return;  // we are already loaded
@@ -1176,6 +1259,9 @@ void Skin::checkLoadImage(Image **addressOfPointer, const std::string &skinEleme
     // NOTE: only the default skin is loaded with a resource name (it must never be unloaded by other instances), and it
     // is NOT added to the resources vector
 
+    const bool mipmapped = cv::skin_mipmaps.getBool() || forceLoadMipmaps;
+    const bool keepInSystemMemory = this->isAtlasElement(skinElementName);
+
     std::string defaultFilePath1 = MCENGINE_DATA_DIR "materials/default/";
     defaultFilePath1.append(skinElementName);
     defaultFilePath1.append("@2x.");
@@ -1196,10 +1282,10 @@ void Skin::checkLoadImage(Image **addressOfPointer, const std::string &skinEleme
     filepath2.append(".");
     filepath2.append(fileExtension);
 
-    const bool existsDefaultFilePath1 = env->fileExists(defaultFilePath1);
-    const bool existsDefaultFilePath2 = env->fileExists(defaultFilePath2);
-    const bool existsFilepath1 = env->fileExists(filepath1);
-    const bool existsFilepath2 = env->fileExists(filepath2);
+    const bool existsDefaultFilePath1 = this->skinFileExists(defaultFilePath1);
+    const bool existsDefaultFilePath2 = this->skinFileExists(defaultFilePath2);
+    const bool existsFilepath1 = this->skinFileExists(filepath1);
+    const bool existsFilepath2 = this->skinFileExists(filepath2);
 
     // check if an @2x version of this image exists
     if(cv::skin_hd.getBool()) {
@@ -1209,30 +1295,29 @@ void Skin::checkLoadImage(Image **addressOfPointer, const std::string &skinEleme
                 std::string defaultResourceName = resourceName;
                 defaultResourceName.append("_DEFAULT");  // so we don't load the default skin twice
 
-                if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync();
+                if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
 
-                *addressOfPointer = resourceManager->loadImageAbs(defaultFilePath1, defaultResourceName,
-                                                                  cv::skin_mipmaps.getBool() || forceLoadMipmaps);
+                *addressOfPointer = resourceManager->loadImageAbs(defaultFilePath1, defaultResourceName, mipmapped,
+                                                                  keepInSystemMemory);
             } else {
                 // fallback to @1x
                 if(existsDefaultFilePath2) {
                     std::string defaultResourceName = resourceName;
                     defaultResourceName.append("_DEFAULT");  // so we don't load the default skin twice
 
-                    if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync();
+                    if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
 
                     *addressOfPointer = resourceManager->loadImageAbs(defaultFilePath2, defaultResourceName,
-                                                                      cv::skin_mipmaps.getBool() || forceLoadMipmaps);
+                                                                      mipmapped, keepInSystemMemory);
                 }
             }
         }
 
         // load user skin
         if(existsFilepath1) {
-            if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync();
+            if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
 
-            *addressOfPointer =
-                resourceManager->loadImageAbs(filepath1, "", cv::skin_mipmaps.getBool() || forceLoadMipmaps);
+            *addressOfPointer = resourceManager->loadImageAbs(filepath1, "", mipmapped, keepInSystemMemory);
             this->resources.push_back(*addressOfPointer);
 
             // export
@@ -1256,19 +1341,18 @@ void Skin::checkLoadImage(Image **addressOfPointer, const std::string &skinEleme
             std::string defaultResourceName = resourceName;
             defaultResourceName.append("_DEFAULT");  // so we don't load the default skin twice
 
-            if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync();
+            if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
 
-            *addressOfPointer = resourceManager->loadImageAbs(defaultFilePath2, defaultResourceName,
-                                                              cv::skin_mipmaps.getBool() || forceLoadMipmaps);
+            *addressOfPointer = resourceManager->loadImageAbs(defaultFilePath2, defaultResourceName, mipmapped,
+                                                              keepInSystemMemory);
         }
     }
 
     // load user skin
     if(existsFilepath2) {
-        if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync();
+        if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
 
-        *addressOfPointer =
-            resourceManager->loadImageAbs(filepath2, "", cv::skin_mipmaps.getBool() || forceLoadMipmaps);
+        *addressOfPointer = resourceManager->loadImageAbs(filepath2, "", mipmapped, keepInSystemMemory);
         this->resources.push_back(*addressOfPointer);
     }
 
@@ -1291,7 +1375,7 @@ void Skin::loadSound(Sound *&sndRef, const std::string &skinElementName, std::st
 
     bool was_first_load = false;
 
-    auto try_load_sound = [isSample, isOverlayable, &was_first_load](
+    auto try_load_sound = [this, isSample, isOverlayable, &was_first_load](
                               const std::string &base_path, const std::string &filename, bool loop,
                               const std::string &resource_name, bool default_skin) -> Sound * {
         const char *extensions[] = {".wav", ".mp3", ".ogg", ".flac"};
@@ -1303,7 +1387,7 @@ void Skin::loadSound(Sound *&sndRef, const std::string &skinElementName, std::st
             path.append(fn);
 
             // this check will fix up the filename casing
-            if(env->fileExists(path)) {
+            if(this->skinFileExists(path)) {
                 Sound *existing_sound = resourceManager->getSound(resource_name);
 
                 // default already loaded, just return it
@@ -1315,7 +1399,7 @@ void Skin::loadSound(Sound *&sndRef, const std::string &skinElementName, std::st
                 if(existing_sound) resourceManager->destroyResource(existing_sound, true);
 
                 if(cv::skin_async.getBool()) {
-                    resourceManager->requestNextLoadAsync();
+                    resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
                 }
 
                 // load sound here
@@ -2,6 +2,9 @@
 // Copyright (c) 2015, PG, All rights reserved.
 #include "cbase.h"
 
+#include <memory>
+#include <unordered_map>
+
 extern Image *MISSING_TEXTURE;
 
 class Image;
@@ -9,6 +12,7 @@ class Sound;
 class Resource;
 class ConVar;
 
+class SkinAtlas;
 class SkinImage;
 
 class Skin final {
@@ -349,6 +353,7 @@ class Skin final {
     // custom
     [[nodiscard]] inline bool useSmoothCursorTrail() const { return this->cursorMiddle != MISSING_TEXTURE; }
     [[nodiscard]] inline bool isDefaultSkin() const { return this->bIsDefaultSkin; }
+    [[nodiscard]] inline SkinAtlas *getAtlas() const { return this->atlas.get(); }
 
     bool parseSkinINI(std::string filepath);
 
@@ -364,6 +369,13 @@ class Skin final {
                    bool isOverlayable = false, bool isSample = false, bool loop = false,
                    bool fallback_to_default = true);
 
+    // like env->fileExists(), but resolved against a listing of the containing folder (built once per folder and
+    // load), instead of stat()ing every candidate path. fixes up the filename casing if found
+    bool skinFileExists(std::string &filePath);
+
+    // whether the element gets packed into the atlas (its pixels then have to be kept in system memory until then)
+    [[nodiscard]] bool isAtlasElement(const std::string &skinElementName) const;
+
     bool bReady{false};
     bool bIsDefaultSkin;
     f32 animationSpeedMultiplier{1.f};
@@ -648,6 +660,14 @@ class Skin final {
     std::vector<std::string> filepathsForExport;
 
    private:
+    void buildAtlas();
+
+    std::unique_ptr<SkinAtlas> atlas;
+    bool bAtlasPending{false};
+
+    // folder -> (lowercase filename -> actual filename)
+    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> fileIndex;
+
     // sounds
     Sound *normalHitNormal{nullptr};
     Sound *normalHitWhistle{nullptr};
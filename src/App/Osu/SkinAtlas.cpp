@@ -0,0 +1,172 @@
+#include "SkinAtlas.h"
+
+#include <algorithm>
+
+#include "ConVar.h"
+#include "Engine.h"
+#include "Image.h"
+#include "ResourceManager.h"
+#include "Skin.h"
+#include "TextureAtlas.h"
+
+static constexpr const size_t VERTS_PER_QUAD{Env::cfg(REND::GLES32) ? 6 : 4};
+
+// anything bigger than this isn't worth wasting atlas space on (and likely isn't drawn often enough to matter)
+static constexpr const int MAX_ELEMENT_SIZE{512};
+static constexpr const size_t MIN_ATLAS_SIZE{256};
+static constexpr const size_t MAX_ATLAS_SIZE{4096};
+
+SkinAtlas::SkinAtlas()
+    : vao((Env::cfg(REND::GLES32) ? Graphics::PRIMITIVE::PRIMITIVE_TRIANGLES : Graphics::PRIMITIVE::PRIMITIVE_QUADS),
+          Graphics::USAGE_TYPE::USAGE_DYNAMIC) {}
+
+SkinAtlas::~SkinAtlas() { this->clear(); }
+
+void SkinAtlas::build(const std::vector<Image *> &images) {
+    this->clear();
+
+    std::vector<TextureAtlas::PackRect> packRects;
+    std::vector<Image *> packedImages;
+    for(Image *image : images) {
+        if(image == nullptr || image == MISSING_TEXTURE || !image->isReady()) continue;
+        if(std::ranges::find(packedImages, image) != packedImages.end()) continue;  // e.g. shared default glyphs
+
+        const i32 width = image->getWidth();
+        const i32 height = image->getHeight();
+        if(width < 1 || height < 1 || width > MAX_ELEMENT_SIZE || height > MAX_ELEMENT_SIZE) continue;
+        if(image->getRawImage().size() < static_cast<u64>(width) * height * Image::NUM_CHANNELS) continue;
+
+        packRects.push_back({.x = 0, .y = 0, .width = width, .height = height, .id = (int)packedImages.size()});
+        packedImages.push_back(image);
+    }
+
+    if(packRects.empty()) return;
+
+    // the size estimate is only a heuristic, grow until everything fits
+    size_t atlasSize = TextureAtlas::calculateOptimalSize(packRects, 0.75f, MIN_ATLAS_SIZE, MAX_ATLAS_SIZE);
+    while(true) {
+        resourceManager->requestNextLoadUnmanaged();
+        this->atlas.reset(resourceManager->createTextureAtlas((int)atlasSize, (int)atlasSize));
+        if(this->atlas->packRects(packRects)) break;
+
+        if(atlasSize >= MAX_ATLAS_SIZE) {
+            debugLog("SkinAtlas: Couldn't fit {} images into {}x{}, not batching skin elements\n", packRects.size(),
+                     atlasSize, atlasSize);
+            this->atlas.reset();
+            return;
+        }
+        atlasSize *= 2;
+    }
+
+    const auto atlasWidth = static_cast<float>(this->atlas->getWidth());
+    const auto atlasHeight = static_cast<float>(this->atlas->getHeight());
+
+    std::vector<Color> pixels;
+    for(const auto &rect : packRects) {
+        const Image *image = packedImages[rect.id];
+        const std::vector<u8> &rawImage = image->getRawImage();
+
+        // RGBA -> ARGB
+        pixels.resize(static_cast<size_t>(rect.width) * rect.height);
+        for(size_t i = 0; i < pixels.size(); i++) {
+            const u8 *pixel = &rawImage[i * Image::NUM_CHANNELS];
+            pixels[i] = Color(pixel[3], pixel[0], pixel[1], pixel[2]);
+        }
+        this->atlas->putAt(rect.x, rect.y, rect.width, rect.height, false, false, pixels.data());
+
+        this->regions[image] = Region{
+            .uvTopLeft = vec2(rect.x / atlasWidth, rect.y / atlasHeight),
+            .uvBottomRight = vec2((rect.x + rect.width) / atlasWidth, (rect.y + rect.height) / atlasHeight)};
+    }
+
+    // finalize atlas texture
+    resourceManager->loadResource(this->atlas.get());
+
+    debugLog("SkinAtlas: Packed {} images into {}x{}\n", this->regions.size(), this->atlas->getWidth(),
+             this->atlas->getHeight());
+}
+
+void SkinAtlas::clear() {
+    this->regions.clear();
+    this->atlas.reset();
+    this->vao.clear();
+    this->iBatchDepth = 0;
+}
+
+const SkinAtlas::Region *SkinAtlas::getRegion(const Image *image) const {
+    const auto it = this->regions.find(image);
+    return it != this->regions.end() ? &it->second : nullptr;
+}
+
+void SkinAtlas::beginBatch() { this->iBatchDepth++; }
+
+void SkinAtlas::endBatch() {
+    if(this->iBatchDepth < 1) return;
+    if(--this->iBatchDepth == 0) this->flush();
+}
+
+void SkinAtlas::drawImage(Image *image, AnchorPoint anchor) {
+    const Region *region = nullptr;
+    if(this->iBatchDepth < 1 || anchor != AnchorPoint::CENTER || (region = this->getRegion(image)) == nullptr ||
+       !this->atlas->isReady()) {
+        // keep the draw order intact
+        this->flush();
+        g->drawImage(image, anchor);
+        return;
+    }
+
+    const Color color = g->getColor();
+    if(!image->isReady() || color.A() == 0) return;
+
+    // same geometry as drawImage(), but baked with the current world transform, since the batch is drawn later (and
+    // possibly under a different transform)
+    const Matrix4 world = g->getWorldMatrix();
+    const float halfWidth = static_cast<float>(image->getWidth()) / 2.0f;
+    const float halfHeight = static_cast<float>(image->getHeight()) / 2.0f;
+
+    const vec4 topLeft = world.getGLM() * vec4(-halfWidth, -halfHeight, 0.0f, 1.0f);
+    const vec4 bottomLeft = world.getGLM() * vec4(-halfWidth, halfHeight, 0.0f, 1.0f);
+    const vec4 bottomRight = world.getGLM() * vec4(halfWidth, halfHeight, 0.0f, 1.0f);
+    const vec4 topRight = world.getGLM() * vec4(halfWidth, -halfHeight, 0.0f, 1.0f);
+
+    const vec2 &uv0 = region->uvTopLeft;
+    const vec2 &uv1 = region->uvBottomRight;
+
+    const auto addVertex = [&](const vec4 &pos, float u, float v) {
+        this->vao.addVertex(pos.x, pos.y, pos.z);
+        this->vao.addTexcoord(u, v);
+        this->vao.addColor(color);
+    };
+
+    if constexpr(VERTS_PER_QUAD == 6) {
+        addVertex(topLeft, uv0.x, uv0.y);
+        addVertex(bottomLeft, uv0.x, uv1.y);
+        addVertex(bottomRight, uv1.x, uv1.y);
+
+        addVertex(topLeft, uv0.x, uv0.y);
+        addVertex(bottomRight, uv1.x, uv1.y);
+        addVertex(topRight, uv1.x, uv0.y);
+    } else {
+        addVertex(topLeft, uv0.x, uv0.y);
+        addVertex(bottomLeft, uv0.x, uv1.y);
+        addVertex(bottomRight, uv1.x, uv1.y);
+        addVertex(topRight, uv1.x, uv0.y);
+    }
+}
+
+void SkinAtlas::flush() {
+    if(this->vao.getVertices().empty()) return;
+
+    this->atlas->getAtlasImage()->bind();
+    g->pushTransform();
+    {
+        // vertices are already transformed
+        Matrix4 identity;
+        g->setWorldMatrix(identity);
+        g->drawVAO(&this->vao);
+    }
+    g->popTransform();
+    if(cv::r_image_unbind_after_drawimage.getBool()) this->atlas->getAtlasImage()->unbind();
+
+    this->vao.clear();
+}
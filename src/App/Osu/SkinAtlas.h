@@ -0,0 +1,52 @@
+#pragma once
+#include "cbase.h"
+
+#include "VertexArrayObject.h"
+
+#include <memory>
+#include <unordered_map>
+
+class Image;
+class TextureAtlas;
+
+// packs the small, frequently drawn skin elements (hitcircles, overlays, number glyphs) into a single texture at skin
+// load time, so that e.g. a hitcircle with its overlay and combo number, or the HUD score, can be drawn with a single
+// texture bind and draw call instead of one per element/glyph
+class SkinAtlas final {
+    NOCOPY_NOMOVE(SkinAtlas)
+   public:
+    // sub-rect of a packed image, in normalized texture coordinates of the atlas
+    struct Region {
+        vec2 uvTopLeft;
+        vec2 uvBottomRight;
+    };
+
+    SkinAtlas();
+    ~SkinAtlas();
+
+    // images which aren't ready, don't have their pixels in system memory, or don't fit are skipped (and keep being
+    // drawn on their own)
+    void build(const std::vector<Image *> &images);
+    void clear();
+
+    [[nodiscard]] const Region *getRegion(const Image *image) const;
+    [[nodiscard]] inline bool isBuilt() const { return this->atlas != nullptr; }
+    [[nodiscard]] inline size_t getNumPackedImages() const { return this->regions.size(); }
+
+    // batching, can be nested (only the outermost endBatch() draws)
+    void beginBatch();
+    void endBatch();
+
+    // drop-in replacement for g->drawImage(), using the current color and world transform.
+    // packed images are queued while a batch is active, anything else flushes the queue and is drawn immediately
+    void drawImage(Image *image, AnchorPoint anchor = AnchorPoint::CENTER);
+
+   private:
+    void flush();
+
+    std::unique_ptr<TextureAtlas> atlas{nullptr};
+    std::unordered_map<const Image *, Region> regions;
+
+    VertexArrayObject vao;
+    int iBatchDepth{0};
+};
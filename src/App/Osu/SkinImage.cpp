@@ -102,10 +102,13 @@ bool SkinImage::loadImage(const std::string& skinElementName, bool ignoreDefault
     defaultFilePath2.append(skinElementName);
     defaultFilePath2.append(".png");
 
-    const bool existsFilepath1 = env->fileExists(filepath1);
-    const bool existsFilepath2 = env->fileExists(filepath2);
-    const bool existsDefaultFilePath1 = env->fileExists(defaultFilePath1);
-    const bool existsDefaultFilePath2 = env->fileExists(defaultFilePath2);
+    // atlas elements are packed once loaded, which needs their pixels
+    const bool keepInSystemMemory = this->skin->isAtlasElement(skinElementName);
+
+    const bool existsFilepath1 = this->skin->skinFileExists(filepath1);
+    const bool existsFilepath2 = this->skin->skinFileExists(filepath2);
+    const bool existsDefaultFilePath1 = this->skin->skinFileExists(defaultFilePath1);
+    const bool existsDefaultFilePath2 = this->skin->skinFileExists(defaultFilePath2);
 
     // load user skin
 
@@ -116,9 +119,10 @@ bool SkinImage::loadImage(const std::string& skinElementName, bool ignoreDefault
         if(existsFilepath1) {
             IMAGE image;
 
-            if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync();
+            if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
 
-            image.img = resourceManager->loadImageAbsUnnamed(filepath1, cv::skin_mipmaps.getBool());
+            image.img =
+                resourceManager->loadImageAbsUnnamed(filepath1, cv::skin_mipmaps.getBool(), keepInSystemMemory);
             image.scale = 2.0f;
 
             this->images.push_back(image);
@@ -141,9 +145,9 @@ bool SkinImage::loadImage(const std::string& skinElementName, bool ignoreDefault
     if(existsFilepath2) {
         IMAGE image;
 
-        if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync();
+        if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
 
-        image.img = resourceManager->loadImageAbsUnnamed(filepath2, cv::skin_mipmaps.getBool());
+        image.img = resourceManager->loadImageAbsUnnamed(filepath2, cv::skin_mipmaps.getBool(), keepInSystemMemory);
         image.scale = 1.0f;
 
         this->images.push_back(image);
@@ -170,9 +174,10 @@ bool SkinImage::loadImage(const std::string& skinElementName, bool ignoreDefault
         if(existsDefaultFilePath1) {
             IMAGE image;
 
-            if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync();
+            if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
 
-            image.img = resourceManager->loadImageAbsUnnamed(defaultFilePath1, cv::skin_mipmaps.getBool());
+            image.img = resourceManager->loadImageAbsUnnamed(defaultFilePath1, cv::skin_mipmaps.getBool(),
+                                                             keepInSystemMemory);
             image.scale = 2.0f;
 
             this->images.push_back(image);
@@ -193,9 +198,10 @@ bool SkinImage::loadImage(const std::string& skinElementName, bool ignoreDefault
     if(existsDefaultFilePath2) {
         IMAGE image;
 
-        if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync();
+        if(cv::skin_async.getBool()) resourceManager->requestNextLoadAsync(LoadPriority::HIGH);
 
-        image.img = resourceManager->loadImageAbsUnnamed(defaultFilePath2, cv::skin_mipmaps.getBool());
+        image.img =
+            resourceManager->loadImageAbsUnnamed(defaultFilePath2, cv::skin_mipmaps.getBool(), keepInSystemMemory);
         image.scale = 1.0f;
 
         this->images.push_back(image);
@@ -280,7 +286,7 @@ void SkinImage::drawRaw(vec2 pos, float scale, AnchorPoint anchor) {
         Image *img = this->getImageForCurrentFrame().img;
 
         if(this->fDrawClipWidthPercent == 1.0f) {
-            g->drawImage(img, anchor);
+            this->skin->getAtlas()->drawImage(img, anchor);
         } else if(img->isReady()) {
             // NOTE: Anchor point not handled here, but fDrawClipWidthPercent only used for health bar right now
             const float realWidth = img->getWidth();
@@ -398,6 +404,10 @@ bool SkinImage::isReady() {
     return this->bReady;
 }
 
+const SkinAtlas::Region *SkinImage::getAtlasRegionForCurrentFrame() {
+    return this->skin->getAtlas()->getRegion(this->getImageForCurrentFrame().img);
+}
+
 SkinImage::IMAGE SkinImage::getImageForCurrentFrame() {
     if(this->images.size() > 0)
         return this->images[this->iFrameCounter % this->images.size()];
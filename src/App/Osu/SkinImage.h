@@ -2,6 +2,8 @@
 // Copyright (c) 2017, PG, All rights reserved.
 #include "cbase.h"
 
+#include "SkinAtlas.h"
+
 class Skin;
 
 class Image;
@@ -47,6 +49,10 @@ class SkinImage final {
 
     vec2 getImageSizeForCurrentFrame();  // width/height of the actual image texture as loaded from disk
     IMAGE getImageForCurrentFrame();
+    [[nodiscard]] inline Image *getImageForFrame(int frame) const { return this->images[frame].img; }
+
+    // sub-rect of the current frame in the skin atlas, nullptr if it isn't packed
+    const SkinAtlas::Region *getAtlasRegionForCurrentFrame();
 
     float getResolutionScale();
 
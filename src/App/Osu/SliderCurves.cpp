@@ -1,9 +1,13 @@
 // Copyright (c) 2015, PG & Jeffrey Han (opsu!), All rights reserved.
 #include "SliderCurves.h"
 
+#include "BenchCheck.h"
 #include "ConVar.h"
 #include "Engine.h"
 
+#include <memory>
+#include <random>
+
 //**********************//
 //	 Curve Base Class	//
 //**********************//
@@ -83,8 +87,12 @@ void SliderCurveType::calculateIntermediaryPoints(float approxLength) {
     // subdivide the curve, calculate all intermediary points
     const int numPoints = (int)(approxLength / 4.0f) + 2;
     this->points.reserve(numPoints);
+    this->pointsAt(numPoints, this->points);
+}
+
+void SliderCurveType::pointsAt(int numPoints, std::vector<vec2> &output) {
     for(int i = 0; i < numPoints; i++) {
-        this->points.push_back(this->pointAt((float)i / (float)(numPoints - 1)));
+        output.push_back(this->pointAt((float)i / (float)(numPoints - 1)));
     }
 }
 
@@ -104,7 +112,12 @@ void SliderCurveType::calculateCurveDistances() {
 }
 
 SliderCurveTypeBezier2::SliderCurveTypeBezier2(const std::vector<vec2> &points) : SliderCurveType() {
-    this->initCustom(SliderBezierApproximator().createBezier(points));
+    if(cv::slider_curve_batch_eval.getBool()) {
+        std::vector<vec2> curvePoints;
+        SliderCurveBatchEvaluator::get().createBezier(points, curvePoints);
+        this->initCustom(std::move(curvePoints));
+    } else
+        this->initCustom(SliderBezierApproximator().createBezier(points));
 }
 
 SliderCurveTypeCentripetalCatmullRom::SliderCurveTypeCentripetalCatmullRom(const std::vector<vec2> &points)
@@ -154,6 +167,13 @@ vec2 SliderCurveTypeCentripetalCatmullRom::pointAt(float t) {
     return C;
 }
 
+void SliderCurveTypeCentripetalCatmullRom::pointsAt(int numPoints, std::vector<vec2> &output) {
+    if(cv::slider_curve_batch_eval.getBool() && this->points.size() == 4)
+        SliderCurveBatchEvaluator::get().createCatmull(this->points, this->time, numPoints, output);
+    else
+        SliderCurveType::pointsAt(numPoints, output);
+}
+
 //*******************//
 //	 Curve Classes	 //
 //*******************//
@@ -576,12 +596,18 @@ SliderCurveCircumscribedCircle::SliderCurveCircumscribedCircle(std::vector<vec2>
     const float steps =
         std::min(this->fPixelLength / (std::clamp<float>(curvePointsSeparation, 1.0f, 100.0f)), max_points);
     const int intSteps = (int)std::round(steps) + 2;  // must guarantee an int range of 0 to steps!
-    for(int i = 0; i < intSteps; i++) {
-        float t = std::clamp<float>((float)i / steps, 0.0f, 1.0f);
-        this->curvePoints.push_back(this->pointAt(t));
+    if(cv::slider_curve_batch_eval.getBool()) {
+        SliderCurveBatchEvaluator::get().createArc(this->vCircleCenter, this->fRadius, this->fCalculationStartAngle,
+                                                   this->fCalculationEndAngle, steps, intSteps,
+                                                   cv::slider_curve_max_length.getFloat(), this->curvePoints);
+    } else {
+        for(int i = 0; i < intSteps; i++) {
+            float t = std::clamp<float>((float)i / steps, 0.0f, 1.0f);
+            this->curvePoints.push_back(this->pointAt(t));
 
-        if(t >= 1.0f)  // early break if we've already reached the end
-            break;
+            if(t >= 1.0f)  // early break if we've already reached the end
+                break;
+        }
     }
 
     // add the segment (no special logic here for SliderCurveCircumscribedCircle, just add the entire vector)
@@ -737,3 +763,263 @@ void SliderBezierApproximator::approximate(std::vector<vec2> &controlPoints, std
         output.push_back(p);
     }
 }
+
+SliderCurveBatchEvaluator &SliderCurveBatchEvaluator::get() {
+    // curves are built on the main thread and on the background calc/loader threads
+    thread_local SliderCurveBatchEvaluator evaluator;
+    return evaluator;
+}
+
+void SliderCurveBatchEvaluator::createBezier(const std::vector<vec2> &controlPoints, std::vector<vec2> &output) {
+    const size_t n = controlPoints.size();
+    this->iCount = n;
+    if(n == 0) return;
+
+    this->midX.resize(n);
+    this->midY.resize(n);
+    this->leftX.resize(n * 2 - 1);
+    this->leftY.resize(n * 2 - 1);
+    this->rightX.resize(n);
+    this->rightY.resize(n);
+
+    // same traversal as SliderBezierApproximator: the left half is always flattened first
+    size_t depth = 1;
+    this->stackX.resize(n);
+    this->stackY.resize(n);
+    for(size_t i = 0; i < n; i++) {
+        this->stackX[i] = controlPoints[i].x;
+        this->stackY[i] = controlPoints[i].y;
+    }
+
+    while(depth > 0) {
+        const size_t top = (depth - 1) * n;
+        if(this->isFlatEnough(&this->stackX[top], &this->stackY[top])) {
+            this->approximate(&this->stackX[top], &this->stackY[top], output);
+            depth--;
+            continue;
+        }
+
+        this->subdivide(&this->stackX[top], &this->stackY[top]);
+
+        // the right half replaces the parent, the left half goes on top of it
+        std::copy_n(this->rightX.begin(), n, this->stackX.begin() + static_cast<ptrdiff_t>(top));
+        std::copy_n(this->rightY.begin(), n, this->stackY.begin() + static_cast<ptrdiff_t>(top));
+        depth++;
+        if(this->stackX.size() < depth * n) {
+            this->stackX.resize(depth * n);
+            this->stackY.resize(depth * n);
+        }
+        std::copy_n(this->leftX.begin(), n, this->stackX.begin() + static_cast<ptrdiff_t>(top + n));
+        std::copy_n(this->leftY.begin(), n, this->stackY.begin() + static_cast<ptrdiff_t>(top + n));
+    }
+
+    output.push_back(controlPoints[n - 1]);
+}
+
+bool SliderCurveBatchEvaluator::isFlatEnough(const float *x, const float *y) const {
+    // no early exit, so that the loop vectorizes
+    bool flat = true;
+    for(size_t i = 1; i + 1 < this->iCount; i++) {
+        const float dx = x[i - 1] - 2.f * x[i] + x[i + 1];
+        const float dy = y[i - 1] - 2.f * y[i] + y[i + 1];
+        const auto length = (double)std::sqrt(dx * dx + dy * dy);
+        flat &= !(length * length > BEZIER_TOLERANCE_SQ * 4);
+    }
+    return flat;
+}
+
+void SliderCurveBatchEvaluator::subdivide(const float *x, const float *y) {
+    const size_t n = this->iCount;
+    std::copy_n(x, n, this->midX.begin());
+    std::copy_n(y, n, this->midY.begin());
+
+    // de casteljau, every pass averages neighbours and peels off one point of each half
+    float *mx = this->midX.data();
+    float *my = this->midY.data();
+    for(size_t i = 0; i < n; i++) {
+        this->leftX[i] = mx[0];
+        this->leftY[i] = my[0];
+        this->rightX[n - i - 1] = mx[n - i - 1];
+        this->rightY[n - i - 1] = my[n - i - 1];
+
+        const size_t m = n - i - 1;
+        for(size_t j = 0; j < m; j++) {
+            mx[j] = (mx[j] + mx[j + 1]) / 2.f;
+        }
+        for(size_t j = 0; j < m; j++) {
+            my[j] = (my[j] + my[j + 1]) / 2.f;
+        }
+    }
+}
+
+void SliderCurveBatchEvaluator::approximate(const float *x, const float *y, std::vector<vec2> &output) {
+    const size_t n = this->iCount;
+    this->subdivide(x, y);
+
+    for(size_t i = 0; i + 1 < n; ++i) {
+        this->leftX[n + i] = this->rightX[i + 1];
+        this->leftY[n + i] = this->rightY[i + 1];
+    }
+
+    output.emplace_back(x[0], y[0]);
+    for(size_t i = 1; i + 1 < n; ++i) {
+        const size_t index = 2 * i;
+        output.emplace_back(0.25f * (this->leftX[index - 1] + 2.f * this->leftX[index] + this->leftX[index + 1]),
+                            0.25f * (this->leftY[index - 1] + 2.f * this->leftY[index] + this->leftY[index + 1]));
+    }
+}
+
+void SliderCurveBatchEvaluator::createCatmull(const std::vector<vec2> &points, const float (&time)[4], int numPoints,
+                                              std::vector<vec2> &output) {
+    if(numPoints <= 0) return;
+    const auto count = static_cast<size_t>(numPoints);
+
+    this->t.resize(count);
+    this->x.resize(count);
+    this->y.resize(count);
+
+    for(size_t i = 0; i < count; i++) {
+        this->t[i] = ((float)i / (float)(numPoints - 1)) * (time[2] - time[1]) + time[1];
+    }
+
+    // same expression as pointAt(), once per coordinate
+    const float t0 = time[0], t1 = time[1], t2 = time[2], t3 = time[3];
+    const auto evaluate = [&](float p0, float p1, float p2, float p3, float *out) {
+        for(size_t i = 0; i < count; i++) {
+            const float ti = this->t[i];
+            const float a1 = p0 * ((t1 - ti) / (t1 - t0)) + (p1 * ((ti - t0) / (t1 - t0)));
+            const float a2 = p1 * ((t2 - ti) / (t2 - t1)) + (p2 * ((ti - t1) / (t2 - t1)));
+            const float a3 = p2 * ((t3 - ti) / (t3 - t2)) + (p3 * ((ti - t2) / (t3 - t2)));
+
+            const float b1 = a1 * ((t2 - ti) / (t2 - t0)) + (a2 * ((ti - t0) / (t2 - t0)));
+            const float b2 = a2 * ((t3 - ti) / (t3 - t1)) + (a3 * ((ti - t1) / (t3 - t1)));
+
+            out[i] = b1 * ((t2 - ti) / (t2 - t1)) + (b2 * ((ti - t1) / (t2 - t1)));
+        }
+    };
+    evaluate(points[0].x, points[1].x, points[2].x, points[3].x, this->x.data());
+    evaluate(points[0].y, points[1].y, points[2].y, points[3].y, this->y.data());
+
+    output.reserve(output.size() + count);
+    for(size_t i = 0; i < count; i++) {
+        output.emplace_back(this->x[i], this->y[i]);
+    }
+}
+
+void SliderCurveBatchEvaluator::createArc(vec2 center, float radius, float startAngle, float endAngle, float steps,
+                                          int maxSteps, float sanityRange, std::vector<vec2> &output) {
+    // the scalar loop stops after the first t which reaches 1
+    size_t count = 0;
+    this->t.clear();
+    while(count < static_cast<size_t>(std::max(maxSteps, 0))) {
+        const float ti = std::clamp<float>((float)count / steps, 0.0f, 1.0f);
+        this->t.push_back(ti);
+        count++;
+        if(ti >= 1.0f) break;
+    }
+
+    this->x.resize(count);
+    this->y.resize(count);
+    for(size_t i = 0; i < count; i++) {
+        const float ang = std::lerp(startAngle, endAngle, this->t[i]);
+        this->x[i] = std::clamp<float>(std::cos(ang) * radius + center.x, -sanityRange, sanityRange);
+        this->y[i] = std::clamp<float>(std::sin(ang) * radius + center.y, -sanityRange, sanityRange);
+    }
+
+    output.reserve(output.size() + count);
+    for(size_t i = 0; i < count; i++) {
+        output.emplace_back(this->x[i], this->y[i]);
+    }
+}
+
+void SliderCurve::bench() {
+    // builds a set of pathological (aspire-style) sliders point by point and with the batch evaluator, checks that
+    // both produce the same curve and compares how long they take
+    struct Slider {
+        const char *name;
+        char type;
+        std::vector<vec2> controlPoints;
+        float pixelLength;
+    };
+
+    std::mt19937 rng{727};
+    std::uniform_real_distribution<f32> coord{0.f, 512.f};
+    const auto randomPoints = [&](size_t count) {
+        std::vector<vec2> points(count);
+        for(auto &point : points) point = vec2{coord(rng), coord(rng)};
+        return points;
+    };
+
+    std::vector<Slider> corpus;
+    corpus.push_back({"bezier, 1000 control points", 'B', randomPoints(1000), 20000.f});
+    corpus.push_back({"bezier, 200 control points", 'B', randomPoints(200), 5000.f});
+    {
+        // 300 red points, i.e. 300 short beziers
+        std::vector<vec2> points = randomPoints(1);
+        for(int i = 0; i < 300; i++) {
+            const std::vector<vec2> segment = randomPoints(3);
+            points.insert(points.end(), segment.begin(), segment.end());
+            points.push_back(points.back());
+        }
+        corpus.push_back({"bezier, 300 red points", 'B', std::move(points), 30000.f});
+    }
+    corpus.push_back({"catmull, 500 control points", 'C', randomPoints(500), 30000.f});
+    corpus.push_back({"linear, 2000 control points", 'L', randomPoints(2000), 30000.f});
+    corpus.push_back({"perfect, huge", 'P', {vec2{0.f, 0.f}, vec2{200.f, 40.f}, vec2{400.f, 0.f}}, 30000.f});
+    corpus.push_back({"perfect, normal", 'P', {vec2{0.f, 0.f}, vec2{100.f, 40.f}, vec2{200.f, 0.f}}, 300.f});
+
+    static constexpr int RUNS = 20;
+    static constexpr f32 EPSILON = 0.01f;
+
+    BenchCheck check("slider_curve_bench");
+
+    const bool configuredBatchEval = cv::slider_curve_batch_eval.getBool();
+    f64 totalTime[2]{};
+    for(const Slider &slider : corpus) {
+        std::unique_ptr<SliderCurve> curves[2];
+        f64 time[2]{};
+        for(const bool batch : {false, true}) {
+            cv::slider_curve_batch_eval.setValue(batch);
+
+            const u64 start = Timing::getTicksNS();
+            for(int run = 0; run < RUNS; run++) {
+                curves[batch].reset(SliderCurve::createCurve(slider.type, slider.controlPoints, slider.pixelLength));
+            }
+            time[batch] = static_cast<f64>(Timing::getTicksNS() - start) / RUNS / 1000000.0;
+            totalTime[batch] += time[batch];
+        }
+
+        // the equal distance points, and the raw segment points the slider body is drawn from
+        const auto &pointsA = curves[0]->getPoints();
+        const auto &pointsB = curves[1]->getPoints();
+        bool match = pointsA.size() == pointsB.size() &&
+                     curves[0]->getPointSegments().size() == curves[1]->getPointSegments().size();
+        f32 maxError = 0.f;
+        for(size_t i = 0; match && i < pointsA.size(); i++) {
+            maxError =
+                std::max({maxError, std::abs(pointsA[i].x - pointsB[i].x), std::abs(pointsA[i].y - pointsB[i].y)});
+        }
+        for(size_t s = 0; match && s < curves[0]->getPointSegments().size(); s++) {
+            const auto &segmentA = curves[0]->getPointSegments()[s];
+            const auto &segmentB = curves[1]->getPointSegments()[s];
+            match = segmentA.size() == segmentB.size();
+            for(size_t i = 0; match && i < segmentA.size(); i++) {
+                maxError = std::max(
+                    {maxError, std::abs(segmentA[i].x - segmentB[i].x), std::abs(segmentA[i].y - segmentB[i].y)});
+            }
+        }
+
+        Engine::logRaw(
+            "slider_curve_bench: {:28s} {:5d} points, scalar {:.3f} ms, batch {:.3f} ms ({:.2f}x), max error {:g}\n",
+            slider.name, pointsB.size(), time[0], time[1], time[0] / std::max(time[1], 1e-9), maxError);
+
+        check.expect(match, "{:s}: batch curve has {:d} points in {:d} segments, scalar {:d} in {:d}", slider.name,
+                     pointsB.size(), curves[1]->getPointSegments().size(), pointsA.size(),
+                     curves[0]->getPointSegments().size());
+        check.expect(!match || maxError <= EPSILON, "{:s}: batch curve is off by up to {:g}", slider.name, maxError);
+    }
+
+    Engine::logRaw("slider_curve_bench: total scalar {:.3f} ms, batch {:.3f} ms\n", totalTime[0], totalTime[1]);
+    cv::slider_curve_batch_eval.setValue(configuredBatchEval);
+    check.finish();
+}
@@ -20,6 +20,9 @@ class SliderCurve {
     static SliderCurve *createCurve(char osuSliderCurveType, std::vector<vec2> controlPoints, float pixelLength,
                                     float curvePointsSeparation);
 
+    // slider_curve_bench: pathological sliders with and without slider_curve_batch_eval (which must match)
+    static void bench();
+
    public:
     SliderCurve(std::vector<vec2> controlPoints, float pixelLength);
     virtual ~SliderCurve() { ; }
@@ -70,6 +73,9 @@ class SliderCurveType {
     [[nodiscard]] inline const std::vector<float> &getCurveDistances() const { return this->curveDistances; }
 
    protected:
+    // the points for init(), (float)i / (numPoints - 1) for every i. one pointAt() per point, unless overridden
+    virtual void pointsAt(int numPoints, std::vector<vec2> &output);
+
     // either one must be called from one of the subclasses
     void init(
         float approxLength);  // subdivide the curve by calling virtual pointAt() to create all intermediary points
@@ -101,6 +107,9 @@ class SliderCurveTypeCentripetalCatmullRom final : public SliderCurveType {
 
     vec2 pointAt(float t) override;
 
+   protected:
+    void pointsAt(int numPoints, std::vector<vec2> &output) override;
+
    private:
     float time[4];
     std::vector<vec2> points;
@@ -186,3 +195,45 @@ class SliderBezierApproximator {
     std::vector<vec2> subdivisionBuffer1;
     std::vector<vec2> subdivisionBuffer2;
 };
+
+// evaluates whole curve segments at once, with the same math as the one point at a time code paths (see
+// slider_curve_batch_eval, slider_curve_bench). coordinates are kept as separate x/y arrays so that the inner loops
+// vectorize, and all scratch buffers are kept around between calls (one instance per thread, see get())
+class SliderCurveBatchEvaluator {
+    NOCOPY_NOMOVE(SliderCurveBatchEvaluator)
+   public:
+    static SliderCurveBatchEvaluator &get();
+
+    SliderCurveBatchEvaluator() = default;
+
+    // same output as SliderBezierApproximator::createBezier()
+    void createBezier(const std::vector<vec2> &controlPoints, std::vector<vec2> &output);
+
+    // same output as SliderCurveTypeCentripetalCatmullRom::pointAt() for (float)i / (numPoints - 1), for every i
+    void createCatmull(const std::vector<vec2> &points, const float (&time)[4], int numPoints,
+                       std::vector<vec2> &output);
+
+    // same output as SliderCurveCircumscribedCircle::pointAt() for every clamp(i / steps, 0, 1) up to the first 1
+    void createArc(vec2 center, float radius, float startAngle, float endAngle, float steps, int maxSteps,
+                   float sanityRange, std::vector<vec2> &output);
+
+   private:
+    static constexpr const double BEZIER_TOLERANCE_SQ{0.25 * 0.25};  // same as SliderBezierApproximator
+
+    [[nodiscard]] bool isFlatEnough(const float *x, const float *y) const;
+    void subdivide(const float *x, const float *y);  // into leftX/Y and rightX/Y
+    void approximate(const float *x, const float *y, std::vector<vec2> &output);
+
+    size_t iCount{0};
+
+    // bezier subdivision stack, iCount floats per entry
+    std::vector<float> stackX;
+    std::vector<float> stackY;
+
+    std::vector<float> midX, midY;
+    std::vector<float> leftX, leftY;    // 2 * iCount - 1, approximate() uses the whole thing
+    std::vector<float> rightX, rightY;
+
+    // t, x and y of every point for catmull/arc segments
+    std::vector<float> t, x, y;
+};
@@ -39,7 +39,7 @@ float s_fBoundingBoxMinY = (std::numeric_limits<float>::max)();
 float s_fBoundingBoxMaxY = 0.0f;
 
 // forward decls
-void drawFillSliderBodyPeppy(const std::vector<vec2> &points, VertexArrayObject *circleMesh, float radius,
+void drawFillSliderBodyPeppy(std::span<const vec2> points, VertexArrayObject *circleMesh, float radius,
                              int drawFromIndex, int drawUpToIndex, Shader *shader = nullptr);
 void checkUpdateVars(float hitcircleDiameter);
 void resetRenderTargetBoundingBox();
@@ -132,7 +132,7 @@ VertexArrayObject *generateVAO(const std::vector<vec2> &points, float hitcircleD
     return vao;
 }
 
-void draw(const std::vector<vec2> &points, const std::vector<vec2> &alwaysPoints, float hitcircleDiameter, float from,
+void draw(std::span<const vec2> points, std::span<const vec2> alwaysPoints, float hitcircleDiameter, float from,
           float to, Color undimmedColor, float colorRGBMultiplier, float alpha, long sliderTimeForRainbow) {
     if(cv::slider_alpha_multiplier.getFloat() <= 0.0f || alpha <= 0.0f) return;
 
@@ -271,7 +271,7 @@ void draw(const std::vector<vec2> &points, const std::vector<vec2> &alwaysPoints
                                           s_fBoundingBoxMaxY - s_fBoundingBoxMinY);
 }
 
-void draw(VertexArrayObject *vao, const std::vector<vec2> &alwaysPoints, vec2 translation, float scale,
+void draw(VertexArrayObject *vao, std::span<const vec2> alwaysPoints, vec2 translation, float scale,
           float hitcircleDiameter, float from, float to, Color undimmedColor, float colorRGBMultiplier, float alpha,
           long sliderTimeForRainbow, bool doEnableRenderTarget, bool doDisableRenderTarget,
           bool doDrawSliderFrameBufferToScreen) {
@@ -385,7 +385,7 @@ void draw(VertexArrayObject *vao, const std::vector<vec2> &alwaysPoints, vec2 tr
 
 namespace {  // static
 
-void drawFillSliderBodyPeppy(const std::vector<vec2> &points, VertexArrayObject *circleMesh, float radius,
+void drawFillSliderBodyPeppy(std::span<const vec2> points, VertexArrayObject *circleMesh, float radius,
                              int drawFromIndex, int drawUpToIndex, Shader *shader) {
     if(drawFromIndex < 0) drawFromIndex = 0;
     if(drawUpToIndex < 0) drawUpToIndex = points.size();
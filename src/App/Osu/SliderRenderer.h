@@ -4,6 +4,7 @@
 #include "Vectors.h"
 #include "Color.h"
 
+#include <span>
 #include <vector>
 
 class Shader;
@@ -13,10 +14,10 @@ namespace SliderRenderer {
 VertexArrayObject *generateVAO(const std::vector<vec2> &points, float hitcircleDiameter,
                                vec3 translation = vec3(0, 0, 0), bool skipOOBPoints = true);
 
-void draw(const std::vector<vec2> &points, const std::vector<vec2> &alwaysPoints, float hitcircleDiameter,
+void draw(std::span<const vec2> points, std::span<const vec2> alwaysPoints, float hitcircleDiameter,
           float from = 0.0f, float to = 1.0f, Color undimmedColor = 0xffffffff, float colorRGBMultiplier = 1.0f,
           float alpha = 1.0f, long sliderTimeForRainbow = 0);
-void draw(VertexArrayObject *vao, const std::vector<vec2> &alwaysPoints, vec2 translation, float scale,
+void draw(VertexArrayObject *vao, std::span<const vec2> alwaysPoints, vec2 translation, float scale,
           float hitcircleDiameter, float from = 0.0f, float to = 1.0f, Color undimmedColor = 0xffffffff,
           float colorRGBMultiplier = 1.0f, float alpha = 1.0f, long sliderTimeForRainbow = 0,
           bool doEnableRenderTarget = true, bool doDisableRenderTarget = true,
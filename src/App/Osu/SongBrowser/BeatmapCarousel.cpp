@@ -1,6 +1,7 @@
 // Copyright (c) 2025, WH, All rights reserved.
 
 #include "BeatmapCarousel.h"
+#include "BackgroundImageHandler.h"
 #include "CollectionButton.h"
 #include "SongBrowser.h"
 #include "CarouselButton.h"
@@ -9,23 +10,454 @@
 #include "UIContextMenu.h"
 #include "OptionsMenu.h"
 #include "CBaseUIContainer.h"
+#include "ConVar.h"
 #include "Engine.h"
+#include "Osu.h"
 #include "Mouse.h"
 #include "Keyboard.h"
+#include "AnimationHandler.h"
+#include "ResourceManager.h"
+#include "Skin.h"
+#include "SoundEngine.h"
+
+#include <algorithm>
+
+float CarouselRowWidget::lastHoverSoundTime = 0;
+
+CarouselRowWidget::CarouselRowWidget(BeatmapCarousel *carousel) : CBaseUIButton(), carousel(carousel) {
+    this->bVisible = false;
+}
+
+CarouselRowWidget::~CarouselRowWidget() { this->unbind(); }
+
+void CarouselRowWidget::bind(CarouselButton *row) {
+    this->row = row;
+    row->widget = this;
+
+    // whatever this widget showed before, the row starts out from its resting state
+    this->deleteAnimations();
+    this->moveAwayState = MOVE_AWAY_STATE::MOVE_CENTER;
+    this->fHoverMoveAwayAnimation = 0.0f;
+    this->fHoverOffsetAnimation = 0.0f;
+    this->fTargetOffsetPercent = row->getOffsetPercent();
+    this->fOffsetPercent = this->fTargetOffsetPercent;
+    this->bRightClick = false;
+    this->bRightClickCheck = false;
+
+    // scrolling pinch effect
+    this->fCenterOffsetAnimation = 1.0f;
+
+    float centerOffsetVelocityAnimationTarget =
+        std::clamp<float>((std::abs(this->carousel->getVelocity().y)) / 3500.0f, 0.0f, 1.0f);
+
+    if(osu->getSongBrowser()->isRightClickScrolling()) centerOffsetVelocityAnimationTarget = 0.0f;
+
+    this->fCenterOffsetVelocityAnimation = centerOffsetVelocityAnimationTarget;
+
+    CBaseUIButton::setVisible(true);
+
+    // force early layout update
+    this->updateLayout();
+}
+
+void CarouselRowWidget::unbind() {
+    if(this->row != nullptr) this->row->widget = nullptr;
+    this->row = nullptr;
+
+    this->deleteAnimations();
+    CBaseUIButton::setVisible(false);
+}
+
+void CarouselRowWidget::deleteAnimations() {
+    anim->deleteExistingAnimation(&this->fOffsetPercent);
+    anim->deleteExistingAnimation(&this->fCenterOffsetAnimation);
+    anim->deleteExistingAnimation(&this->fCenterOffsetVelocityAnimation);
+    anim->deleteExistingAnimation(&this->fHoverOffsetAnimation);
+    anim->deleteExistingAnimation(&this->fHoverMoveAwayAnimation);
+}
+
+void CarouselRowWidget::draw() {
+    if(!this->bVisible || this->row == nullptr) return;
+    if(this->vPos.y + this->vSize.y < 0) return;
+    if(this->vPos.y > osu->getScreenHeight()) return;
+
+    this->drawMenuButtonBackground();
+
+    // debug inner bounding box
+    if(cv::debug_osu.getBool()) {
+        // scaling
+        const vec2 pos = this->getActualPos();
+        const vec2 size = this->getActualSize();
+
+        g->setColor(0xffff00ff);
+        g->drawLine(pos.x, pos.y, pos.x + size.x, pos.y);
+        g->drawLine(pos.x, pos.y, pos.x, pos.y + size.y);
+        g->drawLine(pos.x, pos.y + size.y, pos.x + size.x, pos.y + size.y);
+        g->drawLine(pos.x + size.x, pos.y, pos.x + size.x, pos.y + size.y);
+    }
+
+    // debug outer/actual bounding box
+    if(cv::debug_osu.getBool()) {
+        g->setColor(0xffff0000);
+        g->drawLine(this->vPos.x, this->vPos.y, this->vPos.x + this->vSize.x, this->vPos.y);
+        g->drawLine(this->vPos.x, this->vPos.y, this->vPos.x, this->vPos.y + this->vSize.y);
+        g->drawLine(this->vPos.x, this->vPos.y + this->vSize.y, this->vPos.x + this->vSize.x,
+                    this->vPos.y + this->vSize.y);
+        g->drawLine(this->vPos.x + this->vSize.x, this->vPos.y, this->vPos.x + this->vSize.x,
+                    this->vPos.y + this->vSize.y);
+    }
+
+    this->row->draw();
+}
+
+void CarouselRowWidget::drawMenuButtonBackground() {
+    g->setColor(this->row->isSelected() ? this->row->getActiveBackgroundColor()
+                                        : this->row->getInactiveBackgroundColor());
+    g->pushTransform();
+    {
+        g->scale(this->fScale, this->fScale);
+        g->translate(this->vPos.x + this->vSize.x / 2, this->vPos.y + this->vSize.y / 2);
+        g->drawImage(osu->getSkin()->getMenuButtonBackground());
+    }
+    g->popTransform();
+}
+
+void CarouselRowWidget::mouse_update(bool *propagate_clicks) {
+    if(!this->bVisible || this->row == nullptr) return;
+
+    // Not correct, but clears most of the lag
+    if(this->vPos.y + this->vSize.y < 0) return;
+    if(this->vPos.y > osu->getScreenHeight()) return;
+
+    // HACKHACK: absolutely disgusting
+    // temporarily fool CBaseUIElement with modified position and size
+    {
+        vec2 posBackup = this->vPos;
+        vec2 sizeBackup = this->vSize;
+
+        this->vPos = this->getActualPos();
+        this->vSize = this->getActualSize();
+        {
+            CBaseUIButton::mouse_update(propagate_clicks);
+        }
+        this->vPos = posBackup;
+        this->vSize = sizeBackup;
+    }
+
+    // (clicking might have rebuilt the rows, and unbound or rebound this widget)
+    if(!this->bVisible || this->row == nullptr) return;
+
+    // HACKHACK: this should really be part of the UI base
+    // right click detection
+    if(mouse->isRightDown()) {
+        if(!this->bRightClickCheck) {
+            this->bRightClickCheck = true;
+            this->bRightClick = this->isMouseInside();
+        }
+    } else {
+        if(this->bRightClick) {
+            if(this->isMouseInside()) this->row->onRightMouseUpInside();
+        }
+
+        this->bRightClickCheck = false;
+        this->bRightClick = false;
+    }
+
+    this->row->update();
+
+    const float targetOffsetPercent = this->row->getOffsetPercent();
+    if(targetOffsetPercent != this->fTargetOffsetPercent) {
+        this->fTargetOffsetPercent = targetOffsetPercent;
+        anim->moveQuadOut(&this->fOffsetPercent, targetOffsetPercent, 0.25f, true);
+    }
+
+    // animations need constant layout updates while visible
+    this->updateLayout();
+}
+
+void CarouselRowWidget::updateLayout() {
+    this->fScale = BeatmapCarousel::getRowScale();
+
+    if(this->bVisible)  // lag prevention (animationHandler overflow)
+    {
+        const float centerOffsetAnimationTarget =
+            1.0f - std::clamp<float>(std::abs((this->vPos.y + (this->vSize.y / 2) - this->carousel->getPos().y -
+                                               this->carousel->getSize().y / 2) /
+                                              (this->carousel->getSize().y / 2)),
+                                     0.0f, 1.0f);
+        anim->moveQuadOut(&this->fCenterOffsetAnimation, centerOffsetAnimationTarget, 0.5f, true);
+
+        float centerOffsetVelocityAnimationTarget =
+            std::clamp<float>((std::abs(this->carousel->getVelocity().y)) / 3500.0f, 0.0f, 1.0f);
+
+        if(osu->getSongBrowser()->isRightClickScrolling()) centerOffsetVelocityAnimationTarget = 0.0f;
+
+        if(this->carousel->isScrolling())
+            anim->moveQuadOut(&this->fCenterOffsetVelocityAnimation, 0.0f, 1.0f, true);
+        else
+            anim->moveQuadOut(&this->fCenterOffsetVelocityAnimation, centerOffsetVelocityAnimationTarget, 1.25f, true);
+    }
+
+    this->setSize(BeatmapCarousel::getRowSize());
+
+    const float percentCenterOffsetAnimation = 0.035f;
+    const float percentVelocityOffsetAnimation = 0.35f;
+    const float percentHoverOffsetAnimation = 0.075f;
+
+    // this is the minimum offset necessary to not clip into the score scrollview (including all possible max animations
+    // which can push us to the left, worst case)
+    float minOffset = this->carousel->getSize().x * (percentCenterOffsetAnimation + percentHoverOffsetAnimation);
+    {
+        // also respect the width of the button image: push to the right until the edge of the button image can never be
+        // visible even if all animations are fully active the 0.85f here heuristically pushes the buttons a bit further
+        // to the right than would be necessary, to make animations work better on lower resolutions (would otherwise
+        // hit the left edge too early)
+        const float buttonWidthCompensation =
+            std::max(this->carousel->getSize().x - this->getActualSize().x * 0.85f, 0.0f);
+        minOffset += buttonWidthCompensation;
+    }
+
+    float offsetX =
+        minOffset -
+        this->carousel->getSize().x *
+            (percentCenterOffsetAnimation * this->fCenterOffsetAnimation *
+                 (1.0f - this->fCenterOffsetVelocityAnimation) +
+             percentHoverOffsetAnimation * this->fHoverOffsetAnimation -
+             percentVelocityOffsetAnimation * this->fCenterOffsetVelocityAnimation + this->fOffsetPercent);
+    offsetX = std::clamp<float>(
+        offsetX, 0.0f,
+        this->carousel->getSize().x -
+            this->getActualSize().x * 0.15f);  // WARNING: hardcoded to match 0.85f above for buttonWidthCompensation
+
+    this->setRelPosX(offsetX);
+    this->setRelPosY(this->row->getTargetRelPosY() + this->getSize().y * 0.125f * this->fHoverMoveAwayAnimation);
+
+    this->row->updateLayoutEx();
+}
+
+void CarouselRowWidget::onClicked(bool left, bool right) {
+    CBaseUIButton::onClicked(left, right);
+
+    this->row->onClicked();
+}
+
+void CarouselRowWidget::onMouseInside() {
+    CBaseUIButton::onMouseInside();
+
+    // hover sound
+    if(engine->getTime() > lastHoverSoundTime + 0.05f)  // to avoid earraep
+    {
+        if(engine->hasFocus()) soundEngine->play(osu->getSkin()->getMenuHover());
+
+        lastHoverSoundTime = engine->getTime();
+    }
+
+    // hover anim
+    anim->moveQuadOut(&this->fHoverOffsetAnimation, 1.0f, 1.0f * (1.0f - this->fHoverOffsetAnimation), true);
+
+    // move the rest of the buttons away from hovered-over one
+    bool foundCenter = false;
+    for(CarouselRowWidget *widget : this->carousel->getRowWidgets()) {
+        if(widget == this) {
+            foundCenter = true;
+            widget->setMoveAwayState(MOVE_AWAY_STATE::MOVE_CENTER);
+        } else
+            widget->setMoveAwayState(foundCenter ? MOVE_AWAY_STATE::MOVE_DOWN : MOVE_AWAY_STATE::MOVE_UP);
+    }
+}
+
+void CarouselRowWidget::onMouseOutside() {
+    CBaseUIButton::onMouseOutside();
+
+    // reverse hover anim
+    anim->moveQuadOut(&this->fHoverOffsetAnimation, 0.0f, 1.0f * this->fHoverOffsetAnimation, true);
+
+    // only reset all other elements' state if we still should do so (possible frame delay of onMouseOutside coming
+    // together with the next element already getting onMouseInside!)
+    if(this->moveAwayState == MOVE_AWAY_STATE::MOVE_CENTER) {
+        for(CarouselRowWidget *widget : this->carousel->getRowWidgets()) {
+            widget->setMoveAwayState(MOVE_AWAY_STATE::MOVE_CENTER);
+        }
+    }
+}
+
+void CarouselRowWidget::resetMoveAway() { this->setMoveAwayState(MOVE_AWAY_STATE::MOVE_CENTER, false); }
+
+vec2 CarouselRowWidget::getActualOffset() const { return BeatmapCarousel::getRowMargin(this->fScale); }
+
+void CarouselRowWidget::setMoveAwayState(MOVE_AWAY_STATE moveAwayState, bool animate) {
+    this->moveAwayState = moveAwayState;
+
+    // if we are not visible, destroy possibly existing animation
+    if(!this->isVisible() || !animate) anim->deleteExistingAnimation(&this->fHoverMoveAwayAnimation);
+
+    // only submit a new animation if we are visible, otherwise we would overwhelm the animationhandler with a shitload
+    // of requests every time for every button (if we are not visible then we can just directly set the new value)
+    switch(this->moveAwayState) {
+        case MOVE_AWAY_STATE::MOVE_CENTER: {
+            if(!this->isVisible() || !animate)
+                this->fHoverMoveAwayAnimation = 0.0f;
+            else
+                anim->moveQuartOut(&this->fHoverMoveAwayAnimation, 0, 0.7f, this->isMouseInside() ? 0.0f : 0.05f,
+                                   true);  // add a tiny bit of delay to avoid jerky movement if the cursor is briefly
+                                           // between songbuttons while moving
+        } break;
+
+        case MOVE_AWAY_STATE::MOVE_UP: {
+            if(!this->isVisible() || !animate)
+                this->fHoverMoveAwayAnimation = -1.0f;
+            else
+                anim->moveQuartOut(&this->fHoverMoveAwayAnimation, -1.0f, 0.7f, true);
+        } break;
+
+        case MOVE_AWAY_STATE::MOVE_DOWN: {
+            if(!this->isVisible() || !animate)
+                this->fHoverMoveAwayAnimation = 1.0f;
+            else
+                anim->moveQuartOut(&this->fHoverMoveAwayAnimation, 1.0f, 0.7f, true);
+        } break;
+    }
+}
 
 BeatmapCarousel::~BeatmapCarousel() {
-    // elements are free'd manually/externally by SongBrowser, so invalidate the container to avoid double-free
-    // TODO: factor this out from SongBrowser
+    // the widgets are owned by the pool, not by the container
     this->getContainer()->invalidate();
+    for(const auto &widget : this->widgetPool) {
+        widget->unbind();
+    }
 }
 
 void BeatmapCarousel::draw() { CBaseUIScrollView::draw(); }
 
+float BeatmapCarousel::getRowScale() {
+    Image *menuButtonBackground = osu->getSkin()->getMenuButtonBackground();
+
+    const vec2 minimumSize = vec2(699.0f, 103.0f) * (osu->getSkin()->isMenuButtonBackground2x() ? 2.0f : 1.0f);
+    const float minimumScale = Osu::getImageScaleToFitResolution(menuButtonBackground, minimumSize);
+    return Osu::getImageScale(menuButtonBackground->getSize() * minimumScale, 64.0f) * cv::ui_scale.getFloat();
+}
+
+vec2 BeatmapCarousel::getRowSize() {
+    const Image *menuButtonBackground = osu->getSkin()->getMenuButtonBackground();
+    const float rowScale = getRowScale();
+    return vec2((int)(menuButtonBackground->getWidth() * rowScale),
+                (int)(menuButtonBackground->getHeight() * rowScale));
+}
+
+vec2 BeatmapCarousel::getRowMargin(float rowScale) {
+    static constexpr int marginPixelsX = 9;
+    static constexpr int marginPixelsY = 9;
+
+    const float hd2xMultiplier = osu->getSkin()->isMenuButtonBackground2x() ? 2.0f : 1.0f;
+    const float correctedMarginPixelsY =
+        (2 * marginPixelsY + osu->getSkin()->getMenuButtonBackground()->getHeight() / hd2xMultiplier - 103.0f) / 2.0f;
+    return vec2((int)(marginPixelsX * rowScale * hd2xMultiplier),
+                (int)(correctedMarginPixelsY * rowScale * hd2xMultiplier));
+}
+
+void BeatmapCarousel::clearRows() {
+    this->rows.clear();
+    this->bVisibleRowsDirty = true;
+
+    // widgets stay bound until updateVisibleRows(), so that rows which are still in view afterwards keep animating
+    // smoothly. the hover offsets of the old layout don't make sense anymore though
+    for(CarouselRowWidget *widget : this->activeWidgets) {
+        widget->resetMoveAway();
+    }
+}
+
+void BeatmapCarousel::addRow(CarouselButton *button) {
+    button->iRowIndex = static_cast<u32>(this->rows.size());
+    this->rows.push_back(button);
+}
+
+bool BeatmapCarousel::hasRow(const CarouselButton *button) const {
+    return button->iRowIndex < this->rows.size() && this->rows[button->iRowIndex] == button;
+}
+
+void BeatmapCarousel::onRowLayoutChanged() {
+    // the container only holds the visible rows, so the scroll size has to come from the row model
+    const vec2 rowSize = getRowSize();
+    vec2 contentSize{std::max(this->getSize().x, rowSize.x), 0.f};
+    if(!this->rows.empty()) contentSize.y = this->rows.back()->getTargetRelPosY() + rowSize.y;
+    this->setScrollSize(contentSize + vec2(this->getSize().y / 2));
+
+    this->bVisibleRowsDirty = true;
+    this->updateVisibleRows();
+}
+
+void BeatmapCarousel::updateVisibleRows() {
+    // keep half a screen of rows around the viewport, so they've already been updated once they scroll into view
+    const float margin = this->getSize().y / 2;
+    const float viewTop = -this->getRelPosY() - margin;  // (in container space)
+    const float viewBottom = -this->getRelPosY() + this->getSize().y + margin;
+    const float rowHeight = getRowSize().y;
+
+    // rows are laid out top to bottom
+    const auto first = std::ranges::lower_bound(
+        this->rows, viewTop, std::less{},
+        [rowHeight](const CarouselButton *row) { return row->getTargetRelPosY() + rowHeight; });
+    const auto last = std::ranges::lower_bound(first, this->rows.end(), viewBottom, std::less{},
+                                               [](const CarouselButton *row) { return row->getTargetRelPosY(); });
+
+    const auto firstVisibleRow = static_cast<size_t>(first - this->rows.begin());
+    const auto numVisibleRows = static_cast<size_t>(last - first);
+    if(!this->bVisibleRowsDirty && firstVisibleRow == this->iFirstVisibleRow &&
+       numVisibleRows == this->iNumVisibleRows)
+        return;
+
+    this->bVisibleRowsDirty = false;
+    this->iFirstVisibleRow = firstVisibleRow;
+    this->iNumVisibleRows = numVisibleRows;
+
+    const size_t lastVisibleRow = firstVisibleRow + numVisibleRows;
+
+    // return the widgets of rows which went out of range (or aren't rows anymore) to the pool
+    std::erase_if(this->activeWidgets, [&](CarouselRowWidget *widget) {
+        const CarouselButton *row = widget->getRow();
+        if(row != nullptr && this->hasRow(row) && row->iRowIndex >= firstVisibleRow &&
+           row->iRowIndex < lastVisibleRow)
+            return false;
+
+        widget->unbind();
+        this->freeWidgets.push_back(widget);
+        return true;
+    });
+
+    // and bind the ones which came into range
+    for(auto it = first; it != last; ++it) {
+        CarouselButton *row = *it;
+        if(row->widget != nullptr) continue;
+
+        if(this->freeWidgets.empty())
+            this->freeWidgets.push_back(this->widgetPool.emplace_back(std::make_unique<CarouselRowWidget>(this)).get());
+
+        CarouselRowWidget *widget = this->freeWidgets.back();
+        this->freeWidgets.pop_back();
+
+        widget->bind(row);
+        this->activeWidgets.push_back(widget);
+    }
+
+    std::ranges::sort(this->activeWidgets, std::less{},
+                      [](const CarouselRowWidget *widget) { return widget->getRow()->iRowIndex; });
+
+    CBaseUIContainer *container = this->getContainer();
+    container->invalidate();
+    for(CarouselRowWidget *widget : this->activeWidgets) {
+        container->addBaseUIElement(widget, widget->getRelPos().x, widget->getRelPos().y);
+    }
+}
+
 void BeatmapCarousel::mouse_update(bool *propagate_clicks) {
+    if(this->isVisible()) this->updateVisibleRows();
+
     CBaseUIScrollView::mouse_update(propagate_clicks);
     if(!this->isVisible()) return;
     this->getContainer()->update_pos();  // necessary due to constant animations
 
+    this->prefetchThumbnails();
+
     // handle right click absolute scrolling
     {
         if(mouse->isRightDown() && !this->browser_ptr->contextMenu->isMouseInside()) {
@@ -61,68 +493,106 @@ void BeatmapCarousel::mouse_update(bool *propagate_clicks) {
     }
 }
 
+void BeatmapCarousel::prefetchThumbnails() {
+    // remember the last scroll direction, so that we keep prefetching in that direction while standing still
+    const float scrollPosY = this->getRelPosY();
+    if(scrollPosY < this->fPrevScrollPosY)
+        this->bScrollingDown = true;
+    else if(scrollPosY > this->fPrevScrollPosY)
+        this->bScrollingDown = false;
+    this->fPrevScrollPosY = scrollPosY;
+
+    const int numPrefetch = cv::songbrowser_thumbnail_prefetch.getInt();
+    if(numPrefetch < 1 || !cv::draw_songbrowser_thumbnails.getBool()) return;
+
+    const std::vector<CarouselButton *> &elements{this->rows};
+    const float viewTop = -this->getRelPosY();  // (in container space)
+    const float viewBottom = viewTop + this->getSize().y;
+    const float rowHeight = getRowSize().y;
+
+    // rows are laid out top to bottom, so binary search for the viewport edge instead of scanning everything
+    const auto firstBelow = std::ranges::lower_bound(elements, viewBottom, std::less{},
+                                                     [](const CarouselButton *e) { return e->getTargetRelPosY(); });
+    const auto firstInside =
+        std::ranges::lower_bound(elements, viewTop, std::less{},
+                                 [rowHeight](const CarouselButton *e) { return e->getTargetRelPosY() + rowHeight; });
+
+    auto prefetch = [](CarouselButton *element) {
+        if(element->isCollectionButton()) return;
+        const auto *songButton = static_cast<SongButton *>(element);
+        osu->getBackgroundImageHandler()->prefetchBackgroundImage(songButton->getThumbnailBeatmap(), true);
+    };
+
+    if(this->bScrollingDown) {
+        for(auto it = firstBelow; it != elements.end() && it - firstBelow < numPrefetch; ++it) {
+            prefetch(*it);
+        }
+    } else {
+        for(auto it = firstInside; it != elements.begin() && firstInside - it < numPrefetch;) {
+            prefetch(*--it);
+        }
+    }
+}
+
 void BeatmapCarousel::onKeyUp(KeyboardEvent & /*e*/) { /*this->getContainer()->onKeyUp(e);*/ ; }
 
+int BeatmapCarousel::getBottomSelectedRow() const {
+    for(int i = static_cast<int>(this->rows.size()) - 1; i >= 0; i--) {
+        if(this->rows[i]->isSelected()) return i;
+    }
+    return -1;
+}
+
 // don't consume keys, we are not a keyboard listener, but called from SongBrowser::onKeyDown manually
 void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
     /*this->getContainer()->onKeyDown(e);*/
 
-    const std::vector<CBaseUIElement *> &elements{this->getContainer()->getElements()};
+    const std::vector<CarouselButton *> &elements{this->rows};
+
+    // diffs which are shown below their expanded parent song button are skipped by left/right
+    auto isDependentDiffButton = [](const CarouselButton *button) {
+        return button->isDifficultyButton() &&
+               !static_cast<const SongDifficultyButton *>(button)->isIndependentDiffButton();
+    };
 
     // selection move
     if(!keyboard->isAltDown() && key == KEY_DOWN) {
-        // get bottom selection
-        int selectedIndex = -1;
-        for(int i = 0; i < elements.size(); i++) {
-            auto *button = dynamic_cast<CarouselButton *>(elements[i]);
-            if(button != nullptr && button->isSelected()) selectedIndex = i;
-        }
+        const int selectedIndex = this->getBottomSelectedRow();
 
         // select +1
-        if(selectedIndex > -1 && selectedIndex + 1 < elements.size()) {
-            int nextSelectionIndex = selectedIndex + 1;
-            auto *nextButton = dynamic_cast<CarouselButton *>(elements[nextSelectionIndex]);
-            auto *songButton = dynamic_cast<SongButton *>(elements[nextSelectionIndex]);
-            if(nextButton != nullptr) {
-                nextButton->select(true, false);
-
-                // if this is a song button, select top child
-                if(songButton != nullptr) {
-                    const auto &children = songButton->getChildren();
-                    if(children.size() > 0 && !children[0]->isSelected()) children[0]->select(true, false, false);
-                }
+        if(selectedIndex > -1 && static_cast<size_t>(selectedIndex + 1) < elements.size()) {
+            CarouselButton *nextButton = elements[selectedIndex + 1];
+            nextButton->select(true, false);
+
+            // if this is a song button, select top child
+            if(!nextButton->isCollectionButton()) {
+                const auto &children = nextButton->getChildren();
+                if(children.size() > 0 && !children[0]->isSelected()) children[0]->select(true, false, false);
             }
         }
     }
 
     if(!keyboard->isAltDown() && key == KEY_UP) {
-        // get bottom selection
-        int selectedIndex = -1;
-        for(int i = 0; i < elements.size(); i++) {
-            auto *button = dynamic_cast<CarouselButton *>(elements[i]);
-            if(button != nullptr && button->isSelected()) selectedIndex = i;
-        }
+        const int selectedIndex = this->getBottomSelectedRow();
 
         // select -1
         if(selectedIndex > -1 && selectedIndex - 1 > -1) {
             int nextSelectionIndex = selectedIndex - 1;
-            auto *nextButton = dynamic_cast<CarouselButton *>(elements[nextSelectionIndex]);
-            bool isCollectionButton = dynamic_cast<CollectionButton *>(elements[nextSelectionIndex]);
-
-            if(nextButton != nullptr) {
-                nextButton->select();
-
-                // automatically open collection on top of this one and go to bottom child
-                if(isCollectionButton && nextSelectionIndex - 1 > -1) {
-                    nextSelectionIndex = nextSelectionIndex - 1;
-                    auto *nextCollectionButton = dynamic_cast<CollectionButton *>(elements[nextSelectionIndex]);
-                    if(nextCollectionButton != nullptr) {
-                        nextCollectionButton->select();
-
-                        const auto &children = nextCollectionButton->getChildren();
-                        if(children.size() > 0 && !children[children.size() - 1]->isSelected())
-                            children[children.size() - 1]->select();
-                    }
+            CarouselButton *nextButton = elements[nextSelectionIndex];
+            const bool isCollectionButton = nextButton->isCollectionButton();
+
+            nextButton->select();
+
+            // automatically open collection on top of this one and go to bottom child
+            if(isCollectionButton && nextSelectionIndex - 1 > -1) {
+                nextSelectionIndex = nextSelectionIndex - 1;
+                CarouselButton *nextCollectionButton = elements[nextSelectionIndex];
+                if(nextCollectionButton->isCollectionButton()) {
+                    nextCollectionButton->select();
+
+                    const auto &children = nextCollectionButton->getChildren();
+                    if(children.size() > 0 && !children[children.size() - 1]->isSelected())
+                        children[children.size() - 1]->select();
                 }
             }
         }
@@ -135,24 +605,19 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
 
         bool foundSelected = false;
         for(sSz i = elements.size() - 1; i >= 0; i--) {
-            const auto *diffButtonPointer = dynamic_cast<const SongDifficultyButton *>(elements[i]);
-            const auto *collectionButtonPointer = dynamic_cast<const CollectionButton *>(elements[i]);
-
-            auto *button = dynamic_cast<CarouselButton *>(elements[i]);
-            const bool isSongDifficultyButtonAndNotIndependent =
-                (diffButtonPointer != nullptr && !diffButtonPointer->isIndependentDiffButton());
+            CarouselButton *button = elements[i];
+            const bool isCollectionButton = button->isCollectionButton();
 
-            if(foundSelected && button != nullptr && !button->isSelected() &&
-               !isSongDifficultyButtonAndNotIndependent && (!jumpToNextGroup || collectionButtonPointer != nullptr)) {
+            if(foundSelected && !button->isSelected() && !isDependentDiffButton(button) &&
+               (!jumpToNextGroup || isCollectionButton)) {
                 this->browser_ptr->bNextScrollToSongButtonJumpFixUseScrollSizeDelta = true;
                 {
                     button->select();
 
-                    if(!jumpToNextGroup || collectionButtonPointer == nullptr) {
+                    if(!jumpToNextGroup || !isCollectionButton) {
                         // automatically open collection below and go to bottom child
-                        auto *collectionButton = dynamic_cast<CollectionButton *>(elements[i]);
-                        if(collectionButton != nullptr) {
-                            const auto &children = collectionButton->getChildren();
+                        if(isCollectionButton) {
+                            const auto &children = button->getChildren();
                             if(children.size() > 0 && !children[children.size() - 1]->isSelected())
                                 children[children.size() - 1]->select();
                         }
@@ -163,7 +628,7 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
                 break;
             }
 
-            if(button != nullptr && button->isSelected()) foundSelected = true;
+            if(button->isSelected()) foundSelected = true;
         }
     }
 
@@ -172,24 +637,12 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
 
         const bool jumpToNextGroup = keyboard->isShiftDown();
 
-        // get bottom selection
-        sSz selectedIndex = -1;
-        for(size_t i = 0; i < elements.size(); i++) {
-            const auto *button = dynamic_cast<const CarouselButton *>(elements[i]);
-            if(button != nullptr && button->isSelected()) selectedIndex = i;
-        }
-
+        const int selectedIndex = this->getBottomSelectedRow();
         if(selectedIndex > -1) {
             for(size_t i = selectedIndex; i < elements.size(); i++) {
-                const auto *diffButtonPointer = dynamic_cast<const SongDifficultyButton *>(elements[i]);
-                const auto *collectionButtonPointer = dynamic_cast<const CollectionButton *>(elements[i]);
-
-                auto *button = dynamic_cast<CarouselButton *>(elements[i]);
-                const bool isSongDifficultyButtonAndNotIndependent =
-                    (diffButtonPointer != nullptr && !diffButtonPointer->isIndependentDiffButton());
-
-                if(button != nullptr && !button->isSelected() && !isSongDifficultyButtonAndNotIndependent &&
-                   (!jumpToNextGroup || collectionButtonPointer != nullptr)) {
+                CarouselButton *button = elements[i];
+                if(!button->isSelected() && !isDependentDiffButton(button) &&
+                   (!jumpToNextGroup || button->isCollectionButton())) {
                     button->select();
                     break;
                 }
@@ -203,12 +656,8 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
     // group open/close
     // NOTE: only closing works atm (no "focus" state on buttons yet)
     if((key == KEY_ENTER || key == KEY_NUMPAD_ENTER) && keyboard->isShiftDown()) {
-        for(auto element : elements) {
-            const auto *collectionButtonPointer = dynamic_cast<const CollectionButton *>(element);
-
-            auto *button = dynamic_cast<CarouselButton *>(element);
-
-            if(collectionButtonPointer != nullptr && button != nullptr && button->isSelected()) {
+        for(CarouselButton *button : elements) {
+            if(button->isCollectionButton() && button->isSelected()) {
                 button->select();  // deselect
                 this->browser_ptr->scrollToSongButton(button);
                 break;
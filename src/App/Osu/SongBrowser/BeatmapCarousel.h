@@ -1,10 +1,69 @@
 #pragma once
 // Copyright (c) 2025, WH, All rights reserved.
 
+#include "CBaseUIButton.h"
 #include "CBaseUIScrollView.h"
 
+#include <memory>
+
+class BeatmapCarousel;
+class CarouselButton;
 class SongBrowser;
 
+// draws one carousel row and forwards input to it. the carousel keeps a small pool of these and binds them to the rows
+// around the viewport, all geometry and animation state lives in here, so a widget starts fresh every time it's bound
+class CarouselRowWidget final : public CBaseUIButton {
+    NOCOPY_NOMOVE(CarouselRowWidget)
+   public:
+    CarouselRowWidget(BeatmapCarousel *carousel);
+    ~CarouselRowWidget() override;
+
+    void draw() override;
+    void mouse_update(bool *propagate_clicks) override;
+
+    void bind(CarouselButton *row);
+    void unbind();
+
+    // (without animating)
+    void resetMoveAway();
+
+    [[nodiscard]] inline CarouselButton *getRow() const { return this->row; }
+
+    [[nodiscard]] vec2 getActualOffset() const;
+    [[nodiscard]] inline vec2 getActualSize() const { return this->vSize - 2.f * this->getActualOffset(); }
+    [[nodiscard]] inline vec2 getActualPos() const { return this->vPos + this->getActualOffset(); }
+
+   private:
+    enum class MOVE_AWAY_STATE : uint8_t { MOVE_CENTER, MOVE_UP, MOVE_DOWN };
+
+    static float lastHoverSoundTime;
+
+    void onClicked(bool left = true, bool right = false) override;
+    void onMouseInside() override;
+    void onMouseOutside() override;
+
+    void updateLayout();
+    void drawMenuButtonBackground();
+    void deleteAnimations();
+    void setMoveAwayState(MOVE_AWAY_STATE moveAwayState, bool animate = true);
+
+    BeatmapCarousel *carousel;
+    CarouselButton *row{nullptr};
+
+    float fScale{1.0f};
+    float fOffsetPercent{0.0f};
+    float fTargetOffsetPercent{0.0f};
+    float fHoverOffsetAnimation{0.0f};
+    float fHoverMoveAwayAnimation{0.0f};
+    float fCenterOffsetAnimation{0.0f};
+    float fCenterOffsetVelocityAnimation{0.0f};
+
+    MOVE_AWAY_STATE moveAwayState{MOVE_AWAY_STATE::MOVE_CENTER};
+
+    bool bRightClick{false};
+    bool bRightClickCheck{false};
+};
+
 class BeatmapCarousel : public CBaseUIScrollView {
     NOCOPY_NOMOVE(BeatmapCarousel)
    public:
@@ -15,6 +74,9 @@ class BeatmapCarousel : public CBaseUIScrollView {
         this->setDrawFrame(false);
         this->setHorizontalScrolling(false);
         this->setScrollResistance(15);
+
+        // rows are virtualized by the carousel itself (and animate around), see updateVisibleRows()
+        this->bCullChildren = false;
     }
     ~BeatmapCarousel() override;
 
@@ -25,6 +87,43 @@ class BeatmapCarousel : public CBaseUIScrollView {
     void draw() override;
     void mouse_update(bool *propagate_clicks) override;
 
+    // the carousel is backed by a flat list of rows (in layout order). rows are plain data, only the ones around the
+    // viewport get one of the pooled CarouselRowWidgets bound to them, and only those are in the container. so
+    // per-frame updating/positioning/clipping/drawing only touches a handful of widgets, no matter how many beatmaps
+    // there are
+    void clearRows();
+    void addRow(CarouselButton *button);
+    [[nodiscard]] inline const std::vector<CarouselButton *> &getRows() const { return this->rows; }
+    [[nodiscard]] bool hasRow(const CarouselButton *button) const;
+
+    // the bound widgets, in row order
+    [[nodiscard]] inline const std::vector<CarouselRowWidget *> &getRowWidgets() const { return this->activeWidgets; }
+
+    // call after the rows were (re)laid out
+    void onRowLayoutChanged();
+
+    // all rows have the same size, which only depends on the skin and ui_scale
+    [[nodiscard]] static float getRowScale();
+    [[nodiscard]] static vec2 getRowSize();
+    [[nodiscard]] static vec2 getRowMargin(float rowScale);  // around the visible part of the button image
+
    private:
+    void updateVisibleRows();
+    void prefetchThumbnails();
+
+    [[nodiscard]] int getBottomSelectedRow() const;
+
     SongBrowser *browser_ptr;
+
+    std::vector<CarouselButton *> rows;
+    size_t iFirstVisibleRow{0};
+    size_t iNumVisibleRows{0};
+    bool bVisibleRowsDirty{true};
+
+    std::vector<std::unique_ptr<CarouselRowWidget>> widgetPool;
+    std::vector<CarouselRowWidget *> freeWidgets;
+    std::vector<CarouselRowWidget *> activeWidgets;
+
+    float fPrevScrollPosY{0.f};
+    bool bScrollingDown{true};
 };
@@ -1,59 +1,70 @@
 #pragma once
 // Copyright (c) 2016, PG, All rights reserved.
-#include <utility>
 #include <atomic>
+#include <utility>
+#include <vector>
 
-#include "CBaseUIButton.h"
+#include "cbase.h"
 
-class BeatmapCarousel;
+class CarouselRowWidget;
 class DatabaseBeatmap;
+class McFont;
 class SongBrowser;
 class SongButton;
 class UIContextMenu;
 
-class CarouselButton : public CBaseUIButton {
+// one row of the song carousel (a collection, beatmap set or difficulty).
+// rows are plain data: while a row is in view, one of the carousel's pooled CarouselRowWidgets is bound to it, which
+// owns the on-screen geometry and animations, draws the row and forwards input to it (see BeatmapCarousel)
+class CarouselButton {
+    NOCOPY_NOMOVE(CarouselButton)
    public:
-    CarouselButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, float xPos, float yPos,
-                   float xSize, float ySize, UString name);
-    ~CarouselButton() override;
-    void deleteAnimations();
-
-    void draw() override;
-    void mouse_update(bool *propagate_clicks) override;
-
-    virtual void updateLayoutEx();
+    CarouselButton(SongBrowser *songBrowser, UIContextMenu *contextMenu);
+    virtual ~CarouselButton();
 
-    CarouselButton *setVisible(bool visible) override;
+    // only called while bound to a widget
+    virtual void draw() { ; }
+    virtual void update() { ; }
+    virtual void updateLayoutEx() { ; }
 
     void select(bool fireCallbacks = true, bool autoSelectBottomMostChild = true, bool wasParentSelected = true);
     void deselect();
 
-    void resetAnimations();
+    void onClicked();
+    virtual void onRightMouseUpInside() { ; }
 
-    void setTargetRelPosY(float targetRelPosY);
+    void setTargetRelPosY(float targetRelPosY) { this->fTargetRelPosY = targetRelPosY; }
     void setChildren(std::vector<SongButton *> children) { this->children = std::move(children); }
-    void setOffsetPercent(float offsetPercent) { this->fOffsetPercent = offsetPercent; }
     void setHideIfSelected(bool hideIfSelected) { this->bHideIfSelected = hideIfSelected; }
     void setIsSearchMatch(bool isSearchMatch) { this->bIsSearchMatch = isSearchMatch; }
 
-    [[nodiscard]] vec2 getActualOffset() const;
-    [[nodiscard]] inline vec2 getActualSize() const { return this->vSize - 2.f * this->getActualOffset(); }
-    [[nodiscard]] inline vec2 getActualPos() const { return this->vPos + this->getActualOffset(); }
+    [[nodiscard]] inline float getTargetRelPosY() const { return this->fTargetRelPosY; }
+    [[nodiscard]] vec2 getActualPos() const;
+    [[nodiscard]] vec2 getActualSize() const;
     inline std::vector<SongButton *> &getChildren() { return this->children; }
 
+    // the offset (in percent of the carousel width) the widget animates towards
+    [[nodiscard]] virtual float getOffsetPercent() const { return 0.0f; }
+
     [[nodiscard]] virtual DatabaseBeatmap *getDatabaseBeatmap() const { return nullptr; }
     [[nodiscard]] virtual Color getActiveBackgroundColor() const;
     [[nodiscard]] virtual Color getInactiveBackgroundColor() const;
 
+    // cheap type checks, for code which has to look at every row in the carousel
+    [[nodiscard]] inline bool isCollectionButton() const { return this->type == TYPE::COLLECTION; }
+    [[nodiscard]] inline bool isDifficultyButton() const { return this->type == TYPE::DIFFICULTY; }
+
     [[nodiscard]] inline bool isSelected() const { return this->bSelected; }
     [[nodiscard]] inline bool isHiddenIfSelected() const { return this->bHideIfSelected; }
     [[nodiscard]] inline bool isSearchMatch() const { return this->bIsSearchMatch.load(); }
 
+    // the widget currently showing this row, or nullptr while it's out of view
+    [[nodiscard]] inline CarouselRowWidget *getWidget() const { return this->widget; }
+
    protected:
-    void drawMenuButtonBackground();
+    enum class TYPE : uint8_t { SONG, DIFFICULTY, COLLECTION };
 
     virtual void onSelected(bool /*wasSelected*/, bool /*autoSelectBottomMostChild*/, bool /*wasParentSelected*/) { ; }
-    virtual void onRightMouseUpInside() { ; }
 
     SongBrowser *songBrowser;
     UIContextMenu *contextMenu;
@@ -61,37 +72,21 @@ class CarouselButton : public CBaseUIButton {
     McFont *font;
     McFont *fontBold;
 
+    TYPE type{TYPE::SONG};
     bool bSelected;
 
     std::vector<SongButton *> children;
 
    private:
-    static int marginPixelsX;
-    static int marginPixelsY;
-    static float lastHoverSoundTime;
-
-    enum class MOVE_AWAY_STATE : uint8_t { MOVE_CENTER, MOVE_UP, MOVE_DOWN };
+    friend class BeatmapCarousel;
+    friend class CarouselRowWidget;
 
-    void onClicked(bool left = true, bool right = false) override;
-    void onMouseInside() override;
-    void onMouseOutside() override;
-
-    void setMoveAwayState(MOVE_AWAY_STATE moveAwayState, bool animate = true);
-
-    bool bRightClick;
-    bool bRightClickCheck;
+    CarouselRowWidget *widget{nullptr};
+    u32 iRowIndex{0};  // position in BeatmapCarousel::rows, only valid if the row at that index is this one
 
     float fTargetRelPosY;
-    float fScale;
-    float fOffsetPercent;
-    float fHoverOffsetAnimation;
-    float fHoverMoveAwayAnimation;
-    float fCenterOffsetAnimation;
-    float fCenterOffsetVelocityAnimation;
 
     std::atomic<bool> bIsSearchMatch;
 
     bool bHideIfSelected;
-
-    MOVE_AWAY_STATE moveAwayState;
 };
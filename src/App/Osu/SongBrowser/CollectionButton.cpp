@@ -20,22 +20,16 @@
 #include "UIContextMenu.h"
 
 CollectionButton::CollectionButton(SongBrowser *songBrowser, UIContextMenu *contextMenu,
-                                   float xPos, float yPos, float xSize, float ySize, UString name,
                                    const UString &collectionName, std::vector<SongButton *> children)
-    : CarouselButton(songBrowser, contextMenu, xPos, yPos, xSize, ySize, std::move(name)) {
+    : CarouselButton(songBrowser, contextMenu) {
     this->sCollectionName = collectionName.utf8View();
     this->children = std::move(children);
+    this->type = TYPE::COLLECTION;
 
     this->fTitleScale = 0.35f;
-
-    // settings
-    this->setOffsetPercent(0.075f * 0.5f);
 }
 
 void CollectionButton::draw() {
-    CarouselButton::draw();
-    if(!this->bVisible) return;
-
     Skin *skin = osu->getSkin();
 
     // scaling
@@ -5,14 +5,14 @@
 
 class CollectionButton : public CarouselButton {
    public:
-    CollectionButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, float xPos,
-                     float yPos, float xSize, float ySize, UString name, const UString &collectionName,
+    CollectionButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, const UString &collectionName,
                      std::vector<SongButton *> children);
 
     void draw() override;
 
     void triggerContextMenu(vec2 pos);
 
+    [[nodiscard]] float getOffsetPercent() const override { return 0.075f * 0.5f; }
     [[nodiscard]] Color getActiveBackgroundColor() const override;
     [[nodiscard]] Color getInactiveBackgroundColor() const override;
 
@@ -72,17 +72,12 @@ void InfoLabel::draw() {
     }
 
     // build strings
-    UString titleText = this->sArtist.c_str();
-    titleText.append(" - ");
-    titleText.append(this->sTitle.c_str());
-    titleText.append(" [");
-    titleText.append(this->sDiff.c_str());
-    titleText.append("]");
-    UString subTitleText = "Mapped by ";
-    subTitleText.append(this->sMapper.c_str());
-    const UString songInfoText = this->buildSongInfoString();
-    const UString diffInfoText = this->buildDiffInfoString();
-    const UString offsetInfoText = this->buildOffsetInfoString();
+    // (rebuilt every frame, so no UString here: these are only ever drawn, never edited)
+    const Utf8String titleText = Utf8String::fmt("{:s} - {:s} [{:s}]", this->sArtist, this->sTitle, this->sDiff);
+    const Utf8String subTitleText = Utf8String::fmt("Mapped by {:s}", this->sMapper);
+    const Utf8String songInfoText = this->buildSongInfoString();
+    const Utf8String diffInfoText = this->buildDiffInfoString();
+    const Utf8String offsetInfoText = this->buildOffsetInfoString();
 
     const float globalScale = std::max((this->vSize.y / this->getMinimumHeight()) * 0.91f, 1.0f);
 
@@ -292,7 +287,7 @@ void InfoLabel::setFromBeatmap(Beatmap * /*beatmap*/, DatabaseBeatmap *diff2) {
     this->setOnlineOffset(diff2->getOnlineOffset());
 }
 
-UString InfoLabel::buildSongInfoString() {
+Utf8String InfoLabel::buildSongInfoString() {
     unsigned long lengthMS = this->iLengthMS;
     auto speed = osu->getSelectedBeatmap()->getSpeedMultiplier();
 
@@ -306,18 +301,18 @@ UString InfoLabel::buildSongInfoString() {
 
     int numObjects = this->iNumObjects;
     if(this->iMinBPM == this->iMaxBPM) {
-        return UString::format("Length: %02i:%02i BPM: %i Objects: %i", minutes, seconds, maxBPM, numObjects);
+        return Utf8String::fmt("Length: {:02d}:{:02d} BPM: {} Objects: {}", minutes, seconds, maxBPM, numObjects);
     } else {
-        return UString::format("Length: %02i:%02i BPM: %i-%i (%i) Objects: %i", minutes, seconds, minBPM, maxBPM,
+        return Utf8String::fmt("Length: {:02d}:{:02d} BPM: {}-{} ({}) Objects: {}", minutes, seconds, minBPM, maxBPM,
                                mostCommonBPM, numObjects);
     }
 }
 
-UString InfoLabel::buildDiffInfoString() {
+Utf8String InfoLabel::buildDiffInfoString() {
     auto *beatmap = osu->getSelectedBeatmap();
-    if(!beatmap) return "";
+    if(!beatmap) return {};
     auto diff2 = beatmap->getSelectedDifficulty2();
-    if(!diff2) return "";
+    if(!diff2) return {};
 
     bool pp_available = false;
     float CS = this->fCS;
@@ -363,7 +358,7 @@ UString InfoLabel::buildDiffInfoString() {
     const float starComparisonEpsilon = 0.01f;
     const bool starsAndModStarsAreEqual = (std::abs(stars - modStars) < starComparisonEpsilon);
 
-    UString finalString;
+    Utf8String finalString;
     if(pp_available) {
         const int clampedModPp = static_cast<int>(
             std::round<int>((std::isfinite(modPp) && modPp >= static_cast<float>(std::numeric_limits<int>::min()) &&
@@ -371,21 +366,22 @@ UString InfoLabel::buildDiffInfoString() {
                                 ? static_cast<int>(modPp)
                                 : 0));
         if(starsAndModStarsAreEqual) {
-            finalString = UString::format("CS:%.3g AR:%.3g OD:%.3g HP:%.3g Stars:%.3g (%ipp)", CS, AR, OD, HP, stars,
-                                          clampedModPp);
+            finalString = Utf8String::fmt("CS:{:.3g} AR:{:.3g} OD:{:.3g} HP:{:.3g} Stars:{:.3g} ({}pp)", CS, AR, OD, HP,
+                                          stars, clampedModPp);
         } else {
-            finalString = UString::format("CS:%.3g AR:%.3g OD:%.3g HP:%.3g Stars:%.3g -> %.3g (%ipp)", CS, AR, OD, HP,
-                                          stars, modStars, clampedModPp);
+            finalString = Utf8String::fmt("CS:{:.3g} AR:{:.3g} OD:{:.3g} HP:{:.3g} Stars:{:.3g} -> {:.3g} ({}pp)", CS,
+                                          AR, OD, HP, stars, modStars, clampedModPp);
         }
     } else {
-        finalString = UString::format("CS:%.3g AR:%.3g OD:%.3g HP:%.3g Stars:%.3g * (??? pp)", CS, AR, OD, HP, stars);
+        finalString = Utf8String::fmt("CS:{:.3g} AR:{:.3g} OD:{:.3g} HP:{:.3g} Stars:{:.3g} * (??? pp)", CS, AR, OD, HP,
+                                      stars);
     }
 
     return finalString;
 }
 
-UString InfoLabel::buildOffsetInfoString() {
-    return UString::format("Your Offset: %ld ms / Online Offset: %ld ms", this->iLocalOffset, this->iOnlineOffset);
+Utf8String InfoLabel::buildOffsetInfoString() {
+    return Utf8String::fmt("Your Offset: {} ms / Online Offset: {} ms", this->iLocalOffset, this->iOnlineOffset);
 }
 
 float InfoLabel::getMinimumWidth() {
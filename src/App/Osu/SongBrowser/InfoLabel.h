@@ -18,10 +18,10 @@ class InfoLabel : public CBaseUIButton {
 
     void setFromBeatmap(Beatmap *beatmap, DatabaseBeatmap *diff2);
 
-    void setArtist(std::string artist) { this->sArtist = std::move(artist); }
-    void setTitle(std::string title) { this->sTitle = std::move(title); }
-    void setDiff(std::string diff) { this->sDiff = std::move(diff); }
-    void setMapper(std::string mapper) { this->sMapper = std::move(mapper); }
+    void setArtist(std::string_view artist) { this->sArtist = artist; }
+    void setTitle(std::string_view title) { this->sTitle = title; }
+    void setDiff(std::string_view diff) { this->sDiff = diff; }
+    void setMapper(std::string_view mapper) { this->sMapper = mapper; }
 
     void setLengthMS(unsigned long lengthMS) { this->iLengthMS = lengthMS; }
     void setBPM(int minBPM, int maxBPM, int mostCommonBPM) {
@@ -46,9 +46,9 @@ class InfoLabel : public CBaseUIButton {
     [[nodiscard]] long getBeatmapID() const { return this->iBeatmapId; }
 
    private:
-    UString buildSongInfoString();
-    UString buildDiffInfoString();
-    UString buildOffsetInfoString();
+    Utf8String buildSongInfoString();
+    Utf8String buildDiffInfoString();
+    Utf8String buildOffsetInfoString();
 
     McFont *font;
 
@@ -6,6 +6,7 @@
 #include "DatabaseBeatmap.h"
 #include "DifficultyCalculator.h"
 #include "Osu.h"
+#include "Profiler.h"
 #include "Timing.h"
 #include "Thread.h"
 
@@ -64,6 +65,8 @@ void MapCalcThread::run() {
             return;
         }
 
+        VPROF_ZONE("MapCalcThread::calc");
+
         aimStrains.clear();
         speedStrains.clear();
 
@@ -73,7 +76,7 @@ void MapCalcThread::run() {
             return;
         }
 
-        auto c = DatabaseBeatmap::loadPrimitiveObjects(diff2->sFilePath, this->should_stop);
+        auto c = DatabaseBeatmap::loadPrimitiveObjects(diff2->getFilePath(), this->should_stop);
 
         if(this->should_stop.load()) {
             return;
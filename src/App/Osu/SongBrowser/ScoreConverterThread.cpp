@@ -21,6 +21,18 @@ static std::vector<f64> aimStrains;
 static std::vector<f64> speedStrains;
 static std::vector<DifficultyCalculator::DiffObject> diffObjects;
 
+// recalculated scores are written to the score journal in batches, outside of scores_mtx, and the journal gets a chance
+// to be compacted after every batch (instead of only after recalculating everything)
+static constexpr size_t PP_UPDATE_BATCH_SIZE{100};
+static std::vector<FinishedScore> pp_updates;
+
+static void journal_pp_updates() {
+    if(pp_updates.empty()) return;
+
+    db->onScoresPPChanged(pp_updates);
+    pp_updates.clear();
+}
+
 // XXX: This is barebones, no caching, *hopefully* fast enough (worst part is loading the .osu files)
 // XXX: Probably code duplicated a lot, I'm pretty sure there's 4 places where I calc ppv2...
 static void update_ppv2(const FinishedScore& score) {
@@ -83,6 +95,7 @@ static void update_ppv2(const FinishedScore& score) {
             other.ppv2_total_stars = info.total_stars;
             other.ppv2_aim_stars = info.aim_stars;
             other.ppv2_speed_stars = info.speed_stars;
+            pp_updates.push_back(other);
             db->bDidScoresChangeForStats = true;
             break;
         }
@@ -135,13 +148,18 @@ static void run_sct(const std::unordered_map<MD5Hash, std::vector<FinishedScore>
         }
         Timing::sleep(1);
 
-        if(dead.load()) return;
+        if(dead.load()) break;
 
         // This is "placeholder" until we get accurate replay simulation
         {
             update_ppv2(score);
         }
 
+        if(pp_updates.size() >= PP_UPDATE_BATCH_SIZE) {
+            journal_pp_updates();
+            db->maybeCompactScores();
+        }
+
         // @PPV3: below
         if(!USE_PPV3) {
             sct_computed++;
@@ -193,6 +211,11 @@ static void run_sct(const std::unordered_map<MD5Hash, std::vector<FinishedScore>
         idx++;
     }
 
+    journal_pp_updates();
+    if(dead.load()) return;
+
+    db->maybeCompactScores();
+
     sct_computed++;
 }
 
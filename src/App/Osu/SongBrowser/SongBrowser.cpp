@@ -249,10 +249,10 @@ bool sort_by_artist(SongButton const *a, SongButton const *b) {
     const auto *aPtr = a->getDatabaseBeatmap(), *bPtr = b->getDatabaseBeatmap();
     if((aPtr == nullptr) || (bPtr == nullptr)) return (aPtr == nullptr) < (bPtr == nullptr);
 
-    const auto &artistA{aPtr->getArtistLatin()};
-    const auto &artistB{bPtr->getArtistLatin()};
+    const auto artistA{aPtr->getArtistLatin()};
+    const auto artistB{bPtr->getArtistLatin()};
 
-    i32 cmp = strcasecmp(artistA.c_str(), artistB.c_str());
+    i32 cmp = SString::compare_ncase(artistA, artistB);
     if(cmp == 0) return sort_by_difficulty(a, b);
     return cmp < 0;
 }
@@ -271,10 +271,10 @@ bool sort_by_creator(SongButton const *a, SongButton const *b) {
     const auto *aPtr = a->getDatabaseBeatmap(), *bPtr = b->getDatabaseBeatmap();
     if((aPtr == nullptr) || (bPtr == nullptr)) return (aPtr == nullptr) < (bPtr == nullptr);
 
-    const auto &creatorA{aPtr->getCreator()};
-    const auto &creatorB{bPtr->getCreator()};
+    const auto creatorA{aPtr->getCreator()};
+    const auto creatorB{bPtr->getCreator()};
 
-    i32 cmp = strcasecmp(creatorA.c_str(), creatorB.c_str());
+    i32 cmp = SString::compare_ncase(creatorA, creatorB);
     if(cmp == 0) return sort_by_difficulty(a, b);
     return cmp < 0;
 }
@@ -308,10 +308,10 @@ bool sort_by_title(SongButton const *a, SongButton const *b) {
     const auto *aPtr = a->getDatabaseBeatmap(), *bPtr = b->getDatabaseBeatmap();
     if((aPtr == nullptr) || (bPtr == nullptr)) return (aPtr == nullptr) < (bPtr == nullptr);
 
-    const auto &titleA{aPtr->getTitleLatin()};
-    const auto &titleB{bPtr->getTitleLatin()};
+    const auto titleA{aPtr->getTitleLatin()};
+    const auto titleB{bPtr->getTitleLatin()};
 
-    i32 cmp = strcasecmp(titleA.c_str(), titleB.c_str());
+    i32 cmp = SString::compare_ncase(titleA, titleB);
     if(cmp == 0) return sort_by_difficulty(a, b);
     return cmp < 0;
 }
@@ -1243,8 +1243,8 @@ void SongBrowser::onPlayEnd(bool quit) {
     if(!quit) {
         this->rebuildScoreButtons();
 
-        auto *selectedSongDiffButton = dynamic_cast<SongDifficultyButton *>(this->selectedButton);
-        if(selectedSongDiffButton != nullptr) selectedSongDiffButton->updateGrade();
+        if(this->selectedButton != nullptr && this->selectedButton->isDifficultyButton())
+            static_cast<SongDifficultyButton *>(this->selectedButton)->updateGrade();
     }
 
     // update song info
@@ -1263,9 +1263,10 @@ void SongBrowser::onSelectionChange(CarouselButton *button, bool rebuild) {
     // I'm still not happy with this, but at least all state update logic is localized in this function instead of
     // spread across all buttons
 
-    auto *songButtonPointer = dynamic_cast<SongButton *>(button);
-    auto *songDiffButtonPointer = dynamic_cast<SongDifficultyButton *>(button);
-    auto *collectionButtonPointer = dynamic_cast<CollectionButton *>(button);
+    auto *songButtonPointer = !button->isCollectionButton() ? static_cast<SongButton *>(button) : nullptr;
+    auto *songDiffButtonPointer =
+        button->isDifficultyButton() ? static_cast<SongDifficultyButton *>(button) : nullptr;
+    auto *collectionButtonPointer = button->isCollectionButton() ? static_cast<CollectionButton *>(button) : nullptr;
 
     if(songDiffButtonPointer != nullptr) {
         if(this->selectionPreviousSongDiffButton != nullptr &&
@@ -1330,9 +1331,8 @@ void SongBrowser::onDifficultySelected(DatabaseBeatmap *diff2, bool play) {
     // start playing
     if(play) {
         if(BanchoState::is_in_a_multi_room()) {
-            BanchoState::room.map_name =
-                UString::format("%s - %s [%s]", diff2->getArtistLatin().c_str(), diff2->getTitleLatin().c_str(),
-                                diff2->getDifficultyName().c_str());
+            BanchoState::room.map_name = UString::fmt("{:s} - {:s} [{:s}]", diff2->getArtistLatin(),
+                                                      diff2->getTitleLatin(), diff2->getDifficultyName());
             BanchoState::room.map_md5 = diff2->getMD5Hash();
             BanchoState::room.map_id = diff2->getID();
 
@@ -1403,7 +1403,7 @@ void SongBrowser::refreshBeatmaps() {
     this->selectionPreviousCollectionButton = nullptr;
 
     // delete local database and UI
-    this->carousel->getContainer()->invalidate();
+    this->carousel->clearRows();
 
     for(auto &songButton : this->songButtons) {
         delete songButton;
@@ -1473,11 +1473,9 @@ void SongBrowser::addBeatmapSet(BeatmapSet *mapset) {
 
     SongButton *songButton;
     if(mapset->getDifficulties().size() > 1) {
-        songButton =
-            new SongButton(this, this->contextMenu, 250, 250 + this->beatmaps.size() * 50, 200, 50, "", mapset);
+        songButton = new SongButton(this, this->contextMenu, mapset);
     } else {
-        songButton = new SongDifficultyButton(this, this->contextMenu, 250, 250 + this->beatmaps.size() * 50, 200, 50,
-                                              "", mapset->getDifficulties()[0], nullptr);
+        songButton = new SongDifficultyButton(this, this->contextMenu, mapset->getDifficulties()[0], nullptr);
     }
 
     this->songButtons.push_back(songButton);
@@ -1575,7 +1573,7 @@ void SongBrowser::addBeatmapSet(BeatmapSet *mapset) {
 }
 
 void SongBrowser::addSongButtonToAlphanumericGroup(SongButton *btn, std::vector<CollectionButton *> &group,
-                                                   const std::string &name) {
+                                                   std::string_view name) {
     if(group.size() != 28) {
         debugLog("Alphanumeric group wasn't initialized!\n");
         return;
@@ -1597,7 +1595,7 @@ void SongBrowser::addSongButtonToAlphanumericGroup(SongButton *btn, std::vector<
     }
 
     if(cv::debug_osu.getBool()) {
-        debugLog("Inserting {:s}\n", name.c_str());
+        debugLog("Inserting {:s}\n", name);
     }
 
     children->push_back(btn);
@@ -1608,8 +1606,8 @@ void SongBrowser::requestNextScrollToSongButtonJumpFix(SongDifficultyButton *dif
 
     this->bNextScrollToSongButtonJumpFixScheduled = true;
     this->fNextScrollToSongButtonJumpFixOldRelPosY =
-        (diffButton->getParentSongButton() != nullptr ? diffButton->getParentSongButton()->getRelPos().y
-                                                      : diffButton->getRelPos().y);
+        (diffButton->getParentSongButton() != nullptr ? diffButton->getParentSongButton()->getTargetRelPosY()
+                                                      : diffButton->getTargetRelPosY());
     this->fNextScrollToSongButtonJumpFixOldScrollSizeY = this->carousel->getScrollSize().y;
 }
 
@@ -1672,7 +1670,8 @@ void SongBrowser::scrollToSongButton(CarouselButton *songButton, bool alignOnTop
         float delta = 0.0f;
         {
             if(!this->bNextScrollToSongButtonJumpFixUseScrollSizeDelta)
-                delta = (songButton->getRelPos().y - this->fNextScrollToSongButtonJumpFixOldRelPosY);  // (default case)
+                delta = (songButton->getTargetRelPosY() -
+                         this->fNextScrollToSongButtonJumpFixOldRelPosY);  // (default case)
             else
                 delta = this->carousel->getScrollSize().y -
                         this->fNextScrollToSongButtonJumpFixOldScrollSizeY;  // technically not correct but feels a
@@ -1681,20 +1680,20 @@ void SongBrowser::scrollToSongButton(CarouselButton *songButton, bool alignOnTop
         this->carousel->scrollToY(this->carousel->getRelPosY() - delta, false);
     }
 
-    this->carousel->scrollToY(-songButton->getRelPos().y +
-                              (alignOnTop ? (0) : (this->carousel->getSize().y / 2 - songButton->getSize().y / 2)));
+    this->carousel->scrollToY(
+        -songButton->getTargetRelPosY() +
+        (alignOnTop ? (0) : (this->carousel->getSize().y / 2 - BeatmapCarousel::getRowSize().y / 2)));
 }
 
 void SongBrowser::rebuildSongButtons() {
-    this->carousel->getContainer()->invalidate();
+    this->carousel->clearRows();
 
     // NOTE: currently supports 3 depth layers (collection > beatmap > diffs)
     for(auto &visibleSongButton : this->visibleSongButtons) {
         CarouselButton *button = visibleSongButton;
-        button->resetAnimations();
 
         if(!(button->isSelected() && button->isHiddenIfSelected()))
-            this->carousel->getContainer()->addBaseUIElement(button);
+            this->carousel->addRow(button);
 
         // children
         if(button->isSelected()) {
@@ -1714,10 +1713,8 @@ void SongBrowser::rebuildSongButtons() {
 
                 if(this->bInSearch && !isButton2SearchMatch) continue;
 
-                button2->resetAnimations();
-
                 if(!(button2->isSelected() && button2->isHiddenIfSelected()))
-                    this->carousel->getContainer()->addBaseUIElement(button2);
+                    this->carousel->addRow(button2);
 
                 // child children
                 if(button2->isSelected()) {
@@ -1725,10 +1722,8 @@ void SongBrowser::rebuildSongButtons() {
                     for(auto button3 : children2) {
                         if(this->bInSearch && !button3->isSearchMatch()) continue;
 
-                        button3->resetAnimations();
-
                         if(!(button3->isSelected() && button3->isHiddenIfSelected()))
-                            this->carousel->getContainer()->addBaseUIElement(button3);
+                            this->carousel->addRow(button3);
                     }
                 }
             }
@@ -1750,49 +1745,46 @@ void SongBrowser::updateSongButtonLayout() {
     // this rebuilds the entire songButton layout (songButtons in relation to others)
     // only the y axis is set, because the x axis is constantly animated and handled within the button classes
     // themselves
-    const std::vector<CBaseUIElement *> &elements = this->carousel->getContainer()->getElements();
+    const std::vector<CarouselButton *> &elements = this->carousel->getRows();
+
+    // (all rows have the same size)
+    const vec2 rowSize = BeatmapCarousel::getRowSize();
+    const float rowActualHeight = rowSize.y - 2.f * BeatmapCarousel::getRowMargin(BeatmapCarousel::getRowScale()).y;
 
     int yCounter = this->carousel->getSize().y / 4;
     if(elements.size() <= 1) yCounter = this->carousel->getSize().y / 2;
 
     bool isSelected = false;
     bool inOpenCollection = false;
-    for(auto &element : elements) {
-        auto *songButton = dynamic_cast<CarouselButton *>(element);
-
-        if(songButton != nullptr) {
-            const auto *diffButtonPointer = dynamic_cast<const SongDifficultyButton *>(songButton);
-
-            // depending on the object type, layout differently
-            const bool isCollectionButton = dynamic_cast<CollectionButton *>(songButton) != nullptr;
-            const bool isDiffButton = diffButtonPointer != nullptr;
-            const bool isIndependentDiffButton = isDiffButton && diffButtonPointer->isIndependentDiffButton();
-
-            // give selected items & diffs a bit more spacing, to make them stand out
-            if(((songButton->isSelected() && !isCollectionButton) || isSelected ||
-                (isDiffButton && !isIndependentDiffButton)))
-                yCounter += songButton->getSize().y * 0.1f;
-
-            isSelected = songButton->isSelected() || (isDiffButton && !isIndependentDiffButton);
-
-            // give collections a bit more spacing at start & end
-            if((songButton->isSelected() && isCollectionButton)) yCounter += songButton->getSize().y * 0.2f;
-            if(inOpenCollection && isCollectionButton && !songButton->isSelected())
-                yCounter += songButton->getSize().y * 0.2f;
-            if(isCollectionButton) {
-                if(songButton->isSelected())
-                    inOpenCollection = true;
-                else
-                    inOpenCollection = false;
-            }
+    for(auto *songButton : elements) {
+        // depending on the object type, layout differently
+        const bool isCollectionButton = songButton->isCollectionButton();
+        const bool isDiffButton = songButton->isDifficultyButton();
+        const bool isIndependentDiffButton =
+            isDiffButton && static_cast<const SongDifficultyButton *>(songButton)->isIndependentDiffButton();
+
+        // give selected items & diffs a bit more spacing, to make them stand out
+        if(((songButton->isSelected() && !isCollectionButton) || isSelected ||
+            (isDiffButton && !isIndependentDiffButton)))
+            yCounter += rowSize.y * 0.1f;
+
+        isSelected = songButton->isSelected() || (isDiffButton && !isIndependentDiffButton);
+
+        // give collections a bit more spacing at start & end
+        if((songButton->isSelected() && isCollectionButton)) yCounter += rowSize.y * 0.2f;
+        if(inOpenCollection && isCollectionButton && !songButton->isSelected()) yCounter += rowSize.y * 0.2f;
+        if(isCollectionButton) {
+            if(songButton->isSelected())
+                inOpenCollection = true;
+            else
+                inOpenCollection = false;
+        }
 
-            songButton->setTargetRelPosY(yCounter);
-            songButton->updateLayoutEx();
+        songButton->setTargetRelPosY(yCounter);
 
-            yCounter += songButton->getActualSize().y;
-        }
+        yCounter += rowActualHeight;
     }
-    this->carousel->setScrollSizeToContent(this->carousel->getSize().y / 2);
+    this->carousel->onRowLayoutChanged();
 }
 
 bool SongBrowser::searchMatcher(const DatabaseBeatmap *databaseBeatmap,
@@ -2394,13 +2386,10 @@ void SongBrowser::rebuildScoreButtons() {
     // (weird place for this to be, i think the intent is to update them after you set a score)
     if(validBeatmap) {
         for(auto &visibleSongButton : this->visibleSongButtons) {
-            if(visibleSongButton->getDatabaseBeatmap() == this->beatmap->getSelectedDifficulty2()) {
-                auto *songButtonPointer = dynamic_cast<SongButton *>(visibleSongButton);
-                if(songButtonPointer != nullptr) {
-                    for(CarouselButton *diffButton : songButtonPointer->getChildren()) {
-                        auto *diffButtonPointer = dynamic_cast<SongButton *>(diffButton);
-                        if(diffButtonPointer != nullptr) diffButtonPointer->updateGrade();
-                    }
+            if(visibleSongButton->getDatabaseBeatmap() == this->beatmap->getSelectedDifficulty2() &&
+               !visibleSongButton->isCollectionButton()) {
+                for(SongButton *diffButton : visibleSongButton->getChildren()) {
+                    diffButton->updateGrade();
                 }
             }
         }
@@ -2415,6 +2404,9 @@ void SongBrowser::checkHandleKillBackgroundSearchMatcher() {
     if(!this->backgroundSearchMatcher->isDead()) {
         this->backgroundSearchMatcher->kill();
 
+        // don't wait behind queued thumbnails if it hasn't even started yet
+        resourceManager->prioritizeLoad(this->backgroundSearchMatcher);
+
         const double startTime = Timing::getTimeReal();
         while(!this->backgroundSearchMatcher->isAsyncReady()) {
             if(Timing::getTimeReal() - startTime > 2) {
@@ -2440,8 +2432,7 @@ void SongBrowser::onDatabaseLoadingFinished() {
         {
             // 0-9
             {
-                auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "0-9",
-                                               std::vector<SongButton *>());
+                auto *b = new CollectionButton(this, this->contextMenu, "0-9", std::vector<SongButton *>());
                 this->artistCollectionButtons.push_back(b);
             }
 
@@ -2449,15 +2440,14 @@ void SongBrowser::onDatabaseLoadingFinished() {
             for(size_t i = 0; i < 26; i++) {
                 UString artistCollectionName = UString::format("%c", 'A' + i);
 
-                auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", artistCollectionName,
+                auto *b = new CollectionButton(this, this->contextMenu, artistCollectionName,
                                                std::vector<SongButton *>());
                 this->artistCollectionButtons.push_back(b);
             }
 
             // Other
             {
-                auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Other",
-                                               std::vector<SongButton *>());
+                auto *b = new CollectionButton(this, this->contextMenu, "Other", std::vector<SongButton *>());
                 this->artistCollectionButtons.push_back(b);
             }
         }
@@ -2470,30 +2460,23 @@ void SongBrowser::onDatabaseLoadingFinished() {
 
             std::vector<SongButton *> children;
 
-            auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", difficultyCollectionName,
-                                           children);
+            auto *b = new CollectionButton(this, this->contextMenu, difficultyCollectionName, children);
             this->difficultyCollectionButtons.push_back(b);
         }
 
         // bpm
         {
-            auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Under 60 BPM",
-                                           std::vector<SongButton *>());
+            auto *b = new CollectionButton(this, this->contextMenu, "Under 60 BPM", std::vector<SongButton *>());
             this->bpmCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Under 120 BPM",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "Under 120 BPM", std::vector<SongButton *>());
             this->bpmCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Under 180 BPM",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "Under 180 BPM", std::vector<SongButton *>());
             this->bpmCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Under 240 BPM",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "Under 240 BPM", std::vector<SongButton *>());
             this->bpmCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Under 300 BPM",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "Under 300 BPM", std::vector<SongButton *>());
             this->bpmCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Over 300 BPM",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "Over 300 BPM", std::vector<SongButton *>());
             this->bpmCollectionButtons.push_back(b);
         }
 
@@ -2501,8 +2484,7 @@ void SongBrowser::onDatabaseLoadingFinished() {
         {
             // 0-9
             {
-                auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "0-9",
-                                               std::vector<SongButton *>());
+                auto *b = new CollectionButton(this, this->contextMenu, "0-9", std::vector<SongButton *>());
                 this->creatorCollectionButtons.push_back(b);
             }
 
@@ -2510,15 +2492,14 @@ void SongBrowser::onDatabaseLoadingFinished() {
             for(size_t i = 0; i < 26; i++) {
                 UString artistCollectionName = UString::format("%c", 'A' + i);
 
-                auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", artistCollectionName,
+                auto *b = new CollectionButton(this, this->contextMenu, artistCollectionName,
                                                std::vector<SongButton *>());
                 this->creatorCollectionButtons.push_back(b);
             }
 
             // Other
             {
-                auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Other",
-                                               std::vector<SongButton *>());
+                auto *b = new CollectionButton(this, this->contextMenu, "Other", std::vector<SongButton *>());
                 this->creatorCollectionButtons.push_back(b);
             }
         }
@@ -2530,26 +2511,19 @@ void SongBrowser::onDatabaseLoadingFinished() {
 
         // length
         {
-            auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "1 minute or less",
-                                           std::vector<SongButton *>());
+            auto *b = new CollectionButton(this, this->contextMenu, "1 minute or less", std::vector<SongButton *>());
             this->lengthCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "2 minutes or less",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "2 minutes or less", std::vector<SongButton *>());
             this->lengthCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "3 minutes or less",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "3 minutes or less", std::vector<SongButton *>());
             this->lengthCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "4 minutes or less",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "4 minutes or less", std::vector<SongButton *>());
             this->lengthCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "5 minutes or less",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "5 minutes or less", std::vector<SongButton *>());
             this->lengthCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "10 minutes or less",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "10 minutes or less", std::vector<SongButton *>());
             this->lengthCollectionButtons.push_back(b);
-            b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Over 10 minutes",
-                                     std::vector<SongButton *>());
+            b = new CollectionButton(this, this->contextMenu, "Over 10 minutes", std::vector<SongButton *>());
             this->lengthCollectionButtons.push_back(b);
         }
 
@@ -2557,8 +2531,7 @@ void SongBrowser::onDatabaseLoadingFinished() {
         {
             // 0-9
             {
-                auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "0-9",
-                                               std::vector<SongButton *>());
+                auto *b = new CollectionButton(this, this->contextMenu, "0-9", std::vector<SongButton *>());
                 this->titleCollectionButtons.push_back(b);
             }
 
@@ -2566,15 +2539,14 @@ void SongBrowser::onDatabaseLoadingFinished() {
             for(size_t i = 0; i < 26; i++) {
                 UString artistCollectionName = UString::format("%c", 'A' + i);
 
-                auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", artistCollectionName,
+                auto *b = new CollectionButton(this, this->contextMenu, artistCollectionName,
                                                std::vector<SongButton *>());
                 this->titleCollectionButtons.push_back(b);
             }
 
             // Other
             {
-                auto *b = new CollectionButton(this, this->contextMenu, 250, 250, 200, 50, "", "Other",
-                                               std::vector<SongButton *>());
+                auto *b = new CollectionButton(this, this->contextMenu, "Other", std::vector<SongButton *>());
                 this->titleCollectionButtons.push_back(b);
             }
         }
@@ -2655,7 +2627,7 @@ void SongBrowser::onSearchUpdate() {
         this->checkHandleKillBackgroundSearchMatcher();
 
         // reset container and visible buttons list
-        this->carousel->getContainer()->invalidate();
+        this->carousel->clearRows();
         this->visibleSongButtons.clear();
 
         // reset all search flags
@@ -2683,7 +2655,7 @@ void SongBrowser::onSearchUpdate() {
 void SongBrowser::rebuildSongButtonsAndVisibleSongButtonsWithSearchMatchSupport(bool scrollToTop,
                                                                                 bool doRebuildSongButtons) {
     // reset container and visible buttons list
-    this->carousel->getContainer()->invalidate();
+    this->carousel->clearRows();
     this->visibleSongButtons.clear();
 
     // use flagged search matches to rebuild visible song buttons
@@ -3032,12 +3004,12 @@ void SongBrowser::onSelectionOptions() {
         const vec2 heuristicSongButtonPositionAfterSmoothScrollFinishes =
             (this->carousel->getPos() + this->carousel->getSize() / 2.f);
 
-        auto *songButtonPointer = dynamic_cast<SongButton *>(this->selectedButton);
-        auto *collectionButtonPointer = dynamic_cast<CollectionButton *>(this->selectedButton);
-        if(songButtonPointer != nullptr) {
-            songButtonPointer->triggerContextMenu(heuristicSongButtonPositionAfterSmoothScrollFinishes);
-        } else if(collectionButtonPointer != nullptr) {
-            collectionButtonPointer->triggerContextMenu(heuristicSongButtonPositionAfterSmoothScrollFinishes);
+        if(this->selectedButton->isCollectionButton()) {
+            static_cast<CollectionButton *>(this->selectedButton)
+                ->triggerContextMenu(heuristicSongButtonPositionAfterSmoothScrollFinishes);
+        } else {
+            static_cast<SongButton *>(this->selectedButton)
+                ->triggerContextMenu(heuristicSongButtonPositionAfterSmoothScrollFinishes);
         }
     }
 }
@@ -3248,31 +3220,43 @@ void SongBrowser::selectSongButton(CarouselButton *songButton) {
 }
 
 void SongBrowser::selectRandomBeatmap() {
-    // filter songbuttons or independent diffs
-    const std::vector<CBaseUIElement *> &elements = this->carousel->getContainer()->getElements();
-    std::vector<SongButton *> songButtons;
-    for(auto element : elements) {
-        auto *songButtonPointer = dynamic_cast<SongButton *>(element);
-        auto *songDifficultyButtonPointer = dynamic_cast<SongDifficultyButton *>(element);
+    // only allow songbuttons or independent diffs
+    auto isCandidate = [](const CarouselButton *row) {
+        if(row->isCollectionButton()) return false;
+        return !row->isDifficultyButton() || static_cast<const SongDifficultyButton *>(row)->isIndependentDiffButton();
+    };
 
-        if(songButtonPointer != nullptr &&
-           (songDifficultyButtonPointer == nullptr ||
-            songDifficultyButtonPointer->isIndependentDiffButton()))  // only allow songbuttons or independent diffs
-            songButtons.push_back(songButtonPointer);
+    const std::vector<CarouselButton *> &rows = this->carousel->getRows();
+    if(rows.empty()) return;
+
+    // almost every row is a candidate (unless we're looking at closed groups), so just try some random rows first
+    CarouselButton *randomButton = nullptr;
+    std::uniform_int_distribution<size_t> rng(0, rows.size() - 1);
+    for(int i = 0; i < 32 && randomButton == nullptr; i++) {
+        CarouselButton *row = rows[rng(this->rngalg)];
+        if(isCandidate(row)) randomButton = row;
     }
 
-    if(songButtons.size() < 1) return;
+    // and otherwise pick among the few candidates there are
+    if(randomButton == nullptr) {
+        const auto numCandidates = std::ranges::count_if(rows, isCandidate);
+        if(numCandidates < 1) return;
+
+        auto randomCandidate = std::uniform_int_distribution<sSz>(0, numCandidates - 1)(this->rngalg);
+        for(CarouselButton *row : rows) {
+            if(isCandidate(row) && randomCandidate-- == 0) {
+                randomButton = row;
+                break;
+            }
+        }
+    }
 
     // remember previous
     if(this->beatmap != nullptr && this->beatmap->getSelectedDifficulty2() != nullptr) {
         this->previousRandomBeatmaps.push_back(this->beatmap->getSelectedDifficulty2());
     }
 
-    std::uniform_int_distribution<size_t> rng(0, songButtons.size() - 1);
-    size_t randomIndex = rng(this->rngalg);
-
-    auto *songButton = dynamic_cast<SongButton *>(songButtons[randomIndex]);
-    this->selectSongButton(songButton);
+    this->selectSongButton(randomButton);
 }
 
 void SongBrowser::selectPreviousRandomBeatmap() {
@@ -3284,20 +3268,12 @@ void SongBrowser::selectPreviousRandomBeatmap() {
             this->previousRandomBeatmaps.pop_back();  // deletes the current beatmap which may also be at the top (so
                                                       // we don't switch to ourself)
 
-        // filter songbuttons
-        const std::vector<CBaseUIElement *> &elements = this->carousel->getContainer()->getElements();
-        std::vector<SongButton *> songButtons;
-        for(auto element : elements) {
-            auto *songButtonPointer = dynamic_cast<SongButton *>(element);
-
-            if(songButtonPointer != nullptr)  // allow ALL songbuttons
-                songButtons.push_back(songButtonPointer);
-        }
-
-        // select it, if we can find it (and remove it from memory)
+        // select it, if we can find it among the songbuttons (and remove it from memory)
         bool foundIt = false;
         const DatabaseBeatmap *previousRandomBeatmap = this->previousRandomBeatmaps.back();
-        for(auto &songButton : songButtons) {
+        for(CarouselButton *songButton : this->carousel->getRows()) {
+            if(songButton->isCollectionButton()) continue;
+
             if(songButton->getDatabaseBeatmap() != nullptr &&
                songButton->getDatabaseBeatmap() == previousRandomBeatmap) {
                 this->previousRandomBeatmaps.pop_back();
@@ -3325,14 +3301,11 @@ void SongBrowser::selectPreviousRandomBeatmap() {
 }
 
 void SongBrowser::playSelectedDifficulty() {
-    const std::vector<CBaseUIElement *> &elements = this->carousel->getContainer()->getElements();
-    for(auto element : elements) {
-        auto *songDifficultyButton = dynamic_cast<SongDifficultyButton *>(element);
-        if(songDifficultyButton != nullptr && songDifficultyButton->isSelected()) {
-            songDifficultyButton->select();
-            break;
-        }
-    }
+    // (the selection logic always keeps track of the selected diff)
+    SongDifficultyButton *songDifficultyButton = this->selectionPreviousSongDiffButton;
+    if(songDifficultyButton != nullptr && songDifficultyButton->isSelected() &&
+       this->carousel->hasRow(songDifficultyButton))
+        songDifficultyButton->select();
 }
 
 void SongBrowser::recreateCollectionsButtons() {
@@ -3346,7 +3319,7 @@ void SongBrowser::recreateCollectionsButtons() {
 
         // sanity
         if(this->group == GROUP::GROUP_COLLECTIONS) {
-            this->carousel->getContainer()->invalidate();
+            this->carousel->clearRows();
             this->visibleSongButtons.clear();
         }
     }
@@ -3403,8 +3376,7 @@ void SongBrowser::recreateCollectionsButtons() {
 
         if(!folder.empty()) {
             UString uname = collection->name.c_str();
-            this->collectionButtons.push_back(new CollectionButton(
-                this, this->contextMenu, 250, 250 + this->beatmaps.size() * 50, 200, 50, "", uname, folder));
+            this->collectionButtons.push_back(new CollectionButton(this, this->contextMenu, uname, folder));
         }
     }
 
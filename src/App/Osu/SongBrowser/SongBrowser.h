@@ -91,7 +91,7 @@ class SongBrowser final : public ScreenBackable {
     void refreshBeatmaps();
     void addBeatmapSet(BeatmapSet *beatmap);
     void addSongButtonToAlphanumericGroup(SongButton *btn, std::vector<CollectionButton *> &group,
-                                          const std::string &name);
+                                          std::string_view name);
 
     void requestNextScrollToSongButtonJumpFix(SongDifficultyButton *diffButton);
     bool isButtonVisible(CarouselButton *songButton);
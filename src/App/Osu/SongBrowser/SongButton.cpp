@@ -2,7 +2,6 @@
 #include "SongButton.h"
 
 #include <algorithm>
-#include <utility>
 
 #include "CollectionButton.h"
 #include "ScoreButton.h"
@@ -23,9 +22,8 @@
 #include "SkinImage.h"
 #include "UIContextMenu.h"
 
-SongButton::SongButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, float xPos, float yPos, float xSize,
-                       float ySize, UString name, DatabaseBeatmap *databaseBeatmap)
-    : CarouselButton(songBrowser, contextMenu, xPos, yPos, xSize, ySize, std::move(name)) {
+SongButton::SongButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, DatabaseBeatmap *databaseBeatmap)
+    : CarouselButton(songBrowser, contextMenu) {
     this->databaseBeatmap = databaseBeatmap;
 
     // settings
@@ -47,14 +45,11 @@ SongButton::SongButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, flo
 
         // and add them
         for(auto difficultie : difficulties) {
-            SongButton *songButton =
-                new SongDifficultyButton(this->songBrowser, this->contextMenu, 0, 0, 0, 0, "", difficultie, this);
+            SongButton *songButton = new SongDifficultyButton(this->songBrowser, this->contextMenu, difficultie, this);
 
             this->children.push_back(songButton);
         }
     }
-
-    this->updateLayoutEx();
 }
 
 SongButton::~SongButton() {
@@ -64,31 +59,16 @@ SongButton::~SongButton() {
 }
 
 void SongButton::draw() {
-    if(!this->bVisible) return;
-    if(this->vPos.y + this->vSize.y < 0) return;
-    if(this->vPos.y > osu->getScreenHeight()) return;
-
-    CarouselButton::draw();
-
     // draw background image
     this->sortChildren();
-    if(this->databaseBeatmap != nullptr && this->children.size() > 0) {
-        // use the bottom child (hardest diff, assuming default sorting, and respecting the current search matches)
-        for(int i = this->children.size() - 1; i >= 0; i--) {
-            // NOTE: if no search is active, then all search matches return true by default
-            if(this->children[i]->isSearchMatch()) {
-                auto representative_beatmap = dynamic_cast<SongButton *>(this->children[i])->getDatabaseBeatmap();
-
-                this->sTitle = representative_beatmap->getTitle();
-                this->sArtist = representative_beatmap->getArtist();
-                this->sMapper = representative_beatmap->getCreator();
-
-                this->drawBeatmapBackgroundThumbnail(
-                    osu->getBackgroundImageHandler()->getLoadBackgroundImage(representative_beatmap));
-
-                break;
-            }
-        }
+    // NOTE: if no search is active, then all search matches return true by default
+    if(auto representative_beatmap = this->getThumbnailBeatmap(); representative_beatmap != nullptr) {
+        this->sTitle = representative_beatmap->getTitle();
+        this->sArtist = representative_beatmap->getArtist();
+        this->sMapper = representative_beatmap->getCreator();
+
+        this->drawBeatmapBackgroundThumbnail(
+            osu->getBackgroundImageHandler()->getLoadBackgroundImage(representative_beatmap, true));
     }
 
     if(this->grade != FinishedScore::Grade::N) this->drawGrade();
@@ -96,6 +76,17 @@ void SongButton::draw() {
     this->drawSubTitle();
 }
 
+DatabaseBeatmap *SongButton::getThumbnailBeatmap() const {
+    if(this->databaseBeatmap == nullptr) return nullptr;
+
+    // use the bottom child (hardest diff, assuming default sorting, and respecting the current search matches)
+    for(auto it = this->children.rbegin(); it != this->children.rend(); ++it) {
+        if((*it)->isSearchMatch()) return (*it)->getDatabaseBeatmap();
+    }
+
+    return nullptr;
+}
+
 void SongButton::drawBeatmapBackgroundThumbnail(Image *image) {
     if(!cv::draw_songbrowser_thumbnails.getBool() || osu->getSkin()->getVersion() < 2.2f) return;
 
@@ -214,8 +205,6 @@ void SongButton::drawSubTitle(float deselectedAlpha, bool forceSelectedStyle) {
 void SongButton::sortChildren() { std::ranges::sort(this->children, sort_by_difficulty); }
 
 void SongButton::updateLayoutEx() {
-    CarouselButton::updateLayoutEx();
-
     // scaling
     const vec2 size = this->getActualSize();
 
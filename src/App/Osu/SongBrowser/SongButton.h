@@ -9,8 +9,7 @@ class BeatmapCarousel;
 
 class SongButton : public CarouselButton {
    public:
-    SongButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, float xPos, float yPos,
-               float xSize, float ySize, UString name, DatabaseBeatmap *databaseBeatmap);
+    SongButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, DatabaseBeatmap *databaseBeatmap);
     ~SongButton() override;
 
     void draw() override;
@@ -23,6 +22,8 @@ class SongButton : public CarouselButton {
     virtual void updateGrade() { ; }
 
     [[nodiscard]] DatabaseBeatmap *getDatabaseBeatmap() const override { return this->databaseBeatmap; }
+    // the beatmap whose background is drawn as this button's thumbnail
+    [[nodiscard]] virtual DatabaseBeatmap *getThumbnailBeatmap() const;
     FinishedScore::Grade grade = FinishedScore::Grade::N;
 
    protected:
@@ -1,13 +1,10 @@
 // Copyright (c) 2016, PG, All rights reserved.
 #include "SongDifficultyButton.h"
 
-#include <utility>
-
 #include "ScoreButton.h"
 #include "SongBrowser.h"
 // ---
 
-#include "AnimationHandler.h"
 #include "BackgroundImageHandler.h"
 #include "Beatmap.h"
 #include "ConVar.h"
@@ -18,39 +15,30 @@
 #include "Osu.h"
 #include "ResourceManager.h"
 #include "Skin.h"
-#include "SoundEngine.h"
 #include "Timing.h"
 
-SongDifficultyButton::SongDifficultyButton(SongBrowser* songBrowser, UIContextMenu* contextMenu, float xPos, float yPos,
-                                           float xSize, float ySize, UString name, DatabaseBeatmap* diff2,
+SongDifficultyButton::SongDifficultyButton(SongBrowser* songBrowser, UIContextMenu* contextMenu, DatabaseBeatmap* diff2,
                                            SongButton* parentSongButton)
-    : SongButton(songBrowser, contextMenu, xPos, yPos, xSize, ySize, std::move(name), nullptr) {
+    : SongButton(songBrowser, contextMenu, nullptr) {
     this->databaseBeatmap = diff2;  // NOTE: can't use parent constructor for passing this argument, as it would
                                     // otherwise try to build a full button (and not just a diff button)
     this->parentSongButton = parentSongButton;
+    this->type = TYPE::DIFFICULTY;
 
     this->sMapper = this->databaseBeatmap->getCreator();
     this->sDiff = this->databaseBeatmap->getDifficultyName();
 
     this->fDiffScale = 0.18f;
-    this->fOffsetPercentAnim = (this->parentSongButton != nullptr ? 1.0f : 0.0f);
 
     this->bUpdateGradeScheduled = true;
-    this->bPrevOffsetPercentSelectionState = this->isIndependentDiffButton();
 
     // settings
     this->setHideIfSelected(false);
 
-    this->updateLayoutEx();
     this->updateGrade();
 }
 
-SongDifficultyButton::~SongDifficultyButton() { anim->deleteExistingAnimation(&this->fOffsetPercentAnim); }
-
 void SongDifficultyButton::draw() {
-    CarouselButton::draw();
-    if(!this->bVisible) return;
-
     const bool isIndependentDiff = this->isIndependentDiffButton();
 
     Skin* skin = osu->getSkin();
@@ -61,7 +49,7 @@ void SongDifficultyButton::draw() {
 
     // draw background image
     this->drawBeatmapBackgroundThumbnail(
-        osu->getBackgroundImageHandler()->getLoadBackgroundImage(this->databaseBeatmap));
+        osu->getBackgroundImageHandler()->getLoadBackgroundImage(this->databaseBeatmap, true));
 
     if(this->grade != FinishedScore::Grade::N) this->drawGrade();
 
@@ -144,32 +132,16 @@ void SongDifficultyButton::draw() {
     }
 }
 
-void SongDifficultyButton::mouse_update(bool* propagate_clicks) {
-    if(!this->bVisible) return;
-    SongButton::mouse_update(propagate_clicks);
-
-    // dynamic settings (moved from constructor to here)
-    const bool newOffsetPercentSelectionState = (this->bSelected || !this->isIndependentDiffButton());
-    if(newOffsetPercentSelectionState != this->bPrevOffsetPercentSelectionState) {
-        this->bPrevOffsetPercentSelectionState = newOffsetPercentSelectionState;
-        anim->moveQuadOut(&this->fOffsetPercentAnim, newOffsetPercentSelectionState ? 1.0f : 0.0f,
-                          0.25f * (1.0f - this->fOffsetPercentAnim), true);
-    }
-    this->setOffsetPercent(std::lerp(0.0f, 0.075f, this->fOffsetPercentAnim));
-
+void SongDifficultyButton::update() {
     if(this->bUpdateGradeScheduled) {
         this->bUpdateGradeScheduled = false;
         this->updateGrade();
     }
 }
 
-void SongDifficultyButton::onClicked(bool left, bool right) {
-    soundEngine->play(osu->getSkin()->getSelectDifficultySound());
-
-    // NOTE: Intentionally not calling Button::onClicked(left, right), since that one plays another sound
-    CBaseUIButton::onClicked(left, right);
-
-    this->select(true, true);
+float SongDifficultyButton::getOffsetPercent() const {
+    // diffs below their parent song button (and the selected one) are indented
+    return (this->bSelected || !this->isIndependentDiffButton()) ? 0.075f : 0.0f;
 }
 
 void SongDifficultyButton::onSelected(bool wasSelected, bool autoSelectBottomMostChild, bool wasParentSelected) {
@@ -6,17 +6,18 @@ class ConVar;
 
 class SongDifficultyButton : public SongButton {
    public:
-    SongDifficultyButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, float xPos,
-                         float yPos, float xSize, float ySize, UString name, DatabaseBeatmap *diff2,
+    SongDifficultyButton(SongBrowser *songBrowser, UIContextMenu *contextMenu, DatabaseBeatmap *diff2,
                          SongButton *parentSongButton);
-    ~SongDifficultyButton() override;
 
     void draw() override;
-    void mouse_update(bool *propagate_clicks) override;
-    void onClicked(bool left = true, bool right = false) override;
+    void update() override;
 
     void updateGrade() override;
 
+    [[nodiscard]] float getOffsetPercent() const override;
+
+    [[nodiscard]] DatabaseBeatmap *getThumbnailBeatmap() const override { return this->databaseBeatmap; }
+
     [[nodiscard]] Color getInactiveBackgroundColor() const override;
 
     [[nodiscard]] inline SongButton *getParentSongButton() const { return this->parentSongButton; }
@@ -29,10 +30,8 @@ class SongDifficultyButton : public SongButton {
     std::string sDiff;
 
     float fDiffScale;
-    float fOffsetPercentAnim;
 
     SongButton *parentSongButton;
 
     bool bUpdateGradeScheduled;
-    bool bPrevOffsetPercentSelectionState;
 };
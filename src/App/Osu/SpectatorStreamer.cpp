@@ -0,0 +1,197 @@
+#include "SpectatorStreamer.h"
+
+#include "BenchCheck.h"
+#include "ConVar.h"
+#include "Engine.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <random>
+
+namespace proto = BANCHO::Proto;
+
+SpectatorStreamer::~SpectatorStreamer() { free(this->packet.memory); }
+
+void SpectatorStreamer::reset(f64 now) {
+    this->frames.clear();
+    this->last_flush = now;
+    this->flush_interval = 0.0;
+}
+
+bool SpectatorStreamer::should_flush(f64 now, u32 pending_requests) {
+    if(this->frames.empty()) return false;
+
+    const f64 base_interval = std::clamp(cv::spec_flush_interval.getFloat() / 1000.0, 0.0, MAX_FLUSH_INTERVAL);
+    this->flush_interval = std::max(this->flush_interval, base_interval);
+    if(now < this->last_flush + this->flush_interval) return false;
+
+    if(pending_requests > 0) {
+        // a second request could reach the server before the one in flight, so wait for it (and send everything
+        // buffered until then in one bundle). if it takes longer than the interval, the connection is slow, so also
+        // back off a bit
+        this->flush_interval = std::min(std::max(this->flush_interval * 2.0, 0.1), MAX_FLUSH_INTERVAL);
+        return false;
+    }
+
+    this->flush_interval = std::max(this->flush_interval / 2.0, base_interval);
+    return true;
+}
+
+const Packet &SpectatorStreamer::flush(f64 now, const ScoreFrame &score, u16 sequence) {
+    this->packet.id = OUT_SPECTATE_FRAMES;
+    this->packet.pos = 0;
+    this->packet.reserve(sizeof(i32) + sizeof(u16) + this->frames.size() * sizeof(LiveReplayFrame) + sizeof(u8) +
+                         sizeof(ScoreFrame) + sizeof(u16));
+
+    proto::write<i32>(&this->packet, 0);
+    proto::write<u16>(&this->packet, this->frames.size());
+    for(const auto &frame : this->frames) {
+        proto::write<LiveReplayFrame>(&this->packet, frame);
+    }
+    proto::write<u8>(&this->packet, LiveReplayBundle::Action::NONE);
+    proto::write<ScoreFrame>(&this->packet, score);
+    proto::write<u16>(&this->packet, sequence);
+
+    this->frames.clear();
+    this->last_flush = now;
+    return this->packet;
+}
+
+void SpectatorStreamer::bench() {
+    // plays SECONDS of 60 fps input through a SpectatorStreamer and a stand-in bancho server (in simulated time,
+    // nothing is actually sent), and measures how long each frame takes from being written until the server has it
+    static constexpr f64 SECONDS = 120.0;
+    static constexpr f64 FRAME_TIME = 1.0 / 60.0;
+    static constexpr f64 TICK_TIME = 1.0 / 240.0;  // update_networking() runs once per game frame
+
+    struct Connection {
+        const char *name;
+        f64 latency;  // one way
+        f64 jitter;
+    };
+
+    struct Request {
+        f64 arrival;
+        f64 response;
+        std::vector<u8> data;
+    };
+
+    const f32 configuredInterval = cv::spec_flush_interval.getFloat();
+    BenchCheck check("spec_stream_bench");
+
+    const std::array<Connection, 2> connections{Connection{"good connection", 0.03, 0.02},
+                                                Connection{"bad connection", 0.4, 0.4}};
+    for(const Connection &connection : connections) {
+        for(const f32 interval : {1000.f, configuredInterval}) {
+            cv::spec_flush_interval.setValue(interval);
+
+            SpectatorStreamer streamer;
+            streamer.reset(0.0);
+
+            std::mt19937 rng(1234);
+            std::uniform_real_distribution<f64> jitter(0.0, connection.jitter);
+
+            std::vector<f64> writeTimes;
+            std::vector<f64> delays;
+            std::vector<int> timesReceived;
+            std::vector<Request> inFlight;
+            std::vector<u8> outgoing;
+            int numRequests = 0;
+            i32 lastSequence = -1;
+            u16 sequence = 0;
+
+            f64 now = 0.0;
+            const auto numPending = [&] {
+                return static_cast<u32>(std::ranges::count_if(
+                    inFlight, [now](const Request &request) { return request.response > now; }));
+            };
+
+            for(; now < SECONDS + 5.0; now += TICK_TIME) {
+                if(now < SECONDS && now >= static_cast<f64>(writeTimes.size()) * FRAME_TIME) {
+                    streamer.add_frame(LiveReplayFrame{.key_flags = 0,
+                                                       .padding = 0,
+                                                       .mouse_x = 0.f,
+                                                       .mouse_y = 0.f,
+                                                       .time = static_cast<i32>(writeTimes.size())});
+                    writeTimes.push_back(now);
+
+                    if(streamer.should_flush(now, numPending())) {
+                        const Packet &packet = streamer.flush(now, ScoreFrame{}, sequence++);
+                        outgoing.insert(outgoing.end(), packet.memory, packet.memory + packet.pos);
+                    }
+                } else if(now >= SECONDS && !streamer.empty() && numPending() == 0) {
+                    // end of the play, send whatever is left
+                    const Packet &packet = streamer.flush(now, ScoreFrame{}, sequence++);
+                    outgoing.insert(outgoing.end(), packet.memory, packet.memory + packet.pos);
+                }
+
+                // everything queued since the last tick goes out in one request
+                if(!outgoing.empty()) {
+                    const f64 arrival = now + connection.latency + jitter(rng);
+                    inFlight.push_back(Request{.arrival = arrival,
+                                               .response = arrival + connection.latency + jitter(rng),
+                                               .data = std::move(outgoing)});
+                    outgoing.clear();
+                    numRequests++;
+                }
+
+                // the server side
+                for(Request &request : inFlight) {
+                    if(request.arrival > now || request.data.empty()) continue;
+
+                    Packet packet{.memory = request.data.data(), .size = request.data.size()};
+                    while(packet.pos < packet.size) {
+                        BANCHO::Proto::read<i32>(&packet);
+                        const u16 numFrames = BANCHO::Proto::read<u16>(&packet);
+                        i32 prevTime = -1;
+                        for(u16 i = 0; i < numFrames; i++) {
+                            const auto frame = BANCHO::Proto::read<LiveReplayFrame>(&packet);
+                            if(!check.expect(frame.time >= 0 && static_cast<size_t>(frame.time) < writeTimes.size(),
+                                             "received frame {:d}, which was never written", frame.time))
+                                continue;
+
+                            check.expect(frame.time > prevTime, "frame {:d} came after frame {:d} in the same bundle",
+                                         frame.time, prevTime);
+                            prevTime = frame.time;
+
+                            timesReceived.resize(writeTimes.size());
+                            timesReceived[frame.time]++;
+                            delays.push_back(request.arrival - writeTimes[frame.time]);
+                        }
+                        BANCHO::Proto::read<u8>(&packet);
+                        BANCHO::Proto::read<ScoreFrame>(&packet);
+                        const i32 bundleSequence = BANCHO::Proto::read<u16>(&packet);
+                        check.expect(bundleSequence > lastSequence, "{:s}: bundle {:d} arrived after bundle {:d}",
+                                     connection.name, bundleSequence, lastSequence);
+                        lastSequence = std::max(lastSequence, bundleSequence);
+                    }
+                    request.data.clear();
+                }
+                std::erase_if(inFlight, [now](const Request &request) {
+                    return request.data.empty() && request.response <= now;
+                });
+            }
+
+            // every frame has to reach the server exactly once
+            timesReceived.resize(writeTimes.size());
+            for(size_t i = 0; i < timesReceived.size(); i++) {
+                check.expect(timesReceived[i] == 1, "{:s}: frame {:d} was received {:d} times", connection.name, i,
+                             timesReceived[i]);
+            }
+
+            std::ranges::sort(delays);
+            const auto percentile = [&](f64 p) {
+                return delays.empty() ? 0.0 : delays[static_cast<size_t>(p * (delays.size() - 1))] * 1000.0;
+            };
+            Engine::logRaw(
+                "spec_stream_bench: {:s}, spec_flush_interval {:.0f}: {:d} frames, {:d} requests ({:.1f} per second)\n",
+                connection.name, interval, delays.size(), numRequests, numRequests / SECONDS);
+            Engine::logRaw("    delay: p50 {:.0f} ms, p95 {:.0f} ms, p99 {:.0f} ms, max {:.0f} ms\n", percentile(0.5),
+                           percentile(0.95), percentile(0.99), percentile(1.0));
+        }
+    }
+
+    cv::spec_flush_interval.setValue(configuredInterval);
+    check.finish();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "BanchoProtocol.h"
+#include "noinclude.h"
+
+#include <vector>
+
+// batches the local player's replay frames into OUT_SPECTATE_FRAMES packets for our spectators.
+// frames are sent every spec_flush_interval ms, but only while no other bancho request is in flight, so that bundles
+// can't overtake each other on the way to the server. if requests are slow to come back, the interval doubles until
+// they go through again, but never gets longer than the fixed 1 second we used to send them at
+class SpectatorStreamer {
+    NOCOPY_NOMOVE(SpectatorStreamer)
+   public:
+    static constexpr const f64 MAX_FLUSH_INTERVAL{1.0};
+
+    SpectatorStreamer() = default;
+    ~SpectatorStreamer();
+
+    // start of a new play, drops anything left over from the previous one
+    void reset(f64 now);
+
+    inline void add_frame(const LiveReplayFrame &frame) { this->frames.push_back(frame); }
+    [[nodiscard]] inline bool empty() const { return this->frames.empty(); }
+
+    // whether the buffered frames should be sent now. pending_requests is the number of bancho requests which are
+    // still in flight, frames are held back (and keep getting batched) until it's 0
+    [[nodiscard]] bool should_flush(f64 now, u32 pending_requests);
+
+    // writes the buffered frames into a packet and clears them.
+    // the packet's buffer is reused by the next flush, so send it with BANCHO::Net::send_packet_copy()
+    const Packet &flush(f64 now, const ScoreFrame &score, u16 sequence);
+
+    [[nodiscard]] inline f64 get_flush_interval() const { return this->flush_interval; }
+
+    // spec_stream_bench: frame delivery delay over a simulated connection, and checks that every frame arrives once
+    // and that bundles arrive in order
+    static void bench();
+
+   private:
+    std::vector<LiveReplayFrame> frames;
+    Packet packet;
+    f64 last_flush = 0.0;
+    f64 flush_interval = 0.0;
+};
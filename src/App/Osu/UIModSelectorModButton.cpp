@@ -53,6 +53,7 @@ void UIModSelectorModButton::draw() {
             bool draw_inverted_colors = this->getActiveModName() == UString("afl");
 
             if(draw_inverted_colors) {
+                g->flushBatch();
                 glEnable(GL_COLOR_LOGIC_OP);
                 glLogicOp(GL_COPY_INVERTED);
             }
@@ -60,6 +61,7 @@ void UIModSelectorModButton::draw() {
             this->getActiveImageFunc()->draw(this->vPos + this->vSize / 2.f);
 
             if(draw_inverted_colors) {
+                g->flushBatch();
                 glDisable(GL_COLOR_LOGIC_OP);
             }
         }
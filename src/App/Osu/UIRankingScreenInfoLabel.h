@@ -17,10 +17,10 @@ class UIRankingScreenInfoLabel : public CBaseUIElement {
 
     void setFromBeatmap(Beatmap *beatmap, DatabaseBeatmap *diff2);
 
-    void setArtist(std::string artist) { this->sArtist = std::move(artist); }
-    void setTitle(std::string title) { this->sTitle = std::move(title); }
-    void setDiff(std::string diff) { this->sDiff = std::move(diff); }
-    void setMapper(std::string mapper) { this->sMapper = std::move(mapper); }
+    void setArtist(std::string_view artist) { this->sArtist = artist; }
+    void setTitle(std::string_view title) { this->sTitle = title; }
+    void setDiff(std::string_view diff) { this->sDiff = diff; }
+    void setMapper(std::string_view mapper) { this->sMapper = mapper; }
     void setPlayer(std::string player) { this->sPlayer = std::move(player); }
     void setDate(std::string date) { this->sDate = std::move(date); }
 
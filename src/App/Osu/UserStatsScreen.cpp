@@ -97,12 +97,7 @@ void UserStatsScreen::rebuildScoreButtons() {
 
         UString title = "...";
         if(diff != nullptr) {
-            title = diff->getArtist().c_str();
-            title.append(" - ");
-            title.append(diff->getTitle().c_str());
-            title.append(" [");
-            title.append(diff->getDifficultyName().c_str());
-            title.append("]");
+            title = UString::fmt("{:s} - {:s} [{:s}]", diff->getArtist(), diff->getTitle(), diff->getDifficultyName());
         }
 
         auto *button = new ScoreButton(this->m_contextMenu.get(), 0, 0, 300, 100, ScoreButton::STYLE::TOP_RANKS);
@@ -0,0 +1,22 @@
+#include "BenchCheck.h"
+
+#include "Engine.h"
+
+void BenchCheck::fail(std::string message) {
+    Engine::logRaw("{:s}: FAILED: {:s}\n", this->sName, message);
+
+    if(this->iNumFailures++ == 0) this->sFirstFailure = std::move(message);
+}
+
+bool BenchCheck::finish() {
+    if(this->iNumFailures == 0) {
+        Engine::logRaw("{:s}: all {:d} checks passed\n", this->sName, this->iNumChecks);
+        return true;
+    }
+
+    Engine::logRaw("{:s}: {:d} of {:d} checks FAILED\n", this->sName, this->iNumFailures, this->iNumChecks);
+    engine->showMessageError(UString(this->sName), UString::fmt("{:d} of {:d} checks failed, first: {:s}",
+                                                                 this->iNumFailures, this->iNumChecks,
+                                                                 this->sFirstFailure));
+    return false;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// correctness checks for the *_bench commands, which compare an optimized path against a reference (or check an
+// invariant) while timing them. every failed check is logged, and finish() reports the result once at the end, with
+// an error notification if anything failed, so that a broken fast path can't hide in the timing output
+class BenchCheck {
+   public:
+    explicit BenchCheck(std::string_view name) : sName(name) {}
+
+    // logs the formatted message if !ok, returns ok
+    template <typename... Args>
+    bool expect(bool ok, fmt::format_string<Args...> fmt, Args &&...args) {
+        this->iNumChecks++;
+        if(!ok) this->fail(fmt::format(fmt, std::forward<Args>(args)...));
+        return ok;
+    }
+
+    template <typename T>
+    bool expectEqual(const T &actual, const T &expected, std::string_view what) {
+        return this->expect(actual == expected, "{:s}: expected {}, got {}", what, expected, actual);
+    }
+
+    // reports the first element which differs
+    template <typename Range>
+    bool expectEqualElements(const Range &actual, const Range &expected, std::string_view what) {
+        this->iNumChecks++;
+        if(std::ranges::size(actual) != std::ranges::size(expected)) {
+            this->fail(fmt::format("{:s}: expected {:d} elements, got {:d}", what, std::ranges::size(expected),
+                                   std::ranges::size(actual)));
+            return false;
+        }
+
+        const auto [actualIt, expectedIt] = std::ranges::mismatch(actual, expected);
+        if(actualIt == std::ranges::end(actual)) return true;
+
+        this->fail(fmt::format("{:s}: element {:d}: expected {}, got {}", what,
+                               std::ranges::distance(std::ranges::begin(actual), actualIt), *expectedIt, *actualIt));
+        return false;
+    }
+
+    // logs a summary, and shows an error if any check failed. returns true if all checks passed
+    bool finish();
+
+   private:
+    void fail(std::string message);
+
+    std::string sName;
+    std::string sFirstFailure;
+    int iNumChecks{0};
+    int iNumFailures{0};
+};
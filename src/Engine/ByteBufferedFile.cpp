@@ -5,6 +5,16 @@
 #include <system_error>
 #include <cassert>
 
+#if defined(_WIN32)
+#include "WinDebloatDefs.h"
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 ByteBufferedFile::Reader::Reader(const UString &uPath) : buffer(READ_BUFFER_SIZE) {
     auto path = std::filesystem::path(uPath.plat_str());
     this->file.open(path, std::ios::binary);
@@ -168,6 +178,144 @@ void ByteBufferedFile::Reader::skip_string() {
     this->skip_bytes(len);
 }
 
+ByteBufferedFile::MappedFile::MappedFile(const UString &uPath) {
+    auto path = std::filesystem::path(uPath.plat_str());
+
+    std::error_code ec;
+    const auto file_size = std::filesystem::file_size(path, ec);
+    if(ec) {
+        this->set_error("Failed to open file for reading: " + ec.message());
+        debugLog("Failed to open '{:s}': {:s}\n", path.string().c_str(), ec.message().c_str());
+        return;
+    }
+
+    this->view_size = static_cast<size_t>(file_size);
+    if(this->view_size == 0) return;  // nothing to map
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file != INVALID_HANDLE_VALUE) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);  // the mapping keeps the file open
+        if(mapping != nullptr) {
+            const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if(view != nullptr) {
+                this->mapping = mapping;
+                this->view = static_cast<const u8 *>(view);
+                return;
+            }
+            CloseHandle(mapping);
+        }
+    }
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if(fd >= 0) {
+        void *view = mmap(nullptr, this->view_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);  // the mapping keeps the file open
+        if(view != MAP_FAILED) {
+            // we're going to read all of it, likely from several threads at once
+            madvise(view, this->view_size, MADV_WILLNEED);
+            this->mapping = view;
+            this->view = static_cast<const u8 *>(view);
+            return;
+        }
+    }
+#endif
+
+    // couldn't map it (e.g. some network drives), just read the whole thing
+    debugLog("Failed to map '{:s}', reading it into memory instead\n", path.string().c_str());
+    std::ifstream file(path, std::ios::binary);
+    this->fallback_buffer.resize(this->view_size);
+    file.read(reinterpret_cast<char *>(this->fallback_buffer.data()), static_cast<std::streamsize>(this->view_size));
+    if(!file.is_open() || static_cast<size_t>(file.gcount()) != this->view_size) {
+        this->set_error("Failed to read file: " + std::generic_category().message(errno));
+        this->fallback_buffer.clear();
+        this->view_size = 0;
+        return;
+    }
+    this->view = this->fallback_buffer.data();
+}
+
+ByteBufferedFile::MappedFile::~MappedFile() {
+    if(this->mapping == nullptr) return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(this->view);
+    CloseHandle(static_cast<HANDLE>(this->mapping));
+#else
+    munmap(this->mapping, this->view_size);
+#endif
+}
+
+void ByteBufferedFile::MappedFile::set_error(const std::string &error_msg) {
+    if(!this->error_flag) {  // only set first error
+        this->error_flag = true;
+        this->last_error = error_msg;
+    }
+}
+
+MD5Hash ByteBufferedFile::MemoryReader::read_hash() {
+    MD5Hash hash;
+
+    u8 empty_check = this->read<u8>();
+    if(empty_check == 0) return hash;
+
+    u32 len = this->read_uleb128();
+    u32 extra = 0;
+    if(len > 32) {
+        // just continue, see Reader::read_hash()
+        extra = len - 32;
+        len = 32;
+    }
+
+    assert(len <= 32);
+    if(this->read_bytes(reinterpret_cast<u8 *>(hash.hash.data()), len) != len) {
+        return hash;
+    }
+    this->skip_bytes(extra);
+    hash.hash[len] = '\0';
+    return hash;
+}
+
+std::string ByteBufferedFile::MemoryReader::read_string() {
+    u8 empty_check = this->read<u8>();
+    if(empty_check == 0) return {};
+
+    u32 len = this->read_uleb128();
+    if(this->error_flag || len > this->total_size - this->total_pos) {
+        this->error_flag = true;
+        return {};
+    }
+
+    // construct straight from the mapped memory, no intermediate copy
+    std::string str_out(reinterpret_cast<const char *>(this->data + this->total_pos), len);
+    this->total_pos += len;
+    return str_out;
+}
+
+u32 ByteBufferedFile::MemoryReader::read_uleb128() {
+    u32 result = 0;
+    u32 shift = 0;
+    u8 byte = 0;
+
+    do {
+        byte = this->read<u8>();
+        result |= (byte & 0x7f) << shift;
+        shift += 7;
+    } while((byte & 0x80) && shift < 35);
+
+    return result;
+}
+
+void ByteBufferedFile::MemoryReader::skip_string() {
+    u8 empty_check = this->read<u8>();
+    if(empty_check == 0) return;
+
+    u32 len = this->read_uleb128();
+    this->skip_bytes(len);
+}
+
 ByteBufferedFile::Writer::Writer(const UString &uPath) : buffer(WRITE_BUFFER_SIZE) {
     auto path = std::filesystem::path(uPath.plat_str());
     this->file_path = path;
@@ -193,6 +193,104 @@ class ByteBufferedFile {
         std::string last_error;
     };
 
+    // read-only view of a whole file, memory-mapped where possible (otherwise read into memory at once).
+    // for parsers which want to jump around in the file, or split it up between threads (see MemoryReader)
+    class MappedFile {
+        NOCOPY_NOMOVE(MappedFile)
+       public:
+        MappedFile(const UString &uPath);
+        ~MappedFile();
+
+        [[nodiscard]] bool good() const { return !this->error_flag; }
+        [[nodiscard]] std::string_view error() const { return this->last_error; }
+
+        [[nodiscard]] inline const u8 *data() const { return this->view; }
+        [[nodiscard]] inline size_t size() const { return this->view_size; }
+
+       private:
+        void set_error(const std::string &error_msg);
+
+        const u8 *view{nullptr};
+        size_t view_size{0};
+
+        void *mapping{nullptr};  // platform handle, or null if we fell back to reading the file
+        std::vector<u8> fallback_buffer;
+
+        bool error_flag{false};
+        std::string last_error;
+    };
+
+    // same interface as Reader, but reads from memory (e.g. a MappedFile) instead of a stream.
+    // cheap to copy, so several readers can work on different parts of the same file at once
+    class MemoryReader {
+       public:
+        MemoryReader() = default;
+        MemoryReader(const u8 *data, size_t size) : total_size(size), data(data) {}
+        MemoryReader(const MappedFile &file) : MemoryReader(file.data(), file.size()) {}
+
+        [[nodiscard]] always_inline_attr size_t read_bytes(u8 *out, size_t len) {
+            if(this->error_flag || len > this->total_size - this->total_pos) {
+                this->error_flag = true;
+                if(out != nullptr) {
+                    memset(out, 0, len);
+                }
+                return 0;
+            }
+
+            if(out != nullptr) {
+                memcpy(out, this->data + this->total_pos, len);
+            }
+            this->total_pos += len;
+            return len;
+        }
+
+        template <typename T>
+        [[nodiscard]] T read() {
+            T result;
+            if((this->read_bytes(reinterpret_cast<u8 *>(&result), sizeof(T))) != sizeof(T)) {
+                memset(&result, 0, sizeof(T));
+            }
+            return result;
+        }
+
+        always_inline_attr void skip_bytes(size_t n) {
+            if(this->error_flag || n > this->total_size - this->total_pos) {
+                this->error_flag = true;
+                return;
+            }
+            this->total_pos += n;
+        }
+
+        template <typename T>
+        void skip() {
+            this->skip_bytes(sizeof(T));
+        }
+
+        // absolute position, e.g. one remembered from total_pos earlier
+        void seek(size_t pos) {
+            if(pos > this->total_size) {
+                this->error_flag = true;
+                return;
+            }
+            this->total_pos = pos;
+        }
+
+        [[nodiscard]] bool good() const { return !this->error_flag; }
+
+        [[nodiscard]] MD5Hash read_hash();
+        [[nodiscard]] std::string read_string();
+        [[nodiscard]] u32 read_uleb128();
+
+        void skip_string();
+
+        size_t total_size{0};
+        size_t total_pos{0};
+
+       private:
+        const u8 *data{nullptr};
+        bool error_flag{false};
+    };
+
     class Writer {
         NOCOPY_NOMOVE(Writer)
        public:
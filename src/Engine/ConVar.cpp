@@ -4,21 +4,32 @@
 #include "Bancho.h"
 #include "BanchoUsers.h"
 #include "Beatmap.h"
+#include "BenchCheck.h"
 #include "CBaseUILabel.h"
+#include "Chat.h"
 #include "Console.h"
 #include "Database.h"
+#include "DrainRate.h"
 #include "Engine.h"
+#include "FPSLimiter.h"
+#include "Font.h"
+#include "HitObjectStacking.h"
 #include "ModSelector.h"
+#include "NullGraphicsInterface.h"
 #include "Osu.h"
 #include "Profiler.h"
 #include "RichPresence.h"
+#include "SimulatedBeatmap.h"
+#include "SliderCurves.h"
 #include "SongBrowser/LoudnessCalcThread.h"
 #include "SoundEngine.h"
+#include "SpectatorStreamer.h"
 #include "SpectatorScreen.h"
 #include "UpdateHandler.h"
 
 #include <algorithm>
 #include <fmt/chrono.h>
+#include <unordered_map>
 #include <unordered_set>
 
 static std::vector<ConVar *> &_getGlobalConVarArray() {
@@ -101,7 +112,7 @@ void ConVar::execFloat(float args) {
     if(auto *cb = std::get_if<NativeConVarCallbackFloat>(&this->callback)) (*cb)(args);
 }
 
-double ConVar::getDouble() const {
+double ConVar::resolveDouble() const {
     if(this->isFlagSet(cv::SERVER) && this->hasServerValue.load(std::memory_order_acquire)) {
         return this->dServerValue.load(std::memory_order_acquire);
     }
@@ -117,7 +128,7 @@ double ConVar::getDouble() const {
     return this->dClientValue.load(std::memory_order_acquire);
 }
 
-const ConVarString &ConVar::getString() const {
+const ConVarString &ConVar::resolveString() const {
     if(this->isFlagSet(cv::SERVER) && this->hasServerValue.load(std::memory_order_acquire)) {
         return this->sServerValue;
     }
@@ -133,10 +144,16 @@ const ConVarString &ConVar::getString() const {
     return this->sClientValue;
 }
 
+void ConVar::updateEffectiveValue() {
+    this->dEffectiveValue.store(this->resolveDouble(), std::memory_order_relaxed);
+    this->pEffectiveString.store(&this->resolveString(), std::memory_order_relaxed);
+}
+
 
 void ConVar::setDefaultDouble(double defaultValue) {
     this->dDefaultValue = defaultValue;
     this->sDefaultValue = fmt::format("{:g}", defaultValue);
+    this->updateEffectiveValue();
 }
 
 void ConVar::setDefaultString(const std::string_view &defaultValue) {
@@ -147,6 +164,8 @@ void ConVar::setDefaultString(const std::string_view &defaultValue) {
     if(f != 0.0) {
         this->dDefaultValue = f;
     }
+
+    this->updateEffectiveValue();
 }
 
 bool ConVar::onSetValueGameplay(CvarEditor editor) {
@@ -313,15 +332,68 @@ bool ConVarHandler::areAllCvarsSubmittable() {
 
 void ConVarHandler::resetServerCvars() {
     for(const auto &cv : _getGlobalConVarArray()) {
-        cv->hasServerValue.store(false, std::memory_order_release);
         cv->serverProtectionPolicy.store(ConVar::ProtectionPolicy::DEFAULT, std::memory_order_release);
+        cv->clearServerValue();
     }
 }
 
 void ConVarHandler::resetSkinCvars() {
     for(const auto &cv : _getGlobalConVarArray()) {
         cv->hasSkinValue.store(false, std::memory_order_release);
+        cv->updateEffectiveValue();
+    }
+}
+
+void ConVarHandler::updateMultiplayerState() {
+    const bool inMultiRoom = BanchoState::is_in_a_multi_room();
+    if(inMultiRoom == this->bInMultiRoom) return;
+    this->bInMultiRoom = inMultiRoom;
+
+    for(const auto &cv : _getGlobalConVarArray()) {
+        if(cv->isProtected()) cv->updateEffectiveValue();
+    }
+}
+
+// measures the per-read cost of the cached getDouble() against the full lookup it replaced
+void ConVarHandler::bench() const {
+    static constexpr int NUM_ITERATIONS = 1000;
+
+    std::vector<const ConVar *> valueCvars;
+    for(const ConVar *cv : this->getConVarArray()) {
+        if(cv->hasValue()) valueCvars.push_back(cv);
+    }
+    if(valueCvars.empty()) return;
+
+    // the cached value has to be exactly what a full lookup gives
+    BenchCheck check("cvar_bench");
+    for(const ConVar *cv : valueCvars) {
+        check.expectEqual(cv->getDouble(), cv->resolveDouble(), cv->getName());
+    }
+
+    const auto numReads = static_cast<double>(valueCvars.size() * NUM_ITERATIONS);
+    double cachedSum = 0.0;  // so the reads can't be optimized out
+    double resolvedSum = 0.0;
+
+    u64 startTime = Timing::getTicksNS();
+    for(int i = 0; i < NUM_ITERATIONS; i++) {
+        for(const ConVar *cv : valueCvars) {
+            cachedSum += cv->getDouble();
+        }
+    }
+    const double cachedNS = static_cast<double>(Timing::getTicksNS() - startTime) / numReads;
+
+    startTime = Timing::getTicksNS();
+    for(int i = 0; i < NUM_ITERATIONS; i++) {
+        for(const ConVar *cv : valueCvars) {
+            resolvedSum += cv->resolveDouble();
+        }
     }
+    const double resolvedNS = static_cast<double>(Timing::getTicksNS() - startTime) / numReads;
+
+    Engine::logRaw("cvar_bench: {:.0f} reads each, cached: {:.2f} ns/read, resolved: {:.2f} ns/read\n", numReads,
+                   cachedNS, resolvedNS);
+    check.expectEqual(cachedSum, resolvedSum, "sum of all reads");
+    check.finish();
 }
 
 
@@ -452,6 +524,34 @@ static void _listcommands(void) {
     Engine::logRaw("----------------------------------------------\n");
 }
 
+static void _cvar_bench(void) { cvars->bench(); }
+
+static void _ustring_bench(void) { Utf8String::bench(); }
+
+static void _font_bench(void) { McFont::bench(); }
+
+static void _chat_bench(void) { ChatChannel::bench(); }
+
+static void _gfx_batch_bench(void) { NullGraphicsInterface::batchBench(); }
+
+static void _gfx_stream_bench(void) { NullGraphicsInterface::streamBench(); }
+
+static void _fps_pacing_stats(const UString &args) { FPSLimiter::pacing_stats(args); }
+
+static void _fps_pacing_bench(void) { FPSLimiter::pacing_bench(); }
+
+static void _spec_stream_bench(void) { SpectatorStreamer::bench(); }
+
+static void _replay_seek_bench(void) { SimulatedBeatmap::bench(); }
+
+static void _slider_curve_bench(void) { SliderCurve::bench(); }
+
+static void _stacking_bench(const UString &args) { HitObjectStacking::bench(args); }
+
+static void _drain_cache_stats(const UString &args) { DrainRate::printStats(args); }
+
+static void _drain_cache_bench(const UString &args) { DrainRate::bench(args); }
+
 static void _dumpcommands(void) {
     // XXX: move this into assets/
     std::string html_template = R"(<!DOCTYPE html>
@@ -698,6 +798,10 @@ void _vprof(float newValue) {
     }
 }
 
+void _vprof_trace(float newValue) { ProfilerTrace::setEnabled(!!static_cast<int>(newValue)); }
+
+void _vprof_trace_dump(const UString &args) { ProfilerTrace::dumpCommand(args); }
+
 void _osuOptionsSliderQualityWrapper(float newValue) {
     float value = std::lerp(1.0f, 2.5f, 1.0f - newValue);
     cv::slider_curve_points_separation.setValue(value);
@@ -247,8 +247,15 @@ class ConVar {
 
     std::string getFancyDefaultValue();
 
-    [[nodiscard]] double getDouble() const;
-    [[nodiscard]] const ConVarString &getString() const;
+    // these just read the cached effective value (see updateEffectiveValue()), so they're cheap enough for hot paths
+    [[nodiscard]] inline double getDouble() const { return this->dEffectiveValue.load(std::memory_order_relaxed); }
+    [[nodiscard]] inline const ConVarString &getString() const {
+        return *this->pEffectiveString.load(std::memory_order_relaxed);
+    }
+
+    // full server > skin > client lookup, only needed for updating the cached values (and cvar_bench)
+    [[nodiscard]] double resolveDouble() const;
+    [[nodiscard]] const ConVarString &resolveString() const;
 
     template <typename T = int>
     [[nodiscard]] inline auto getVal() const {
@@ -274,7 +281,15 @@ class ConVar {
 
     [[nodiscard]] inline bool isFlagSet(uint8_t flag) const { return (bool)((this->iFlags & flag) == flag); }
 
-    void setServerProtected(ProtectionPolicy policy) { this->serverProtectionPolicy.store(policy, std::memory_order_release); }
+    void setServerProtected(ProtectionPolicy policy) {
+        this->serverProtectionPolicy.store(policy, std::memory_order_release);
+        this->updateEffectiveValue();
+    }
+
+    void clearServerValue() {
+        this->hasServerValue.store(false, std::memory_order_release);
+        this->updateEffectiveValue();
+    }
 
     [[nodiscard]] inline bool isProtected() const {
         switch(this->serverProtectionPolicy.load(std::memory_order_acquire)) {
@@ -289,6 +304,9 @@ class ConVar {
     }
 
    private:
+    // must be called whenever the client/skin/server/default values, their flags, or the multiplayer state change
+    void updateEffectiveValue();
+
     // invalidates replay, returns true if value change should be allowed
     [[nodiscard]] bool onSetValueGameplay(CvarEditor editor);
 
@@ -344,6 +362,8 @@ class ConVar {
         this->dSkinValue.store(this->dDefaultValue, std::memory_order_relaxed);
         this->dServerValue.store(this->dDefaultValue, std::memory_order_relaxed);
 
+        this->updateEffectiveValue();
+
         // set callback if provided
         if constexpr(!std::is_same_v<Callback, std::nullptr_t>) {
             if constexpr(std::is_invocable_v<Callback>)
@@ -412,6 +432,9 @@ class ConVar {
             }
         }
 
+        // (before callbacks, they might read the new value)
+        this->updateEffectiveValue();
+
         // prevent score submission if the cvar was protected
         if(this->isProtected()) {
             this->onSetValueProtected(oldString, newString);
@@ -468,6 +491,10 @@ class ConVar {
     ConVarString sServerValue{};
     std::atomic<ProtectionPolicy> serverProtectionPolicy{ProtectionPolicy::DEFAULT};
 
+    // cached result of resolveDouble()/resolveString()
+    std::atomic<double> dEffectiveValue{0.0};
+    std::atomic<const ConVarString *> pEffectiveString{&this->sClientValue};
+
     // callback storage (allow having 1 "change" callback and 1 single value (or void) callback)
     ExecutionCallback callback{std::monostate()};
     ChangeCallback changeCallback{std::monostate()};
@@ -499,6 +526,15 @@ class ConVarHandler {
 
     void resetServerCvars();
     void resetSkinCvars();
+
+    // protected cvars resolve to their default values while in a multiplayer room, call once per frame
+    void updateMultiplayerState();
+
+    // cvar_bench
+    void bench() const;
+
+   private:
+    bool bInMultiRoom{false};
 };
 
 extern ConVarHandler *cvars;
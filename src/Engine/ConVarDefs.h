@@ -33,22 +33,36 @@ inline void setThreadPriority(float /**/) { ; }
 
 extern void _borderless();
 extern void _center();
+extern void _chat_bench();
+extern void _cvar_bench();
 extern void _dpiinfo();
+extern void _drain_cache_bench();
+extern void _drain_cache_stats();
 extern void _dumpcommands();
 extern void _echo();
 extern void _errortest();
 extern void _exec();
 extern void _find();
+extern void _font_bench();
 extern void _focus();
+extern void _fps_pacing_bench();
+extern void _fps_pacing_stats();
+extern void _gfx_batch_bench();
+extern void _gfx_stream_bench();
 extern void _help();
 extern void _listcommands();
 extern void _maximize();
 extern void _minimize();
 extern void _printsize();
+extern void _replay_seek_bench();
 extern void _toggleresizable();
 extern void _restart();
 extern void _save();
+extern void _slider_curve_bench();
+extern void _spec_stream_bench();
+extern void _stacking_bench();
 extern void _update();
+extern void _ustring_bench();
 
 #define OSU_VERSION_DATEONLY 0
 
@@ -60,6 +74,8 @@ extern void onRichPresenceChange(const UString &, const UString &);
 }
 extern void _osu_songbrowser_search_hardcoded_filter(const UString &, const UString &);
 extern void _vprof(float);
+extern void _vprof_trace(float);
+extern void _vprof_trace_dump(const UString &);
 extern void _volume(const UString &, const UString &);
 #endif
 
@@ -92,24 +108,39 @@ namespace cmd {
 // Generic commands
 CONVAR(borderless, "borderless", CLIENT, CFUNC(_borderless));
 CONVAR(center, "center", CLIENT, CFUNC(_center));
+CONVAR(chat_bench, "chat_bench", CLIENT, CFUNC(_chat_bench));
 CONVAR(clear, "clear");
+CONVAR(cvar_bench, "cvar_bench", CLIENT, CFUNC(_cvar_bench));
 CONVAR(dpiinfo, "dpiinfo", CLIENT, CFUNC(_dpiinfo));
+CONVAR(drain_cache_bench, "drain_cache_bench", CLIENT, CFUNC(_drain_cache_bench));
+CONVAR(drain_cache_stats, "drain_cache_stats", CLIENT, CFUNC(_drain_cache_stats));
 CONVAR(dumpcommands, "dumpcommands", CLIENT, CFUNC(_dumpcommands));
 CONVAR(errortest, "errortest", CLIENT, CFUNC(_errortest));
 CONVAR(exec, "exec", CLIENT, CFUNC(_exec));
 CONVAR(find, "find", CLIENT, CFUNC(_find));
 CONVAR(focus, "focus", CLIENT, CFUNC(_focus));
+CONVAR(font_bench, "font_bench", CLIENT, CFUNC(_font_bench));
+CONVAR(fps_pacing_bench, "fps_pacing_bench", CLIENT, CFUNC(_fps_pacing_bench));
+CONVAR(fps_pacing_stats, "fps_pacing_stats", CLIENT, CFUNC(_fps_pacing_stats));
+CONVAR(gfx_batch_bench, "gfx_batch_bench", CLIENT, CFUNC(_gfx_batch_bench));
+CONVAR(gfx_stream_bench, "gfx_stream_bench", CLIENT, CFUNC(_gfx_stream_bench));
 CONVAR(help, "help", CLIENT, CFUNC(_help));
 CONVAR(listcommands, "listcommands", CLIENT, CFUNC(_listcommands));
 CONVAR(maximize, "maximize", CLIENT, CFUNC(_maximize));
 CONVAR(minimize, "minimize", CLIENT, CFUNC(_minimize));
 CONVAR(printsize, "printsize", CLIENT, CFUNC(_printsize));
+CONVAR(replay_seek_bench, "replay_seek_bench", CLIENT, CFUNC(_replay_seek_bench));
 CONVAR(resizable_toggle, "resizable_toggle", CLIENT, CFUNC(_toggleresizable));
 CONVAR(restart, "restart", CLIENT, CFUNC(_restart));
 CONVAR(save, "save", CLIENT, CFUNC(_save));
 CONVAR(showconsolebox, "showconsolebox");
 CONVAR(snd_restart, "snd_restart");
+CONVAR(slider_curve_bench, "slider_curve_bench", CLIENT, CFUNC(_slider_curve_bench));
+CONVAR(spec_stream_bench, "spec_stream_bench", CLIENT, CFUNC(_spec_stream_bench));
+CONVAR(stacking_bench, "stacking_bench", CLIENT, CFUNC(_stacking_bench));
 CONVAR(update, "update", CLIENT, CFUNC(_update));
+CONVAR(ustring_bench, "ustring_bench", CLIENT, CFUNC(_ustring_bench));
+CONVAR(vprof_trace_dump, "vprof_trace_dump", CLIENT, CFUNC(_vprof_trace_dump));
 CONVAR(complete_oauth, "complete_oauth", CLIENT, CFUNC(BANCHO::Net::complete_oauth));
 
 // Server-callable commands
@@ -217,7 +248,14 @@ CONVAR(r_opengl_legacy_vao_use_vertex_array, "r_opengl_legacy_vao_use_vertex_arr
        "texcoords/normals/etc. are NOT in gl_MultiTexCoord0 -> requiring a shader with attributes)");
 CONVAR(font_load_system, "font_load_system", true, CLIENT,
        "try to load a similar system font if a glyph is missing in the bundled fonts");
+CONVAR(font_run_cache, "font_run_cache", true, CLIENT,
+       "remember the measured width/height of recently measured strings (per font)");
 CONVAR(r_image_unbind_after_drawimage, "r_image_unbind_after_drawimage", true, CLIENT);
+CONVAR(r_batch_sprites, "r_batch_sprites", true, CLIENT,
+       "collect drawImage() calls into a vertex buffer and draw them with one draw call per texture");
+CONVAR(r_stream_buffer_size, "r_stream_buffer_size", 12, CLIENT,
+       "size in MB of the persistently mapped buffer for per-frame geometry (text, cursor trail, batched sprites), "
+       "should fit about three frames. 0 disables it. requires a restart");
 CONVAR(r_globaloffset_x, "r_globaloffset_x", 0.0f, CLIENT | PROTECTED | GAMEPLAY);
 CONVAR(r_globaloffset_y, "r_globaloffset_y", 0.0f, CLIENT | PROTECTED | GAMEPLAY);
 CONVAR(r_sync_debug, "r_sync_debug", false, CLIENT | HIDDEN, "print debug information about sync objects");
@@ -242,6 +280,9 @@ CONVAR(vprof_graph_range_max, "vprof_graph_range_max", 16.666666f, CLIENT | SERV
 CONVAR(vprof_graph_width, "vprof_graph_width", 800.0f, CLIENT | SERVER);
 CONVAR(vprof_spike, "vprof_spike", 0, CLIENT | SERVER,
        "measure and display largest spike details (1 = small info, 2 = extended info)");
+CONVAR(vprof_trace, "vprof_trace", false, CLIENT,
+       "record timed zones from all threads (main thread VPROF scopes, loaders, audio, network), see vprof_trace_dump",
+       CFUNC(_vprof_trace));
 
 // Keybinds
 CONVAR(BOSS_KEY, "key_boss", (int)KEY_INSERT, CLIENT);
@@ -300,8 +341,14 @@ CONVAR(win_disable_windows_key_while_playing, "win_disable_windows_key_while_pla
 CONVAR(database_enabled, "database_enabled", true, CLIENT);
 CONVAR(database_ignore_version, "database_ignore_version", true, CLIENT,
        "ignore upper version limit and force load the db file (may crash)");
+CONVAR(database_load_threads, "database_load_threads", 0, CLIENT,
+       "number of threads used to decode osu!.db (0 = automatic)");
 CONVAR(database_version, "database_version", OSU_VERSION_DATEONLY, CLIENT | NOLOAD | NOSAVE,
        "maximum supported osu!.db version, above this will use fallback loader");
+CONVAR(drain_cache, "drain_cache", true, CLIENT,
+       "remember drain rate simulation results per beatmap/mods in neosu_drain.db");
+CONVAR(drain_cache_max_entries, "drain_cache_max_entries", 50000, CLIENT,
+       "results kept in neosu_drain.db, the least recently used ones are dropped first");
 CONVAR(osu_folder, "osu_folder", "", CLIENT);
 CONVAR(osu_folder_sub_skins, "osu_folder_sub_skins", "Skins/", CLIENT);
 CONVAR(songs_folder, "songs_folder", "Songs/", CLIENT);
@@ -366,6 +413,8 @@ CONVAR(songbrowser_search_delay, "songbrowser_search_delay", 0.2f, CLIENT,
 CONVAR(songbrowser_search_hardcoded_filter, "songbrowser_search_hardcoded_filter", "", CLIENT,
        "allows forcing the specified search filter to be active all the time",
        CFUNC(_osu_songbrowser_search_hardcoded_filter));
+CONVAR(songbrowser_thumbnail_prefetch, "songbrowser_thumbnail_prefetch", 3, CLIENT,
+       "how many song buttons outside of the visible area (in scroll direction) to start loading thumbnails for");
 
 // Song browser (maybe useful to servers)
 CONVAR(songbrowser_scorebrowser_enabled, "songbrowser_scorebrowser_enabled", true, CLIENT | SKINS | SERVER);
@@ -742,14 +791,20 @@ CONVAR(auto_snapping_strength, "auto_snapping_strength", 1.0f, CLIENT | SERVER,
        "How many iterations of quadratic interpolation to use, more = snappier, 0 = linear");
 
 // Performance tweaks
-CONVAR(background_image_cache_size, "background_image_cache_size", 32, CLIENT,
-       "how many images can stay loaded in parallel");
+CONVAR(background_image_cache_budget_mb, "background_image_cache_budget_mb", 256, CLIENT,
+       "how much memory (in MB, decoded) cached background images may use before the least recently used get evicted");
+CONVAR(background_image_cache_size, "background_image_cache_size", 256, CLIENT,
+       "how many images can stay cached (loaded or loading) in parallel");
 CONVAR(background_image_eviction_delay_frames, "background_image_eviction_delay_frames", 0, CLIENT,
        "how many frames to keep stale background images in the cache before deleting them (if seconds && frames)");
 CONVAR(background_image_eviction_delay_seconds, "background_image_eviction_delay_seconds", 0.05f, CLIENT,
        "how many seconds to keep stale background images in the cache before deleting them (if seconds && frames)");
 CONVAR(background_image_loading_delay, "background_image_loading_delay", 0.1f, CLIENT,
        "how many seconds to wait until loading background images for visible beatmaps starts");
+CONVAR(background_image_thumbnail_cache, "background_image_thumbnail_cache", true, CLIENT,
+       "keep downscaled song browser thumbnails on disk (in cache/thumbnails/)");
+CONVAR(background_image_thumbnail_height, "background_image_thumbnail_height", 256, CLIENT,
+       "height in pixels to decode song browser thumbnails at (0 = always load full resolution images)");
 
 // Display settings
 CONVAR(fps_max, "fps_max", 1000.0f, CLIENT, "framerate limiter, gameplay");
@@ -757,6 +812,9 @@ CONVAR(fps_max_menu, "fps_max_menu", 420.f, CLIENT, "framerate limiter, menus");
 CONVAR(fps_max_background, "fps_max_background", 30.0f, CLIENT, "framerate limiter, background");
 CONVAR(fps_max_yield, "fps_max_yield", false, CLIENT,
        "always release rest of timeslice once per frame (call scheduler via sleep(0))");
+CONVAR(fps_max_adaptive_spin, "fps_max_adaptive_spin", true, CLIENT,
+       "sleep for most of the frame and spin for the rest, based on how late the scheduler has been waking us up "
+       "(see fps_pacing_stats); otherwise use the platform's precise sleep");
 // fps_unlimited: Unused since v39.01. Instead we just check if fps_max <= 0 (see MainMenu.cpp for migration)
 CONVAR(fps_unlimited, "fps_unlimited", false, CLIENT | HIDDEN | NOSAVE);
 CONVAR(
@@ -780,6 +838,8 @@ CONVAR(beatmap_max_num_slider_scoringtimes, "beatmap_max_num_slider_scoringtimes
        "(prevent crashing on deliberate game-breaking beatmaps)");
 CONVAR(build_timestamp, "build_timestamp", BUILD_TIMESTAMP, CONSTANT);
 CONVAR(debug_network, "debug_network", false, CONSTANT);
+CONVAR(slider_curve_batch_eval, "slider_curve_batch_eval", true, CLIENT,
+       "evaluate whole slider curve segments at once instead of point by point (same result, see slider_curve_bench)");
 CONVAR(slider_curve_max_length, "slider_curve_max_length", 65536 / 2, CONSTANT,
        "maximum slider length in osu!pixels (i.e. pixelLength). also used to clamp all "
        "(control-)point coordinates to sane values.");
@@ -1095,8 +1155,10 @@ CONVAR(scoreboard_animations, "scoreboard_animations", true, CLIENT | SKINS | SE
 CONVAR(scores_bonus_pp, "scores_bonus_pp", true, CLIENT | SKINS | SERVER,
        "whether to add bonus pp to total (real) pp or not");
 CONVAR(scores_enabled, "scores_enabled", true, CLIENT | SKINS | SERVER);
+CONVAR(scores_journal_compact_threshold, "scores_journal_compact_threshold", 500, CLIENT,
+       "rewrite neosu_scores.db (in the background) once this many changes have been appended to its journal");
 CONVAR(scores_save_immediately, "scores_save_immediately", true, CLIENT | SKINS | SERVER,
-       "write scores.db as soon as a new score is added");
+       "append scores to the neosu_scores.db journal as soon as they are added");
 CONVAR(scores_sort_by_pp, "scores_sort_by_pp", true, CLIENT | SKINS | SERVER,
        "display pp in score browser instead of score");
 CONVAR(scrubbing_smooth, "scrubbing_smooth", true, CLIENT | SKINS | SERVER);
@@ -1110,10 +1172,15 @@ CONVAR(show_approach_circle_on_first_hidden_object, "show_approach_circle_on_fir
        CLIENT | SKINS | SERVER);
 CONVAR(simulate_replays, "simulate_replays", false, CLIENT | SKINS | SERVER,
        "experimental \"improved\" replay playback");
+CONVAR(simulate_replays_checkpoint_interval, "simulate_replays_checkpoint_interval", 5000, CLIENT | SKINS | SERVER,
+       "how often (in ms of replay time) to save the simulation state while watching a replay, for faster seeking "
+       "backwards (0 = only rewind to the start)");
 CONVAR(skin, "skin", "default", CLIENT | SKINS | SERVER);
 CONVAR(skin_animation_force, "skin_animation_force", false, CLIENT | SKINS | SERVER);
 CONVAR(skin_animation_fps_override, "skin_animation_fps_override", -1.0f, CLIENT | SKINS | SERVER);
 CONVAR(skin_async, "skin_async", true, CLIENT | SKINS | SERVER, "load in background without blocking");
+CONVAR(skin_atlas, "skin_atlas", true, CLIENT | SKINS | SERVER,
+       "pack hitcircles and number glyphs into a texture atlas, to batch their draw calls (not used with skin_mipmaps)");
 CONVAR(skin_color_index_add, "skin_color_index_add", 0, CLIENT | SKINS | SERVER);
 CONVAR(skin_force_hitsound_sample_set, "skin_force_hitsound_sample_set", 0, CLIENT | SKINS | SERVER,
        "force a specific hitsound sample set to always be used regardless of what "
@@ -1189,6 +1256,11 @@ CONVAR(sort_skins_cleaned, "sort_skins_cleaned", false, CLIENT | SKINS | SERVER,
        "set to true to sort skins alphabetically, ignoring special characters at the start (not like stable)");
 
 CONVAR(spec_buffer, "spec_buffer", 2500, CLIENT, "size of spectator buffer in milliseconds");
+// spec_flush_interval: Every flush is its own bancho request (only one in flight at a time), so the default of 100ms
+// means up to 10 requests per second while someone is spectating you, instead of the 1 per second we used to send.
+CONVAR(spec_flush_interval, "spec_flush_interval", 100, CLIENT,
+       "how often to send replay frames to your spectators, in milliseconds (longer while the connection is slow). "
+       "each send is a separate request to the server");
 CONVAR(spec_share_map, "spec_share_map", true, CLIENT | SKINS | SERVER,
        "automatically send currently-playing beatmap to #spectator");
 
@@ -1196,6 +1268,9 @@ CONVAR(spinner_fade_out_time_multiplier, "spinner_fade_out_time_multiplier", 0.7
 CONVAR(spinner_use_ar_fadein, "spinner_use_ar_fadein", false, CLIENT | SKINS | SERVER,
        "whether spinners should fade in with AR (same as circles), or with hardcoded 400 ms fadein time (osu!default)");
 CONVAR(ssl_verify, "ssl_verify", true, CLIENT);
+CONVAR(stacking_grid, "stacking_grid", true, CLIENT,
+       "look up nearby hitobjects in a spatial hash when calculating stacks on dense maps (same result, see "
+       "stacking_bench)");
 CONVAR(stars_ignore_clamped_sliders, "stars_ignore_clamped_sliders", true, CLIENT | SKINS | SERVER,
        "skips processing sliders limited by slider_curve_max_length");
 CONVAR(stars_slider_curve_points_separation, "stars_slider_curve_points_separation", 20.0f, CLIENT | SKINS | SERVER,
@@ -1213,6 +1288,8 @@ CONVAR(ui_scale_to_dpi_minimum_height, "ui_scale_to_dpi_minimum_height", 1300, C
        "any in-game resolutions below this will have ui_scale_to_dpi force disabled");
 CONVAR(ui_scale_to_dpi_minimum_width, "ui_scale_to_dpi_minimum_width", 2200, CLIENT | SKINS | SERVER,
        "any in-game resolutions below this will have ui_scale_to_dpi force disabled");
+CONVAR(ui_scrollview_culling, "ui_scrollview_culling", true, CLIENT,
+       "only update/draw the children of scrollviews which are around the visible area");
 CONVAR(ui_scrollview_kinetic_approach_time, "ui_scrollview_kinetic_approach_time", 0.075f, CLIENT | SKINS | SERVER,
        "approach target afterscroll delta over this duration");
 CONVAR(ui_scrollview_kinetic_energy_multiplier, "ui_scrollview_kinetic_energy_multiplier", 24.0f, CLIENT,
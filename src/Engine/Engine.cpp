@@ -9,6 +9,7 @@
 #include "Console.h"
 #include "ConsoleBox.h"
 #include "DiscordInterface.h"
+#include "FrameArena.h"
 #include "Keyboard.h"
 #include "Mouse.h"
 #include "NetworkHandler.h"
@@ -292,6 +293,9 @@ void Engine::onPaint() {
 void Engine::onUpdate() {
     VPROF_BUDGET("Engine::onUpdate", VPROF_BUDGETGROUP_UPDATE);
 
+    // anything allocated from the frame arena during the last update/draw is gone now
+    frame::arena().reset();
+
     if(this->bBlackout) return;
 
     {
@@ -1,41 +1,230 @@
 // Copyright (c) 2025, WH, All rights reserved.
 #include "FPSLimiter.h"
 #include "Timing.h"
+#include "BenchCheck.h"
 #include "ConVar.h"
+#include "Engine.h"
 #include "types.h"
 
+#include <algorithm>
 #include <cassert>
+#include <random>
 
 namespace FPSLimiter {
 namespace  // static
 {
-u64 next_frame_time{0};
+constexpr u64 MIN_SPIN_NS{50 * Timing::NS_PER_US};
+constexpr u64 MAX_SPIN_NS{4 * Timing::NS_PER_MS};  // no matter how bad the scheduler is, never burn more than this
+constexpr u64 LATENCY_DECAY{64};  // the latency estimate drops by 1/64th of the difference per faster wakeup
+
+FramePacer pacer;
+
+// for busy-wait loops: lets the cpu know we're spinning, which saves power and gives the other hyperthread on the
+// core its execution resources back
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+}  // namespace
+
+void PacingHistogram::add(u64 ns) {
+    this->buckets[std::min<u64>(ns / this->iBucketNS, this->buckets.size() - 1)]++;
+    this->iCount++;
+    this->iMaxNS = std::max(this->iMaxNS, ns);
+}
+
+void PacingHistogram::clear() {
+    std::ranges::fill(this->buckets, 0);
+    this->iCount = 0;
+    this->iMaxNS = 0;
+}
+
+u64 PacingHistogram::getPercentileNS(f64 percentile) const {
+    if(this->iCount == 0) return 0;
+
+    const auto rank = static_cast<u64>(std::clamp(percentile, 0.0, 1.0) * static_cast<f64>(this->iCount - 1));
+    u64 seen = 0;
+    for(size_t i = 0; i < this->buckets.size(); i++) {
+        seen += this->buckets[i];
+        if(seen > rank) return std::min((i + 1) * this->iBucketNS, this->iMaxNS);
+    }
+    return this->iMaxNS;
+}
+
+FramePacer::FramePacer()
+    : frameTimes(10 * Timing::NS_PER_US, 10000),  // up to 100ms
+      oversleep(1 * Timing::NS_PER_US, 10000),    // up to 10ms
+      iSchedulerLatencyNS(1 * Timing::NS_PER_MS) {}
+
+void FramePacer::resetStats() {
+    this->frameTimes.clear();
+    this->oversleep.clear();
+    this->iMissedDeadlines = 0;
+    this->iLastFrameEnd = 0;
+}
+
+u64 FramePacer::getSpinThresholdNS() const {
+    // some headroom over the peak, a single late wakeup costs a whole frame
+    return std::clamp(this->iSchedulerLatencyNS * 3 / 2, MIN_SPIN_NS, MAX_SPIN_NS);
+}
+
+void FramePacer::waitUntil(u64 deadline) {
+    const u64 now = Timing::getTicksNS();
+    if(deadline <= now) return;
+
+    if(!cv::fps_max_adaptive_spin.getBool()) {
+        Timing::sleepNSPrecise(deadline - now);
+        return;
+    }
+
+    const u64 spinThreshold = this->getSpinThresholdNS();
+    if(deadline - now > spinThreshold) {
+        const u64 requested = deadline - now - spinThreshold;
+        Timing::sleepNS(requested);
+
+        const u64 slept = Timing::getTicksNS() - now;
+        const u64 late = slept > requested ? slept - requested : 0;
+        this->oversleep.add(late);
+
+        if(late > this->iSchedulerLatencyNS)
+            this->iSchedulerLatencyNS = late;
+        else
+            this->iSchedulerLatencyNS -= (this->iSchedulerLatencyNS - late) / LATENCY_DECAY;
+    }
+
+    while(Timing::getTicksNS() < deadline) {
+        cpu_relax();
+    }
 }
 
-void limit_frames(int target_fps) {
+void FramePacer::limit(int target_fps) {
     if(target_fps > 0) {
         const u64 frame_time_ns = Timing::NS_PER_SECOND / static_cast<u64>(target_fps);
         const u64 now = Timing::getTicksNS();
 
         // if we're ahead of schedule, sleep until next frame
-        if(next_frame_time > now) {
+        if(this->iNextFrameTime > now) {
             // never sleep more than the current target fps frame time
-            const u64 sleep_time = std::min(next_frame_time - now, frame_time_ns);
-            Timing::sleepNSPrecise(sleep_time);
-        } else if(cv::fps_max_yield.getBool()) {
-            Timing::sleep(0);
-            next_frame_time = Timing::getTicksNS();  // update "now" to reflect the time spent in yield
+            this->waitUntil(now + std::min(this->iNextFrameTime - now, frame_time_ns));
         } else {
-            // behind schedule or exactly on time, reset to now
-            next_frame_time = now;
+            if(this->iNextFrameTime != 0 && now - this->iNextFrameTime > frame_time_ns / 10)
+                this->iMissedDeadlines++;  // more than a tenth of a frame late, not just a rounding error
+
+            if(cv::fps_max_yield.getBool()) {
+                Timing::sleep(0);
+                this->iNextFrameTime = Timing::getTicksNS();  // update "now" to reflect the time spent in yield
+            } else {
+                // behind schedule or exactly on time, reset to now
+                this->iNextFrameTime = now;
+            }
         }
         // set time for next frame
-        next_frame_time += frame_time_ns;
+        this->iNextFrameTime += frame_time_ns;
     } else if(cv::fps_unlimited_yield.getBool()) {
         Timing::sleep(0);
     }
+
+    const u64 frameEnd = Timing::getTicksNS();
+    if(this->iLastFrameEnd != 0) this->frameTimes.add(frameEnd - this->iLastFrameEnd);
+    this->iLastFrameEnd = frameEnd;
+}
+
+void limit_frames(int target_fps) { pacer.limit(target_fps); }
+
+void reset() { pacer.reset(); }
+
+FramePacer &get_pacer() { return pacer; }
+
+void pacing_stats(const UString &args) {
+    if(args == "reset") {
+        pacer.resetStats();
+        Engine::logRaw("fps_pacing_stats: reset\n");
+        return;
+    }
+
+    const auto ms = [](u64 ns) { return static_cast<f64>(ns) / static_cast<f64>(Timing::NS_PER_MS); };
+    const PacingHistogram &frameTimes = pacer.getFrameTimes();
+    const PacingHistogram &oversleep = pacer.getOversleep();
+
+    Engine::logRaw("fps_pacing_stats: {:d} frames, {:d} missed deadlines (\"fps_pacing_stats reset\" to clear)\n",
+                   frameTimes.getCount(), pacer.getMissedDeadlines());
+    Engine::logRaw("    frame time: p50 {:.3f} ms, p99 {:.3f} ms, p99.9 {:.3f} ms, max {:.3f} ms\n",
+                   ms(frameTimes.getPercentileNS(0.5)), ms(frameTimes.getPercentileNS(0.99)),
+                   ms(frameTimes.getPercentileNS(0.999)), ms(frameTimes.getMaxNS()));
+    Engine::logRaw("    oversleep:  p50 {:.3f} ms, p99 {:.3f} ms, p99.9 {:.3f} ms, max {:.3f} ms ({:d} sleeps)\n",
+                   ms(oversleep.getPercentileNS(0.5)), ms(oversleep.getPercentileNS(0.99)),
+                   ms(oversleep.getPercentileNS(0.999)), ms(oversleep.getMaxNS()), oversleep.getCount());
+    Engine::logRaw("    scheduler latency estimate {:.3f} ms, spinning for the last {:.3f} ms of each wait\n",
+                   ms(pacer.getSchedulerLatencyNS()), ms(pacer.getSpinThresholdNS()));
 }
 
-void reset() { next_frame_time = 0; }
+void pacing_bench() {
+    // runs a separate limiter against a synthetic workload (busy frames of varying length, a few of them too long
+    // for the target), once with the platform's precise sleep and once with adaptive spinning, and checks how close
+    // the frame times stay to the target. blocks for about 2 * SECONDS
+    static constexpr int TARGET_FPS = 240;
+    static constexpr f64 SECONDS = 3.0;
+    static constexpr int NUM_FRAMES = static_cast<int>(TARGET_FPS * SECONDS);
+
+    const u64 targetNS = Timing::NS_PER_SECOND / TARGET_FPS;
+    const auto ms = [](u64 ns) { return static_cast<f64>(ns) / static_cast<f64>(Timing::NS_PER_MS); };
+
+    BenchCheck check("fps_pacing_bench");
+
+    const bool configuredAdaptiveSpin = cv::fps_max_adaptive_spin.getBool();
+    for(const bool adaptiveSpin : {false, true}) {
+        cv::fps_max_adaptive_spin.setValue(adaptiveSpin);
+
+        std::mt19937 rng{1337};  // same workload for both runs
+        std::uniform_int_distribution<u64> workNS{targetNS / 8, targetNS * 3 / 4};
+        std::uniform_int_distribution<int> lateFrame{0, 49};
+
+        FramePacer benchPacer;
+        u64 onTarget = 0, numChecked = 0;
+        u64 lastFrame = 0;
+        for(int frame = 0; frame < NUM_FRAMES; frame++) {
+            // 2% of the frames take 1.5 frames, the limiter has to catch up without bunching the next ones
+            const u64 work = lateFrame(rng) == 0 ? targetNS * 3 / 2 : workNS(rng);
+            const u64 workEnd = Timing::getTicksNS() + work;
+            while(Timing::getTicksNS() < workEnd) {
+                // spin
+            }
+
+            benchPacer.limit(TARGET_FPS);
+
+            const u64 now = Timing::getTicksNS();
+            if(lastFrame != 0 && work < targetNS) {
+                const u64 frameTime = now - lastFrame;
+                const u64 error = frameTime > targetNS ? frameTime - targetNS : targetNS - frameTime;
+                if(error <= targetNS / 20) onTarget++;  // within 5%
+                numChecked++;
+            }
+            lastFrame = now;
+        }
+
+        const PacingHistogram &frameTimes = benchPacer.getFrameTimes();
+        const u64 p50 = frameTimes.getPercentileNS(0.5);
+        const u64 p99 = frameTimes.getPercentileNS(0.99);
+
+        Engine::logRaw(
+            "fps_pacing_bench: fps_max_adaptive_spin {:d}: target {:.3f} ms, p50 {:.3f} ms, p99 {:.3f} ms, "
+            "p99.9 {:.3f} ms\n",
+            adaptiveSpin, ms(targetNS), ms(p50), ms(p99), ms(frameTimes.getPercentileNS(0.999)));
+        Engine::logRaw(
+            "    {:.1f}% of normal frames within 5% of the target, {:d} missed deadlines, oversleep p99 {:.3f} ms\n",
+            100.0 * static_cast<f64>(onTarget) / static_cast<f64>(std::max<u64>(numChecked, 1)),
+            benchPacer.getMissedDeadlines(), ms(benchPacer.getOversleep().getPercentileNS(0.99)));
+
+        check.expect(p50 >= targetNS - targetNS / 20 && p50 <= targetNS + targetNS / 20,
+                     "fps_max_adaptive_spin {:d}: median frame time {:.3f} ms, more than 5% off the {:.3f} ms target",
+                     adaptiveSpin, ms(p50), ms(targetNS));
+    }
+
+    cv::fps_max_adaptive_spin.setValue(configuredAdaptiveSpin);
+    check.finish();
+}
 
 }  // namespace FPSLimiter
@@ -1,7 +1,69 @@
 #pragma once
 // Copyright (c) 2025, WH, All rights reserved.
+#include "types.h"
+
+#include <vector>
+
+class UString;
 
 namespace FPSLimiter {
 void limit_frames(int targetFPS);
 void reset();
+
+// fixed-width buckets, everything past the last one is counted in the last one
+class PacingHistogram {
+   public:
+    PacingHistogram(u64 bucketNS, size_t numBuckets) : buckets(numBuckets, 0), iBucketNS(bucketNS) {}
+
+    void add(u64 ns);
+    void clear();
+
+    [[nodiscard]] u64 getPercentileNS(f64 percentile) const;  // upper edge of the bucket, 0 if empty
+    [[nodiscard]] inline u64 getCount() const { return this->iCount; }
+    [[nodiscard]] inline u64 getMaxNS() const { return this->iMaxNS; }
+
+   private:
+    std::vector<u32> buckets;
+    u64 iBucketNS;
+    u64 iCount{0};
+    u64 iMaxNS{0};
+};
+
+// sleeps until the next frame is due. the bulk of the wait is a normal (imprecise) sleep, the last part is spent
+// spinning, and how long that last part is follows the scheduler latency measured on the previous sleeps: a system
+// which oversleeps by 1ms gets ~1.5ms of spinning, one which wakes up on time barely spins at all
+class FramePacer {
+   public:
+    FramePacer();
+
+    void limit(int targetFPS);
+    void reset() { this->iNextFrameTime = 0; }
+    void resetStats();
+
+    [[nodiscard]] inline const PacingHistogram &getFrameTimes() const { return this->frameTimes; }
+    [[nodiscard]] inline const PacingHistogram &getOversleep() const { return this->oversleep; }
+    [[nodiscard]] inline u64 getMissedDeadlines() const { return this->iMissedDeadlines; }
+    [[nodiscard]] inline u64 getSchedulerLatencyNS() const { return this->iSchedulerLatencyNS; }
+    [[nodiscard]] u64 getSpinThresholdNS() const;
+
+   private:
+    void waitUntil(u64 deadline);
+
+    PacingHistogram frameTimes;  // from one limit() to the next, i.e. what the user sees
+    PacingHistogram oversleep;   // how much later than requested the os sleeps returned
+
+    u64 iNextFrameTime{0};
+    u64 iLastFrameEnd{0};
+    u64 iMissedDeadlines{0};
+    u64 iSchedulerLatencyNS;  // peak oversleep, decays slowly
+};
+
+// the one limit_frames() uses (fps_pacing_stats)
+FramePacer &get_pacer();
+
+// fps_pacing_stats [reset]: get_pacer()'s frame time/oversleep histograms
+void pacing_stats(const UString &args);
+
+// fps_pacing_bench: a separate pacer against a synthetic workload, with and without adaptive spinning
+void pacing_bench();
 };  // namespace FPSLimiter
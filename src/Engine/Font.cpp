@@ -15,8 +15,11 @@
 #include <ft2build.h>
 
 #include <algorithm>
+#include <array>
+#include <span>
 #include <utility>
 
+#include "BenchCheck.h"
 #include "ConVar.h"
 #include "Engine.h"
 #include "File.h"
@@ -84,6 +87,7 @@ void McFont::constructor(const std::vector<wchar_t> &characters, int fontSize, b
     m_dynamicRegionY = 0;
     m_slotsPerRow = 0;
     m_currentTime = 0;
+    m_geometryGeneration = 1;
     m_atlasNeedsReload = false;
 
     // setup error glyph
@@ -131,6 +135,7 @@ void McFont::init() {
         m_fHeight = std::max(m_fHeight, static_cast<float>(curHeight));
     }
 
+    m_geometryGeneration++;
     this->bReady = true;
 }
 
@@ -149,9 +154,14 @@ void McFont::destroy() {
     }
 
     m_vGlyphMetrics.clear();
+    for(auto &page : m_metricsPages) {
+        page.reset();
+    }
+    m_runCache.fill({});
     m_dynamicSlots.clear();
     m_dynamicSlotMap.clear();
     m_fHeight = 1.0f;
+    m_geometryGeneration++;
     m_atlasNeedsReload = false;
 }
 
@@ -165,6 +175,7 @@ bool McFont::addGlyph(wchar_t ch) {
 
 int McFont::allocateDynamicSlot(wchar_t ch) {
     m_currentTime++;
+    m_geometryGeneration++;  // an eviction changes the metrics of whatever was in the slot before
 
     // look for free slot
     for(size_t i = 0; i < m_dynamicSlots.size(); i++) {
@@ -202,6 +213,7 @@ int McFont::allocateDynamicSlot(wchar_t ch) {
                               false, true, clearData.get());
 
         // remove evicted character from metrics and existence map
+        setCachedGlyphMetrics(m_dynamicSlots[lruIndex].character, nullptr);
         m_vGlyphMetrics.erase(m_dynamicSlots[lruIndex].character);
         m_vGlyphExistence.erase(m_dynamicSlots[lruIndex].character);
     }
@@ -214,12 +226,14 @@ int McFont::allocateDynamicSlot(wchar_t ch) {
     return lruIndex;
 }
 
-void McFont::markSlotUsed(wchar_t ch) {
+bool McFont::markSlotUsed(wchar_t ch) {
     auto it = m_dynamicSlotMap.find(ch);
     if(it != m_dynamicSlotMap.end()) {
         m_currentTime++;
         m_dynamicSlots[it->second].lastUsed = m_currentTime;
+        return true;
     }
+    return false;
 }
 
 void McFont::initializeDynamicRegion(int atlasSize) {
@@ -653,20 +667,24 @@ void McFont::buildGlyphGeometry(const GLYPH_METRICS &gm, const vec3 &basePos, fl
     vertexCount += VERTS_PER_VAO;
 }
 
-void McFont::buildStringGeometry(const UString &text, size_t &vertexCount) {
-    if(!this->bReady || text.length() == 0 || text.length() > cv::r_drawstring_max_string_length.getInt()) return;
+template <typename Codepoints>
+bool McFont::buildStringGeometry(const Codepoints &codepoints, int length, size_t &vertexCount) {
+    if(!this->bReady || length == 0 || length > cv::r_drawstring_max_string_length.getInt()) return false;
 
     float advanceX = 0.0f;
-    const size_t maxGlyphs =
-        std::min(text.length(), (int)((double)(m_vertices.size() - vertexCount) / (double)VERTS_PER_VAO));
+    bool usedDynamicGlyphs = false;
+    const size_t maxGlyphs = std::min(length, (int)((double)(m_vertices.size() - vertexCount) / (double)VERTS_PER_VAO));
+
+    size_t i = 0;
+    for(const wchar_t ch : codepoints) {
+        if(i++ >= maxGlyphs) break;
 
-    for(int i = 0; i < maxGlyphs; i++) {
-        const GLYPH_METRICS &gm = getGlyphMetrics(text[i]);
+        const GLYPH_METRICS &gm = getGlyphMetrics(ch);
         buildGlyphGeometry(gm, vec3(), advanceX, vertexCount);
         advanceX += gm.advance_x;
 
         // mark dynamic slot as recently used (if this character is in a dynamic slot)
-        markSlotUsed(text[i]);
+        usedDynamicGlyphs |= markSlotUsed(ch);
     }
 
     // reload atlas if new glyphs were added to dynamic slots
@@ -674,23 +692,26 @@ void McFont::buildStringGeometry(const UString &text, size_t &vertexCount) {
         m_textureAtlas->getAtlasImage()->reload();
         m_atlasNeedsReload = false;
     }
+
+    return usedDynamicGlyphs;
 }
 
-void McFont::drawString(const UString &text) {
+template <typename Codepoints>
+void McFont::drawCodepoints(const Codepoints &codepoints, int length) {
     if(!this->bReady) return;
 
     const int maxNumGlyphs = cv::r_drawstring_max_string_length.getInt();
-    if(text.length() == 0 || text.length() > maxNumGlyphs) return;
+    if(length == 0 || length > maxNumGlyphs) return;
 
     m_vao.empty();
 
-    const size_t totalVerts = text.length() * VERTS_PER_VAO;
+    const size_t totalVerts = length * VERTS_PER_VAO;
     m_vao.reserve(totalVerts);
     m_vertices.resize(totalVerts);
     m_texcoords.resize(totalVerts);
 
     size_t vertexCount = 0;
-    buildStringGeometry(text, vertexCount);
+    buildStringGeometry(codepoints, length, vertexCount);
 
     for(size_t i = 0; i < vertexCount; i++) {
         m_vao.addVertex(m_vertices[i]);
@@ -703,6 +724,11 @@ void McFont::drawString(const UString &text) {
     if(cv::r_debug_drawstring_unbind.getBool()) m_textureAtlas->getAtlasImage()->unbind();
 }
 
+void McFont::drawString(const UString &text) { this->drawCodepoints(text.unicodeView(), text.length()); }
+
+// no wide copy, the codepoints are decoded straight from the UTF-8 while building the geometry
+void McFont::drawString(const Utf8String &text) { this->drawCodepoints(text.codepoints(), text.length()); }
+
 void McFont::beginBatch() {
     m_batchActive = true;
     m_batchQueue.totalVerts = 0;
@@ -715,14 +741,17 @@ void McFont::addToBatch(const UString &text, const vec3 &pos, Color color) {
     m_batchQueue.totalVerts += verts;
 
     if(m_batchQueue.usedEntries < m_batchQueue.entryList.size()) {
-        // reuse existing entry
+        // reuse existing entry (and its geometry, if the text is the same as last time)
         BatchEntry &entry = m_batchQueue.entryList[m_batchQueue.usedEntries];
-        entry.text = text;
+        if(entry.text != text) {
+            entry.text = text;
+            entry.geometryGeneration = 0;
+        }
         entry.pos = pos;
         entry.color = color;
     } else {
         // need to add new entry
-        m_batchQueue.entryList.push_back({text, pos, color});
+        m_batchQueue.entryList.push_back({.text = text, .pos = pos, .color = color});
     }
     m_batchQueue.usedEntries++;
 }
@@ -733,21 +762,31 @@ void McFont::flushBatch() {
         return;
     }
 
-    m_vertices.resize(m_batchQueue.totalVerts);
-    m_texcoords.resize(m_batchQueue.totalVerts);
     m_vao.empty();
     m_vao.reserve(m_batchQueue.totalVerts);
 
-    size_t currentVertex = 0;
     for(size_t i = 0; i < m_batchQueue.usedEntries; i++) {
-        const auto &entry = m_batchQueue.entryList[i];
-        const size_t stringStart = currentVertex;
-        buildStringGeometry(entry.text, currentVertex);
-
-        for(size_t j = stringStart; j < currentVertex; j++) {
-            m_vertices[j] += entry.pos;
-            m_vao.addVertex(m_vertices[j]);
-            m_vao.addTexcoord(m_texcoords[j]);
+        auto &entry = m_batchQueue.entryList[i];
+
+        if(entry.geometryGeneration != m_geometryGeneration) {
+            const size_t maxVerts = entry.text.length() * VERTS_PER_VAO;
+            m_vertices.resize(maxVerts);
+            m_texcoords.resize(maxVerts);
+
+            size_t vertexCount = 0;
+            entry.hasDynamicGlyphs = buildStringGeometry(entry.text.unicodeView(), entry.text.length(), vertexCount);
+            entry.vertices.assign(m_vertices.begin(), m_vertices.begin() + static_cast<ptrdiff_t>(vertexCount));
+            entry.texcoords.assign(m_texcoords.begin(), m_texcoords.begin() + static_cast<ptrdiff_t>(vertexCount));
+            entry.geometryGeneration = this->bReady ? m_geometryGeneration : 0;
+        } else if(entry.hasDynamicGlyphs) {
+            for(int j = 0; j < entry.text.length(); j++) {
+                markSlotUsed(entry.text[j]);
+            }
+        }
+
+        for(size_t j = 0; j < entry.vertices.size(); j++) {
+            m_vao.addVertex(entry.vertices[j] + entry.pos);
+            m_vao.addTexcoord(entry.texcoords[j]);
             m_vao.addColor(entry.color);
         }
     }
@@ -761,100 +800,197 @@ void McFont::flushBatch() {
     m_batchActive = false;
 }
 
-float McFont::getStringWidth(const UString &text) const {
-    if(!this->bReady) return 1.0f;
+template <typename Codepoints>
+const McFont::MeasuredRun &McFont::measureRun(const Codepoints &codepoints, size_t hash, int length) const {
+    MeasuredRun *run = &m_uncachedRun;
+    MeasuredRun key{.hash = hash, .check = 0xcbf29ce484222325ULL, .length = length, .first = 0, .last = 0};
+    if(cv::font_run_cache.getBool()) {
+        // verify hits with more than just the hash, a collision would silently return the size of some other string.
+        // this only costs a pass over the codepoints, without any glyph lookups
+        bool isFirst = true;
+        for(const wchar_t ch : codepoints) {
+            key.check = (key.check ^ static_cast<uint32_t>(ch)) * 0x100000001b3ULL;
+            if(isFirst) key.first = ch;
+            key.last = ch;
+            isFirst = false;
+        }
+
+        MeasuredRun *set = &m_runCache[(hash % RUN_CACHE_SETS) * RUN_CACHE_WAYS];
+        m_runCacheTime++;
+
+        MeasuredRun *lru = set;
+        for(size_t i = 0; i < RUN_CACHE_WAYS; i++) {
+            if(set[i].lastUsed != 0 && set[i].hash == key.hash && set[i].check == key.check &&
+               set[i].length == key.length && set[i].first == key.first && set[i].last == key.last) {
+                set[i].lastUsed = m_runCacheTime;
+                return set[i];
+            }
+            if(set[i].lastUsed < lru->lastUsed) lru = &set[i];
+        }
+        run = lru;
+    }
 
     float width = 0.0f;
-    for(int i = 0; i < text.length(); i++) {
-        width += getGlyphMetrics(text[i]).advance_x;
+    float height = 0.0f;
+    for(const wchar_t ch : codepoints) {
+        const GLYPH_METRICS &gm = getGlyphMetrics(ch);
+        width += gm.advance_x;
+        height = std::max(height, static_cast<float>(gm.top));
     }
-    return width;
+
+    key.width = width;
+    key.height = height;
+    key.lastUsed = m_runCacheTime;
+    *run = key;
+    return *run;
+}
+
+float McFont::getStringWidth(const UString &text) const {
+    if(!this->bReady) return 1.0f;
+    if(text.length() == 0) return 0.0f;
+
+    const std::wstring_view chars = text.unicodeView();
+    return measureRun(chars, std::hash<std::wstring_view>{}(chars), text.length()).width;
 }
 
 float McFont::getStringHeight(const UString &text) const {
     if(!this->bReady) return 1.0f;
+    if(text.length() == 0) return 0.0f;
 
-    float height = 0.0f;
-    for(int i = 0; i < text.length(); i++) {
-        height = std::max(height, static_cast<float>(getGlyphMetrics(text[i]).top));
-    }
-    return height;
+    const std::wstring_view chars = text.unicodeView();
+    return measureRun(chars, std::hash<std::wstring_view>{}(chars), text.length()).height;
+}
+
+float McFont::getStringWidth(const Utf8String &text) const {
+    if(!this->bReady) return 1.0f;
+    if(text.length() == 0) return 0.0f;
+
+    return measureRun(text.codepoints(), std::hash<Utf8String>{}(text), text.length()).width;
+}
+
+float McFont::getStringHeight(const Utf8String &text) const {
+    if(!this->bReady) return 1.0f;
+    if(text.length() == 0) return 0.0f;
+
+    return measureRun(text.codepoints(), std::hash<Utf8String>{}(text), text.length()).height;
 }
 
 std::vector<UString> McFont::wrap(const UString &text, f64 max_width) const {
     std::vector<UString> lines;
     lines.emplace_back();
 
-    UString word = "";
-    u32 line = 0;
+    const std::wstring_view chars = text.unicodeView();
+    const auto charWidth = [this](wchar_t ch) -> f64 { return getGlyphMetrics(ch).advance_x; };
+
     f64 line_width = 0.0;
-    f64 word_width = 0.0;
-    for(int i = 0; i < text.length(); i++) {
-        if(text[i] == '\n') {
-            lines[line].append(word);
+    size_t i = 0;
+    while(i < chars.length()) {
+        if(chars[i] == L'\n') {
             lines.emplace_back();
-            line++;
             line_width = 0.0;
-            word = "";
-            word_width = 0.0;
+            i++;
             continue;
         }
 
-        f32 char_width = getGlyphMetrics(text[i]).advance_x;
-
-        if(text[i] == ' ') {
-            lines[line].append(word);
-            line_width += word_width;
-            word = "";
-            word_width = 0.0;
-
-            if(line_width + char_width > max_width) {
+        if(chars[i] == L' ') {
+            const f64 space_width = charWidth(L' ');
+            if(line_width + space_width > max_width) {
                 // Ignore spaces at the end of a line
                 lines.emplace_back();
-                line++;
                 line_width = 0.0;
             } else if(line_width > 0.0) {
-                lines[line].append(' ');
-                line_width += char_width;
+                lines.back().append(L' ');
+                line_width += space_width;
             }
-        } else {
-            if(word_width + char_width > max_width) {
+            i++;
+            continue;
+        }
+
+        // measure the whole word first, most of them can be placed without looking at single characters again
+        size_t word_end = chars.find_first_of(L" \n", i);
+        if(word_end == std::wstring_view::npos) word_end = chars.length();
+
+        f64 word_width = 0.0;
+        for(size_t j = i; j < word_end; j++) {
+            word_width += charWidth(chars[j]);
+        }
+
+        if(word_width <= max_width) {
+            // Wrap word on new line
+            if(line_width + word_width > max_width) {
+                lines.emplace_back();
+                line_width = 0.0;
+            }
+            lines.back().append(UString(chars.data() + i, static_cast<int>(word_end - i)));
+            line_width += word_width;
+            i = word_end;
+            continue;
+        }
+
+        // too long for a single line, split it up
+        size_t piece_start = i;
+        f64 piece_width = 0.0;
+        for(; i < word_end; i++) {
+            const f64 char_width = charWidth(chars[i]);
+            if(i > piece_start && piece_width + char_width > max_width) {
                 // Split word onto new line
-                lines[line].append(word);
+                lines.back().append(UString(chars.data() + piece_start, static_cast<int>(i - piece_start)));
                 lines.emplace_back();
-                line++;
                 line_width = 0.0;
-                word = "";
-                word_width = 0.0;
-            } else if(line_width + word_width + char_width > max_width) {
+                piece_start = i;
+                piece_width = 0.0;
+            } else if(line_width + piece_width + char_width > max_width) {
                 // Wrap word on new line
                 lines.emplace_back();
-                line++;
                 line_width = 0.0;
-                word.append(text[i]);
-                word_width += char_width;
-            } else {
-                // Add character to word
-                word.append(text[i]);
-                word_width += char_width;
             }
+            piece_width += char_width;
         }
+        lines.back().append(UString(chars.data() + piece_start, static_cast<int>(word_end - piece_start)));
+        line_width += piece_width;
     }
 
-    // Don't forget! ;)
-    lines[line].append(word);
-
     return lines;
 }
 
 const McFont::GLYPH_METRICS &McFont::getGlyphMetrics(wchar_t ch) const {
+    const auto index = static_cast<uint32_t>(ch);
+    if(index < NUM_METRICS_PAGES * METRICS_PAGE_SIZE) {
+        const auto &page = m_metricsPages[index / METRICS_PAGE_SIZE];
+        if(page != nullptr) {
+            if(const GLYPH_METRICS *metrics = (*page)[index % METRICS_PAGE_SIZE]; metrics != nullptr) return *metrics;
+        }
+    }
+    return lookupGlyphMetrics(ch);
+}
+
+void McFont::setCachedGlyphMetrics(wchar_t ch, const GLYPH_METRICS *metrics) const {
+    const auto index = static_cast<uint32_t>(ch);
+    if(index >= NUM_METRICS_PAGES * METRICS_PAGE_SIZE) return;
+
+    auto &page = m_metricsPages[index / METRICS_PAGE_SIZE];
+    if(page == nullptr) {
+        if(metrics == nullptr) return;
+        page = std::make_unique<MetricsPage>();
+    }
+    (*page)[index % METRICS_PAGE_SIZE] = metrics;
+}
+
+const McFont::GLYPH_METRICS &McFont::lookupGlyphMetrics(wchar_t ch) const {
     auto it = m_vGlyphMetrics.find(ch);
-    if(it != m_vGlyphMetrics.end()) return it->second;
+    if(it != m_vGlyphMetrics.end()) {
+        // map nodes never move, so this stays valid until the glyph is evicted (or the font destroyed)
+        setCachedGlyphMetrics(ch, &it->second);
+        return it->second;
+    }
 
     // attempt dynamic loading for unicode characters
     if(const_cast<McFont *>(this)->loadGlyphDynamic(ch)) {
         it = m_vGlyphMetrics.find(ch);
-        if(it != m_vGlyphMetrics.end()) return it->second;
+        if(it != m_vGlyphMetrics.end()) {
+            setCachedGlyphMetrics(ch, &it->second);
+            return it->second;
+        }
     }
 
     // fallback to unknown character glyph
@@ -975,3 +1111,169 @@ void McFont::cleanupSharedResources() {
         s_sharedFtLibraryInitialized = false;
     }
 }
+
+void McFont::bench() {
+    static constexpr int NUM_ITERATIONS = 2000;
+
+    McFont *font = resourceManager->getFont("FONT_DEFAULT");
+    if(font == nullptr || !font->isReady()) return;
+
+    const std::array<UString, 5> chat{
+        "hey does anyone know how to get the new skin working? the cursor trail looks really weird for me",
+        "gl on the map! that last stream is actually insane lmao",
+        "!mp settings",
+        "ありがとう、またね～ see you tomorrow",
+        "https://osu.ppy.sh/beatmapsets/39804#osu/129891\nhttps://osu.ppy.sh/community/forums/topics/1234567",
+    };
+    const std::array<UString, 4> titles{
+        "xi - FREEDOM DiVE [FOUR DIMENSIONS]",
+        "Camellia - 光線チューニング ~なずな妄想海フォーミュラ~ [Ascension to Heaven]",
+        "DragonForce - Through the Fire and Flames [Legend]",
+        "ヒトリエ - ワールズエンド・ダンスホール [Extra]",
+    };
+
+    // what every measurement used to do: a hash map lookup (lookupGlyphMetrics()) per character
+    const auto referenceWidth = [font](const UString &str) {
+        float width = 0.0f;
+        for(const wchar_t ch : str.unicodeView()) width += font->lookupGlyphMetrics(ch).advance_x;
+        return width;
+    };
+    const auto referenceHeight = [font](const UString &str) {
+        float height = 0.0f;
+        for(const wchar_t ch : str.unicodeView()) {
+            height = std::max(height, static_cast<float>(font->lookupGlyphMetrics(ch).top));
+        }
+        return height;
+    };
+
+    // the previous, per-character wrap(), except that it doesn't drop the character at which a word gets split anymore
+    // (which wrap() fixed)
+    const auto referenceWrap = [font](const UString &text, f64 max_width) {
+        std::vector<UString> lines;
+        lines.emplace_back();
+
+        UString word = "";
+        u32 line = 0;
+        f64 line_width = 0.0;
+        f64 word_width = 0.0;
+        for(int i = 0; i < text.length(); i++) {
+            if(text[i] == '\n') {
+                lines[line].append(word);
+                lines.emplace_back();
+                line++;
+                line_width = 0.0;
+                word = "";
+                word_width = 0.0;
+                continue;
+            }
+
+            f32 char_width = font->lookupGlyphMetrics(text[i]).advance_x;
+
+            if(text[i] == ' ') {
+                lines[line].append(word);
+                line_width += word_width;
+                word = "";
+                word_width = 0.0;
+
+                if(line_width + char_width > max_width) {
+                    // Ignore spaces at the end of a line
+                    lines.emplace_back();
+                    line++;
+                    line_width = 0.0;
+                } else if(line_width > 0.0) {
+                    lines[line].append(' ');
+                    line_width += char_width;
+                }
+            } else {
+                if(word_width + char_width > max_width) {
+                    // Split word onto new line
+                    lines[line].append(word);
+                    lines.emplace_back();
+                    line++;
+                    line_width = 0.0;
+                    word = "";
+                    word.append(text[i]);
+                    word_width = char_width;
+                } else if(line_width + word_width + char_width > max_width) {
+                    // Wrap word on new line
+                    lines.emplace_back();
+                    line++;
+                    line_width = 0.0;
+                    word.append(text[i]);
+                    word_width += char_width;
+                } else {
+                    // Add character to word
+                    word.append(text[i]);
+                    word_width += char_width;
+                }
+            }
+        }
+
+        // Don't forget! ;)
+        lines[line].append(word);
+
+        return lines;
+    };
+
+    const auto time = [](const auto &func) -> double {
+        const u64 startTime = Timing::getTicksNS();
+        for(int i = 0; i < NUM_ITERATIONS; i++) func();
+        return static_cast<double>(Timing::getTicksNS() - startTime) / NUM_ITERATIONS;
+    };
+
+    const bool wasRunCacheEnabled = cv::font_run_cache.getBool();
+    BenchCheck check("font_bench");
+    float checksum = 0.0f;  // so nothing can be optimized out
+
+    for(const auto &[name, workload] : {std::pair{"chat", std::span<const UString>(chat)},
+                                        std::pair{"song titles", std::span<const UString>(titles)}}) {
+        // the table and the run cache (cold, then hot) have to measure exactly what the map lookups did
+        for(const bool runCache : {false, true, true}) {
+            cv::font_run_cache.setValue(runCache);
+            const char *path = runCache ? "run cache" : "table";
+            for(const UString &str : workload) {
+                check.expectEqual(font->getStringWidth(str), referenceWidth(str),
+                                  fmt::format("width of \"{:s}\" ({:s})", str, path));
+                check.expectEqual(font->getStringHeight(str), referenceHeight(str),
+                                  fmt::format("height of \"{:s}\" ({:s})", str, path));
+            }
+        }
+
+        for(const f64 maxWidth : {200.0, 50.0}) {
+            for(const UString &str : workload) {
+                check.expectEqualElements(font->wrap(str, maxWidth), referenceWrap(str, maxWidth),
+                                          fmt::format("wrap(\"{:s}\", {:g})", str, maxWidth));
+            }
+        }
+
+        const double mapNS = time([&] {
+            for(const UString &str : workload) checksum += referenceWidth(str);
+        });
+
+        cv::font_run_cache.setValue(false);
+        const double tableNS = time([&] {
+            for(const UString &str : workload) checksum += font->getStringWidth(str);
+        });
+
+        cv::font_run_cache.setValue(true);
+        const double cachedNS = time([&] {
+            for(const UString &str : workload) checksum += font->getStringWidth(str);
+        });
+
+        const double referenceWrapNS = time([&] {
+            for(const UString &str : workload) checksum += static_cast<float>(referenceWrap(str, 200.0).size());
+        });
+        const double wrapNS = time([&] {
+            for(const UString &str : workload) checksum += static_cast<float>(font->wrap(str, 200.0).size());
+        });
+
+        Engine::logRaw("font_bench: {:s} ({:d} strings), per iteration:\n", name, workload.size());
+        Engine::logRaw("    getStringWidth: {:.0f} ns (map), {:.0f} ns (table), {:.0f} ns (run cache)\n", mapNS,
+                       tableNS, cachedNS);
+        Engine::logRaw("    wrap: {:.0f} ns (per character), {:.0f} ns (per word)\n", referenceWrapNS, wrapNS);
+    }
+
+    cv::font_run_cache.setValue(wasRunCacheEnabled);
+    Engine::logRaw("font_bench: done ({:g})\n", checksum);
+    check.finish();
+}
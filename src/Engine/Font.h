@@ -11,8 +11,10 @@
 
 #include "Resource.h"
 #include "UString.h"
+#include "Utf8String.h"
 #include "VertexArrayObject.h"
 
+#include <array>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -40,7 +42,11 @@ class McFont final : public Resource {
     // called on engine shutdown to clean up freetype/shared fallback fonts
     static void cleanupSharedResources();
 
+    // font_bench: string measuring (per-character map lookups vs. the metrics table vs. the run cache) on FONT_DEFAULT
+    static void bench();
+
     void drawString(const UString &text);
+    void drawString(const Utf8String &text);
     void beginBatch();
     void addToBatch(const UString &text, const vec3 &pos, Color color = 0xffffffff);
     void flushBatch();
@@ -55,6 +61,8 @@ class McFont final : public Resource {
 
     float getStringWidth(const UString &text) const;
     float getStringHeight(const UString &text) const;
+    float getStringWidth(const Utf8String &text) const;
+    float getStringHeight(const Utf8String &text) const;
     std::vector<UString> wrap(const UString &text, f64 max_width) const;
 
    public:
@@ -92,6 +100,28 @@ class McFont final : public Resource {
         UString text;
         vec3 pos{0.f};
         Color color;
+
+        // retained geometry of text (relative to pos), only rebuilt if the text changes or glyphs move in the atlas.
+        // entries are reused in the order they're added, so e.g. HUD text which is redrawn every frame doesn't need
+        // to be laid out again until it actually changes
+        std::vector<vec3> vertices;
+        std::vector<vec2> texcoords;
+        uint64_t geometryGeneration{0};  // 0 = needs rebuild
+        bool hasDynamicGlyphs{false};    // keep their atlas slots alive while the geometry is reused
+    };
+
+    // width/height of a measured string, keyed by its hash. the metrics of a glyph never change for the lifetime of
+    // the font (evicted dynamic glyphs come back the same), so entries only have to be dropped in destroy()
+    // a cached entry only counts as a hit if all of hash, length, check and the first/last codepoints match
+    struct MeasuredRun {
+        size_t hash;
+        uint64_t check;  // second, independent hash (FNV-1a over the codepoints)
+        int length;
+        wchar_t first;
+        wchar_t last;
+        float width;
+        float height;
+        uint64_t lastUsed;  // 0 = empty
     };
 
     struct TextBatch {
@@ -118,13 +148,25 @@ class McFont final : public Resource {
     // size of each dynamic slot
     static constexpr int DYNAMIC_SLOT_SIZE{64};
 
+    // direct-indexed glyph metrics lookup for the BMP, in pages of 256 characters which are only allocated once a
+    // character in them is looked up (a font which only ever draws ascii text needs a single page)
+    static constexpr size_t METRICS_PAGE_SIZE{256};
+    static constexpr size_t NUM_METRICS_PAGES{0x10000 / METRICS_PAGE_SIZE};
+    using MetricsPage = std::array<const GLYPH_METRICS *, METRICS_PAGE_SIZE>;
+
+    // small set-associative LRU cache of measured strings
+    static constexpr size_t RUN_CACHE_SETS{64};
+    static constexpr size_t RUN_CACHE_WAYS{4};
+
     forceinline bool hasGlyph(wchar_t ch) const { return m_vGlyphMetrics.find(ch) != m_vGlyphMetrics.end(); };
+    const GLYPH_METRICS &lookupGlyphMetrics(wchar_t ch) const;
+    void setCachedGlyphMetrics(wchar_t ch, const GLYPH_METRICS *metrics) const;
     bool addGlyph(wchar_t ch);
     bool loadGlyphDynamic(wchar_t ch);
 
     // atlas management methods
     int allocateDynamicSlot(wchar_t ch);
-    void markSlotUsed(wchar_t ch);
+    bool markSlotUsed(wchar_t ch);
     void initializeDynamicRegion(int atlasSize);
 
     // consolidated glyph processing methods
@@ -139,7 +181,14 @@ class McFont final : public Resource {
     bool loadGlyphFromFace(wchar_t ch, FT_Face face, int fontIndex);
 
     void buildGlyphGeometry(const GLYPH_METRICS &gm, const vec3 &basePos, float advanceX, size_t &vertexCount);
-    void buildStringGeometry(const UString &text, size_t &vertexCount);
+
+    // shared by the UString/Utf8String overloads, codepoints is any range of wchar_t with length elements
+    template <typename Codepoints>
+    bool buildStringGeometry(const Codepoints &codepoints, int length, size_t &vertexCount);
+    template <typename Codepoints>
+    void drawCodepoints(const Codepoints &codepoints, int length);
+    template <typename Codepoints>
+    const MeasuredRun &measureRun(const Codepoints &codepoints, size_t hash, int length) const;
 
     static std::unique_ptr<Channel[]> unpackMonoBitmap(const FT_Bitmap &bitmap);
 
@@ -163,6 +212,10 @@ class McFont final : public Resource {
     std::vector<wchar_t> m_vGlyphs;
     std::unordered_map<wchar_t, bool> m_vGlyphExistence;
     std::unordered_map<wchar_t, GLYPH_METRICS> m_vGlyphMetrics;
+    mutable std::array<std::unique_ptr<MetricsPage>, NUM_METRICS_PAGES> m_metricsPages;  // points into m_vGlyphMetrics
+    mutable std::array<MeasuredRun, RUN_CACHE_SETS * RUN_CACHE_WAYS> m_runCache{};
+    mutable MeasuredRun m_uncachedRun{};
+    mutable uint64_t m_runCacheTime{0};
 
     VertexArrayObject m_vao;
     TextBatch m_batchQueue;
@@ -186,6 +239,7 @@ class McFont final : public Resource {
     std::vector<DynamicSlot> m_dynamicSlots;
     std::unordered_map<wchar_t, int> m_dynamicSlotMap;  // character -> slot index for O(1) lookup
     uint64_t m_currentTime;                             // for LRU tracking
+    uint64_t m_geometryGeneration;                      // bumped whenever cached glyph geometry may be stale
     bool m_atlasNeedsReload;                            // flag to batch atlas reloads
 
     bool m_batchActive;
@@ -0,0 +1,102 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef NEOSU_COUNT_ALLOCATIONS
+
+namespace {  // static namespace
+std::atomic<u64> s_numGlobalAllocations{0};
+}  // namespace
+
+// the array/nothrow variants forward to these
+void *operator new(size_t size) {
+    s_numGlobalAllocations.fetch_add(1, std::memory_order_relaxed);
+    if(size == 0) size = 1;
+    while(true) {
+        if(void *ptr = std::malloc(size)) return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+        if(handler == nullptr) std::abort();  // built without exceptions, nothing to throw
+        handler();
+    }
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t /*size*/) noexcept { std::free(ptr); }
+
+u64 FrameArena::getNumGlobalAllocations() { return s_numGlobalAllocations.load(std::memory_order_relaxed); }
+
+#else
+
+u64 FrameArena::getNumGlobalAllocations() { return 0; }
+
+#endif
+
+void FrameArena::reset() {
+    if(this->blocks.size() > 1) {
+        size_t totalSize = 0;
+        for(const auto &block : this->blocks) {
+            totalSize += block.size;
+        }
+        this->blocks.clear();
+        this->addBlock(std::min(totalSize, MAX_RETAINED_SIZE));
+    }
+    this->iBlockPos = 0;
+
+    this->iLastFrameBytesAllocated = this->iBytesAllocated;
+    this->iBytesAllocated = 0;
+
+    const u64 numGlobalAllocations = FrameArena::getNumGlobalAllocations();
+    this->iLastFrameGlobalAllocations = numGlobalAllocations - this->iLastResetGlobalAllocations;
+    this->iLastResetGlobalAllocations = numGlobalAllocations;
+}
+
+size_t FrameArena::getBytesReserved() const {
+    size_t size = 0;
+    for(const auto &block : this->blocks) {
+        size += block.size;
+    }
+    return size;
+}
+
+void FrameArena::addBlock(size_t size) {
+    // not make_unique(), no need to zero it
+    this->blocks.push_back(Block{.data = std::unique_ptr<std::byte[]>(new std::byte[size]), .size = size});
+    this->iBlockPos = 0;
+}
+
+void *FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    if(this->blocks.empty() || this->blocks.back().size - this->iBlockPos < bytes + alignment) {
+        const size_t lastSize = this->blocks.empty() ? 0 : this->blocks.back().size;
+        this->addBlock(std::max({MIN_BLOCK_SIZE, lastSize * 2, bytes + alignment}));
+    }
+
+    Block &block = this->blocks.back();
+    void *ptr = block.data.get() + this->iBlockPos;
+    size_t space = block.size - this->iBlockPos;
+    std::align(alignment, bytes, ptr, space);  // can't fail, there's always room for the padding
+
+    const size_t newPos = block.size - space + bytes;
+    this->iBytesAllocated += newPos - this->iBlockPos;
+    this->iBlockPos = newPos;
+    return ptr;
+}
+
+void FrameArena::do_deallocate(void *p, size_t bytes, size_t /*alignment*/) {
+    // everything is freed at once in reset(), except for the last allocation which can be given back right away
+    // (e.g. a temporary string that is destroyed before anything else was allocated)
+    if(this->blocks.empty()) return;
+
+    std::byte *top = this->blocks.back().data.get() + this->iBlockPos;
+    if(static_cast<std::byte *>(p) + bytes == top) this->iBlockPos -= bytes;
+}
+
+namespace frame {
+FrameArena &arena() {
+    static FrameArena arena;
+    return arena;
+}
+}  // namespace frame
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "noinclude.h"
+#include "types.h"
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// count global operator new calls, for spotting per-frame allocations in the VisualProfiler
+// (debug builds only, and not if mimalloc is linked in, which replaces operator new/delete itself)
+#if defined(_DEBUG) && !defined(NEOSU_USE_MIMALLOC)
+#define NEOSU_COUNT_ALLOCATIONS
+#endif
+
+// bump allocator for memory which only has to live until the end of the current frame (scratch geometry, digit
+// buffers, ...). the engine resets it at the start of every frame, so nothing allocated from it may be kept around
+// longer than that. main thread only
+class FrameArena final : public std::pmr::memory_resource {
+    NOCOPY_NOMOVE(FrameArena)
+   public:
+    FrameArena() = default;
+    ~FrameArena() override = default;
+
+    // frees everything allocated since the last reset. if that didn't fit into a single block, the blocks are
+    // replaced with one big enough for all of it, so that the steady state doesn't allocate at all
+    void reset();
+
+    // stats for the previous frame
+    [[nodiscard]] inline size_t getLastFrameBytesAllocated() const { return this->iLastFrameBytesAllocated; }
+    [[nodiscard]] inline u64 getLastFrameGlobalAllocations() const { return this->iLastFrameGlobalAllocations; }
+    [[nodiscard]] size_t getBytesReserved() const;
+
+    // total number of global operator new calls (on any thread) so far, 0 if NEOSU_COUNT_ALLOCATIONS isn't defined
+    static u64 getNumGlobalAllocations();
+
+   private:
+    static constexpr const size_t MIN_BLOCK_SIZE{64ULL * 1024};
+    static constexpr const size_t MAX_RETAINED_SIZE{16ULL * 1024 * 1024};  // don't hold on to a one-off spike forever
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    void addBlock(size_t size);
+
+    std::vector<Block> blocks;  // the last one is the one being filled
+    size_t iBlockPos{0};
+
+    size_t iBytesAllocated{0};
+    size_t iLastFrameBytesAllocated{0};
+    u64 iLastResetGlobalAllocations{0};
+    u64 iLastFrameGlobalAllocations{0};
+};
+
+// containers for per-frame scratch data, e.g.
+//     frame::vector<vec2> points{frame::resource()};
+namespace frame {
+template <typename T>
+using vector = std::pmr::vector<T>;
+
+FrameArena &arena();
+inline std::pmr::memory_resource *resource() { return &arena(); }
+}  // namespace frame
@@ -14,14 +14,19 @@
 #include <csetjmp>
 #include <cstddef>
 #include <cstring>
+#include <filesystem>
 #include <mutex>
 #include <utility>
 
+#include "ConVar.h"
 #include "Engine.h"
 #include "Environment.h"
 #include "File.h"
+#include "crypto.h"
 
 namespace {
+constexpr const char *THUMBNAIL_CACHE_DIR = MCENGINE_DATA_DIR "cache/thumbnails/";
+
 #if defined(ZLIBNG_VERNUM) && ZLIBNG_VERNUM < 0x020205F0L
 // this is complete bullshit and a bug in zlib-ng (probably, less likely libpng)
 // need to prevent zlib from lazy-initializing the crc tables, otherwise data race galore
@@ -267,6 +272,7 @@ Image::Image(i32 width, i32 height, bool mipmapped, bool keepInSystemMemory) : R
 
 bool Image::loadRawImage() {
     bool alreadyLoaded = this->rawImage.size() > 0;
+    std::string thumbnailCachePath;
 
     // if it isn't a created image (created within the engine), load it from the corresponding file
     if(!this->bCreatedImage) {
@@ -281,6 +287,15 @@ bool Image::loadRawImage() {
         if(this->bInterrupted)  // cancellation point
             return false;
 
+        // thumbnails: skip decoding the full-size source entirely if we already have a cached copy
+        if(this->iThumbnailHeight > 0 && cv::background_image_thumbnail_cache.getBool()) {
+            thumbnailCachePath = this->getThumbnailCachePath();
+            if(!thumbnailCachePath.empty() && this->loadThumbnail(thumbnailCachePath)) return true;
+
+            if(this->bInterrupted)  // cancellation point
+                return false;
+        }
+
         // load entire file
         std::vector<u8> fileBuffer;
         size_t fileSize{0};
@@ -360,6 +375,25 @@ bool Image::loadRawImage() {
                 return false;
             }
 
+            // thumbnails: let the decoder do the bulk of the downscaling (scaled IDCT), the rest is done afterwards
+            if(this->iThumbnailHeight > 0 && this->iHeight > this->iThumbnailHeight) {
+                int numScalingFactors = 0;
+                const tjscalingfactor *scalingFactors = tj3GetScalingFactors(&numScalingFactors);
+
+                tjscalingfactor bestScalingFactor{.num = 1, .denom = 1};
+                for(int i = 0; i < numScalingFactors; i++) {
+                    const i32 scaledHeight = TJSCALED(this->iHeight, scalingFactors[i]);
+                    if(scaledHeight >= this->iThumbnailHeight &&
+                       scaledHeight < TJSCALED(this->iHeight, bestScalingFactor))
+                        bestScalingFactor = scalingFactors[i];
+                }
+
+                if(tj3SetScalingFactor(tjInstance, bestScalingFactor) == 0) {
+                    this->iWidth = TJSCALED(this->iWidth, bestScalingFactor);
+                    this->iHeight = TJSCALED(this->iHeight, bestScalingFactor);
+                }
+            }
+
             // preallocate
             this->rawImage.resize(static_cast<u64>(this->iWidth) * this->iHeight * Image::NUM_CHANNELS);
 
@@ -408,9 +442,158 @@ bool Image::loadRawImage() {
         return false;
     }
 
+    if(!this->bCreatedImage && !alreadyLoaded && this->iThumbnailHeight > 0) {
+        this->downscaleToThumbnail();
+
+        if(this->bInterrupted)  // cancellation point
+            return false;
+
+        if(!thumbnailCachePath.empty()) this->saveThumbnail(thumbnailCachePath);
+    }
+
     return true;
 }
 
+std::string Image::getThumbnailCachePath() const {
+    namespace fs = std::filesystem;
+
+    // key: source path + mtime + size + requested height, so edited/replaced backgrounds get a new entry
+    std::error_code ec;
+    const auto path = fs::path(UString(this->sFilePath).plat_str());
+    const auto modTime = fs::last_write_time(path, ec);
+    if(ec) return {};
+    const auto fileSize = fs::file_size(path, ec);
+    if(ec) return {};
+
+    const std::string key = fmt::format("{:s}|{:d}|{:d}|{:d}", this->sFilePath,
+                                        static_cast<i64>(modTime.time_since_epoch().count()), fileSize,
+                                        this->iThumbnailHeight);
+
+    std::array<u8, 16> hash{};
+    crypto::hash::md5(key.data(), key.size(), hash.data());
+
+    return fmt::format("{:s}{:s}.jpg", THUMBNAIL_CACHE_DIR, crypto::conv::encodehex(hash));
+}
+
+bool Image::loadThumbnail(const std::string &cachePath) {
+    if(File::exists(cachePath) != File::FILETYPE::FILE) return false;
+
+    std::vector<u8> fileBuffer;
+    {
+        File file(cachePath);
+        if(!file.canRead() || file.getFileSize() < 4) return false;
+        fileBuffer = file.takeFileBuffer();
+    }
+    if(fileBuffer.empty()) return false;
+
+    tjhandle tjInstance = tj3Init(TJINIT_DECOMPRESS);
+    if(!tjInstance) return false;
+
+    bool success = false;
+    if(tj3DecompressHeader(tjInstance, fileBuffer.data(), fileBuffer.size()) == 0) {
+        const i32 width = tj3Get(tjInstance, TJPARAM_JPEGWIDTH);
+        const i32 height = tj3Get(tjInstance, TJPARAM_JPEGHEIGHT);
+
+        if(width > 0 && height > 0 && height <= this->iThumbnailHeight) {
+            this->rawImage.resize(static_cast<u64>(width) * height * Image::NUM_CHANNELS);
+            if(tj3Decompress8(tjInstance, fileBuffer.data(), fileBuffer.size(), this->rawImage.data(), 0, TJPF_RGBA) ==
+               0) {
+                this->iWidth = width;
+                this->iHeight = height;
+                this->type = Image::TYPE::TYPE_JPG;
+                success = true;
+            }
+        }
+    }
+    tj3Destroy(tjInstance);
+
+    if(!success) {
+        debugLog("Image Warning: Discarding broken thumbnail {:s} for {:s}\n", cachePath, this->sFilePath);
+        this->rawImage.clear();
+        Environment::deleteFile(cachePath);
+    }
+
+    return success;
+}
+
+void Image::saveThumbnail(const std::string &cachePath) const {
+    if(this->rawImage.empty()) return;
+
+    // only cache opaque thumbnails, jpeg has no alpha channel (practically all beatmap backgrounds are opaque anyway)
+    const u64 totalPixels = static_cast<u64>(this->iWidth) * this->iHeight;
+    for(u64 i = 0; i < totalPixels; i++) {
+        if(this->rawImage[i * Image::NUM_CHANNELS + 3] < 255) return;
+    }
+
+    tjhandle tjInstance = tj3Init(TJINIT_COMPRESS);
+    if(!tjInstance) return;
+
+    tj3Set(tjInstance, TJPARAM_QUALITY, 90);
+    tj3Set(tjInstance, TJPARAM_SUBSAMP, TJSAMP_420);
+
+    u8 *jpegBuf = nullptr;
+    size_t jpegSize = 0;
+    if(tj3Compress8(tjInstance, this->rawImage.data(), this->iWidth, 0, this->iHeight, TJPF_RGBA, &jpegBuf,
+                    &jpegSize) == 0) {
+        Environment::createDirectory(THUMBNAIL_CACHE_DIR);
+
+        // write to a temporary file first, so that concurrent/interrupted loads never see a partial thumbnail
+        const std::string tempPath = cachePath + ".tmp";
+        bool written = false;
+        {
+            File file(tempPath, File::TYPE::WRITE);
+            if(file.canWrite()) {
+                file.write(jpegBuf, jpegSize);
+                written = true;
+            }
+        }
+        if(written && !Environment::renameFile(tempPath, cachePath)) Environment::deleteFile(tempPath);
+    } else {
+        debugLog("Image Warning: tj3Compress8 failed: {:s} for thumbnail of {:s}\n", tj3GetErrorStr(tjInstance),
+                 this->sFilePath);
+    }
+
+    tj3Free(jpegBuf);
+    tj3Destroy(tjInstance);
+}
+
+void Image::downscaleToThumbnail() {
+    if(this->iHeight <= this->iThumbnailHeight || this->iWidth < 1) return;
+
+    const i32 srcWidth = this->iWidth;
+    const i32 srcHeight = this->iHeight;
+    const i32 dstHeight = this->iThumbnailHeight;
+    const i32 dstWidth = std::max(1, static_cast<i32>(static_cast<i64>(srcWidth) * dstHeight / srcHeight));
+
+    // box filter, every destination pixel averages the source pixels it covers
+    std::vector<u8> scaled(static_cast<u64>(dstWidth) * dstHeight * Image::NUM_CHANNELS);
+    for(i32 y = 0; y < dstHeight; y++) {
+        const i32 srcY0 = static_cast<i32>(static_cast<i64>(y) * srcHeight / dstHeight);
+        const i32 srcY1 = std::max(srcY0 + 1, static_cast<i32>(static_cast<i64>(y + 1) * srcHeight / dstHeight));
+
+        for(i32 x = 0; x < dstWidth; x++) {
+            const i32 srcX0 = static_cast<i32>(static_cast<i64>(x) * srcWidth / dstWidth);
+            const i32 srcX1 = std::max(srcX0 + 1, static_cast<i32>(static_cast<i64>(x + 1) * srcWidth / dstWidth));
+
+            std::array<u32, Image::NUM_CHANNELS> sum{};
+            for(i32 sy = srcY0; sy < srcY1; sy++) {
+                const u8 *row = &this->rawImage[(static_cast<u64>(sy) * srcWidth + srcX0) * Image::NUM_CHANNELS];
+                for(i32 sx = srcX0; sx < srcX1; sx++, row += Image::NUM_CHANNELS) {
+                    for(u8 c = 0; c < Image::NUM_CHANNELS; c++) sum[c] += row[c];
+                }
+            }
+
+            const u32 count = static_cast<u32>((srcY1 - srcY0) * (srcX1 - srcX0));
+            u8 *out = &scaled[(static_cast<u64>(y) * dstWidth + x) * Image::NUM_CHANNELS];
+            for(u8 c = 0; c < Image::NUM_CHANNELS; c++) out[c] = static_cast<u8>(sum[c] / count);
+        }
+    }
+
+    this->rawImage = std::move(scaled);
+    this->iWidth = dstWidth;
+    this->iHeight = dstHeight;
+}
+
 Color Image::getPixel(i32 x, i32 y) const {
     if(unlikely(x < 0 || y < 0 || this->rawImage.size() < 1)) return 0xffffff00;
 
@@ -33,8 +33,14 @@ class Image : public Resource {
     void setPixels(const u8 *data, u64 size, TYPE type);
     void setPixels(const std::vector<u8> &pixels);
 
+    // if set before loading, the image is decoded at (at most) this height and cached on disk (see loadThumbnail)
+    inline void setThumbnailHeight(i32 height) { this->iThumbnailHeight = height; }
+
     [[nodiscard]] Color getPixel(i32 x, i32 y) const;
 
+    // decoded RGBA pixels, only available while loading or if the image is kept in system memory
+    [[nodiscard]] inline const std::vector<u8> &getRawImage() const { return this->rawImage; }
+
     [[nodiscard]] inline Image::TYPE getType() const { return this->type; }
     [[nodiscard]] inline i32 getWidth() const { return this->iWidth; }
     [[nodiscard]] inline i32 getHeight() const { return this->iHeight; }
@@ -64,6 +70,7 @@ class Image : public Resource {
 
     i32 iWidth;
     i32 iHeight;
+    i32 iThumbnailHeight{0};
 
     Graphics::WRAP_MODE wrapMode;
     Image::TYPE type;
@@ -78,6 +85,12 @@ class Image : public Resource {
     static bool canHaveTransparency(const u8 *data, u64 size);
 
     static bool decodePNGFromMemory(const u8 *data, u64 size, std::vector<u8> &outData, i32 &outWidth, i32 &outHeight);
+
+    // thumbnail cache
+    [[nodiscard]] std::string getThumbnailCachePath() const;
+    bool loadThumbnail(const std::string &cachePath);
+    void saveThumbnail(const std::string &cachePath) const;
+    void downscaleToThumbnail();
 };
 
 #endif
@@ -1,6 +1,7 @@
 // Copyright (c) 2015, PG, All rights reserved.
 #include "NetworkHandler.h"
 #include "Engine.h"
+#include "Profiler.h"
 #include "Thread.h"
 #include "SString.h"
 #include "ConVar.h"
@@ -78,6 +79,8 @@ void NetworkHandler::networkThreadFunc(const std::stop_token& stopToken) {
         processNewRequests();
 
         if(!this->active_requests.empty()) {
+            VPROF_ZONE("NetworkHandler::perform");
+
             int running_handles;
             CURLMcode mres = curl_multi_perform(this->multi_handle, &running_handles);
 
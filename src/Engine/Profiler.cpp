@@ -5,6 +5,14 @@
 
 #include "ConVar.h"
 #include "Engine.h"
+#include "Environment.h"
+#include "File.h"
+#include "Thread.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 ProfilerProfile g_profCurrentProfile(true);
 
@@ -21,8 +29,6 @@ ProfilerProfile::ProfilerProfile(bool manualStartViaMain) : root("Root", VPROF_B
         group.name = nullptr;
     }
 
-    this->iNumNodes = 0;
-
     // create all groups in predefined order
     this->groupNameToID(
         VPROF_BUDGETGROUP_ROOT);  // NOTE: the root group must always be the first group to be created here
@@ -123,17 +129,194 @@ ProfilerNode *ProfilerNode::getSubNode(const char *name, const char *group) {
         child = child->sibling;
     }
 
-    // "add" new node
-    if(g_profCurrentProfile.iNumNodes >= VPROF_MAX_NUM_NODES) {
-        engine->showMessageErrorFatal("Engine", "Increase VPROF_MAX_NUM_NODES");
-        engine->shutdown();
-        return nullptr;
-    }
-
-    ProfilerNode *node = &(g_profCurrentProfile.nodes[g_profCurrentProfile.iNumNodes++]);
-    node->constructor(name, group, this);
+    // add new node
+    ProfilerNode *node = &g_profCurrentProfile.nodes.emplace_back(name, group, this);
     node->sibling = this->child;
     this->child = node;
 
     return node;
 }
+
+namespace ProfilerTrace {
+namespace {  // static namespace
+
+struct Event {
+    // atomic because the dump reads rings while their threads keep writing (relaxed is free on the usual targets)
+    std::atomic<const char *> name;
+    std::atomic<u64> beginNS;
+    std::atomic<u64> endNS;
+};
+
+struct ThreadRing {
+    std::array<Event, RING_SIZE> events;
+    std::atomic<u64> iHead{0};  // number of events written, the newest one is at (head - 1) % RING_SIZE
+    std::atomic<bool> bInUse{true};
+
+    // only changed under the registry mutex
+    u32 iThreadID{0};
+    std::string threadName;
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadRing>> rings;
+u32 iNextThreadID{1};
+
+// frees the ring for reuse when its thread exits
+struct ThreadRingOwner {
+    ThreadRing *ring{nullptr};
+    ~ThreadRingOwner() {
+        if(this->ring != nullptr) this->ring->bInUse.store(false, std::memory_order_release);
+    }
+};
+thread_local ThreadRingOwner currentRing;
+
+ThreadRing *registerCurrentThread() {
+    std::scoped_lock lock(registryMutex);
+
+    ThreadRing *ring = nullptr;
+    for(const auto &candidate : rings) {
+        if(!candidate->bInUse.load(std::memory_order_acquire)) {
+            ring = candidate.get();
+            break;
+        }
+    }
+    if(ring == nullptr) ring = rings.emplace_back(std::make_unique<ThreadRing>()).get();
+
+    // the previous thread's zones go away with its id, the dump never attributes them to this one
+    ring->iHead.store(0, std::memory_order_relaxed);
+    ring->bInUse.store(true, std::memory_order_relaxed);
+    ring->iThreadID = iNextThreadID++;
+    ring->threadName = McThread::get_current_thread_name();
+    return ring;
+}
+
+void appendJSONString(std::string &out, const char *str) {
+    out.push_back('"');
+    for(const char *c = str; *c != '\0'; c++) {
+        if(*c == '"' || *c == '\\')
+            out.push_back('\\');
+        else if(static_cast<u8>(*c) < 0x20)
+            continue;
+        out.push_back(*c);
+    }
+    out.push_back('"');
+}
+
+}  // namespace
+
+void recordZone(const char *name, u64 beginNS, u64 endNS) {
+    if(currentRing.ring == nullptr) currentRing.ring = registerCurrentThread();
+    ThreadRing *ring = currentRing.ring;
+
+    // single writer: the slot is filled before the head moves past it. the release fence keeps the previous head
+    // update ahead of the slot writes, so a reader which sees them also sees that the slot was being overwritten
+    const u64 head = ring->iHead.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Event &event = ring->events[head % RING_SIZE];
+    event.name.store(name, std::memory_order_relaxed);
+    event.beginNS.store(beginNS, std::memory_order_relaxed);
+    event.endNS.store(endNS, std::memory_order_relaxed);
+
+    ring->iHead.store(head + 1, std::memory_order_release);
+}
+
+bool dumpChromeTrace(const std::string &filePath, f64 seconds) {
+    struct Zone {
+        const char *name;
+        u64 beginNS;
+        u64 endNS;
+    };
+
+    const u64 now = Timing::getTicksNS();
+    const u64 windowNS = static_cast<u64>(std::max(seconds, 0.0) * 1e9);
+    const u64 windowStart = now > windowNS ? now - windowNS : 0;
+
+    std::string json = R"({"displayTimeUnit":"ms","traceEvents":[)";
+    bool first = true;
+    const auto separator = [&]() {
+        if(!first) json.push_back(',');
+        json.push_back('\n');
+        first = false;
+    };
+
+    std::vector<Zone> zones;
+    size_t numZones = 0;
+    {
+        std::scoped_lock lock(registryMutex);
+
+        for(const auto &ring : rings) {
+            const u64 headBefore = ring->iHead.load(std::memory_order_acquire);
+            if(headBefore == 0) continue;
+
+            zones.clear();
+            for(u64 i = headBefore > RING_SIZE ? headBefore - RING_SIZE : 0; i < headBefore; i++) {
+                const Event &event = ring->events[i % RING_SIZE];
+                zones.push_back(Zone{.name = event.name.load(std::memory_order_relaxed),
+                                     .beginNS = event.beginNS.load(std::memory_order_relaxed),
+                                     .endNS = event.endNS.load(std::memory_order_relaxed)});
+            }
+
+            // drop whatever the thread might have overwritten (or started overwriting) while we were copying
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const u64 headAfter = ring->iHead.load(std::memory_order_relaxed);
+            const u64 firstValid = headAfter + 1 > RING_SIZE ? headAfter + 1 - RING_SIZE : 0;
+            const u64 firstCopied = headBefore > RING_SIZE ? headBefore - RING_SIZE : 0;
+            const size_t numInvalid =
+                firstValid > firstCopied ? std::min<u64>(firstValid - firstCopied, zones.size()) : 0;
+
+            separator();
+            fmt::format_to(std::back_inserter(json),
+                           R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":)", ring->iThreadID);
+            appendJSONString(json, ring->threadName.c_str());
+            json.append("}}");
+
+            for(size_t i = numInvalid; i < zones.size(); i++) {
+                const Zone &zone = zones[i];
+                if(zone.name == nullptr || zone.endNS < windowStart) continue;
+
+                separator();
+                json.append(R"({"name":)");
+                appendJSONString(json, zone.name);
+                fmt::format_to(std::back_inserter(json), R"(,"ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                               ring->iThreadID, static_cast<f64>(zone.beginNS) / 1000.0,
+                               static_cast<f64>(zone.endNS - zone.beginNS) / 1000.0);
+                numZones++;
+            }
+        }
+    }
+    json.append("\n]}\n");
+
+    File file(filePath, File::TYPE::WRITE);
+    if(!file.canWrite()) return false;
+    file.write(reinterpret_cast<const u8 *>(json.data()), json.size());
+
+    debugLog("ProfilerTrace: wrote {} zones to {:s}\n", numZones, filePath);
+    return true;
+}
+
+void dumpCommand(const UString &args) {
+    if(!isEnabled()) Engine::logRaw("vprof_trace_dump: vprof_trace is off, only old zones are left\n");
+
+    const f64 seconds = args.length() > 0 ? args.toDouble() : 10.0;
+    if(seconds <= 0.0) {
+        Engine::logRaw("Usage:  vprof_trace_dump <seconds>\n");
+        return;
+    }
+
+    if(!env->directoryExists("traces") && !env->createDirectory("traces")) {
+        Engine::logRaw("vprof_trace_dump: couldn't create traces folder\n");
+        return;
+    }
+
+    i32 traceNumber = 0;
+    while(env->fileExists(fmt::format("traces/trace{}.json", traceNumber))) traceNumber++;
+
+    const auto traceFilename{fmt::format("traces/trace{}.json", traceNumber)};
+    if(dumpChromeTrace(traceFilename, seconds))
+        Engine::logRaw("vprof_trace_dump: wrote the last {:g} seconds to {:s}\n", seconds, traceFilename);
+    else
+        Engine::logRaw("vprof_trace_dump: couldn't write {:s}\n", traceFilename);
+}
+
+}  // namespace ProfilerTrace
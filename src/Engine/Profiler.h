@@ -1,5 +1,14 @@
 #pragma once
 // Copyright (c) 2020, PG, All rights reserved.
+#include "Timing.h"
+#include "types.h"
+
+#include <atomic>
+#include <deque>
+#include <string>
+
+class UString;
+
 #define VPROF_MAIN()             \
     g_profCurrentProfile.mainprof(); \
     VPROF("Main")
@@ -19,6 +28,9 @@
 #define VPROF_ENTER_SCOPE(name) g_profCurrentProfile.enterScope(name, VPROF_BUDGETGROUP_ROOT)
 #define VPROF_EXIT_SCOPE() g_profCurrentProfile.exitScope()
 
+// only recorded into the trace (see ProfilerTrace), usable from any thread
+#define VPROF_ZONE(name) ProfilerZone ProfZone_(name);
+
 #define VPROF_BUDGETGROUP_ROOT "Root"
 #define VPROF_BUDGETGROUP_SLEEP "Sleep"
 #define VPROF_BUDGETGROUP_EVENTS "Events"
@@ -56,12 +68,10 @@
         }                                                                       \
     } while(false);
 #define VPROF_MAX_NUM_BUDGETGROUPS 128
-#define VPROF_MAX_NUM_NODES 128
 #define VPROF_BUDGET_DBG VPROF_BUDGET
 #else
 #define DBGTIME(...)
 #define VPROF_MAX_NUM_BUDGETGROUPS 32
-#define VPROF_MAX_NUM_NODES 32
 #define VPROF_BUDGET_DBG(...)
 #endif
 
@@ -121,8 +131,8 @@ class ProfilerProfile {
 
         // collect all durations from the last frame and store them as a complete set
         if(this->iEnabled > 0) {
-            for(int i = 0; i < this->iNumNodes; i++) {
-                this->nodes[i].fTimeLastFrame = this->nodes[i].fTimeCurrentFrame;
+            for(ProfilerNode &node : this->nodes) {
+                node.fTimeLastFrame = node.fTimeCurrentFrame;
             }
         }
     }
@@ -167,7 +177,7 @@ class ProfilerProfile {
     [[nodiscard]] inline bool isAtRoot() const { return this->bAtRoot; }
 
     [[nodiscard]] inline int getNumGroups() const { return this->iNumGroups; }
-    [[nodiscard]] inline int getNumNodes() const { return this->iNumNodes; }
+    [[nodiscard]] inline int getNumNodes() const { return static_cast<int>(this->nodes.size()); }
 
     [[nodiscard]] inline const ProfilerNode *getRoot() const { return &this->root; }
 
@@ -196,16 +206,54 @@ class ProfilerProfile {
     ProfilerNode root;
     ProfilerNode *curNode;
 
-    int iNumNodes;
-    ProfilerNode nodes[VPROF_MAX_NUM_NODES];
+    std::deque<ProfilerNode> nodes;  // deque, because nodes link to each other by pointer
 };
 
 extern ProfilerProfile g_profCurrentProfile;
 
+// timeline of zones from all threads (VPROF scopes on the main thread, VPROF_ZONE anywhere), for finding out what
+// every thread was doing around a stutter after the fact (see vprof_trace, vprof_trace_dump).
+// every thread records into its own ring of the last RING_SIZE zones, so recording never takes a lock; a thread only
+// goes through the (locked) registry for its first zone, and its ring is reused by another thread after it exits
+namespace ProfilerTrace {
+inline constexpr const size_t RING_SIZE{16384};
+
+inline std::atomic<bool> bEnabled{false};
+
+[[nodiscard]] inline bool isEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+inline void setEnabled(bool enabled) { bEnabled.store(enabled, std::memory_order_relaxed); }
+
+void recordZone(const char *name, u64 beginNS, u64 endNS);
+
+// writes the zones which ended within the last `seconds` as chrome trace event json (chrome://tracing, perfetto)
+bool dumpChromeTrace(const std::string &filePath, f64 seconds);
+
+// vprof_trace_dump [seconds]: dumpChromeTrace() into the next free traces/trace<n>.json
+void dumpCommand(const UString &args);
+}  // namespace ProfilerTrace
+
+class ProfilerZone {
+   public:
+    inline ProfilerZone(const char *name)
+        : name(name), iBeginNS(ProfilerTrace::isEnabled() ? Timing::getTicksNS() : 0) {}
+    inline ~ProfilerZone() {
+        if(this->iBeginNS != 0) ProfilerTrace::recordZone(this->name, this->iBeginNS, Timing::getTicksNS());
+    }
+
+   private:
+    const char *name;
+    u64 iBeginNS;
+};
+
 class ProfilerScope {
    public:
-    inline ProfilerScope(const char *name, const char *group) { g_profCurrentProfile.enterScope(name, group); }
+    inline ProfilerScope(const char *name, const char *group) : zone(name) {
+        g_profCurrentProfile.enterScope(name, group);
+    }
     inline ~ProfilerScope() { g_profCurrentProfile.exitScope(); }
+
+   private:
+    ProfilerZone zone;
 };
 
 extern ProfilerProfile g_profCurrentProfile;
@@ -13,6 +13,7 @@
 
 class ConVar;
 class UString;
+class Utf8String;
 
 class Image;
 class McFont;
@@ -80,6 +81,20 @@ class Graphics {
         COMPARE_FUNC_ALWAYS
     };
 
+    // per-frame counters, for comparing renderer changes (see gfx_batch_bench)
+    struct DrawStats {
+        u32 drawCalls{0};
+        u32 stateChanges{0};    // texture binds, blend/clip/stencil/... changes
+        u32 batchedSprites{0};  // drawImage()s which went into the sprite batch
+        u32 batchFlushes{0};
+
+        // StreamBuffer, if the renderer has one
+        u64 streamedBytes{0};
+        u32 streamStalls{0};
+        u32 streamWraparounds{0};
+        u32 streamOverflows{0};
+    };
+
    public:
     friend class Engine;
 
@@ -96,6 +111,7 @@ class Graphics {
     // color
     virtual void setColor(Color color) = 0;
     virtual void setAlpha(float alpha) = 0;
+    [[nodiscard]] virtual Color getColor() const = 0;
 
     // 2d primitive drawing
     virtual void drawPixels(int x, int y, int width, int height, Graphics::DRAWPIXELS_TYPE type,
@@ -136,6 +152,7 @@ class Graphics {
     virtual void drawImage(Image *image, AnchorPoint anchor = AnchorPoint::CENTER, float edgeSoftness = 0.0f,
                            McRect clipRect = {}) = 0;
     virtual void drawString(McFont *font, const UString &text) = 0;
+    virtual void drawString(McFont *font, const Utf8String &text) = 0;
 
     // 3d type drawing
     virtual void drawVAO(VertexArrayObject *vao) = 0;
@@ -168,6 +185,7 @@ class Graphics {
 
     // renderer actions
     virtual void flush() = 0;
+    virtual void flushBatch() = 0;  // draws pending batched sprites, for code which changes api state directly
     virtual std::vector<u8> getScreenshot(bool withAlpha = false) = 0;
 
     // renderer info
@@ -223,6 +241,9 @@ class Graphics {
     Matrix4 getProjectionMatrix();
     inline Matrix4 getMVP() const { return this->MP; }
 
+    // stats
+    [[nodiscard]] inline const DrawStats &getLastFrameStats() const { return this->lastFrameStats; }
+
     // 3d gui scenes
     void push3DScene(McRect region);
     void pop3DScene();
@@ -253,6 +274,10 @@ class Graphics {
     Matrix4 worldMatrix;
     Matrix4 MP;
 
+    // stats, reset in beginScene() and copied to lastFrameStats in endScene()
+    DrawStats stats;
+    DrawStats lastFrameStats;
+
     McRect scene3d_region;
     vec3 v3dSceneOffset{0.f};
     bool bTransformUpToDate;
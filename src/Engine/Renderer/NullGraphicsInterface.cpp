@@ -0,0 +1,479 @@
+#include "NullGraphicsInterface.h"
+
+#include "BenchCheck.h"
+#include "ConVar.h"
+#include "Engine.h"
+#include "Font.h"
+#include "Image.h"
+#include "RenderTarget.h"
+#include "Shader.h"
+#include "StreamBuffer.h"
+#include "UString.h"
+#include "VertexArrayObject.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {  // static namespace
+
+class NullImage final : public Image {
+   public:
+    NullImage(NullGraphicsInterface *owner, std::string filePath, bool mipmapped, bool keepInSystemMemory)
+        : Image(std::move(filePath), mipmapped, keepInSystemMemory), owner(owner) {}
+    NullImage(NullGraphicsInterface *owner, i32 width, i32 height, bool mipmapped, bool keepInSystemMemory)
+        : Image(width, height, mipmapped, keepInSystemMemory), owner(owner) {}
+
+    void bind(unsigned int /*textureUnit*/ = 0) override { this->owner->onTextureBind(); }
+    void unbind() override { this->owner->onTextureBind(); }
+
+   private:
+    void init() override { this->bReady = true; }
+    void initAsync() override { this->bAsyncReady = true; }
+    void destroy() override { this->owner->flushBatch(); }
+
+    NullGraphicsInterface *owner;
+};
+
+class NullRenderTarget final : public RenderTarget {
+   public:
+    NullRenderTarget(NullGraphicsInterface *owner, int x, int y, int width, int height,
+                     Graphics::MULTISAMPLE_TYPE multiSampleType)
+        : RenderTarget(x, y, width, height, multiSampleType), owner(owner) {}
+
+    void enable() override { this->owner->onTextureBind(); }
+    void disable() override { this->owner->onTextureBind(); }
+    void bind(unsigned int /*textureUnit*/ = 0) override { this->owner->onTextureBind(); }
+    void unbind() override { this->owner->onTextureBind(); }
+
+   private:
+    void init() override { this->bReady = true; }
+    void initAsync() override { this->bAsyncReady = true; }
+    void destroy() override { ; }
+
+    NullGraphicsInterface *owner;
+};
+
+class NullShader final : public Shader {
+   public:
+    NullShader(NullGraphicsInterface *owner) : owner(owner) {}
+
+    void enable() override { this->owner->onShaderEnable(true); }
+    void disable() override { this->owner->onShaderEnable(false); }
+
+    void setUniform1f(const std::string_view & /*name*/, float /*value*/) override { ; }
+    void setUniform1fv(const std::string_view & /*name*/, int /*count*/, float * /*values*/) override { ; }
+    void setUniform1i(const std::string_view & /*name*/, int /*value*/) override { ; }
+    void setUniform2f(const std::string_view & /*name*/, float /*x*/, float /*y*/) override { ; }
+    void setUniform2fv(const std::string_view & /*name*/, int /*count*/, float * /*vectors*/) override { ; }
+    void setUniform3f(const std::string_view & /*name*/, float /*x*/, float /*y*/, float /*z*/) override { ; }
+    void setUniform3fv(const std::string_view & /*name*/, int /*count*/, float * /*vectors*/) override { ; }
+    void setUniform4f(const std::string_view & /*name*/, float /*x*/, float /*y*/, float /*z*/, float /*w*/) override {
+        ;
+    }
+    void setUniformMatrix4fv(const std::string_view & /*name*/, Matrix4 & /*matrix*/) override { ; }
+    void setUniformMatrix4fv(const std::string_view & /*name*/, float * /*v*/) override { ; }
+
+   private:
+    void init() override { this->bReady = true; }
+    void initAsync() override { this->bAsyncReady = true; }
+    void destroy() override { ; }
+
+    NullGraphicsInterface *owner;
+};
+
+}  // namespace
+
+// system memory instead of a mapped buffer. fences are frame numbers, and the "gpu" finishes a frame
+// gpuLatencyFrames frames after it was submitted, or immediately if something waits for it
+class NullStreamBuffer final : public StreamBuffer {
+    NOCOPY_NOMOVE(NullStreamBuffer)
+   public:
+    NullStreamBuffer(size_t size, u32 gpuLatencyFrames) : memory(size), iLatency(gpuLatencyFrames) {
+        this->setStorage(this->memory.data(), this->memory.size());
+    }
+    ~NullStreamBuffer() override { this->releaseFences(); }
+
+   protected:
+    u64 createFence() override {
+        this->iSubmitted++;
+        if(this->iSubmitted > this->iLatency)
+            this->iCompleted = std::max(this->iCompleted, this->iSubmitted - this->iLatency);
+        return this->iSubmitted;
+    }
+    bool isFenceSignaled(u64 fence) override { return fence <= this->iCompleted; }
+    void waitFence(u64 fence) override { this->iCompleted = std::max(this->iCompleted, fence); }
+    void deleteFence(u64 /*fence*/) override { ; }
+
+   private:
+    std::vector<u8> memory;
+    u64 iLatency;
+    u64 iSubmitted{0};
+    u64 iCompleted{0};
+};
+
+NullGraphicsInterface::NullGraphicsInterface(vec2 resolution, size_t streamBufferSize, u32 gpuLatencyFrames)
+    : vResolution(resolution) {
+    if(streamBufferSize > 0)
+        this->streamBuffer = std::make_unique<NullStreamBuffer>(streamBufferSize, gpuLatencyFrames);
+}
+
+NullGraphicsInterface::~NullGraphicsInterface() = default;
+
+void NullGraphicsInterface::beginScene() {
+    this->stats = {};
+
+    this->pushTransform();
+    Matrix4 defaultProjectionMatrix{};
+    this->setProjectionMatrix(defaultProjectionMatrix);
+    this->updateTransform();
+}
+
+void NullGraphicsInterface::endScene() {
+    this->flushBatch();
+    this->popTransform();
+
+    if(this->streamBuffer) {
+        this->streamBuffer->endFrame();
+
+        const StreamBuffer::Stats &streamStats = this->streamBuffer->getLastFrameStats();
+        this->stats.streamedBytes = streamStats.bytesAllocated;
+        this->stats.streamStalls = streamStats.stalls;
+        this->stats.streamWraparounds = streamStats.wraparounds;
+        this->stats.streamOverflows = streamStats.overflows;
+    }
+
+    this->lastFrameStats = this->stats;
+}
+
+void NullGraphicsInterface::drawImage(Image *image, AnchorPoint anchor, float edgeSoftness, McRect clipRect) {
+    if(image == nullptr || !image->isReady() || this->color.A() == 0) return;
+
+    this->updateTransform();
+
+    const bool clipRectSpecified = vec::length(clipRect.getSize()) != 0;
+    const vec2 size = image->getSize();
+    vec2 topLeft{0.f};
+    switch(anchor) {
+        case AnchorPoint::CENTER:
+            topLeft = -size / 2.f;
+            break;
+        case AnchorPoint::TOP_RIGHT:
+            topLeft.x = -size.x;
+            break;
+        case AnchorPoint::BOTTOM_LEFT:
+            topLeft.y = -size.y;
+            break;
+        case AnchorPoint::LEFT:
+            topLeft.y = -size.y / 2.f;
+            break;
+        default:
+            break;
+    }
+
+    // same rules as OpenGLLegacyInterface::canBatchImage()
+    if(cv::r_batch_sprites.getBool() && edgeSoftness <= 0.0f && !clipRectSpecified &&
+       !cv::r_debug_drawimage.getBool() && this->iNumActiveShaders == 0) {
+        this->spriteBatch.addQuad(reinterpret_cast<uintptr_t>(image), this->worldMatrix, topLeft, topLeft + size,
+                                  this->color);
+        this->stats.batchedSprites++;
+        return;
+    }
+
+    if(clipRectSpecified) this->pushClipRect(clipRect);
+    this->beginDraw();
+    this->stats.stateChanges++;  // image->bind()
+    if(clipRectSpecified) this->popClipRect();
+}
+
+void NullGraphicsInterface::drawString(McFont *font, const UString &text) {
+    if(font == nullptr || text.length() < 1 || !font->isReady()) return;
+
+    this->beginDraw();
+    this->stats.stateChanges++;  // atlas bind
+}
+
+void NullGraphicsInterface::drawString(McFont *font, const Utf8String &text) {
+    if(font == nullptr || text.length() < 1 || !font->isReady()) return;
+
+    this->beginDraw();
+    this->stats.stateChanges++;
+}
+
+void NullGraphicsInterface::drawVAO(VertexArrayObject *vao) {
+    if(vao == nullptr) return;
+
+    this->updateTransform();
+    this->beginDraw();
+
+    // same as OpenGLLegacyInterface::drawStreamedVAO(), baked vaos already live in their own buffers
+    StreamBuffer::VAOLayout layout;
+    if(this->streamBuffer && !vao->isReady() && StreamBuffer::getVAOLayout(*vao, layout)) {
+        const StreamBuffer::Allocation allocation = this->streamBuffer->allocate(layout.size);
+        if(allocation.data != nullptr) StreamBuffer::writeVAO(*vao, layout, allocation.data);
+    }
+}
+
+void NullGraphicsInterface::pushClipRect(McRect clipRect) {
+    if(this->clipRectStack.size() > 0)
+        this->clipRectStack.push(this->clipRectStack.top().intersect(clipRect));
+    else
+        this->clipRectStack.push(clipRect);
+
+    this->setClipRect(this->clipRectStack.top());
+}
+
+void NullGraphicsInterface::popClipRect() {
+    this->clipRectStack.pop();
+
+    if(this->clipRectStack.size() > 0)
+        this->setClipRect(this->clipRectStack.top());
+    else
+        this->setClipping(false);
+}
+
+void NullGraphicsInterface::flushBatch() {
+    if(this->spriteBatch.empty()) return;
+
+    // one texture bind + one draw per run, like OpenGLLegacyInterface::flushBatch()
+    const auto numRuns = static_cast<u32>(this->spriteBatch.getRuns().size());
+    this->stats.drawCalls += numRuns;
+    this->stats.stateChanges += numRuns;
+    this->stats.batchFlushes++;
+
+    if(this->streamBuffer) {
+        const auto &vertices = this->spriteBatch.getVertices();
+        const size_t size = vertices.size() * sizeof(SpriteBatch::Vertex);
+        const StreamBuffer::Allocation allocation = this->streamBuffer->allocate(size);
+        if(allocation.data != nullptr) memcpy(allocation.data, vertices.data(), size);
+    }
+
+    this->spriteBatch.clear();
+}
+
+UString NullGraphicsInterface::getVendor() { return "null"; }
+UString NullGraphicsInterface::getModel() { return "null"; }
+UString NullGraphicsInterface::getVersion() { return "null"; }
+
+Image *NullGraphicsInterface::createImage(std::string filePath, bool mipmapped, bool keepInSystemMemory) {
+    return new NullImage(this, std::move(filePath), mipmapped, keepInSystemMemory);
+}
+
+Image *NullGraphicsInterface::createImage(i32 width, i32 height, bool mipmapped, bool keepInSystemMemory) {
+    return new NullImage(this, width, height, mipmapped, keepInSystemMemory);
+}
+
+RenderTarget *NullGraphicsInterface::createRenderTarget(int x, int y, int width, int height,
+                                                        Graphics::MULTISAMPLE_TYPE multiSampleType) {
+    return new NullRenderTarget(this, x, y, width, height, multiSampleType);
+}
+
+Shader *NullGraphicsInterface::createShaderFromFile(std::string /*vertexShaderFilePath*/,
+                                                    std::string /*fragmentShaderFilePath*/) {
+    return new NullShader(this);
+}
+
+Shader *NullGraphicsInterface::createShaderFromSource(std::string /*vertexShader*/, std::string /*fragmentShader*/) {
+    return new NullShader(this);
+}
+
+VertexArrayObject *NullGraphicsInterface::createVertexArrayObject(Graphics::PRIMITIVE primitive,
+                                                                  Graphics::USAGE_TYPE usage, bool keepInSystemMemory) {
+    // the base class keeps everything in system memory, which is all drawVAO() needs here
+    return new VertexArrayObject(primitive, usage, keepInSystemMemory);
+}
+
+void NullGraphicsInterface::onTransformUpdate(Matrix4 &projectionMatrix, Matrix4 & /*worldMatrix*/) {
+    if(projectionMatrix != this->loadedProjectionMatrix) this->flushBatch();
+    this->loadedProjectionMatrix = projectionMatrix;
+}
+
+void NullGraphicsInterface::batchBench() {
+    // draws a synthetic gameplay frame (hitobjects, hud, cursor trail) through the null renderer, with and without
+    // sprite batching, and reports what the real renderer would have issued for it
+    static constexpr int NUM_FRAMES = 100;
+    static constexpr int NUM_HITOBJECTS = 40;
+    static constexpr int NUM_SCORE_DIGITS = 8;
+    static constexpr int NUM_TRAIL_PARTS = 300;
+    static constexpr u32 NUM_IMAGES = NUM_HITOBJECTS * 4 + 1 + NUM_SCORE_DIGITS + NUM_TRAIL_PARTS + 1;
+
+    BenchCheck check("gfx_batch_bench");
+    u32 unbatchedDrawCalls = 0;
+
+    NullGraphicsInterface null{vec2{1920.f, 1080.f}};
+    const auto makeImage = [&](i32 size) {
+        std::unique_ptr<Image> image{null.createImage(size, size, false, false)};
+        image->loadAsync();
+        image->load();
+        return image;
+    };
+
+    const auto hitcircle = makeImage(128);
+    const auto overlay = makeImage(128);
+    const auto approachcircle = makeImage(128);
+    const auto healthBar = makeImage(256);
+    const auto cursor = makeImage(64);
+    const auto cursortrail = makeImage(32);
+    std::array<std::unique_ptr<Image>, 10> digits;
+    for(auto &digit : digits) digit = makeImage(32);
+
+    const bool configuredBatching = cv::r_batch_sprites.getBool();
+    for(const bool batching : {false, true}) {
+        cv::r_batch_sprites.setValue(batching);
+
+        const u64 start = Timing::getTicksNS();
+        for(int frame = 0; frame < NUM_FRAMES; frame++) {
+            null.beginScene();
+
+            for(int i = 0; i < NUM_HITOBJECTS; i++) {
+                null.pushTransform();
+                null.translate(100.f + static_cast<f32>(i) * 40.f, 300.f + static_cast<f32>(i % 7) * 60.f);
+                null.drawImage(hitcircle.get());
+                null.drawImage(overlay.get());
+                null.drawImage(digits[i % 10].get());
+                null.drawImage(approachcircle.get());
+                null.popTransform();
+            }
+
+            null.drawImage(healthBar.get(), AnchorPoint::TOP_LEFT);
+            null.fillRect(0, 1070, 1920, 10);  // progress bar
+            for(int i = 0; i < NUM_SCORE_DIGITS; i++) {
+                null.pushTransform();
+                null.translate(1600.f + static_cast<f32>(i) * 32.f, 16.f);
+                null.drawImage(digits[(frame + i) % 10].get(), AnchorPoint::TOP_LEFT);
+                null.popTransform();
+            }
+
+            null.setBlendMode(Graphics::BLEND_MODE::BLEND_MODE_ADDITIVE);
+            for(int i = 0; i < NUM_TRAIL_PARTS; i++) {
+                null.pushTransform();
+                null.translate(960.f + static_cast<f32>(i), 540.f);
+                null.drawImage(cursortrail.get());
+                null.popTransform();
+            }
+            null.setBlendMode(Graphics::BLEND_MODE::BLEND_MODE_ALPHA);
+            null.drawImage(cursor.get());
+
+            null.endScene();
+        }
+        const u64 elapsed = Timing::getTicksNS() - start;
+
+        const Graphics::DrawStats &stats = null.getLastFrameStats();
+        Engine::logRaw("gfx_batch_bench: r_batch_sprites {:d}: {:d} draw calls, {:d} state changes per frame\n",
+                       batching, stats.drawCalls, stats.stateChanges);
+        Engine::logRaw("    {:d} batched sprites in {:d} flushes, {:.1f} us cpu per frame\n", stats.batchedSprites,
+                       stats.batchFlushes, static_cast<f64>(elapsed) / NUM_FRAMES / 1000.0);
+
+        // every image in the frame is batchable, and batching has to actually save draw calls
+        if(batching) {
+            check.expectEqual(stats.batchedSprites, NUM_IMAGES, "batched sprites");
+            check.expect(stats.drawCalls < unbatchedDrawCalls, "{:d} draw calls with batching, {:d} without",
+                         stats.drawCalls, unbatchedDrawCalls);
+        } else {
+            check.expectEqual(stats.batchedSprites, 0U, "batched sprites without r_batch_sprites");
+            check.expect(stats.drawCalls >= NUM_IMAGES, "only {:d} draw calls for {:d} images without batching",
+                         stats.drawCalls, NUM_IMAGES);
+            unbatchedDrawCalls = stats.drawCalls;
+        }
+    }
+
+    cv::r_batch_sprites.setValue(configuredBatching);
+    check.finish();
+}
+
+void NullGraphicsInterface::streamBench() {
+    // streams the per-frame geometry of a busy frame (text, cursor trail, batched sprites) through the null
+    // renderer's StreamBuffer, for a few buffer sizes and gpu latencies, and reports how often it had to wait
+    static constexpr int NUM_FRAMES = 600;
+    static constexpr int NUM_STRINGS = 30;
+    static constexpr int NUM_STRING_CHARS = 24;
+    static constexpr int NUM_TRAIL_PARTS = 300;
+    static constexpr int NUM_SPRITES = 160;
+    static constexpr std::array<size_t, 4> SIZES{256ULL * 1024, 1024ULL * 1024, 4096ULL * 1024, 12288ULL * 1024};
+
+    BenchCheck check("gfx_stream_bench");
+
+    for(const size_t size : SIZES) {
+        for(const u32 latency : {1U, 2U, 3U}) {
+            NullGraphicsInterface null{vec2{1920.f, 1080.f}, size, latency};
+
+            std::unique_ptr<Image> sprite{null.createImage(128, 128, false, false)};
+            sprite->loadAsync();
+            sprite->load();
+
+            // unbaked, like McFont's and the cursor trail's
+            std::unique_ptr<VertexArrayObject> text{null.createVertexArrayObject(
+                Graphics::PRIMITIVE::PRIMITIVE_QUADS, Graphics::USAGE_TYPE::USAGE_DYNAMIC, false)};
+            std::unique_ptr<VertexArrayObject> trail{null.createVertexArrayObject(
+                Graphics::PRIMITIVE::PRIMITIVE_QUADS, Graphics::USAGE_TYPE::USAGE_DYNAMIC, false)};
+
+            u64 bytes = 0;
+            u32 stalls = 0, wraparounds = 0, overflows = 0;
+            const u64 start = Timing::getTicksNS();
+            for(int frame = 0; frame < NUM_FRAMES; frame++) {
+                null.beginScene();
+
+                for(int i = 0; i < NUM_STRINGS; i++) {
+                    text->clear();
+                    for(int c = 0; c < NUM_STRING_CHARS; c++) {
+                        const auto x = static_cast<f32>(c * 10);
+                        text->addVertex(x, 0.f);
+                        text->addTexcoord(0.f, 0.f);
+                        text->addVertex(x, 16.f);
+                        text->addTexcoord(0.f, 1.f);
+                        text->addVertex(x + 10.f, 16.f);
+                        text->addTexcoord(1.f, 1.f);
+                        text->addVertex(x + 10.f, 0.f);
+                        text->addTexcoord(1.f, 0.f);
+                    }
+                    null.drawVAO(text.get());
+                }
+
+                trail->clear();
+                for(int i = 0; i < NUM_TRAIL_PARTS; i++) {
+                    const auto x = static_cast<f32>(i);
+                    const Color color = argb(static_cast<u8>(255 - (i * 255) / NUM_TRAIL_PARTS), 255, 255, 255);
+                    for(const vec2 corner : {vec2{0.f, 0.f}, vec2{0.f, 1.f}, vec2{1.f, 1.f}, vec2{1.f, 0.f}}) {
+                        trail->addVertex(x + corner.x * 32.f, 540.f + corner.y * 32.f);
+                        trail->addTexcoord(corner);
+                        trail->addColor(color);
+                    }
+                }
+                null.drawVAO(trail.get());
+
+                for(int i = 0; i < NUM_SPRITES; i++) {
+                    null.pushTransform();
+                    null.translate(static_cast<f32>(i * 12), 300.f);
+                    null.drawImage(sprite.get());
+                    null.popTransform();
+                }
+
+                null.endScene();
+
+                const Graphics::DrawStats &stats = null.getLastFrameStats();
+                bytes += stats.streamedBytes;
+                stalls += stats.streamStalls;
+                wraparounds += stats.streamWraparounds;
+                overflows += stats.streamOverflows;
+            }
+            const u64 elapsed = Timing::getTicksNS() - start;
+
+            Engine::logRaw(
+                "gfx_stream_bench: {:5d} KiB, {:d} frame(s) gpu latency: {:.1f} KiB/frame, {:d} stalls, "
+                "{:d} wraparounds, {:d} overflows, {:.1f} us cpu per frame\n",
+                size / 1024, latency, static_cast<f64>(bytes) / NUM_FRAMES / 1024.0, stalls, wraparounds, overflows,
+                static_cast<f64>(elapsed) / NUM_FRAMES / 1000.0);
+
+            check.expect(bytes > 0, "{:d} KiB, latency {:d}: nothing was streamed", size / 1024, latency);
+
+            // the largest buffer holds many frames of this, it must never have to wait or fall back
+            if(size == SIZES.back()) {
+                check.expectEqual(stalls, 0U, fmt::format("stalls with {:d} KiB, latency {:d}", size / 1024, latency));
+                check.expectEqual(overflows, 0U,
+                                  fmt::format("overflows with {:d} KiB, latency {:d}", size / 1024, latency));
+            }
+        }
+    }
+
+    check.finish();
+}
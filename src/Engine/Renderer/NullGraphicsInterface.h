@@ -0,0 +1,164 @@
+#pragma once
+
+#include "Graphics.h"
+#include "SpriteBatch.h"
+
+#include <memory>
+#include <stack>
+
+class NullStreamBuffer;
+
+// renderer which doesn't draw anything, it only records what the real one would have done (draw calls, state
+// changes, sprite batching) into the DrawStats. for measuring renderer changes without a gpu/window (see
+// gfx_batch_bench). it follows the same batching rules as OpenGLLegacyInterface, and the resources it creates flush
+// the batch in the same places the OpenGL ones do.
+// with a streamBufferSize, unbaked vaos and sprite batches are allocated from a StreamBuffer whose fences signal
+// gpuLatencyFrames frames after they were created (see gfx_stream_bench)
+class NullGraphicsInterface final : public Graphics {
+    NOCOPY_NOMOVE(NullGraphicsInterface)
+   public:
+    NullGraphicsInterface(vec2 resolution, size_t streamBufferSize = 0, u32 gpuLatencyFrames = 1);
+    ~NullGraphicsInterface() override;
+
+    // gfx_batch_bench: a synthetic gameplay frame with and without sprite batching
+    static void batchBench();
+
+    // gfx_stream_bench: the per-frame geometry of a busy frame through the StreamBuffer, for a few buffer sizes and gpu
+    // latencies
+    static void streamBench();
+
+    // scene
+    void beginScene() override;
+    void endScene() override;
+
+    // depth buffer
+    void clearDepthBuffer() override { this->beginStateChange(); }
+
+    // color
+    void setColor(Color color) override { this->color = color; }
+    void setAlpha(float alpha) override { this->color.setA(alpha); }
+    [[nodiscard]] Color getColor() const override { return this->color; }
+
+    // 2d primitive drawing
+    void drawPixels(int /*x*/, int /*y*/, int /*width*/, int /*height*/, Graphics::DRAWPIXELS_TYPE /*type*/,
+                    const void * /*pixels*/) override {
+        this->beginDraw();
+    }
+    void drawPixel(int /*x*/, int /*y*/) override { this->beginDraw(); }
+    void drawLinef(float /*x1*/, float /*y1*/, float /*x2*/, float /*y2*/) override { this->beginDraw(); }
+    void drawRectf(float /*x*/, float /*y*/, float /*width*/, float /*height*/, bool /*withColor*/, Color /*top*/,
+                   Color /*right*/, Color /*bottom*/, Color /*left*/) override {
+        this->beginDraw();
+    }
+    void fillRectf(float /*x*/, float /*y*/, float /*width*/, float /*height*/) override { this->beginDraw(); }
+
+    void fillRoundedRect(int /*x*/, int /*y*/, int /*width*/, int /*height*/, int /*radius*/) override {
+        this->beginDraw();
+    }
+    void fillGradient(int /*x*/, int /*y*/, int /*width*/, int /*height*/, Color /*topLeftColor*/,
+                      Color /*topRightColor*/, Color /*bottomLeftColor*/, Color /*bottomRightColor*/) override {
+        this->beginDraw();
+    }
+
+    void drawQuad(int /*x*/, int /*y*/, int /*width*/, int /*height*/) override { this->beginDraw(); }
+    void drawQuad(vec2 /*topLeft*/, vec2 /*topRight*/, vec2 /*bottomRight*/, vec2 /*bottomLeft*/,
+                  Color /*topLeftColor*/, Color /*topRightColor*/, Color /*bottomRightColor*/,
+                  Color /*bottomLeftColor*/) override {
+        this->beginDraw();
+    }
+
+    // 2d resource drawing
+    void drawImage(Image *image, AnchorPoint anchor = AnchorPoint::CENTER, float edgeSoftness = 0.0f,
+                   McRect clipRect = {}) override;
+    void drawString(McFont *font, const UString &text) override;
+    void drawString(McFont *font, const Utf8String &text) override;
+
+    // 3d type drawing
+    void drawVAO(VertexArrayObject *vao) override;
+
+    // 2d clipping
+    void setClipRect(McRect /*clipRect*/) override { this->beginStateChange(); }
+    void pushClipRect(McRect clipRect) override;
+    void popClipRect() override;
+
+    // stencil buffer
+    void pushStencil() override { this->beginStateChange(); }
+    void fillStencil(bool /*inside*/) override { this->beginStateChange(); }
+    void popStencil() override { this->beginStateChange(); }
+
+    // renderer settings
+    void setClipping(bool /*enabled*/) override { this->beginStateChange(); }
+    void setAlphaTesting(bool /*enabled*/) override { this->beginStateChange(); }
+    void setAlphaTestFunc(COMPARE_FUNC /*alphaFunc*/, float /*ref*/) override { this->beginStateChange(); }
+    void setBlending(bool /*enabled*/) override { this->beginStateChange(); }
+    void setBlendMode(BLEND_MODE /*blendMode*/) override { this->beginStateChange(); }
+    void setDepthBuffer(bool /*enabled*/) override { this->beginStateChange(); }
+    void setDepthWriting(bool /*enabled*/) override { this->beginStateChange(); }
+    void setColorWriting(bool /*r*/, bool /*g*/, bool /*b*/, bool /*a*/) override { this->beginStateChange(); }
+    void setCulling(bool /*enabled*/) override { this->beginStateChange(); }
+    void setVSync(bool /*enabled*/) override { ; }
+    void setAntialiasing(bool /*enabled*/) override { this->beginStateChange(); }
+    void setWireframe(bool /*enabled*/) override { this->beginStateChange(); }
+    void setLineWidth(float /*width*/) override { this->beginStateChange(); }
+
+    // renderer actions
+    void flush() override { this->flushBatch(); }
+    void flushBatch() override;
+    std::vector<u8> getScreenshot(bool /*withAlpha*/ = false) override {
+        this->flushBatch();
+        return {};
+    }
+
+    // renderer info
+    [[nodiscard]] vec2 getResolution() const override { return this->vResolution; }
+    UString getVendor() override;
+    UString getModel() override;
+    UString getVersion() override;
+    int getVRAMTotal() override { return 0; }
+    int getVRAMRemaining() override { return 0; }
+
+    // callbacks
+    void onResolutionChange(vec2 newResolution) override {
+        this->flushBatch();
+        this->vResolution = newResolution;
+    }
+
+    // factory
+    Image *createImage(std::string filePath, bool mipmapped, bool keepInSystemMemory) override;
+    Image *createImage(i32 width, i32 height, bool mipmapped, bool keepInSystemMemory) override;
+    RenderTarget *createRenderTarget(int x, int y, int width, int height,
+                                     Graphics::MULTISAMPLE_TYPE multiSampleType) override;
+    Shader *createShaderFromFile(std::string vertexShaderFilePath, std::string fragmentShaderFilePath) override;
+    Shader *createShaderFromSource(std::string vertexShader, std::string fragmentShader) override;
+    VertexArrayObject *createVertexArrayObject(Graphics::PRIMITIVE primitive, Graphics::USAGE_TYPE usage,
+                                               bool keepInSystemMemory) override;
+
+    // called by the null resources
+    inline void onTextureBind() { this->beginStateChange(); }
+    inline void onShaderEnable(bool enabled) {
+        this->beginStateChange();
+        this->iNumActiveShaders += enabled ? 1 : -1;
+    }
+
+   protected:
+    void onTransformUpdate(Matrix4 &projectionMatrix, Matrix4 &worldMatrix) override;
+
+   private:
+    inline void beginDraw() {
+        this->flushBatch();
+        this->stats.drawCalls++;
+    }
+    inline void beginStateChange() {
+        this->flushBatch();
+        this->stats.stateChanges++;
+    }
+
+    SpriteBatch spriteBatch;
+    std::unique_ptr<NullStreamBuffer> streamBuffer;
+    Matrix4 loadedProjectionMatrix;
+    std::stack<McRect> clipRectStack;
+
+    vec2 vResolution;
+    Color color{0xffffffff};
+    int iNumActiveShaders{0};
+};
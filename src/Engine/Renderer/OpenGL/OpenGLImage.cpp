@@ -45,6 +45,9 @@ void OpenGLImage::init() {
         return;
     }
 
+    // batched sprites could still be using the old contents
+    if(g) g->flushBatch();
+
     // create texture object
     if(this->GLTexture == 0) {
         // FFP compatibility (part 1)
@@ -126,6 +129,7 @@ void OpenGLImage::destroy() {
 
 void OpenGLImage::deleteGL() {
     if(this->GLTexture != 0 && glDeleteTextures != nullptr && glIsTexture != nullptr) {
+        if(g) g->flushBatch();
         if(!glIsTexture(this->GLTexture)) {
             debugLog("WARNING: tried to glDeleteTexture on {} ({:p}), which is not a valid GL texture!\n", this->sName,
                      static_cast<const void*>(&this->GLTexture));
@@ -139,6 +143,9 @@ void OpenGLImage::deleteGL() {
 void OpenGLImage::bind(unsigned int textureUnit) {
     if(!this->bReady) return;
 
+    // the sprite batch binds its own textures when flushing, so that has to happen before
+    if(g) g->flushBatch();
+
     this->iTextureUnitBackup = textureUnit;
 
     // switch texture units before enabling+binding
@@ -156,6 +163,8 @@ void OpenGLImage::bind(unsigned int textureUnit) {
 void OpenGLImage::unbind() {
     if(!this->bReady) return;
 
+    if(g) g->flushBatch();
+
     // restore texture unit (just in case) and set to no texture
     glActiveTexture(GL_TEXTURE0 + this->iTextureUnitBackup);
     glBindTexture(GL_TEXTURE_2D, 0);
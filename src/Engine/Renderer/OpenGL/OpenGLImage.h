@@ -19,6 +19,8 @@ class OpenGLImage final : public Image {
     void setFilterMode(Graphics::FILTER_MODE filterMode) override;
     void setWrapMode(Graphics::WRAP_MODE wrapMode) override;
 
+    [[nodiscard]] inline unsigned int getTextureId() const { return this->GLTexture; }
+
    private:
     void init() override;
     void initAsync() override;
@@ -11,6 +11,7 @@
 #include "OpenGLImage.h"
 #include "OpenGLRenderTarget.h"
 #include "OpenGLShader.h"
+#include "OpenGLStreamBuffer.h"
 #include "OpenGLVertexArrayObject.h"
 
 #include "SDLGLInterface.h"
@@ -18,7 +19,9 @@
 
 #include "shaders.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 
 OpenGLLegacyInterface::OpenGLLegacyInterface()
     : Graphics(),
@@ -59,10 +62,22 @@ OpenGLLegacyInterface::OpenGLLegacyInterface()
 
     // initialize the state cache
     OpenGLStateCache::initialize();
+
+    if(cv::r_stream_buffer_size.getInt() > 0 && OpenGLStreamBuffer::isSupported()) {
+        const size_t size = static_cast<size_t>(cv::r_stream_buffer_size.getInt()) * 1024 * 1024;
+        this->streamBuffer = std::make_unique<OpenGLStreamBuffer>(size);
+        if(!this->streamBuffer->isReady()) this->streamBuffer.reset();
+    }
+    debugLog("OpenGLLegacyInterface: stream buffer {:s}\n", this->streamBuffer ? "enabled" : "disabled");
+}
+
+OpenGLLegacyInterface::~OpenGLLegacyInterface() {
+    if(this->iSpriteBatchBuffer != 0 && glDeleteBuffers != nullptr) glDeleteBuffers(1, &this->iSpriteBatchBuffer);
 }
 
 void OpenGLLegacyInterface::beginScene() {
     this->bInScene = true;
+    this->stats = {};
 
     Matrix4 defaultProjectionMatrix =
         Camera::buildMatrixOrtho2D(0, this->vResolution.x, this->vResolution.y, 0, -1.0f, 1.0f);
@@ -85,6 +100,18 @@ void OpenGLLegacyInterface::beginScene() {
 }
 
 void OpenGLLegacyInterface::endScene() {
+    this->flushBatch();
+
+    if(this->streamBuffer) {
+        this->streamBuffer->endFrame();
+
+        const StreamBuffer::Stats &streamStats = this->streamBuffer->getLastFrameStats();
+        this->stats.streamedBytes = streamStats.bytesAllocated;
+        this->stats.streamStalls = streamStats.stalls;
+        this->stats.streamWraparounds = streamStats.wraparounds;
+        this->stats.streamOverflows = streamStats.overflows;
+    }
+
     popTransform();
 
 #ifdef _DEBUG
@@ -98,9 +125,13 @@ void OpenGLLegacyInterface::endScene() {
 #endif
 
     this->bInScene = false;
+    this->lastFrameStats = this->stats;
 }
 
-void OpenGLLegacyInterface::clearDepthBuffer() { glClear(GL_DEPTH_BUFFER_BIT); }
+void OpenGLLegacyInterface::clearDepthBuffer() {
+    this->flushBatch();
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
 
 void OpenGLLegacyInterface::setColor(Color color) {
     if(color == this->color) return;
@@ -112,12 +143,15 @@ void OpenGLLegacyInterface::setColor(Color color) {
 
 void OpenGLLegacyInterface::drawPixels(int x, int y, int width, int height, Graphics::DRAWPIXELS_TYPE type,
                                        const void *pixels) {
+    this->beginDraw();
+
     glRasterPos2i(x, y + height);  // '+height' because of opengl bottom left origin, but engine top left origin
     glDrawPixels(width, height, GL_RGBA,
                  (type == Graphics::DRAWPIXELS_TYPE::DRAWPIXELS_UBYTE ? GL_UNSIGNED_BYTE : GL_FLOAT), pixels);
 }
 
 void OpenGLLegacyInterface::drawPixel(int x, int y) {
+    this->beginDraw();
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -130,6 +164,7 @@ void OpenGLLegacyInterface::drawPixel(int x, int y) {
 }
 
 void OpenGLLegacyInterface::drawLinef(float x1, float y1, float x2, float y2) {
+    this->beginDraw();
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -144,6 +179,7 @@ void OpenGLLegacyInterface::drawLinef(float x1, float y1, float x2, float y2) {
 
 void OpenGLLegacyInterface::drawRectf(float x, float y, float width, float height, bool withColor, Color top,
                                       Color right, Color bottom, Color left) {
+    this->beginDraw();
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -175,6 +211,7 @@ void OpenGLLegacyInterface::drawRectf(float x, float y, float width, float heigh
 }
 
 void OpenGLLegacyInterface::fillRectf(float x, float y, float width, float height) {
+    this->beginDraw();
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -190,6 +227,8 @@ void OpenGLLegacyInterface::fillRectf(float x, float y, float width, float heigh
 }
 
 void OpenGLLegacyInterface::fillRoundedRect(int x, int y, int width, int height, int radius) {
+    this->beginDraw();
+
     float xOffset = x + radius;
     float yOffset = y + radius;
 
@@ -230,6 +269,7 @@ void OpenGLLegacyInterface::fillRoundedRect(int x, int y, int width, int height,
 
 void OpenGLLegacyInterface::fillGradient(int x, int y, int width, int height, Color topLeftColor, Color topRightColor,
                                          Color bottomLeftColor, Color bottomRightColor) {
+    this->beginDraw();
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -252,6 +292,7 @@ void OpenGLLegacyInterface::fillGradient(int x, int y, int width, int height, Co
 }
 
 void OpenGLLegacyInterface::drawQuad(int x, int y, int width, int height) {
+    this->beginDraw();
     updateTransform();
 
     const int left = x;
@@ -279,6 +320,7 @@ void OpenGLLegacyInterface::drawQuad(int x, int y, int width, int height) {
 
 void OpenGLLegacyInterface::drawQuad(vec2 topLeft, vec2 topRight, vec2 bottomRight, vec2 bottomLeft, Color topLeftColor,
                                      Color topRightColor, Color bottomRightColor, Color bottomLeftColor) {
+    this->beginDraw();
     updateTransform();
 
     glBegin(GL_QUADS);
@@ -358,6 +400,16 @@ void OpenGLLegacyInterface::drawImage(Image *image, AnchorPoint anchor, float ed
             abort();
     }
 
+    if(this->canBatchImage(smoothedEdges, clipRectSpecified)) {
+        this->spriteBatch.addQuad(static_cast<OpenGLImage *>(image)->getTextureId(), this->worldMatrix, vec2{x, y},
+                                  vec2{x + width, y + height}, this->color);
+        this->stats.batchedSprites++;
+        return;
+    }
+
+    this->beginDraw();
+    this->stats.stateChanges++;  // image->bind()
+
     if(smoothedEdges && !clipRectSpecified) {
         // set a default clip rect as the exact image size if one wasn't explicitly passed, but we still want smoothing
         clipRect = McRect{x, y, width, height};
@@ -414,6 +466,27 @@ void OpenGLLegacyInterface::drawImage(Image *image, AnchorPoint anchor, float ed
 void OpenGLLegacyInterface::drawString(McFont *font, const UString &text) {
     if(font == nullptr || text.length() < 1 || !font->isReady()) return;
 
+    this->flushBatch();
+    this->stats.stateChanges++;  // atlas bind, the draw call itself is counted in drawVAO()
+
+    updateTransform();
+
+    if(cv::r_debug_flush_drawstring.getBool()) {
+        glFinish();
+        glFlush();
+        glFinish();
+        glFlush();
+    }
+
+    font->drawString(text);
+}
+
+void OpenGLLegacyInterface::drawString(McFont *font, const Utf8String &text) {
+    if(font == nullptr || text.length() < 1 || !font->isReady()) return;
+
+    this->flushBatch();
+    this->stats.stateChanges++;
+
     updateTransform();
 
     if(cv::r_debug_flush_drawstring.getBool()) {
@@ -429,6 +502,7 @@ void OpenGLLegacyInterface::drawString(McFont *font, const UString &text) {
 void OpenGLLegacyInterface::drawVAO(VertexArrayObject *vao) {
     if(vao == nullptr) return;
 
+    this->beginDraw();
     updateTransform();
 
     // HACKHACK: disable texturing for special primitives, also for untextured vaos
@@ -442,6 +516,9 @@ void OpenGLLegacyInterface::drawVAO(VertexArrayObject *vao) {
         return;
     }
 
+    // otherwise it's per-frame geometry, which goes through the stream buffer if possible (immediate mode if not)
+    if(this->drawStreamedVAO(vao)) return;
+
     const std::vector<vec3> &vertices = vao->getVertices();
     const std::vector<vec3> &normals = vao->getNormals();
     const std::vector<std::vector<vec2>> &texcoords = vao->getTexcoords();
@@ -464,6 +541,8 @@ void OpenGLLegacyInterface::drawVAO(VertexArrayObject *vao) {
 
 void OpenGLLegacyInterface::setClipRect(McRect clipRect) {
     if(cv::r_debug_disable_cliprect.getBool()) return;
+
+    this->beginStateChange();
     // if (m_bIs3DScene) return; // TODO
 
     // rendertargets change the current viewport
@@ -498,6 +577,8 @@ void OpenGLLegacyInterface::popClipRect() {
 }
 
 void OpenGLLegacyInterface::pushStencil() {
+    this->beginStateChange();
+
     // init and clear
     glClearStencil(0);
     glClear(GL_STENCIL_BUFFER_BIT);
@@ -510,14 +591,20 @@ void OpenGLLegacyInterface::pushStencil() {
 }
 
 void OpenGLLegacyInterface::fillStencil(bool inside) {
+    this->beginStateChange();
+
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     glStencilFunc(GL_NOTEQUAL, inside ? 0 : 1, 1);
     glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 }
 
-void OpenGLLegacyInterface::popStencil() { glDisable(GL_STENCIL_TEST); }
+void OpenGLLegacyInterface::popStencil() {
+    this->beginStateChange();
+    glDisable(GL_STENCIL_TEST);
+}
 
 void OpenGLLegacyInterface::setClipping(bool enabled) {
+    this->beginStateChange();
     if(enabled) {
         if(this->clipRectStack.size() > 0) glEnable(GL_SCISSOR_TEST);
     } else
@@ -525,6 +612,7 @@ void OpenGLLegacyInterface::setClipping(bool enabled) {
 }
 
 void OpenGLLegacyInterface::setAlphaTesting(bool enabled) {
+    this->beginStateChange();
     if(enabled)
         glEnable(GL_ALPHA_TEST);
     else
@@ -532,10 +620,12 @@ void OpenGLLegacyInterface::setAlphaTesting(bool enabled) {
 }
 
 void OpenGLLegacyInterface::setAlphaTestFunc(COMPARE_FUNC alphaFunc, float ref) {
+    this->beginStateChange();
     glAlphaFunc(SDLGLInterface::compareFuncToOpenGLMap[alphaFunc], ref);
 }
 
 void OpenGLLegacyInterface::setBlending(bool enabled) {
+    this->beginStateChange();
     if(enabled)
         glEnable(GL_BLEND);
     else
@@ -543,6 +633,7 @@ void OpenGLLegacyInterface::setBlending(bool enabled) {
 }
 
 void OpenGLLegacyInterface::setBlendMode(BLEND_MODE blendMode) {
+    this->beginStateChange();
     switch(blendMode) {
         case BLEND_MODE::BLEND_MODE_ALPHA:
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -560,6 +651,7 @@ void OpenGLLegacyInterface::setBlendMode(BLEND_MODE blendMode) {
 }
 
 void OpenGLLegacyInterface::setDepthBuffer(bool enabled) {
+    this->beginStateChange();
     if(enabled)
         glEnable(GL_DEPTH_TEST);
     else
@@ -567,15 +659,20 @@ void OpenGLLegacyInterface::setDepthBuffer(bool enabled) {
 }
 
 void OpenGLLegacyInterface::setDepthWriting(bool enabled) {
+    this->beginStateChange();
     if(enabled)
         glDepthMask(GL_TRUE);
     else
         glDepthMask(GL_FALSE);
 }
 
-void OpenGLLegacyInterface::setColorWriting(bool r, bool g, bool b, bool a) { glColorMask(r, g, b, a); }
+void OpenGLLegacyInterface::setColorWriting(bool r, bool g, bool b, bool a) {
+    this->beginStateChange();
+    glColorMask(r, g, b, a);
+}
 
 void OpenGLLegacyInterface::setCulling(bool culling) {
+    this->beginStateChange();
     if(culling)
         glEnable(GL_CULL_FACE);
     else
@@ -583,6 +680,7 @@ void OpenGLLegacyInterface::setCulling(bool culling) {
 }
 
 void OpenGLLegacyInterface::setAntialiasing(bool aa) {
+    this->beginStateChange();
     this->bAntiAliasing = aa;
     if(aa)
         glEnable(GL_MULTISAMPLE);
@@ -591,17 +689,88 @@ void OpenGLLegacyInterface::setAntialiasing(bool aa) {
 }
 
 void OpenGLLegacyInterface::setWireframe(bool enabled) {
+    this->beginStateChange();
     if(enabled)
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     else
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 }
 
-void OpenGLLegacyInterface::setLineWidth(float width) { glLineWidth(width); }
+void OpenGLLegacyInterface::setLineWidth(float width) {
+    this->beginStateChange();
+    glLineWidth(width);
+}
 
-void OpenGLLegacyInterface::flush() { glFlush(); }
+void OpenGLLegacyInterface::flush() {
+    this->flushBatch();
+    glFlush();
+}
+
+void OpenGLLegacyInterface::flushBatch() {
+    if(this->spriteBatch.empty()) return;
+
+    const std::vector<SpriteBatch::Vertex> &vertices = this->spriteBatch.getVertices();
+    const size_t size = sizeof(SpriteBatch::Vertex) * vertices.size();
+
+    const StreamBuffer::Allocation allocation =
+        this->streamBuffer ? this->streamBuffer->allocate(size) : StreamBuffer::Allocation{};
+    if(allocation.data != nullptr) {
+        memcpy(allocation.data, vertices.data(), size);
+        glBindBuffer(GL_ARRAY_BUFFER, this->streamBuffer->getBuffer());
+    } else {
+        if(this->iSpriteBatchBuffer == 0) glGenBuffers(1, &this->iSpriteBatchBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, this->iSpriteBatchBuffer);
+
+        // orphan the previous storage instead of waiting for the gpu to be done with it
+        this->iSpriteBatchBufferSize = std::max(this->iSpriteBatchBufferSize, size);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(this->iSpriteBatchBufferSize), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), vertices.data());
+    }
+    const size_t base = allocation.offset;  // 0 for the fallback buffer
+
+    // NOTE: GL_VERTEX_ARRAY has to stay enabled afterwards (see OpenGLVertexArrayObject)
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(SpriteBatch::Vertex),
+                    reinterpret_cast<const void *>(base + offsetof(SpriteBatch::Vertex, pos)));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(SpriteBatch::Vertex),
+                      reinterpret_cast<const void *>(base + offsetof(SpriteBatch::Vertex, texcoord)));
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(SpriteBatch::Vertex),
+                   reinterpret_cast<const void *>(base + offsetof(SpriteBatch::Vertex, color)));
+
+    // the vertices are already in world space
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glActiveTexture(GL_TEXTURE0);
+    glEnable(GL_TEXTURE_2D);
+    for(const SpriteBatch::Run &run : this->spriteBatch.getRuns()) {
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(run.texture));
+        glDrawArrays(GL_QUADS, static_cast<GLint>(run.firstVertex), static_cast<GLsizei>(run.numVertices));
+
+        this->stats.stateChanges++;
+        this->stats.drawCalls++;
+    }
+    if(cv::r_image_unbind_after_drawimage.getBool()) glBindTexture(GL_TEXTURE_2D, 0);
+
+    glPopMatrix();
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // the current color is undefined after drawing with a color array
+    glColor4ub(this->color.R(), this->color.G(), this->color.B(), this->color.A());
+
+    this->stats.batchFlushes++;
+    this->spriteBatch.clear();
+}
 
 std::vector<u8> OpenGLLegacyInterface::getScreenshot(bool withAlpha) {
+    this->flushBatch();
+
     std::vector<u8> result;
     i32 width = this->vResolution.x;
     i32 height = this->vResolution.y;
@@ -641,6 +810,8 @@ std::vector<u8> OpenGLLegacyInterface::getScreenshot(bool withAlpha) {
 }
 
 void OpenGLLegacyInterface::onResolutionChange(vec2 newResolution) {
+    this->flushBatch();
+
     // rebuild viewport
     this->vResolution = newResolution;
     glViewport(0, 0, this->vResolution.x, this->vResolution.y);
@@ -684,6 +855,10 @@ VertexArrayObject *OpenGLLegacyInterface::createVertexArrayObject(Graphics::PRIM
 }
 
 void OpenGLLegacyInterface::onTransformUpdate(Matrix4 &projectionMatrix, Matrix4 &worldMatrix) {
+    // batched sprites are only pre-transformed by the world matrix, the projection has to stay the same
+    if(projectionMatrix != this->loadedProjectionMatrix) this->flushBatch();
+    this->loadedProjectionMatrix = projectionMatrix;
+
     glMatrixMode(GL_PROJECTION);
     glLoadMatrixf(projectionMatrix.get());
 
@@ -691,6 +866,59 @@ void OpenGLLegacyInterface::onTransformUpdate(Matrix4 &projectionMatrix, Matrix4
     glLoadMatrixf(worldMatrix.get());
 }
 
+bool OpenGLLegacyInterface::drawStreamedVAO(VertexArrayObject *vao) {
+    if(!this->streamBuffer || cv::r_opengl_legacy_vao_use_vertex_array.getBool()) return false;
+
+    StreamBuffer::VAOLayout layout;
+    if(!StreamBuffer::getVAOLayout(*vao, layout)) return false;
+
+    const StreamBuffer::Allocation allocation = this->streamBuffer->allocate(layout.size);
+    if(allocation.data == nullptr) return false;
+
+    StreamBuffer::writeVAO(*vao, layout, allocation.data);
+
+    const auto offset = [&](size_t attributeOffset) {
+        return reinterpret_cast<const void *>(allocation.offset + attributeOffset);
+    };
+
+    glBindBuffer(GL_ARRAY_BUFFER, this->streamBuffer->getBuffer());
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, offset(0));
+    if(layout.hasTexcoords) {
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, GL_FLOAT, 0, offset(layout.texcoordOffset));
+    }
+    if(layout.hasColors) {
+        glEnableClientState(GL_COLOR_ARRAY);
+        glColorPointer(4, GL_UNSIGNED_BYTE, 0, offset(layout.colorOffset));
+    }
+    if(layout.hasNormals) {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(GL_FLOAT, 0, offset(layout.normalOffset));
+    }
+
+    glDrawArrays(SDLGLInterface::primitiveToOpenGLMap[vao->getPrimitive()], 0,
+                 static_cast<GLsizei>(layout.numVertices));
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if(layout.hasColors) {
+        // same end state as the immediate-mode path, which went through setColor() for every vertex
+        this->color = vao->getColors()[layout.numVertices - 1];
+        glColor4ub(this->color.R(), this->color.G(), this->color.B(), this->color.A());
+    }
+    return true;
+}
+
+bool OpenGLLegacyInterface::canBatchImage(bool smoothedEdges, bool clipRectSpecified) const {
+    // everything which needs per-image state (shaders, scissor, debug outlines) still draws immediately
+    return cv::r_batch_sprites.getBool() && !smoothedEdges && !clipRectSpecified && !cv::r_debug_drawimage.getBool() &&
+           !cv::r_opengl_legacy_vao_use_vertex_array.getBool() && OpenGLStateCache::getCurrentProgram() == 0;
+}
+
 void OpenGLLegacyInterface::initSmoothClipShader() {
     if(this->smoothClipShader != nullptr) return;
 
@@ -4,16 +4,18 @@
 #define LEGACYOPENGLINTERFACE_H
 
 #include "cbase.h"
+#include "SpriteBatch.h"
 
 #ifdef MCENGINE_FEATURE_OPENGL
 
 class Image;
+class OpenGLStreamBuffer;
 
 class OpenGLLegacyInterface : public Graphics {
 NOCOPY_NOMOVE(OpenGLLegacyInterface)
    public:
     OpenGLLegacyInterface();
-    ~OpenGLLegacyInterface() override = default;
+    ~OpenGLLegacyInterface() override;
 
     // scene
     void beginScene() override;
@@ -29,6 +31,7 @@ NOCOPY_NOMOVE(OpenGLLegacyInterface)
         Color newColor = this->color;
         this->setColor(newColor.setA(alpha));
     }
+    [[nodiscard]] inline Color getColor() const final { return this->color; }
 
     // 2d primitive drawing
     void drawPixels(int x, int y, int width, int height, Graphics::DRAWPIXELS_TYPE type, const void *pixels) final;
@@ -50,6 +53,7 @@ NOCOPY_NOMOVE(OpenGLLegacyInterface)
     void drawImage(Image *image, AnchorPoint anchor = AnchorPoint::CENTER, float edgeSoftness = 0.0f,
                    McRect clipRect = {}) final;
     void drawString(McFont *font, const UString &text) final;
+    void drawString(McFont *font, const Utf8String &text) final;
 
     // 3d type drawing
     void drawVAO(VertexArrayObject *vao) final;
@@ -80,6 +84,7 @@ NOCOPY_NOMOVE(OpenGLLegacyInterface)
 
     // renderer actions
     void flush() final;
+    void flushBatch() final;
     std::vector<u8> getScreenshot(bool withAlpha = false) final;
 
     // renderer info
@@ -106,6 +111,26 @@ NOCOPY_NOMOVE(OpenGLLegacyInterface)
     std::unique_ptr<Shader> smoothClipShader{nullptr};
     void initSmoothClipShader();
 
+    [[nodiscard]] bool canBatchImage(bool smoothedEdges, bool clipRectSpecified) const;
+    bool drawStreamedVAO(VertexArrayObject *vao);
+    inline void beginDraw() {
+        this->flushBatch();
+        this->stats.drawCalls++;
+    }
+    inline void beginStateChange() {
+        this->flushBatch();
+        this->stats.stateChanges++;
+    }
+
+    // sprite batching (drawImage)
+    SpriteBatch spriteBatch;
+    unsigned int iSpriteBatchBuffer{0};
+    size_t iSpriteBatchBufferSize{0};
+    Matrix4 loadedProjectionMatrix;
+
+    // per-frame geometry (unbaked vaos, sprite batches), nullptr if persistent mapping isn't supported
+    std::unique_ptr<OpenGLStreamBuffer> streamBuffer;
+
     // renderer
     bool bInScene{false};
     vec2 vResolution{0.f};
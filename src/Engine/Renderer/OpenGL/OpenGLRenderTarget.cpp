@@ -221,6 +221,9 @@ void OpenGLRenderTarget::destroy() {
 void OpenGLRenderTarget::enable() {
     if(!this->bReady) return;
 
+    // anything batched so far belongs to the previous framebuffer
+    g->flushBatch();
+
     // use the state cache instead of querying OpenGL directly
     this->iFrameBufferBackup = OpenGLStateCache::getCurrentFramebuffer();
     glBindFramebuffer(GL_FRAMEBUFFER, this->iFrameBuffer);
@@ -254,6 +257,8 @@ void OpenGLRenderTarget::enable() {
 void OpenGLRenderTarget::disable() {
     if(!this->bReady) return;
 
+    g->flushBatch();
+
     // if multisampled, blit content for multisampling into resolve texture
 #ifdef HAS_MULTISAMPLING
     if(isMultiSampled()) {
@@ -292,6 +297,8 @@ void OpenGLRenderTarget::disable() {
 void OpenGLRenderTarget::bind(unsigned int textureUnit) {
     if(!this->bReady) return;
 
+    g->flushBatch();
+
     this->iTextureUnitBackup = textureUnit;
 
     // switch texture units before enabling+binding
@@ -314,6 +321,8 @@ void OpenGLRenderTarget::bind(unsigned int textureUnit) {
 void OpenGLRenderTarget::unbind() {
     if(!this->bReady) return;
 
+    g->flushBatch();
+
     // restore texture unit (just in case) and set to no texture
     glActiveTexture(GL_TEXTURE0 + this->iTextureUnitBackup);
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -46,6 +46,9 @@ void OpenGLShader::destroy() {
 void OpenGLShader::enable() {
     if(!this->bReady) return;
 
+    // batched sprites were meant to be drawn without this shader
+    g->flushBatch();
+
     int currentProgram = OpenGLStateCache::getCurrentProgram();
     if(currentProgram == this->iProgram) return;  // already active
 
@@ -57,6 +60,8 @@ void OpenGLShader::enable() {
 void OpenGLShader::disable() {
     if(!this->bReady) return;
 
+    g->flushBatch();
+
     glUseProgramObjectARB(this->iProgramBackup);
 
     // update cache
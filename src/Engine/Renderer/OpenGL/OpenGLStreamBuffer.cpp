@@ -0,0 +1,75 @@
+#include "OpenGLStreamBuffer.h"
+
+#ifdef MCENGINE_FEATURE_OPENGL
+
+#include "ConVar.h"
+#include "Engine.h"
+#include "OpenGLHeaders.h"
+#include "OpenGLSync.h"
+
+namespace {  // static namespace
+constexpr GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+inline GLsync toSync(u64 fence) { return reinterpret_cast<GLsync>(static_cast<uintptr_t>(fence)); }
+}  // namespace
+
+bool OpenGLStreamBuffer::isSupported() {
+    // persistent mapping + fences (3.2)
+    return GLAD_GL_ARB_buffer_storage && glBufferStorage != nullptr &&
+           (GLVersion.major > 3 || (GLVersion.major == 3 && GLVersion.minor >= 2));
+}
+
+OpenGLStreamBuffer::OpenGLStreamBuffer(size_t size) {
+    if(!OpenGLStreamBuffer::isSupported()) return;
+
+    glGenBuffers(1, &this->iBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, this->iBuffer);
+    glBufferStorage(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), nullptr, MAP_FLAGS);
+    void *mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), MAP_FLAGS);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if(mapped == nullptr) {
+        debugLog("OpenGLStreamBuffer: failed to map {:d} bytes (error {:d}), falling back\n", size, glGetError());
+        glDeleteBuffers(1, &this->iBuffer);
+        this->iBuffer = 0;
+        return;
+    }
+
+    this->setStorage(static_cast<u8 *>(mapped), size);
+}
+
+OpenGLStreamBuffer::~OpenGLStreamBuffer() {
+    this->releaseFences();
+
+    if(this->iBuffer != 0 && glDeleteBuffers != nullptr) {
+        glBindBuffer(GL_ARRAY_BUFFER, this->iBuffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDeleteBuffers(1, &this->iBuffer);
+    }
+}
+
+u64 OpenGLStreamBuffer::createFence() {
+    return static_cast<u64>(reinterpret_cast<uintptr_t>(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)));
+}
+
+bool OpenGLStreamBuffer::isFenceSignaled(u64 fence) {
+    const auto result = OpenGLSync::waitForSyncObject(toSync(fence), 0);
+    return result == OpenGLSync::SYNC_ALREADY_SIGNALED || result == OpenGLSync::SYNC_GPU_COMPLETED;
+}
+
+void OpenGLStreamBuffer::waitFence(u64 fence) {
+    if(fence == 0) {
+        // creating the fence failed, so there's nothing more specific to wait for
+        glFinish();
+        return;
+    }
+
+    // r_sync_timeout is in microseconds, glClientWaitSync() wants nanoseconds
+    const auto result = OpenGLSync::waitForSyncObject(toSync(fence), cv::r_sync_timeout.getVal<u64>() * 1000);
+    if(result == OpenGLSync::SYNC_TIMEOUT_EXPIRED || result == OpenGLSync::SYNC_WAIT_FAILED) glFinish();
+}
+
+void OpenGLStreamBuffer::deleteFence(u64 fence) { OpenGLSync::deleteSyncObject(toSync(fence)); }
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "StreamBuffer.h"
+
+#ifdef MCENGINE_FEATURE_OPENGL
+
+// StreamBuffer backed by a persistently mapped GL buffer (ARB_buffer_storage) and sync objects (see OpenGLSync)
+class OpenGLStreamBuffer final : public StreamBuffer {
+    NOCOPY_NOMOVE(OpenGLStreamBuffer)
+   public:
+    static bool isSupported();
+
+    OpenGLStreamBuffer(size_t size);  // check isReady(), mapping can fail
+    ~OpenGLStreamBuffer() override;
+
+    [[nodiscard]] inline unsigned int getBuffer() const { return this->iBuffer; }
+
+   protected:
+    u64 createFence() override;
+    bool isFenceSignaled(u64 fence) override;
+    void waitFence(u64 fence) override;
+    void deleteFence(u64 fence) override;
+
+   private:
+    unsigned int iBuffer{0};
+};
+
+#endif
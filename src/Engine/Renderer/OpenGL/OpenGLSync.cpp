@@ -118,7 +118,8 @@ void OpenGLSync::manageFrameSyncQueue(bool forceWait) {
             debugLog("Waiting for frame {:d} to complete (frames in flight: {:d}/{:d})\n", oldestSync.frameNumber,
                      this->frameSyncQueue.size(), this->iMaxFramesInFlight);
 
-        SYNC_RESULT result = this->waitForSyncObject(oldestSync.syncObject, cv::r_sync_timeout.getInt());
+        const u64 timeoutUS = cv::r_sync_timeout.getVal<u64>();
+        SYNC_RESULT result = this->waitForSyncObject(oldestSync.syncObject, timeoutUS * 1000);
 
         if(debug) {
             switch(result) {
@@ -133,7 +134,7 @@ void OpenGLSync::manageFrameSyncQueue(bool forceWait) {
                     break;
                 case SYNC_TIMEOUT_EXPIRED:
                     debugLog("Frame {:d} sync object timed out after {:d} microseconds\n", oldestSync.frameNumber,
-                             cv::r_sync_timeout.getInt());
+                             timeoutUS);
                     break;
                 case SYNC_WAIT_FAILED:
                     debugLog("Frame {:d} sync wait failed\n", oldestSync.frameNumber);
@@ -19,7 +19,6 @@ NOCOPY_NOMOVE(OpenGLSync)
     void begin();  // call at the beginning of beginScene()
     void end();    // call in endScene()
 
-   private:
     enum SYNC_RESULT : uint8_t {
         SYNC_OBJECT_NOT_READY,  // sync object not created or already signaled
         SYNC_ALREADY_SIGNALED,  // GPU already done with the work
@@ -28,9 +27,12 @@ NOCOPY_NOMOVE(OpenGLSync)
         SYNC_GPU_COMPLETED      // GPU just completed the work during this wait
     };
 
-    SYNC_RESULT waitForSyncObject(GLsync syncObject,
-                                  uint64_t timeoutNs);  // wait for a specific sync object to be reached
-    void deleteSyncObject(GLsync syncObject);           // delete a sync object
+    // also used for other fences (OpenGLStreamBuffer)
+    static SYNC_RESULT waitForSyncObject(GLsync syncObject,
+                                         uint64_t timeoutNs);  // wait for a specific sync object to be reached
+    static void deleteSyncObject(GLsync syncObject);           // delete a sync object
+
+   private:
     void setMaxFramesInFlight(int maxFrames);           // set maximum frames in flight (default: 2)
     // get current maximum frames in flight
     [[nodiscard]] int getMaxFramesInFlight() const { return this->iMaxFramesInFlight; }
@@ -0,0 +1,21 @@
+#include "SpriteBatch.h"
+
+void SpriteBatch::addQuad(u64 texture, const Matrix4 &worldMatrix, vec2 topLeft, vec2 bottomRight, Color color) {
+    const u32 firstVertex = static_cast<u32>(this->vertices.size());
+    if(this->runs.empty() || this->runs.back().texture != texture)
+        this->runs.push_back(Run{.texture = texture, .firstVertex = firstVertex, .numVertices = 0});
+    this->runs.back().numVertices += 4;
+
+    // same winding and texcoords as the immediate-mode path
+    const u32 rgba = abgr(color);
+    this->vertices.push_back(Vertex{worldMatrix * vec3{topLeft.x, topLeft.y, 0.f}, vec2{0.f, 0.f}, rgba});
+    this->vertices.push_back(Vertex{worldMatrix * vec3{topLeft.x, bottomRight.y, 0.f}, vec2{0.f, 1.f}, rgba});
+    this->vertices.push_back(Vertex{worldMatrix * vec3{bottomRight.x, bottomRight.y, 0.f}, vec2{1.f, 1.f}, rgba});
+    this->vertices.push_back(Vertex{worldMatrix * vec3{bottomRight.x, topLeft.y, 0.f}, vec2{1.f, 0.f}, rgba});
+}
+
+void SpriteBatch::clear() {
+    // keeps the capacity, the next frame will need about as much
+    this->vertices.clear();
+    this->runs.clear();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "types.h"
+#include "Color.h"
+#include "Matrices.h"
+#include "Vectors.h"
+
+#include <vector>
+
+// collects textured quads (drawImage()) on the cpu, so that a backend can draw all of them with one buffer upload
+// and one draw call per texture, instead of one immediate-mode draw per image.
+// vertices are already transformed by the world matrix they were added with, so a batch can span any number of
+// push/popTransform()s. everything else (projection, blend mode, clipping, shaders, ...) has to stay the same for the
+// whole batch, backends flush it before changing any of that
+class SpriteBatch {
+   public:
+    struct Vertex {
+        vec3 pos;
+        vec2 texcoord;
+        u32 color;  // RGBA byte order (abgr()), for GL_UNSIGNED_BYTE color arrays
+    };
+
+    // consecutive quads using the same texture
+    struct Run {
+        u64 texture;  // backend texture handle
+        u32 firstVertex;
+        u32 numVertices;
+    };
+
+    void addQuad(u64 texture, const Matrix4 &worldMatrix, vec2 topLeft, vec2 bottomRight, Color color);
+    void clear();
+
+    [[nodiscard]] inline bool empty() const { return this->runs.empty(); }
+    [[nodiscard]] inline size_t getNumQuads() const { return this->vertices.size() / 4; }
+    [[nodiscard]] inline const std::vector<Vertex> &getVertices() const { return this->vertices; }
+    [[nodiscard]] inline const std::vector<Run> &getRuns() const { return this->runs; }
+
+   private:
+    std::vector<Vertex> vertices;
+    std::vector<Run> runs;
+};
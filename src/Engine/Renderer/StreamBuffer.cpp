@@ -0,0 +1,123 @@
+#include "StreamBuffer.h"
+
+#include "VertexArrayObject.h"
+
+#include <cstring>
+
+bool StreamBuffer::getVAOLayout(const VertexArrayObject &vao, VAOLayout &layout) {
+    const auto &vertices = vao.getVertices();
+    const auto &texcoords = vao.getTexcoords();
+    const auto &colors = vao.getColors();
+    const auto &normals = vao.getNormals();
+
+    const size_t numVertices = vertices.size();
+    if(numVertices == 0 || texcoords.size() > 1) return false;
+
+    layout = VAOLayout{.numVertices = numVertices};
+    layout.hasTexcoords = !texcoords.empty() && !texcoords[0].empty();
+    layout.hasColors = !colors.empty();
+    layout.hasNormals = !normals.empty();
+
+    if((layout.hasTexcoords && texcoords[0].size() < numVertices) ||
+       (layout.hasColors && colors.size() < numVertices) || (layout.hasNormals && normals.size() < numVertices))
+        return false;
+
+    layout.size = sizeof(vec3) * numVertices;
+    if(layout.hasTexcoords) {
+        layout.texcoordOffset = layout.size;
+        layout.size += sizeof(vec2) * numVertices;
+    }
+    if(layout.hasColors) {
+        layout.colorOffset = layout.size;
+        layout.size += sizeof(Color) * numVertices;
+    }
+    if(layout.hasNormals) {
+        layout.normalOffset = layout.size;
+        layout.size += sizeof(vec3) * numVertices;
+    }
+    return true;
+}
+
+void StreamBuffer::writeVAO(const VertexArrayObject &vao, const VAOLayout &layout, u8 *data) {
+    const size_t n = layout.numVertices;
+
+    memcpy(data, vao.getVertices().data(), sizeof(vec3) * n);
+    if(layout.hasTexcoords) memcpy(data + layout.texcoordOffset, vao.getTexcoords()[0].data(), sizeof(vec2) * n);
+    if(layout.hasColors) {
+        const auto &colors = vao.getColors();
+        auto *out = reinterpret_cast<Color *>(data + layout.colorOffset);
+        for(size_t i = 0; i < n; i++) {
+            out[i] = abgr(colors[i]);
+        }
+    }
+    if(layout.hasNormals) memcpy(data + layout.normalOffset, vao.getNormals().data(), sizeof(vec3) * n);
+}
+
+StreamBuffer::Allocation StreamBuffer::allocate(size_t size, size_t alignment) {
+    if(this->mapped == nullptr || size == 0) return {};
+    if(size > this->iSize) {
+        this->stats.overflows++;
+        return {};
+    }
+
+    u64 start = (this->iHead + alignment - 1) / alignment * alignment;
+    const bool wrap = (start % this->iSize) + size > this->iSize;
+    if(wrap) start = (start / this->iSize + 1) * this->iSize;  // doesn't fit before the end, skip the tail
+
+    // the gpu has to be done with whatever was in this range one lap ago
+    while(start + size > this->iRetired + this->iSize) {
+        if(this->framesInFlight.empty()) {
+            // this frame alone would already fill the whole buffer
+            this->stats.overflows++;
+            return {};
+        }
+
+        if(!this->isFenceSignaled(this->framesInFlight.front().fence)) {
+            this->stats.stalls++;
+            this->waitFence(this->framesInFlight.front().fence);
+        }
+        this->retireOldestFrame();
+    }
+
+    if(wrap) this->stats.wraparounds++;
+    this->stats.bytesAllocated += start + size - this->iHead;
+    this->stats.allocations++;
+    this->iHead = start + size;
+
+    const size_t offset = start % this->iSize;
+    return Allocation{.data = this->mapped + offset, .offset = offset};
+}
+
+void StreamBuffer::endFrame() {
+    if(this->iHead != this->iFrameStart) {
+        this->framesInFlight.push_back(Frame{.fence = this->createFence(), .end = this->iHead});
+        this->iFrameStart = this->iHead;
+    }
+
+    // don't let finished frames pile up if the buffer is big enough to rarely need them
+    while(!this->framesInFlight.empty() && this->isFenceSignaled(this->framesInFlight.front().fence)) {
+        this->retireOldestFrame();
+    }
+
+    this->lastFrameStats = this->stats;
+    this->stats = {};
+}
+
+void StreamBuffer::setStorage(u8 *mapped, size_t size) {
+    this->iSize = size - size % SIZE_GRANULARITY;
+    this->mapped = this->iSize > 0 ? mapped : nullptr;
+}
+
+void StreamBuffer::releaseFences() {
+    for(const Frame &frame : this->framesInFlight) {
+        this->deleteFence(frame.fence);
+    }
+    this->framesInFlight.clear();
+}
+
+void StreamBuffer::retireOldestFrame() {
+    const Frame &oldest = this->framesInFlight.front();
+    this->deleteFence(oldest.fence);
+    this->iRetired = oldest.end;
+    this->framesInFlight.pop_front();
+}
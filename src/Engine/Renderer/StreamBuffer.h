@@ -0,0 +1,94 @@
+#pragma once
+
+#include "noinclude.h"
+#include "types.h"
+
+#include <deque>
+
+class VertexArrayObject;
+
+// ring allocator for geometry which only lives for one frame (unbaked VertexArrayObjects, batched sprites), inside
+// one big buffer which stays mapped the whole time. sized for about three frames, so that the cpu can keep writing
+// while the gpu is still reading the previous ones; every frame is fenced in endFrame(), and allocate() only waits
+// for a fence if it's about to overwrite something the gpu might not have read yet.
+// the backend provides the memory and the fences, this class is api independent (see NullGraphicsInterface)
+class StreamBuffer {
+    NOCOPY_NOMOVE(StreamBuffer)
+   public:
+    struct Stats {
+        u64 bytesAllocated{0};  // including alignment padding and the skipped tail on wraparounds
+        u32 allocations{0};
+        u32 stalls{0};       // times allocate() had to wait for the gpu
+        u32 wraparounds{0};  // times allocate() continued at the start of the buffer
+        u32 overflows{0};    // allocations which didn't fit at all (the caller has to fall back)
+    };
+
+    struct Allocation {
+        u8 *data{nullptr};  // nullptr if it didn't fit
+        size_t offset{0};   // into the backend buffer
+    };
+
+    // where the attributes of an unbaked VertexArrayObject go in one streamed allocation (offsets from its start)
+    struct VAOLayout {
+        size_t numVertices{0};
+        size_t texcoordOffset{0};
+        size_t colorOffset{0};
+        size_t normalOffset{0};
+        size_t size{0};
+        bool hasTexcoords{false};
+        bool hasColors{false};
+        bool hasNormals{false};
+    };
+
+    // false if the vao can't be drawn from arrays: the immediate-mode path keeps using the last color/texcoord/normal
+    // for vertices which don't have their own, and arrays can't do that. multiple texture units aren't handled either
+    static bool getVAOLayout(const VertexArrayObject &vao, VAOLayout &layout);
+    // copies the vao into a getVAOLayout() sized allocation (colors converted to RGBA byte order)
+    static void writeVAO(const VertexArrayObject &vao, const VAOLayout &layout, u8 *data);
+
+    StreamBuffer() = default;
+    virtual ~StreamBuffer() = default;
+
+    [[nodiscard]] Allocation allocate(size_t size, size_t alignment = 16);
+
+    // fences everything allocated since the last call, call once per frame after the last draw
+    void endFrame();
+
+    [[nodiscard]] inline bool isReady() const { return this->mapped != nullptr; }
+    [[nodiscard]] inline size_t getSize() const { return this->iSize; }
+    [[nodiscard]] inline const Stats &getLastFrameStats() const { return this->lastFrameStats; }
+
+   protected:
+    static constexpr const size_t SIZE_GRANULARITY{256};  // physical offsets keep the alignment of virtual ones
+
+    // backend interface. fences are opaque handles, 0 is never a valid one
+    virtual u64 createFence() = 0;
+    virtual bool isFenceSignaled(u64 fence) = 0;
+    virtual void waitFence(u64 fence) = 0;
+    virtual void deleteFence(u64 fence) = 0;
+
+    void setStorage(u8 *mapped, size_t size);
+    void releaseFences();  // has to be called by backend destructors, the virtuals are gone in ours
+
+   private:
+    struct Frame {
+        u64 fence;
+        u64 end;  // virtual position after the last allocation of the frame
+    };
+
+    void retireOldestFrame();
+
+    std::deque<Frame> framesInFlight;
+
+    // positions are virtual (only ever increase), the physical offset is position % size. so everything before
+    // retired + size is free to overwrite
+    u64 iHead{0};
+    u64 iFrameStart{0};
+    u64 iRetired{0};
+
+    u8 *mapped{nullptr};
+    size_t iSize{0};
+
+    Stats stats;
+    Stats lastFrameStats;
+};
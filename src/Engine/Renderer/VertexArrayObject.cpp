@@ -27,17 +27,18 @@ void VertexArrayObject::initAsync() { this->bAsyncReady = true; }
 
 void VertexArrayObject::destroy() {
     this->clear();
+    this->texcoords.clear();
 
     this->iNumVertices = 0;
     this->bHasTexcoords = false;
 }
 
 void VertexArrayObject::clear() {
+    // keep the capacity around, dynamic VAOs are usually refilled every frame with a similar amount of vertices
     this->vertices.clear();
     for(auto& texcoord : this->texcoords) {
         texcoord.clear();
     }
-    this->texcoords.clear();
     this->normals.clear();
     this->colors.clear();
 
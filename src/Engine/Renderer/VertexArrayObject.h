@@ -2,6 +2,8 @@
 #ifndef VERTEXARRAYOBJECT_H
 #define VERTEXARRAYOBJECT_H
 
+#include <cassert>
+
 #include "Resource.h"
 #include "Graphics.h"
 
@@ -6,6 +6,7 @@
 
 #include "ConVar.h"
 #include "Engine.h"
+#include "Profiler.h"
 #include "Thread.h"
 
 using namespace std::chrono_literals;
@@ -77,7 +78,10 @@ class AsyncResourceLoader::LoaderThread final {
             // prevent child threads from inheriting the name
             McThread::set_current_thread_name(fmt::format("res_{}", work->workId).c_str());
 
-            resource->loadAsync();
+            {
+                VPROF_ZONE("Resource::loadAsync");
+                resource->loadAsync();
+            }
 
             // restore loader thread name
             McThread::set_current_thread_name(loaderThreadName.c_str());
@@ -143,8 +147,8 @@ void AsyncResourceLoader::shutdown() {
     // cleanup remaining work items
     {
         std::scoped_lock lock(this->workQueueMutex);
-        while(!this->pendingWork.empty()) {
-            this->pendingWork.pop();
+        for(auto &lane : this->pendingWork) {
+            lane.clear();
         }
         while(!this->asyncCompleteWork.empty()) {
             this->asyncCompleteWork.pop();
@@ -164,8 +168,8 @@ void AsyncResourceLoader::shutdown() {
     this->asyncDestroyQueue.clear();
 }
 
-void AsyncResourceLoader::requestAsyncLoad(Resource *resource) {
-    auto work = std::make_unique<LoadingWork>(resource, this->iWorkIdCounter.fetch_add(1));
+void AsyncResourceLoader::requestAsyncLoad(Resource *resource, LoadPriority priority) {
+    auto work = std::make_unique<LoadingWork>(resource, this->iWorkIdCounter.fetch_add(1), priority);
 
     // add to tracking set
     {
@@ -176,7 +180,7 @@ void AsyncResourceLoader::requestAsyncLoad(Resource *resource) {
     // add to work queue
     {
         std::scoped_lock lock(this->workQueueMutex);
-        this->pendingWork.push(std::move(work));
+        this->pendingWork[static_cast<size_t>(priority)].push_back(std::move(work));
     }
 
     this->iActiveWorkCount.fetch_add(1);
@@ -295,6 +299,68 @@ void AsyncResourceLoader::reloadResources(const std::vector<Resource *> &resourc
     }
 }
 
+bool AsyncResourceLoader::cancelPendingWork(Resource *resource) {
+    std::vector<std::unique_ptr<LoadingWork>> cancelledWork;
+
+    {
+        std::scoped_lock lock(this->workQueueMutex);
+        for(size_t i = 0; i < NUM_PRIORITIES; i++) {
+            auto &lane = this->pendingWork[i];
+            const auto it =
+                std::ranges::find_if(lane, [resource](const auto &work) { return work->resource == resource; });
+            if(it == lane.end()) continue;
+
+            cancelledWork.push_back(std::move(*it));
+            lane.erase(it);
+            this->queueStats[i].numCancelled++;
+            break;  // a resource can only be queued once
+        }
+    }
+
+    if(cancelledWork.empty()) return false;
+
+    if(cv::debug_rm.getBool())
+        debugLog("AsyncResourceLoader: Cancelled pending load of {:8p} : {:s}\n", static_cast<const void *>(resource),
+                 resource->getName());
+
+    this->finishCancelledWork(cancelledWork);
+    return true;
+}
+
+void AsyncResourceLoader::boostPriority(Resource *resource) {
+    std::scoped_lock lock(this->workQueueMutex);
+
+    for(size_t i = 0; i < NUM_PRIORITIES; i++) {
+        auto &lane = this->pendingWork[i];
+        const auto it = std::ranges::find_if(lane, [resource](const auto &work) { return work->resource == resource; });
+        if(it == lane.end()) continue;
+
+        // already next in line
+        if(i == 0 && it == lane.begin()) return;
+
+        auto work = std::move(*it);
+        lane.erase(it);
+
+        if(cv::debug_rm.getBool())
+            debugLog("AsyncResourceLoader: Boosting priority of {:8p} : {:s} ({} -> {})\n",
+                     static_cast<const void *>(resource), resource->getName(), static_cast<int>(work->priority),
+                     static_cast<int>(LoadPriority::HIGH));
+
+        work->priority = LoadPriority::HIGH;
+        this->pendingWork[static_cast<size_t>(LoadPriority::HIGH)].push_front(std::move(work));
+        return;
+    }
+}
+
+AsyncResourceLoader::QueueStats AsyncResourceLoader::getQueueStats(LoadPriority priority) const {
+    const auto i = static_cast<size_t>(priority);
+
+    std::scoped_lock lock(this->workQueueMutex);
+    QueueStats stats = this->queueStats[i];
+    stats.depth = this->pendingWork[i].size();
+    return stats;
+}
+
 bool AsyncResourceLoader::isLoadingResource(Resource *resource) const {
     std::scoped_lock lock(this->loadingResourcesMutex);
     return this->loadingResourcesSet.find(resource) != this->loadingResourcesSet.end();
@@ -360,15 +426,61 @@ void AsyncResourceLoader::cleanupIdleThreads() {
 }
 
 std::unique_ptr<AsyncResourceLoader::LoadingWork> AsyncResourceLoader::getNextPendingWork() {
-    std::scoped_lock lock(this->workQueueMutex);
+    std::unique_ptr<LoadingWork> work;
+    std::vector<std::unique_ptr<LoadingWork>> cancelledWork;
+
+    {
+        std::scoped_lock lock(this->workQueueMutex);
 
-    if(this->pendingWork.empty()) return nullptr;
+        for(size_t i = 0; i < NUM_PRIORITIES && !work; i++) {
+            auto &lane = this->pendingWork[i];
+            auto &stats = this->queueStats[i];
+
+            while(!lane.empty()) {
+                auto next = std::move(lane.front());
+                lane.pop_front();
+
+                // don't bother starting loads which were interrupted while they were waiting in the queue
+                if(next->resource->isInterrupted()) {
+                    if(cv::debug_rm.getBool())
+                        debugLog("AsyncResourceLoader: Skipping interrupted {:8p} : {:s}\n",
+                                 static_cast<const void *>(next->resource), next->resource->getName());
+
+                    stats.numCancelled++;
+                    cancelledWork.push_back(std::move(next));
+                    continue;
+                }
+
+                const double waitMS =
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - next->requestTime)
+                        .count();
+                stats.avgWaitMS = (stats.numStarted == 0 ? waitMS : stats.avgWaitMS * 0.9 + waitMS * 0.1);
+                stats.lastWaitMS = waitMS;
+                stats.numStarted++;
+
+                work = std::move(next);
+                break;
+            }
+        }
+    }
+
+    // untrack after releasing the queue lock, to not nest it with loadingResourcesMutex
+    if(!cancelledWork.empty()) this->finishCancelledWork(cancelledWork);
 
-    auto work = std::move(this->pendingWork.front());
-    this->pendingWork.pop();
     return work;
 }
 
+void AsyncResourceLoader::finishCancelledWork(const std::vector<std::unique_ptr<LoadingWork>> &cancelledWork) {
+    {
+        std::scoped_lock lock(this->loadingResourcesMutex);
+        for(const auto &work : cancelledWork) {
+            this->loadingResourcesSet.erase(work->resource);
+        }
+    }
+
+    this->iActiveWorkCount.fetch_sub(cancelledWork.size());
+}
+
 void AsyncResourceLoader::markWorkAsyncComplete(std::unique_ptr<LoadingWork> work) {
     std::scoped_lock lock(this->workQueueMutex);
     this->asyncCompleteWork.push(std::move(work));
@@ -1,8 +1,10 @@
 #pragma once
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -23,11 +25,21 @@ class AsyncResourceLoader final {
     AsyncResourceLoader();
     ~AsyncResourceLoader();
 
+    static constexpr const size_t NUM_PRIORITIES{static_cast<size_t>(LoadPriority::COUNT)};
+
+    struct QueueStats {
+        size_t depth;      // currently pending
+        double avgWaitMS;  // time from request until a thread picked it up (moving average)
+        double lastWaitMS;
+        uint64_t numStarted;
+        uint64_t numCancelled;  // dropped before starting (interrupted/destroyed)
+    };
+
    private:
     // main interface for ResourceManager
     inline void resetMaxPerUpdate() { this->bMaxLoadsResetPending = true; }
     inline void setMaxPerUpdate(size_t num) { this->iLoadsPerUpdate = std::clamp<size_t>(num, 1, 512); }
-    void requestAsyncLoad(Resource *resource);
+    void requestAsyncLoad(Resource *resource, LoadPriority priority = LoadPriority::NORMAL);
     void update(bool lowLatency);
     void shutdown();
 
@@ -35,6 +47,13 @@ class AsyncResourceLoader final {
     void scheduleAsyncDestroy(Resource *resource);
     void reloadResources(const std::vector<Resource *> &resources);
 
+    // removes the work for the resource if no thread picked it up yet, returns true if it did
+    bool cancelPendingWork(Resource *resource);
+
+    // priority inheritance: the main thread is about to wait on this resource, so move its work (if still pending)
+    // to the front of the highest priority lane
+    void boostPriority(Resource *resource);
+
     // status queries
     [[nodiscard]] inline bool isLoading() const { return this->iActiveWorkCount.load() > 0; }
     [[nodiscard]] bool isLoadingResource(Resource *resource) const;
@@ -42,15 +61,19 @@ class AsyncResourceLoader final {
     [[nodiscard]] size_t getNumActiveThreads() const { return this->iActiveThreadCount.load(); }
     [[nodiscard]] inline size_t getNumLoadingWorkAsyncDestroy() const { return this->asyncDestroyQueue.size(); }
     [[nodiscard]] inline size_t getMaxPerUpdate() const { return this->iLoadsPerUpdate; }
+    [[nodiscard]] QueueStats getQueueStats(LoadPriority priority) const;
 
     enum class WorkState : uint8_t { PENDING = 0, ASYNC_IN_PROGRESS = 1, ASYNC_COMPLETE = 2, SYNC_COMPLETE = 3 };
 
     struct LoadingWork {
         Resource *resource;
         size_t workId;
+        LoadPriority priority;
+        std::chrono::steady_clock::time_point requestTime;
         std::atomic<WorkState> state{WorkState::PENDING};
 
-        LoadingWork(Resource *res, size_t id) : resource(res), workId(id) {}
+        LoadingWork(Resource *res, size_t id, LoadPriority prio)
+            : resource(res), workId(id), priority(prio), requestTime(std::chrono::steady_clock::now()) {}
     };
 
     class LoaderThread;
@@ -64,6 +87,7 @@ class AsyncResourceLoader final {
     std::unique_ptr<LoadingWork> getNextPendingWork();
     void markWorkAsyncComplete(std::unique_ptr<LoadingWork> work);
     std::unique_ptr<LoadingWork> getNextAsyncCompleteWork();
+    void finishCancelledWork(const std::vector<std::unique_ptr<LoadingWork>> &cancelledWork);
 
     // set during ctor, dependent on hardware
     size_t iMaxThreads;
@@ -90,11 +114,14 @@ class AsyncResourceLoader final {
     std::atomic<size_t> iTotalThreadsCreated{0};
 
     // separate queues for different work states (avoids O(n) scanning)
-    std::queue<std::unique_ptr<LoadingWork>> pendingWork;
+    // pending work has one FIFO lane per priority, threads always drain the highest non-empty lane first
+    std::array<std::deque<std::unique_ptr<LoadingWork>>, NUM_PRIORITIES> pendingWork;
     std::queue<std::unique_ptr<LoadingWork>> asyncCompleteWork;
 
     // single mutex for both work queues (they're accessed in sequence, not concurrently)
+    // also protects the queue stats
     mutable std::mutex workQueueMutex;
+    std::array<QueueStats, NUM_PRIORITIES> queueStats{};
 
     // fast lookup for checking if a resource is being loaded
     std::unordered_set<Resource *> loadingResourcesSet;
@@ -16,6 +16,15 @@ class Shader;
 class VertexArrayObject;
 class RenderTarget;
 
+// async load scheduling class, lower value = picked up first
+enum class LoadPriority : uint8_t
+{
+	HIGH,	// needed for gameplay/the current screen (skin elements, sounds)
+	NORMAL, // default
+	LOW,	// speculative or cosmetic (thumbnails, avatars)
+	COUNT
+};
+
 class Resource
 {
 	NOCOPY_NOMOVE(Resource)
@@ -51,6 +60,7 @@ public:
 
 	[[nodiscard]] inline bool isReady() const { return this->bReady.load(); }
 	[[nodiscard]] inline bool isAsyncReady() const { return this->bAsyncReady.load(); }
+	[[nodiscard]] inline bool isInterrupted() const { return this->bInterrupted.load(); }
 
 protected:
 	virtual void init() = 0;
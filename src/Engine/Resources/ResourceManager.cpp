@@ -17,6 +17,7 @@
 
 ResourceManager::ResourceManager() {
     this->bNextLoadAsync = false;
+    this->nextLoadPriority = LoadPriority::NORMAL;
 
     // reserve space for typed vectors
     this->vImages.reserve(256);
@@ -81,7 +82,8 @@ void ResourceManager::destroyResource(Resource *rs, bool forceBlocking) {
     }
 
     // check if it's being loaded and schedule async destroy if so
-    if(this->asyncLoader->isLoadingResource(rs)) {
+    // (unless no thread picked it up yet, then it can just be dropped from the queue and destroyed right away)
+    if(this->asyncLoader->isLoadingResource(rs) && !this->asyncLoader->cancelPendingWork(rs)) {
         if(debug)
             debugLog("Resource Manager: Scheduled async destroy of {:8p} : {:s}\n", static_cast<const void *>(rs),
                      rs->getName());
@@ -120,6 +122,7 @@ void ResourceManager::loadResource(Resource *res, bool load) {
     if(isManaged) addManagedResource(res);
 
     const bool isNextLoadAsync = this->bNextLoadAsync;
+    const LoadPriority priority = this->nextLoadPriority;
 
     // flags must be reset on every load, to not carry over
     resetFlags();
@@ -132,7 +135,7 @@ void ResourceManager::loadResource(Resource *res, bool load) {
         res->load();
     } else {
         // delegate to async loader
-        this->asyncLoader->requestAsyncLoad(res);
+        this->asyncLoader->requestAsyncLoad(res, priority);
     }
 }
 
@@ -148,13 +151,28 @@ size_t ResourceManager::getNumLoadingWorkAsyncDestroy() const {
     return this->asyncLoader->getNumLoadingWorkAsyncDestroy();
 }
 
+size_t ResourceManager::getNumPendingWork(LoadPriority priority, double *avgWaitMS) const {
+    const auto stats = this->asyncLoader->getQueueStats(priority);
+    if(avgWaitMS != nullptr) *avgWaitMS = stats.avgWaitMS;
+    return stats.depth;
+}
+
+void ResourceManager::prioritizeLoad(Resource *rs) {
+    if(rs == nullptr) return;
+    this->asyncLoader->boostPriority(rs);
+}
+
 void ResourceManager::resetFlags() {
     if(this->nextLoadUnmanagedStack.size() > 0) this->nextLoadUnmanagedStack.pop();
 
     this->bNextLoadAsync = false;
+    this->nextLoadPriority = LoadPriority::NORMAL;
 }
 
-void ResourceManager::requestNextLoadAsync() { this->bNextLoadAsync = true; }
+void ResourceManager::requestNextLoadAsync(LoadPriority priority) {
+    this->bNextLoadAsync = true;
+    this->nextLoadPriority = priority;
+}
 
 void ResourceManager::requestNextLoadUnmanaged() { this->nextLoadUnmanagedStack.push(true); }
 
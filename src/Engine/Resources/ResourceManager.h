@@ -51,7 +51,7 @@ class ResourceManager final {
     void reloadResource(Resource *rs, bool async = false);
     void reloadResources(const std::vector<Resource *> &resources, bool async = false);
 
-    void requestNextLoadAsync();
+    void requestNextLoadAsync(LoadPriority priority = LoadPriority::NORMAL);
     void requestNextLoadUnmanaged();
 
     [[nodiscard]] size_t getSyncLoadMaxBatchSize() const;
@@ -129,6 +129,10 @@ class ResourceManager final {
     [[nodiscard]] size_t getNumLoadingWork() const;
     [[nodiscard]] size_t getNumActiveThreads() const;
     [[nodiscard]] size_t getNumLoadingWorkAsyncDestroy() const;
+    [[nodiscard]] size_t getNumPendingWork(LoadPriority priority, double *avgWaitMS = nullptr) const;
+
+    // call before the main thread blocks waiting on an async load, so it doesn't sit behind lower priority work
+    void prioritizeLoad(Resource *rs);
 
    private:
     template <typename T>
@@ -183,6 +187,7 @@ class ResourceManager final {
 
     // flags
     bool bNextLoadAsync;
+    LoadPriority nextLoadPriority;
     std::stack<bool> nextLoadUnmanagedStack;
 
     // content
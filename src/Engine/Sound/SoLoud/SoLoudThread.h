@@ -4,6 +4,7 @@
 
 #ifdef MCENGINE_FEATURE_SOLOUD
 
+#include "Profiler.h"
 #include "Thread.h"
 #include "Timing.h"
 
@@ -390,7 +391,10 @@ class SoLoudThreadWrapper {
 
                 // unlock while executing task
                 lock.unlock();
-                task->execute();
+                {
+                    VPROF_ZONE("SoLoudThread::task");
+                    task->execute();
+                }
                 lock.lock();
 
                 // yield after execution to give other threads time
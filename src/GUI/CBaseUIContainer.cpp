@@ -16,10 +16,29 @@ void CBaseUIContainer::freeElements() {
         delete this->vElements[i];
     }
     this->vElements.clear();
+    this->onElementsChanged();
 }
 
 // invalidate children without freeing memory
-void CBaseUIContainer::invalidate() { this->vElements.clear(); }
+void CBaseUIContainer::invalidate() {
+    this->vElements.clear();
+    this->onElementsChanged();
+}
+
+void CBaseUIContainer::onElementsChanged() {
+    this->iElementsVersion++;
+    this->clearActiveElements();
+}
+
+void CBaseUIContainer::setActiveElements(const std::vector<CBaseUIElement *> &elements) {
+    this->vActiveElements.assign(elements.begin(), elements.end());
+    this->bHasActiveElements = true;
+}
+
+void CBaseUIContainer::clearActiveElements() {
+    this->vActiveElements.clear();
+    this->bHasActiveElements = false;
+}
 
 CBaseUIContainer *CBaseUIContainer::addBaseUIElement(CBaseUIElement *element, float xPos, float yPos) {
     if(element == nullptr) return this;
@@ -27,6 +46,7 @@ CBaseUIContainer *CBaseUIContainer::addBaseUIElement(CBaseUIElement *element, fl
     element->setRelPos(xPos, yPos);
     element->setPos(this->vPos + element->getRelPos());
     this->vElements.push_back(element);
+    this->onElementsChanged();
 
     return this;
 }
@@ -37,6 +57,7 @@ CBaseUIContainer *CBaseUIContainer::addBaseUIElement(CBaseUIElement *element) {
     element->setRelPos(element->getPos().x, element->getPos().y);
     element->setPos(this->vPos + element->getRelPos());
     this->vElements.push_back(element);
+    this->onElementsChanged();
 
     return this;
 }
@@ -47,6 +68,7 @@ CBaseUIContainer *CBaseUIContainer::addBaseUIElementBack(CBaseUIElement *element
     element->setRelPos(xPos, yPos);
     element->setPos(this->vPos + element->getRelPos());
     this->vElements.insert(this->vElements.begin(), element);
+    this->onElementsChanged();
 
     return this;
 }
@@ -57,6 +79,7 @@ CBaseUIContainer *CBaseUIContainer::addBaseUIElementBack(CBaseUIElement *element
     element->setRelPos(element->getPos().x, element->getPos().y);
     element->setPos(this->vPos + element->getRelPos());
     this->vElements.insert(this->vElements.begin(), element);
+    this->onElementsChanged();
 
     return this;
 }
@@ -69,6 +92,7 @@ CBaseUIContainer *CBaseUIContainer::insertBaseUIElement(CBaseUIElement *element,
     for(size_t i = 0; i < this->vElements.size(); i++) {
         if(this->vElements[i] == index) {
             this->vElements.insert(this->vElements.begin() + std::clamp<int>(i, 0, this->vElements.size()), element);
+            this->onElementsChanged();
             return this;
         }
     }
@@ -87,6 +111,7 @@ CBaseUIContainer *CBaseUIContainer::insertBaseUIElementBack(CBaseUIElement *elem
         if(this->vElements[i] == index) {
             this->vElements.insert(this->vElements.begin() + std::clamp<int>(i + 1, 0, this->vElements.size()),
                                    element);
+            this->onElementsChanged();
             return this;
         }
     }
@@ -100,6 +125,7 @@ CBaseUIContainer *CBaseUIContainer::removeBaseUIElement(CBaseUIElement *element)
     for(size_t i = 0; i < this->vElements.size(); i++) {
         if(this->vElements[i] == element) {
             this->vElements.erase(this->vElements.begin() + i);
+            this->onElementsChanged();
             return this;
         }
     }
@@ -114,6 +140,7 @@ CBaseUIContainer *CBaseUIContainer::deleteBaseUIElement(CBaseUIElement *element)
         if(this->vElements[i] == element) {
             delete element;
             this->vElements.erase(this->vElements.begin() + i);
+            this->onElementsChanged();
             return this;
         }
     }
@@ -135,9 +162,10 @@ CBaseUIElement *CBaseUIContainer::getBaseUIElement(const UString &name) {
 void CBaseUIContainer::draw() {
     if(!this->bVisible) return;
 
+    const std::vector<CBaseUIElement *> &elements = this->getActiveElements();
     MC_UNROLL
-    for(size_t i = 0; i < this->vElements.size(); i++) {
-        const auto &e = this->vElements[i];
+    for(size_t i = 0; i < elements.size(); i++) {
+        const auto &e = elements[i];
         if(e->isVisible()) {
             e->draw();
         }
@@ -170,17 +198,19 @@ void CBaseUIContainer::mouse_update(bool *propagate_clicks) {
     if(!this->bVisible) return;
     CBaseUIElement::mouse_update(propagate_clicks);
 
+    const std::vector<CBaseUIElement *> &elements = this->getActiveElements();
     MC_UNROLL
-    for(size_t i = 0; i < this->vElements.size(); i++) {
-        this->vElements[i]->mouse_update(propagate_clicks);
+    for(size_t i = 0; i < elements.size(); i++) {
+        elements[i]->mouse_update(propagate_clicks);
     }
 }
 
 void CBaseUIContainer::update_pos() {
     const auto &thisPos = this->vPos;
+    const std::vector<CBaseUIElement *> &elements = this->getActiveElements();
     MC_UNROLL
-    for(size_t i = 0; i < this->vElements.size(); i++) {
-        const auto &e = this->vElements[i];
+    for(size_t i = 0; i < elements.size(); i++) {
+        const auto &e = elements[i];
         e->setPos(thisPos + e->getRelPos());
     }
 }
@@ -33,6 +33,14 @@ class CBaseUIContainer : public CBaseUIElement {
 
     [[nodiscard]] inline const std::vector<CBaseUIElement *> &getElements() const { return this->vElements; }
 
+    // incremented whenever children are added/removed
+    [[nodiscard]] inline u32 getElementsVersion() const { return this->iElementsVersion; }
+
+    // restricts draw()/mouse_update()/update_pos() to a subset of the children (in container order), e.g. for scroll
+    // views which only touch the children around their viewport. automatically cleared whenever the children change
+    void setActiveElements(const std::vector<CBaseUIElement *> &elements);
+    void clearActiveElements();
+
     void onMoved() override { this->update_pos(); }
     void onResized() override { this->update_pos(); }
 
@@ -49,4 +57,14 @@ class CBaseUIContainer : public CBaseUIElement {
 
    protected:
     std::vector<CBaseUIElement *> vElements;
+
+   private:
+    [[nodiscard]] inline const std::vector<CBaseUIElement *> &getActiveElements() const {
+        return this->bHasActiveElements ? this->vActiveElements : this->vElements;
+    }
+    void onElementsChanged();
+
+    std::vector<CBaseUIElement *> vActiveElements;
+    u32 iElementsVersion{0};
+    bool bHasActiveElements{false};
 };
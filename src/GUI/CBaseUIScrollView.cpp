@@ -101,6 +101,9 @@ void CBaseUIScrollView::draw() {
         g->pushClipRect(clip_rect);
     }
 
+    // children were added/removed since the last update, don't draw all of them for a frame
+    if(this->isCullIndexStale()) this->updateCulling();
+
     this->container->draw();
 
     if(this->bDrawScrollbars) {
@@ -142,6 +145,7 @@ void CBaseUIScrollView::draw() {
 
 void CBaseUIScrollView::mouse_update(bool *propagate_clicks) {
     if(!this->bVisible) return;
+    if(this->isCullIndexStale()) this->updateCulling();
     this->container->mouse_update(propagate_clicks);
     CBaseUIElement::mouse_update(propagate_clicks);
 
@@ -338,7 +342,7 @@ void CBaseUIScrollView::mouse_update(bool *propagate_clicks) {
     }
 
     // only draw visible elements
-    this->updateClipping();
+    this->updateCulling();
 }
 
 void CBaseUIScrollView::onKeyUp(KeyboardEvent &e) { this->container->onKeyUp(e); }
@@ -489,8 +493,104 @@ void CBaseUIScrollView::scrollToElement(CBaseUIElement *element, int /*xOffset*/
     }
 }
 
-void CBaseUIScrollView::updateClipping() {
+bool CBaseUIScrollView::isCullingEnabled() const {
+    return this->bCullChildren && cv::ui_scrollview_culling.getBool();
+}
+
+bool CBaseUIScrollView::isCullIndexStale() const {
+    return this->isCullingEnabled() &&
+           (!this->bCullIndexValid || this->iCullElementsVersion != this->container->getElementsVersion());
+}
+
+void CBaseUIScrollView::rebuildCullIndex() {
     const std::vector<CBaseUIElement *> &elements = this->container->getElements();
+
+    this->vCullIndex.clear();
+    this->vCullIndex.reserve(elements.size());
+    this->fCullMaxHeight = 0.f;
+    for(u32 i = 0; i < elements.size(); i++) {
+        const float top = elements[i]->getRelPos().y;
+        const float height = elements[i]->getSize().y;
+        this->vCullIndex.push_back({.top = top, .bottom = top + height, .index = i});
+        this->fCullMaxHeight = std::max(this->fCullMaxHeight, height);
+    }
+
+    // children are usually added top to bottom already
+    if(!std::ranges::is_sorted(this->vCullIndex, {}, &CullEntry::top))
+        std::ranges::stable_sort(this->vCullIndex, {}, &CullEntry::top);
+
+    this->vPrevCulledIndices.clear();
+    this->iCullElementsVersion = this->container->getElementsVersion();
+    this->bCullIndexValid = true;
+}
+
+void CBaseUIScrollView::updateCulling() {
+    const std::vector<CBaseUIElement *> &elements = this->container->getElements();
+
+    if(!this->isCullingEnabled()) {
+        if(this->bContainerCulled) {
+            this->bContainerCulled = false;
+            this->bCullIndexValid = false;
+            this->container->clearActiveElements();
+            this->container->update_pos();
+        }
+        this->updateClipping(elements);
+        return;
+    }
+
+    const bool rebuilt = this->isCullIndexStale();
+    if(rebuilt) this->rebuildCullIndex();
+
+    // visible area in container coordinates, plus half a page in both directions, so that children which are about to
+    // be scrolled into view are already positioned (and hovered children get their onMouseOutside())
+    const float margin = this->vSize.y / 2.f;
+    const float viewTop = -std::round(this->vScrollPos.y) - margin;
+    const float viewBottom = -std::round(this->vScrollPos.y) + this->vSize.y + margin;
+
+    const auto begin = std::ranges::lower_bound(this->vCullIndex, viewTop - this->fCullMaxHeight, {}, &CullEntry::top);
+    const auto end = std::ranges::lower_bound(this->vCullIndex, viewBottom, {}, &CullEntry::top);
+
+    this->vCulledIndices.clear();
+    for(auto it = begin; it < end; it++) {
+        if(it->bottom >= viewTop) this->vCulledIndices.push_back(it->index);
+    }
+
+    // keep the container order (= draw order)
+    std::ranges::sort(this->vCulledIndices);
+
+    // hide whatever dropped out of range, since it won't be clipped anymore
+    if(rebuilt) {
+        size_t j = 0;
+        for(u32 i = 0; i < elements.size(); i++) {
+            if(j < this->vCulledIndices.size() && this->vCulledIndices[j] == i)
+                j++;
+            else if(elements[i]->isVisible())
+                elements[i]->setVisible(false);
+        }
+    } else {
+        size_t j = 0;
+        for(const u32 prev : this->vPrevCulledIndices) {
+            while(j < this->vCulledIndices.size() && this->vCulledIndices[j] < prev) j++;
+            if((j >= this->vCulledIndices.size() || this->vCulledIndices[j] != prev) && elements[prev]->isVisible())
+                elements[prev]->setVisible(false);
+        }
+    }
+    std::swap(this->vPrevCulledIndices, this->vCulledIndices);
+
+    this->vCulledElements.clear();
+    for(const u32 index : this->vPrevCulledIndices) {
+        this->vCulledElements.push_back(elements[index]);
+    }
+    this->container->setActiveElements(this->vCulledElements);
+    this->bContainerCulled = true;
+
+    // children which were out of range haven't followed the container
+    this->container->update_pos();
+
+    this->updateClipping(this->vCulledElements);
+}
+
+void CBaseUIScrollView::updateClipping(const std::vector<CBaseUIElement *> &elements) {
     const McRect &me{this->getRect()};
 
     for(auto e : elements) {
@@ -555,22 +655,28 @@ void CBaseUIScrollView::updateScrollbars() {
 }
 
 CBaseUIScrollView *CBaseUIScrollView::setScrollSizeToContent(int border) {
-    auto oldScrollPos = this->vScrollPos;
-    bool wasAtBottom = (this->vSize.y - this->vScrollPos.y) >= this->vScrollSize.y;
-
-    this->vScrollSize = {0.f, 0.f};
+    vec2 contentSize{0.f, 0.f};
 
     const std::vector<CBaseUIElement *> &elements = this->container->getElements();
     for(auto e : elements) {
         const float x = e->getRelPos().x + e->getSize().x;
         const float y = e->getRelPos().y + e->getSize().y;
 
-        if(x > this->vScrollSize.x) this->vScrollSize.x = x;
-        if(y > this->vScrollSize.y) this->vScrollSize.y = y;
+        if(x > contentSize.x) contentSize.x = x;
+        if(y > contentSize.y) contentSize.y = y;
     }
 
-    this->vScrollSize.x += border;
-    this->vScrollSize.y += border;
+    return this->setScrollSize(contentSize + vec2(border, border));
+}
+
+CBaseUIScrollView *CBaseUIScrollView::setScrollSize(vec2 scrollSize) {
+    auto oldScrollPos = this->vScrollPos;
+    bool wasAtBottom = (this->vSize.y - this->vScrollPos.y) >= this->vScrollSize.y;
+
+    this->vScrollSize = scrollSize;
+
+    // (this is where children are usually (re)positioned)
+    this->bCullIndexValid = false;
 
     this->container->setSize(this->vScrollSize);
 
@@ -74,6 +74,8 @@ class CBaseUIScrollView : public CBaseUIElement {
         return this;
     }
     CBaseUIScrollView *setScrollSizeToContent(int border = 5);
+    // for content which isn't (entirely) part of the container, e.g. if only the visible part of a list is added
+    CBaseUIScrollView *setScrollSize(vec2 scrollSize);
     CBaseUIScrollView *setScrollResistance(int scrollResistanceInPixels) {
         this->iScrollResistance = scrollResistanceInPixels;
         return this;
@@ -115,7 +117,18 @@ class CBaseUIScrollView : public CBaseUIElement {
     void onMoved() override;
 
    private:
-    void updateClipping();
+    // children sorted by their (container-relative) vertical extent, for finding the ones around the viewport
+    struct CullEntry {
+        float top;
+        float bottom;
+        u32 index;
+    };
+
+    [[nodiscard]] bool isCullingEnabled() const;
+    [[nodiscard]] bool isCullIndexStale() const;
+    void rebuildCullIndex();
+    void updateCulling();
+    void updateClipping(const std::vector<CBaseUIElement *> &elements);
     void updateScrollbars();
 
     void scrollToYInt(int scrollPosY, bool animated = true, bool slow = true);
@@ -140,6 +153,16 @@ class CBaseUIScrollView : public CBaseUIElement {
     McRect verticalScrollbar;
     McRect horizontalScrollbar;
 
+    // culling
+    std::vector<CullEntry> vCullIndex;
+    std::vector<u32> vCulledIndices;
+    std::vector<u32> vPrevCulledIndices;
+    std::vector<CBaseUIElement *> vCulledElements;
+    float fCullMaxHeight{0.f};
+    u32 iCullElementsVersion{0};
+    bool bCullIndexValid{false};
+    bool bContainerCulled{false};
+
     // scroll logic
     vec2 vScrollSize{0.f};
     vec2 vMouseBackup2{0.f};
@@ -173,6 +196,11 @@ public:
     // Useful in places where you're waiting on new content, like chat logs.
     unsigned sticky : 1 = false;
 
+    // Only position/update/draw the children around the viewport (binary searched by their vertical position),
+    // instead of all of them. Assumes that children only move when the scroll size is (re)set or children are
+    // added/removed, so disable this for views with freely animating children.
+    unsigned bCullChildren : 1 = true;
+
     unsigned bHorizontalClipping : 1 = true;
     unsigned bVerticalClipping : 1 = true;
     unsigned bScrollbarOnLeft : 1 = false;
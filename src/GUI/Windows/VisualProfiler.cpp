@@ -7,6 +7,7 @@
 #include "ConVar.h"
 #include "Engine.h"
 #include "Environment.h"
+#include "FrameArena.h"
 #include "Keyboard.h"
 #include "Mouse.h"
 #include "Profiler.h"
@@ -114,10 +115,30 @@ void VisualProfiler::draw() {
                     addTextLine(
                         UString::format("RM LoadingWorkAD: %zu", resourceManager->getNumLoadingWorkAsyncDestroy()),
                         textFont, this->textLines);
+                    {
+                        static constexpr const char *priorityNames[] = {"High", "Normal", "Low"};
+                        for(size_t i = 0; i < static_cast<size_t>(LoadPriority::COUNT); i++) {
+                            double avgWaitMS = 0.0;
+                            const size_t numPending =
+                                resourceManager->getNumPendingWork(static_cast<LoadPriority>(i), &avgWaitMS);
+                            addTextLine(UString::fmt("RM Queue {:s}: {:d} (wait: {:.1f} ms)", priorityNames[i],
+                                                     numPending, avgWaitMS),
+                                        textFont, this->textLines);
+                        }
+                    }
                     addTextLine(UString::format("RM Named Resources: %zu", resourceManager->getResources().size()),
                                 textFont, this->textLines);
                     addTextLine(UString::format("Animations: %zu", anim->getNumActiveAnimations()), textFont,
                                 this->textLines);
+                    addTextLine(UString::fmt("Frame Arena: {:d} KB ({:d} KB reserved)",
+                                             frame::arena().getLastFrameBytesAllocated() / 1024,
+                                             frame::arena().getBytesReserved() / 1024),
+                                textFont, this->textLines);
+#ifdef NEOSU_COUNT_ALLOCATIONS
+                    addTextLine(
+                        UString::fmt("Allocations: {:d} / frame", frame::arena().getLastFrameGlobalAllocations()),
+                        textFont, this->textLines);
+#endif
                     addTextLine(UString::format("Frame: %lu", engine->getFrameCount()), textFont, this->textLines);
                     addTextLine(UString::format("Time: %f", time), textFont, this->textLines);
                 } break;
@@ -2,6 +2,7 @@
 #include "BaseEnvironment.h"
 #include <algorithm>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cassert>
 
@@ -10,7 +11,7 @@
 namespace SString {
 
 // alphanumeric string comparator that ignores special characters at the start of strings
-inline bool alnum_comp(const std::string& a, const std::string& b) {
+inline bool alnum_comp(std::string_view a, std::string_view b) {
     int i = 0;
     int j = 0;
     while(i < a.length() && j < b.length()) {
@@ -61,13 +62,13 @@ inline void trim(std::string* str) {
     str->erase(str->find_last_not_of(" \t\r\n") + 1);
 }
 
-inline bool contains_ncase(const std::string& haystack, const std::string& needle) {
+inline bool contains_ncase(std::string_view haystack, std::string_view needle) {
     return !haystack.empty() && !std::ranges::search(haystack, needle, [](unsigned char ch1, unsigned char ch2) {
                                      return std::tolower(ch1) == std::tolower(ch2);
                                  }).empty();
 }
 
-inline bool whitespace_only(const std::string& str) {
+inline bool whitespace_only(std::string_view str) {
     return str.empty() || std::ranges::all_of(str, [](unsigned char c) { return std::isspace(c) != 0; });
 }
 
@@ -76,11 +77,21 @@ inline void to_lower(std::string& str) {
     std::ranges::transform(str, str.begin(), [](unsigned char c) { return std::tolower(c); });
 }
 
-inline std::string lower(const std::string& str) {
-    if(str.empty()) return str;
-    auto lstr{str};
+inline std::string lower(std::string_view str) {
+    std::string lstr{str};
     to_lower(lstr);
     return lstr;
 }
 
+// case-insensitive (ASCII) three-way comparison, like strcasecmp()
+inline int compare_ncase(std::string_view a, std::string_view b) {
+    const size_t len = std::min(a.length(), b.length());
+    for(size_t i = 0; i < len; i++) {
+        const int ca = std::tolower((unsigned char)a[i]);
+        const int cb = std::tolower((unsigned char)b[i]);
+        if(ca != cb) return ca - cb;
+    }
+    return a.length() < b.length() ? -1 : (a.length() > b.length() ? 1 : 0);
+}
+
 }  // namespace SString
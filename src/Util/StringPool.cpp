@@ -0,0 +1,67 @@
+#include "StringPool.h"
+
+#include <cstring>
+#include <string>
+
+std::string_view StringPool::intern(std::string_view str) {
+    if(str.empty()) return "";
+
+    const size_t hash = std::hash<std::string_view>{}(str);
+    Shard &shard = this->shards[hash % NUM_SHARDS];
+
+    std::scoped_lock lock(shard.mtx);
+
+    shard.stats.num_interned++;
+    shard.stats.bytes_interned += sizeof(std::string);
+    if(str.length() > 15) {
+        shard.stats.bytes_interned += str.length() + 1;  // too long for the small string buffer (libstdc++/MSVC)
+    }
+
+    if(const auto it = shard.strings.find(str); it != shard.strings.end()) {
+        return *it;
+    }
+
+    const size_t len = str.length() + 1;
+    char *dest = nullptr;
+    if(len > BLOCK_SIZE / 4) {
+        // big strings get their own allocation, so that they don't waste the rest of the current block
+        shard.blocks.push_back(std::make_unique<char[]>(len));
+        dest = shard.blocks.back().get();
+        shard.stats.bytes_allocated += len;
+    } else {
+        if(shard.block == nullptr || shard.block_pos + len > BLOCK_SIZE) {
+            shard.blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+            shard.block = shard.blocks.back().get();
+            shard.block_pos = 0;
+            shard.stats.bytes_allocated += BLOCK_SIZE;
+        }
+        dest = shard.block + shard.block_pos;
+        shard.block_pos += len;
+    }
+
+    memcpy(dest, str.data(), str.length());
+    dest[str.length()] = '\0';
+
+    std::string_view interned{dest, str.length()};
+    shard.strings.insert(interned);
+    shard.stats.num_strings++;
+    shard.stats.bytes_used += len;
+    return interned;
+}
+
+StringPool::Stats StringPool::get_stats() {
+    Stats total;
+    for(auto &shard : this->shards) {
+        std::scoped_lock lock(shard.mtx);
+        total.num_strings += shard.stats.num_strings;
+        total.num_interned += shard.stats.num_interned;
+        total.bytes_interned += shard.stats.bytes_interned;
+        total.bytes_used += shard.stats.bytes_used;
+        total.bytes_allocated += shard.stats.bytes_allocated;
+
+        // rough estimate of the hash set (one node per string, plus the bucket array)
+        total.bytes_allocated += shard.strings.size() * (sizeof(std::string_view) + 2 * sizeof(void *)) +
+                                 shard.strings.bucket_count() * sizeof(void *);
+    }
+    return total;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "noinclude.h"
+#include "types.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// append-only, interning string storage: every distinct string is stored once (NUL-terminated) in large blocks which
+// never move, so views returned by intern() stay valid for as long as the pool exists.
+// meant for lots of small, heavily duplicated strings which live for the whole session (e.g. beatmap metadata)
+class StringPool final {
+    NOCOPY_NOMOVE(StringPool)
+   public:
+    struct Stats {
+        size_t num_strings{0};      // distinct strings stored
+        size_t num_interned{0};     // intern() calls, i.e. how many separate strings there would be without the pool
+        size_t bytes_interned{0};   // what those would take up as separate std::strings (incl. heap allocations)
+        size_t bytes_used{0};       // string data in the pool
+        size_t bytes_allocated{0};  // pool blocks + index
+    };
+
+    StringPool() = default;
+    ~StringPool() = default;
+
+    // thread-safe
+    std::string_view intern(std::string_view str);
+
+    [[nodiscard]] Stats get_stats();
+
+   private:
+    static constexpr const size_t BLOCK_SIZE{64ULL * 1024};
+    static constexpr const size_t NUM_SHARDS{16};
+
+    // split up by hash, so that threads interning at the same time (e.g. while loading databases) rarely share a lock
+    struct Shard {
+        std::mutex mtx;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char *block{nullptr};  // the one currently being filled
+        size_t block_pos{0};
+        std::unordered_set<std::string_view> strings;
+        Stats stats;
+    };
+
+    std::array<Shard, NUM_SHARDS> shards;
+};
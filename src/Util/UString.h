@@ -302,7 +302,10 @@ struct formatter<UString> : formatter<string_view> {
 
 template <typename... Args>
 UString UString::fmt(fmt::format_string<Args...> fmt, Args &&...args) noexcept {
-    return UString(fmt::format(fmt, std::forward<Args>(args)...));
+    // format on the stack (for anything short enough), instead of going through a temporary std::string
+    fmt::memory_buffer buf;
+    fmt::format_to(std::back_inserter(buf), fmt, std::forward<Args>(args)...);
+    return UString(std::string_view{buf.data(), buf.size()});
 }
 
 template <typename Range>
@@ -0,0 +1,131 @@
+#include "Utf8String.h"
+
+#include "BenchCheck.h"
+#include "Engine.h"
+#include "Timing.h"
+#include "UString.h"
+
+#include <array>
+
+namespace {  // static namespace
+std::string_view stripBom(std::string_view utf8) {
+    if(utf8.starts_with("\xEF\xBB\xBF")) utf8.remove_prefix(3);
+    return utf8;
+}
+}  // namespace
+
+Utf8String::Utf8String(std::string_view utf8) : sUtf8(stripBom(utf8)) { this->countCodepoints(0); }
+
+Utf8String::Utf8String(std::string &&utf8) : sUtf8(std::move(utf8)) {
+    if(stripBom(this->sUtf8).length() != this->sUtf8.length()) this->sUtf8.erase(0, 3);
+    this->countCodepoints(0);
+}
+
+Utf8String::Utf8String(const UString &ustr) : sUtf8(ustr.utf8View()) { this->countCodepoints(0); }
+
+void Utf8String::clear() noexcept {
+    this->sUtf8.clear();
+    this->iLength = 0;
+    this->bAsciiOnly = true;
+}
+
+std::wstring Utf8String::toWide() const {
+    std::wstring wide;
+    wide.reserve(this->iLength);
+    for(wchar_t ch : this->codepoints()) {
+        wide.push_back(ch);
+    }
+    return wide;
+}
+
+UString Utf8String::toUString() const { return UString(this->utf8View()); }
+
+Utf8String &Utf8String::append(std::string_view utf8) {
+    const size_t oldLength = this->sUtf8.length();
+    this->sUtf8.append(utf8);
+
+    if(this->bAsciiOnly) {
+        this->countCodepoints(oldLength);
+    } else {
+        // the old text could end in a truncated sequence which the new text completes, so count everything again
+        this->iLength = 0;
+        this->countCodepoints(0);
+    }
+    return *this;
+}
+
+Utf8String &Utf8String::append(const Utf8String &str) { return this->append(str.utf8View()); }
+
+void Utf8String::countCodepoints(size_t from) {
+    const char *p = this->sUtf8.data() + from;
+    const char *end = this->sUtf8.data() + this->sUtf8.length();
+
+    // ascii fast path, most text never leaves it
+    while(p < end && static_cast<unsigned char>(*p) < 0x80) {
+        p++;
+        this->iLength++;
+    }
+
+    if(p == end) return;
+
+    this->bAsciiOnly = false;
+    while(p < end) {
+        Utf8String::decode(p, end);
+        this->iLength++;
+    }
+}
+
+void Utf8String::bench() {
+    static constexpr int NUM_ITERATIONS = 10000;
+
+    // typical per-frame text (HUD/song browser labels), and some song titles
+    static constexpr std::array<std::string_view, 6> samples{
+        "x1234",
+        "98.76%",
+        "Length: 03:21 BPM: 180 Objects: 1234",
+        "CS:4 AR:9.3 OD:8.5 HP:5 Stars:5.67 -> 6.12 (321pp)",
+        "ヒバナ [Extreme]",
+        "Camellia - 光線チューニング ~なずな妄想海フォーミュラ~ [Ascension to Heaven]",
+    };
+
+    // sizeof + heap, assuming a single allocation of exactly the needed size once the SSO buffer is too small
+    const size_t wideSSO = std::wstring{}.capacity();
+    const size_t narrowSSO = std::string{}.capacity();
+    const auto heapSize = [](size_t length, size_t sso, size_t charSize) -> size_t {
+        return length > sso ? (length + 1) * charSize : 0;
+    };
+
+    BenchCheck check("ustring_bench");
+    for(std::string_view sample : samples) {
+        size_t checksum = 0;  // UString adds its length and codepoints, Utf8String subtracts them
+
+        u64 startTime = Timing::getTicksNS();
+        for(int i = 0; i < NUM_ITERATIONS; i++) {
+            UString str(sample);
+            checksum += str.length();
+            for(wchar_t ch : str.unicodeView()) checksum += ch;
+        }
+        const double ustringNS = static_cast<double>(Timing::getTicksNS() - startTime) / NUM_ITERATIONS;
+
+        startTime = Timing::getTicksNS();
+        for(int i = 0; i < NUM_ITERATIONS; i++) {
+            Utf8String str(sample);
+            checksum -= str.length();
+            for(wchar_t ch : str.codepoints()) checksum -= ch;
+        }
+        const double utf8NS = static_cast<double>(Timing::getTicksNS() - startTime) / NUM_ITERATIONS;
+
+        const UString ustr(sample);
+        const size_t ustringBytes = sizeof(UString) + heapSize(ustr.length(), wideSSO, sizeof(wchar_t)) +
+                                    heapSize(ustr.lengthUtf8(), narrowSSO, sizeof(char));
+        const size_t utf8Bytes = sizeof(Utf8String) + heapSize(sample.length(), narrowSSO, sizeof(char));
+
+        Engine::logRaw("ustring_bench: \"{:s}\" ({:d} chars)\n", sample, ustr.length());
+        Engine::logRaw("    UString:    {:.1f} ns (construct + iterate), {:d} bytes\n", ustringNS, ustringBytes);
+        Engine::logRaw("    Utf8String: {:.1f} ns (construct + iterate), {:d} bytes\n", utf8NS, utf8Bytes);
+
+        check.expectEqual<size_t>(checksum, 0,
+                                  fmt::format("\"{:s}\": UString minus Utf8String length and codepoints", sample));
+    }
+    check.finish();
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "fmt/format.h"
+
+class UString;
+
+// immutable-ish text which only keeps its UTF-8 representation (in a single std::string, so short strings don't
+// allocate at all), plus the codepoint count. codepoints are decoded on the fly while iterating, and a wide string is
+// only built if something actually asks for one (e.g. platform APIs).
+// meant for hot paths which build text every frame (labels, HUD) and only ever draw/measure it; UString is still the
+// type to use for anything that edits text by index
+class Utf8String {
+   public:
+    template <typename... Args>
+    [[nodiscard]] static Utf8String fmt(fmt::format_string<Args...> fmt, Args &&...args);
+
+    // forward iterator over the decoded codepoints. invalid/truncated sequences decode to '?', same as UString
+    class CodepointIterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = wchar_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = wchar_t;
+
+        CodepointIterator() = default;
+        CodepointIterator(const char *pos, const char *end) : pos(pos), end(end) {}
+
+        [[nodiscard]] wchar_t operator*() const {
+            const char *p = this->pos;
+            return Utf8String::decode(p, this->end);
+        }
+        CodepointIterator &operator++() {
+            Utf8String::decode(this->pos, this->end);
+            return *this;
+        }
+        CodepointIterator operator++(int) {
+            CodepointIterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const CodepointIterator &other) const { return this->pos == other.pos; }
+
+       private:
+        const char *pos{nullptr};
+        const char *end{nullptr};
+    };
+
+    struct CodepointRange {
+        CodepointIterator first;
+        CodepointIterator last;
+
+        [[nodiscard]] CodepointIterator begin() const { return this->first; }
+        [[nodiscard]] CodepointIterator end() const { return this->last; }
+    };
+
+    // decodes the codepoint at p and advances p past it
+    static inline wchar_t decode(const char *&p, const char *end);
+
+    // ustring_bench: UString vs. Utf8String construction/iteration time and size for typical text
+    static void bench();
+
+   public:
+    Utf8String() = default;
+    explicit Utf8String(std::string_view utf8);
+    explicit Utf8String(std::string &&utf8);
+    explicit Utf8String(const UString &ustr);
+
+    Utf8String(const Utf8String &) = default;
+    Utf8String(Utf8String &&) noexcept = default;
+    Utf8String &operator=(const Utf8String &) = default;
+    Utf8String &operator=(Utf8String &&) noexcept = default;
+    ~Utf8String() = default;
+
+    void clear() noexcept;
+
+    // getters
+    [[nodiscard]] constexpr int length() const noexcept { return this->iLength; }
+    [[nodiscard]] int lengthUtf8() const noexcept { return static_cast<int>(this->sUtf8.length()); }
+    [[nodiscard]] constexpr bool isEmpty() const noexcept { return this->sUtf8.empty(); }
+    [[nodiscard]] constexpr bool isAsciiOnly() const noexcept { return this->bAsciiOnly; }
+    [[nodiscard]] constexpr std::string_view utf8View() const noexcept { return this->sUtf8; }
+    [[nodiscard]] constexpr const char *toUtf8() const noexcept { return this->sUtf8.c_str(); }
+
+    [[nodiscard]] CodepointRange codepoints() const {
+        const char *begin = this->sUtf8.data();
+        const char *end = begin + this->sUtf8.length();
+        return {.first = {begin, end}, .last = {end, end}};
+    }
+
+    // these allocate, only use them where a wide string is actually needed
+    [[nodiscard]] std::wstring toWide() const;
+    [[nodiscard]] UString toUString() const;
+
+    // modifiers
+    Utf8String &append(std::string_view utf8);
+    Utf8String &append(const Utf8String &str);
+    Utf8String &operator+=(std::string_view utf8) { return this->append(utf8); }
+    Utf8String &operator+=(const Utf8String &str) { return this->append(str); }
+
+    bool operator==(const Utf8String &other) const { return this->sUtf8 == other.sUtf8; }
+    auto operator<=>(const Utf8String &other) const { return this->sUtf8 <=> other.sUtf8; }
+
+   private:
+    void countCodepoints(size_t from);
+
+    std::string sUtf8;
+    int iLength{0};
+    bool bAsciiOnly{true};
+};
+
+wchar_t Utf8String::decode(const char *&p, const char *end) {
+    const auto b = static_cast<unsigned char>(*p);
+    if(b < 0x80) {
+        p++;
+        return static_cast<wchar_t>(b);
+    }
+
+    // only well-formed sequences (RFC 3629): no 5/6 byte forms, nothing above U+10FFFF, no overlong encodings and no
+    // surrogates. anything else only consumes the lead byte, so decoding picks up again at the next valid sequence
+    int bytes = 0;
+    char32_t minCodepoint = 0;
+    if(b >= 0xC2 && b <= 0xDF) {
+        bytes = 2;
+        minCodepoint = 0x80;
+    } else if((b & 0xF0) == 0xE0) {
+        bytes = 3;
+        minCodepoint = 0x800;
+    } else if(b >= 0xF0 && b <= 0xF4) {
+        bytes = 4;
+        minCodepoint = 0x10000;
+    }
+
+    if(bytes == 0 || end - p < bytes) {
+        // invalid lead byte or truncated sequence
+        p++;
+        return L'?';
+    }
+
+    // the first byte holds (7 - bytes) payload bits, the continuation bytes (10xxxxxx) 6 each
+    auto codepoint = static_cast<char32_t>(b & (0x7F >> bytes));
+    for(int i = 1; i < bytes; i++) {
+        const auto cont = static_cast<unsigned char>(p[i]);
+        if((cont & 0xC0) != 0x80) {
+            p++;
+            return L'?';
+        }
+        codepoint = (codepoint << 6) | (cont & 0x3F);
+    }
+
+    if(codepoint < minCodepoint || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        p++;
+        return L'?';
+    }
+
+    p += bytes;
+    return static_cast<wchar_t>(codepoint);
+}
+
+namespace std {
+template <>
+struct hash<Utf8String> {
+    size_t operator()(const Utf8String &str) const noexcept { return hash<std::string_view>()(str.utf8View()); }
+};
+}  // namespace std
+
+namespace fmt {
+template <>
+struct formatter<Utf8String> : formatter<string_view> {
+    template <typename FormatContext>
+    auto format(const Utf8String &str, FormatContext &ctx) const {
+        return formatter<string_view>::format(str.utf8View(), ctx);
+    }
+};
+}  // namespace fmt
+
+template <typename... Args>
+Utf8String Utf8String::fmt(fmt::format_string<Args...> fmt, Args &&...args) {
+    fmt::memory_buffer buf;
+    fmt::format_to(std::back_inserter(buf), fmt, std::forward<Args>(args)...);
+    return Utf8String(std::string_view{buf.data(), buf.size()});
+}
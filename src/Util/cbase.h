@@ -18,6 +18,7 @@
 #include "Matrices.h"
 #include "Rect.h"
 #include "UString.h"
+#include "Utf8String.h"
 #include "Vectors.h"
 
 // DEFS
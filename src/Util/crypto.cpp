@@ -4,6 +4,7 @@
 #include "base64.h"            // vendored library
 #include "MD5.h"               // vendored library
 #include "ByteBufferedFile.h"  // for file hashing functions
+#include <array>
 #include <vector>
 #include <cstring>
 
@@ -72,6 +73,28 @@ void md5(const void* data, size_t size, u8* hash) {
     std::memcpy(hash, hasher.getDigest(), 16);
 }
 
+u32 crc32(const void* data, size_t size) {
+    // standard (reflected) CRC-32, as used by zlib/png
+    static constexpr const std::array<u32, 256> table = [] {
+        std::array<u32, 256> out{};
+        for(u32 i = 0; i < 256; i++) {
+            u32 c = i;
+            for(int k = 0; k < 8; k++) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            out[i] = c;
+        }
+        return out;
+    }();
+
+    const auto* bytes = static_cast<const u8*>(data);
+    u32 crc = 0xFFFFFFFFu;
+    for(size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
 void sha256_f(const UString& file_path, u8* hash) {
     constexpr size_t CHUNK_SIZE{32768};
     std::array<u8, CHUNK_SIZE> buffer{};
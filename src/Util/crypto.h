@@ -43,6 +43,9 @@ namespace hash {
 void sha256(const void* data, size_t size, u8* hash);
 void md5(const void* data, size_t size, u8* hash);
 
+// not cryptographic, for detecting corrupted/truncated data
+u32 crc32(const void* data, size_t size);
+
 // takes a file directly
 void sha256_f(const UString& file_path, u8* hash);
 void md5_f(const UString& file_path, u8* hash);
@@ -5,6 +5,8 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cassert>
+#include <utility>
+#include <vector>
 
 // zero-initialized dynamic array, similar to std::vector but way faster when you don't need constructors
 // obviously don't use it on complex types :)
@@ -80,3 +82,68 @@ struct zarray {
     size_t nb = 0;
     T *memory = NULL;
 };
+
+// fixed-capacity FIFO, for keeping the last N of something without ever moving the elements around.
+// index 0 is the oldest element. push_back() on a full ring overwrites the oldest element, so callers which need to
+// clean up after it should check full() and pop_front() first
+template <class T>
+struct ring {
+    ring(size_t capacity) : memory(capacity) { assert(capacity > 0); }
+
+    T &push_back(T t) {
+        if(this->nb == this->memory.size()) this->pop_front();
+
+        T &slot = this->memory[(this->first + this->nb) % this->memory.size()];
+        slot = std::move(t);
+        this->nb++;
+        return slot;
+    }
+
+    void pop_front() {
+        assert(this->nb > 0);
+        this->memory[this->first] = T{};  // release whatever it holds right away
+        this->first = (this->first + 1) % this->memory.size();
+        this->nb--;
+    }
+
+    void clear() {
+        while(this->nb > 0) this->pop_front();
+        this->first = 0;
+    }
+
+    T &operator[](size_t index) { return this->memory[(this->first + index) % this->memory.size()]; }
+    const T &operator[](size_t index) const { return this->memory[(this->first + index) % this->memory.size()]; }
+    T &front() { return (*this)[0]; }
+    T &back() { return (*this)[this->nb - 1]; }
+
+    [[nodiscard]] bool empty() const { return this->nb == 0; }
+    [[nodiscard]] bool full() const { return this->nb == this->memory.size(); }
+    [[nodiscard]] size_t size() const { return this->nb; }
+    [[nodiscard]] size_t capacity() const { return this->memory.size(); }
+
+    template <class R, class V>
+    struct iterator_t {
+        R *r;
+        size_t index;
+
+        V &operator*() const { return (*this->r)[this->index]; }
+        V *operator->() const { return &(*this->r)[this->index]; }
+        iterator_t &operator++() {
+            this->index++;
+            return *this;
+        }
+        bool operator==(const iterator_t &other) const { return this->index == other.index; }
+    };
+    using iterator = iterator_t<ring, T>;
+    using const_iterator = iterator_t<const ring, const T>;
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, this->nb}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, this->nb}; }
+
+   private:
+    std::vector<T> memory;
+    size_t first = 0;
+    size_t nb = 0;
+};